@@ -19,6 +19,7 @@
 #include <QTimer>
 
 #include <shared/QtHelpers.h>
+#include <shared/WorkStealingScheduler.h>
 #include <AccountManager.h>
 #include <AddressManager.h>
 #include <Assignment.h>
@@ -50,6 +51,7 @@ AssignmentClient::AssignmentClient(Assignment::Type requestAssignmentType, QStri
 
     DependencyManager::set<tracing::Tracer>();
     DependencyManager::set<StatTracker>();
+    DependencyManager::set<WorkStealingScheduler>(); // shared by the mixers' slave pools
     DependencyManager::set<AccountManager>();
     DependencyManager::set<ResourceRequestObserver>();
 
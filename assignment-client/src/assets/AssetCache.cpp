@@ -0,0 +1,156 @@
+//
+//  AssetCache.cpp
+//  assignment-client/src/assets
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AssetCache.h"
+
+#include "AssetServerLogging.h"
+
+// an asset bigger than this fraction of the cache is mapped for its request only, it would evict too much
+static const quint64 MAX_CACHED_ASSET_FRACTION = 4;
+
+// smaller assets are read into memory rather than mapped
+static const qint64 MIN_MAPPED_ASSET_SIZE = 64 * 1024;
+
+// mapped assets keep their file open, stay well under the usual descriptor limits
+static const int MAX_MAPPED_ASSETS = 256;
+
+MappedAsset::~MappedAsset() {
+    if (_mapping) {
+        _file.unmap(_mapping);
+    }
+}
+
+AssetCache::AssetCache(const QDir& filesDirectory, quint64 maxBytes) :
+    _filesDirectory(filesDirectory),
+    _maxBytes(maxBytes)
+{
+}
+
+void AssetCache::setMaxBytes(quint64 maxBytes) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _maxBytes = maxBytes;
+    evict();
+}
+
+quint64 AssetCache::getMaxBytes() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _maxBytes;
+}
+
+MappedAssetPointer AssetCache::get(const AssetUtils::AssetHash& hash, bool& wasCached) {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto it = _entries.find(hash);
+        if (it != _entries.end()) {
+            _recentlyUsed.splice(_recentlyUsed.begin(), _recentlyUsed, it->recentlyUsed);
+            ++_stats.numHits;
+            wasCached = true;
+            return it->asset;
+        }
+        ++_stats.numMisses;
+    }
+    wasCached = false;
+
+    // map outside of the lock, the other requests shouldn't wait on the disk
+    auto asset = mapAsset(hash);
+    if (!asset) {
+        return asset;
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    quint64 size = (quint64)asset->size();
+    if (size > _maxBytes / MAX_CACHED_ASSET_FRACTION) {
+        return asset;
+    }
+
+    auto it = _entries.find(hash);
+    if (it != _entries.end()) {
+        // another request mapped it first, use theirs so there is a single mapping
+        return it->asset;
+    }
+
+    _recentlyUsed.push_front(hash);
+    _entries.insert(hash, { asset, _recentlyUsed.begin() });
+    _cachedBytes += size;
+    if (asset->isMapped()) {
+        ++_numMappedAssets;
+    }
+    evict();
+
+    return asset;
+}
+
+void AssetCache::remove(const AssetUtils::AssetHash& hash) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto it = _entries.find(hash);
+    if (it != _entries.end()) {
+        _cachedBytes -= it->asset->size();
+        if (it->asset->isMapped()) {
+            --_numMappedAssets;
+        }
+        _recentlyUsed.erase(it->recentlyUsed);
+        _entries.erase(it);
+    }
+}
+
+void AssetCache::addServedBytes(quint64 bytes, bool fromMemory) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _stats.bytesServed += bytes;
+    if (fromMemory) {
+        _stats.bytesServedFromMemory += bytes;
+    }
+}
+
+AssetCache::Stats AssetCache::sampleStats() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    Stats stats = _stats;
+    stats.cachedBytes = _cachedBytes;
+    stats.numCachedAssets = (int)_entries.size();
+    _stats = Stats();
+    return stats;
+}
+
+MappedAssetPointer AssetCache::mapAsset(const AssetUtils::AssetHash& hash) const {
+    auto asset = std::make_shared<MappedAsset>();
+    asset->_file.setFileName(_filesDirectory.filePath(hash));
+    if (!asset->_file.open(QIODevice::ReadOnly)) {
+        return MappedAssetPointer();
+    }
+
+    asset->_size = asset->_file.size();
+    if (asset->_size >= MIN_MAPPED_ASSET_SIZE) {
+        asset->_mapping = asset->_file.map(0, asset->_size);
+        if (asset->_mapping) {
+            asset->_data = reinterpret_cast<const char*>(asset->_mapping);
+            return asset;
+        }
+        qCWarning(asset_server) << "Could not map asset" << hash << ", reading it instead:" << asset->_file.errorString();
+    }
+
+    asset->_contents = asset->_file.readAll();
+    asset->_file.close();
+    if (asset->_contents.size() != asset->_size) {
+        return MappedAssetPointer();
+    }
+    asset->_data = asset->_contents.constData();
+    return asset;
+}
+
+void AssetCache::evict() {
+    while ((_cachedBytes > _maxBytes || _numMappedAssets > MAX_MAPPED_ASSETS) && !_recentlyUsed.empty()) {
+        auto it = _entries.find(_recentlyUsed.back());
+        _cachedBytes -= it->asset->size();
+        if (it->asset->isMapped()) {
+            --_numMappedAssets;
+        }
+        _entries.erase(it);
+        _recentlyUsed.pop_back();
+    }
+}
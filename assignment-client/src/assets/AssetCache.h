@@ -0,0 +1,100 @@
+//
+//  AssetCache.h
+//  assignment-client/src/assets
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AssetCache_h
+#define hifi_AssetCache_h
+
+#include <list>
+#include <memory>
+#include <mutex>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QHash>
+
+#include "AssetUtils.h"
+
+// The read-only contents of an asset file, they stay valid for as long as the asset is referenced.
+// Large files are memory mapped, small ones are read in, a page per small file would waste memory and descriptors.
+class MappedAsset {
+public:
+    ~MappedAsset();
+
+    const char* data() const { return _data; }
+    qint64 size() const { return _size; }
+    bool isMapped() const { return _mapping != nullptr; }
+
+private:
+    friend class AssetCache;
+
+    QFile _file; // open for as long as it is mapped
+    uchar* _mapping { nullptr };
+    QByteArray _contents;
+    const char* _data { nullptr };
+    qint64 _size { 0 };
+};
+
+using MappedAssetPointer = std::shared_ptr<const MappedAsset>;
+
+// AssetCache keeps the most recently requested asset files mapped in memory, up to a total size.
+//
+// Assets are content addressed, the file for a hash never changes, so a cached mapping only has to be dropped when
+// its file is deleted.  The least recently requested assets are evicted first, requests that still hold an evicted
+// asset keep its mapping until they are done with it.
+class AssetCache {
+public:
+    struct Stats {
+        quint64 numHits { 0 };
+        quint64 numMisses { 0 };
+        quint64 bytesServed { 0 };
+        quint64 bytesServedFromMemory { 0 }; // served from assets that were already cached
+        quint64 cachedBytes { 0 };
+        int numCachedAssets { 0 };
+    };
+
+    AssetCache(const QDir& filesDirectory, quint64 maxBytes);
+
+    // 0 maps files for every request without keeping them
+    void setMaxBytes(quint64 maxBytes);
+    quint64 getMaxBytes() const;
+
+    // returns null if the asset file can't be opened, wasCached is set if it was already in memory
+    MappedAssetPointer get(const AssetUtils::AssetHash& hash, bool& wasCached);
+
+    // drops the asset's mapping, call it before deleting the asset file
+    void remove(const AssetUtils::AssetHash& hash);
+
+    void addServedBytes(quint64 bytes, bool fromMemory);
+
+    // returns the stats since the last call, the cached bytes and assets are current
+    Stats sampleStats();
+
+private:
+    struct Entry {
+        MappedAssetPointer asset;
+        std::list<AssetUtils::AssetHash>::iterator recentlyUsed;
+    };
+
+    MappedAssetPointer mapAsset(const AssetUtils::AssetHash& hash) const;
+    void evict(); // _mutex must be held
+
+    const QDir _filesDirectory;
+
+    mutable std::mutex _mutex;
+    QHash<AssetUtils::AssetHash, Entry> _entries;
+    std::list<AssetUtils::AssetHash> _recentlyUsed; // most recently used first
+    quint64 _maxBytes;
+    quint64 _cachedBytes { 0 };
+    int _numMappedAssets { 0 }; // each keeps its file open
+    Stats _stats;
+};
+
+#endif // hifi_AssetCache_h
@@ -47,6 +47,9 @@ static const uint8_t CPU_AFFINITY_COUNT_LOW = 1;
 static const int INTERFACE_RUNNING_CHECK_FREQUENCY_MS = 1000;
 #endif
 
+static const int DEFAULT_ASSET_CACHE_SIZE_MB = 256;
+static const quint64 BYTES_PER_MEGABYTE = 1024 * 1024;
+
 static const QStringList BAKEABLE_MODEL_EXTENSIONS = { "fbx" };
 static QStringList BAKEABLE_TEXTURE_EXTENSIONS;
 static const QStringList BAKEABLE_SCRIPT_EXTENSIONS = { };
@@ -424,6 +427,8 @@ void AssetServer::completeSetup() {
         return;
     }
 
+    _assetCache = std::make_shared<AssetCache>(_filesDirectory, DEFAULT_ASSET_CACHE_SIZE_MB * BYTES_PER_MEGABYTE);
+
     // load whatever mappings we currently have from the local file
     if (loadMappingsFromFile()) {
         qCInfo(asset_server) << "Serving files from: " << _filesDirectory.path();
@@ -458,6 +463,12 @@ void AssetServer::completeSetup() {
         _filesizeLimit = assetsFilesizeLimit * BITS_PER_MEGABITS;
     }
 
+    // get the size of the in-memory cache of recently requested assets
+    static const QString ASSETS_CACHE_SIZE_OPTION = "assets_cache_size";
+    auto assetsCacheSize = assetServerObject[ASSETS_CACHE_SIZE_OPTION].toInt(DEFAULT_ASSET_CACHE_SIZE_MB);
+    _assetCache->setMaxBytes((quint64)std::max(assetsCacheSize, 0) * BYTES_PER_MEGABYTE);
+    qCDebug(asset_server) << "Caching up to" << assetsCacheSize << "MB of assets in memory";
+
     PathUtils::removeTemporaryApplicationDirs();
     PathUtils::removeTemporaryApplicationDirs("Oven");
 
@@ -537,6 +548,7 @@ void AssetServer::cleanupUnmappedFiles() {
             if (!matched) {
                 // remove the unmapped file
                 QFile removeableFile { fileInfo.absoluteFilePath() };
+                _assetCache->remove(filename);
 
                 if (removeableFile.remove()) {
                     qCDebug(asset_server) << "\tDeleted" << filename << "from asset files directory since it is unmapped.";
@@ -867,7 +879,7 @@ void AssetServer::handleAssetGet(QSharedPointer<ReceivedMessage> message, Shared
     }
 
     // Queue task
-    auto task = new SendAssetTask(message, senderNode, _filesDirectory);
+    auto task = new SendAssetTask(message, senderNode, _assetCache);
     _transferTaskPool.start(task);
 }
 
@@ -957,6 +969,21 @@ void AssetServer::sendStatsPacket() {
         serverStats[uuid] = nodeStats;
     });
 
+    if (_assetCache) {
+        auto cacheStats = _assetCache->sampleStats();
+        quint64 numRequests = cacheStats.numHits + cacheStats.numMisses;
+
+        QJsonObject assetCacheStats;
+        assetCacheStats["1. Hits"] = (double)cacheStats.numHits;
+        assetCacheStats["2. Misses"] = (double)cacheStats.numMisses;
+        assetCacheStats["3. Hit Ratio"] = numRequests > 0 ? (float)cacheStats.numHits / numRequests : 0.0f;
+        assetCacheStats["4. Bytes Served"] = (double)cacheStats.bytesServed;
+        assetCacheStats["5. Bytes Served From Memory"] = (double)cacheStats.bytesServedFromMemory;
+        assetCacheStats["6. Cached Assets"] = cacheStats.numCachedAssets;
+        assetCacheStats["7. Cached (MB)"] = (double)cacheStats.cachedBytes / BYTES_PER_MEGABYTE;
+        serverStats["asset_cache"] = assetCacheStats;
+    }
+
     // send off the stats packets
     ThreadedAssignment::addPacketStatsAndSendStatsPacket(serverStats);
 }
@@ -1171,6 +1198,7 @@ bool AssetServer::deleteMappings(const AssetUtils::AssetPathList& paths) {
         for (auto& hash : hashesToCheckForDeletion) {
             // remove the unmapped file
             QFile removeableFile { _filesDirectory.absoluteFilePath(hash) };
+            _assetCache->remove(hash);
 
             if (removeableFile.remove()) {
                 qCDebug(asset_server) << "\tDeleted" << hash << "from asset files directory since it is now unmapped.";
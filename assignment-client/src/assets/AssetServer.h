@@ -18,6 +18,7 @@
 
 #include <ThreadedAssignment.h>
 
+#include "AssetCache.h"
 #include "AssetUtils.h"
 #include "ReceivedMessage.h"
 
@@ -153,6 +154,9 @@ private:
     QDir _resourcesDirectory;
     QDir _filesDirectory;
 
+    /// Recently requested asset files, shared by the send tasks
+    std::shared_ptr<AssetCache> _assetCache;
+
     /// Task pool for handling uploads and downloads of assets
     QThreadPool _transferTaskPool;
 
@@ -48,10 +48,22 @@ static const QString AUDIO_MIXER_LOGGING_TARGET_NAME = "audio-mixer";
 static const QString AUDIO_ENV_GROUP_KEY = "audio_env";
 static const QString AUDIO_BUFFER_GROUP_KEY = "audio_buffer";
 static const QString AUDIO_THREADING_GROUP_KEY = "audio_threading";
+static const float DEFAULT_SHARED_MIX_POSITION_TOLERANCE = 0.5f; // meters
+static const float DEFAULT_SHARED_MIX_ORIENTATION_TOLERANCE = 10.0f; // degrees
+static const float MIN_SHARED_MIX_POSITION_TOLERANCE = 0.01f; // meters
+static const int DEFAULT_FOA_BUS_HRTF_STREAMS = 16;
+static const float DEFAULT_FOA_BUS_ZONE_SIZE = 8.0f; // meters
+static const float MIN_FOA_BUS_ZONE_SIZE = 1.0f; // meters
 
 int AudioMixer::_numStaticJitterFrames{ DISABLE_STATIC_JITTER_FRAMES };
 float AudioMixer::_noiseMutingThreshold{ DEFAULT_NOISE_MUTING_THRESHOLD };
 float AudioMixer::_attenuationPerDoublingInDistance{ DEFAULT_ATTENUATION_PER_DOUBLING_IN_DISTANCE };
+bool AudioMixer::_batchSends{ false };
+bool AudioMixer::_shareMixes{ false };
+float AudioMixer::_sharedMixPositionTolerance{ DEFAULT_SHARED_MIX_POSITION_TOLERANCE };
+float AudioMixer::_sharedMixOrientationTolerance{ DEFAULT_SHARED_MIX_ORIENTATION_TOLERANCE * RADIANS_PER_DEGREE };
+bool AudioMixer::_useFOABus{ false };
+int AudioMixer::_foaBusHRTFStreams{ DEFAULT_FOA_BUS_HRTF_STREAMS };
 map<QString, shared_ptr<CodecPlugin>> AudioMixer::_availableCodecs{ };
 QStringList AudioMixer::_codecPreferenceOrder{};
 vector<AudioMixer::ZoneDescription> AudioMixer::_audioZones;
@@ -270,13 +282,6 @@ void AudioMixer::sendStatsPacket() {
         return;
     }
 
-#ifdef DEBUG_EVENT_QUEUE
-    QJsonObject qtStats;
-
-    _slavePool.queueStats(qtStats);
-    statsObject["audio_thread_event_queue"] = qtStats;
-#endif
-
     // general stats
     statsObject["useDynamicJitterBuffers"] = _numStaticJitterFrames == DISABLE_STATIC_JITTER_FRAMES;
 
@@ -343,8 +348,55 @@ void AudioMixer::sendStatsPacket() {
 
     statsObject["mix_stats"] = mixStats;
 
+    // send batching stats
+    QJsonObject sendBatchStats;
+
+    sendBatchStats["avg_datagrams_per_frame"] = (float)_stats.sendBatchDatagrams / (float)_numStatFrames;
+    sendBatchStats["avg_syscalls_per_frame"] = (float)_stats.sendBatchSyscalls / (float)_numStatFrames;
+    sendBatchStats["avg_datagrams_per_syscall"] = (_stats.sendBatchSyscalls > 0) ?
+        (float)_stats.sendBatchDatagrams / (float)_stats.sendBatchSyscalls : 0.0f;
+    sendBatchStats["avg_datagrams_per_batch"] = (_stats.sendBatches > 0) ?
+        (float)_stats.sendBatchDatagrams / (float)_stats.sendBatches : 0.0f;
+    sendBatchStats["%_segmented_datagrams"] = (_stats.sendBatchDatagrams > 0) ?
+        (float)_stats.sendBatchSegmentedDatagrams / (float)_stats.sendBatchDatagrams * 100.0f : 0.0f;
+
+    statsObject["send_batch_stats"] = sendBatchStats;
+
+    // shared mix stats
+    QJsonObject sharedMixStats;
+    sharedMixStats["avg_unique_mixes_per_frame"] = (float)_stats.uniqueMixes / (float)_numStatFrames;
+    sharedMixStats["avg_shared_mix_listeners_per_frame"] = (float)_stats.sharedMixListeners / (float)_numStatFrames;
+    sharedMixStats["avg_shared_encodes_per_frame"] = (float)_stats.sharedEncodes / (float)_numStatFrames;
+    sharedMixStats["avg_listeners_per_mix"] = (_stats.uniqueMixes > 0) ?
+        (float)(_stats.uniqueMixes + _stats.sharedMixListeners) / (float)_stats.uniqueMixes : 0.0f;
+
+    statsObject["shared_mix_stats"] = sharedMixStats;
+
+    // FOA bus stats
+    QJsonObject foaBusStats;
+    foaBusStats["avg_zone_encodes_per_frame"] = (float)_stats.foaEncodes / (float)_numStatFrames;
+    foaBusStats["avg_bus_streams_per_frame"] = (float)_stats.foaStreams / (float)_numStatFrames;
+    foaBusStats["avg_bus_renders_per_frame"] = (float)_stats.foaRenders / (float)_numStatFrames;
+
+    statsObject["foa_bus_stats"] = foaBusStats;
+
+    // scheduler stats
+    QJsonObject schedulerStats;
+    const auto& jobStats = _slavePool.getJobStats();
+    int numJobs = std::max(jobStats.numJobs, 1);
+    schedulerStats["avg_jobs_per_frame"] = (float)jobStats.numJobs / (float)_numStatFrames;
+    schedulerStats["avg_participants_per_job"] = (float)jobStats.numParticipants / (float)numJobs;
+    schedulerStats["avg_steals_per_job"] = (float)jobStats.numSteals / (float)numJobs;
+    schedulerStats["avg_dispatch_usecs"] = (float)jobStats.dispatchUsecs / (float)numJobs;
+    schedulerStats["avg_barrier_usecs"] = (float)jobStats.barrierUsecs / (float)numJobs;
+    schedulerStats["avg_job_usecs"] = (float)jobStats.jobUsecs / (float)numJobs;
+    schedulerStats["pinned_threads"] = DependencyManager::get<WorkStealingScheduler>()->isThreadPinningEnabled();
+
+    statsObject["scheduler_stats"] = schedulerStats;
+
     _numStatFrames = _numSilentPackets = 0;
     _stats.reset();
+    _slavePool.resetJobStats();
 
     // add stats for each listerner
     auto nodeList = DependencyManager::get<NodeList>();
@@ -458,9 +510,15 @@ void AudioMixer::start() {
         if (_throttlingRatio > EPSILON) {
             numToRetain = nodeList->size() * (1.0f - _throttlingRatio);
         }
+        // mixes shared between co-located listeners are only valid for the frame they were mixed in
+        _workerSharedData.sharedMixes.clear();
+
         nodeList->nestedEach([&](NodeList::const_iterator cbegin, NodeList::const_iterator cend) {
             // mix across slave threads
             auto mixTimer = _mixTiming.timer();
+            if (_useFOABus) {
+                _workerSharedData.foaBus.prepare(cbegin, cend);
+            }
             _slavePool.mix(cbegin, cend, frame, numToRetain);
         });
 
@@ -549,6 +607,13 @@ void AudioMixer::clearDomainSettings() {
     _numStaticJitterFrames = DISABLE_STATIC_JITTER_FRAMES;
     _attenuationPerDoublingInDistance = DEFAULT_ATTENUATION_PER_DOUBLING_IN_DISTANCE;
     _noiseMutingThreshold = DEFAULT_NOISE_MUTING_THRESHOLD;
+    _batchSends = false;
+    _shareMixes = false;
+    _sharedMixPositionTolerance = DEFAULT_SHARED_MIX_POSITION_TOLERANCE;
+    _sharedMixOrientationTolerance = DEFAULT_SHARED_MIX_ORIENTATION_TOLERANCE * RADIANS_PER_DEGREE;
+    _useFOABus = false;
+    _foaBusHRTFStreams = DEFAULT_FOA_BUS_HRTF_STREAMS;
+    _workerSharedData.foaBus.setZoneSize(DEFAULT_FOA_BUS_ZONE_SIZE);
     _codecPreferenceOrder.clear();
     _audioZones.clear();
     _zoneSettings.clear();
@@ -571,6 +636,12 @@ void AudioMixer::parseSettingsObject(const QJsonObject& settingsObject) {
             }
         }
 
+        const QString PIN_THREADS = "pin_threads";
+        if (audioThreadingGroupObject[PIN_THREADS].toBool()) {
+            // the scheduler is shared with any other mixer in this process, so pinning is never turned back off here
+            DependencyManager::get<WorkStealingScheduler>()->setThreadPinning(true);
+        }
+
         const QString THROTTLE_START_KEY = "throttle_start";
         const QString THROTTLE_BACKOFF_KEY = "throttle_backoff";
 
@@ -588,6 +659,53 @@ void AudioMixer::parseSettingsObject(const QJsonObject& settingsObject) {
         }
 
         qCDebug(audio) << "Throttle Start:" << _throttleStartTarget << "Throttle Backoff:" << _throttleBackoffTarget;
+
+        const QString BATCH_SENDS_KEY = "batch_sends";
+        _batchSends = audioThreadingGroupObject[BATCH_SENDS_KEY].toBool();
+        qCDebug(audio) << "Batched mix sends:" << (_batchSends ? "enabled" : "disabled");
+
+        const QString SHARED_MIX_KEY = "shared_mix";
+        const QString SHARED_MIX_POSITION_TOLERANCE_KEY = "shared_mix_position_tolerance";
+        const QString SHARED_MIX_ORIENTATION_TOLERANCE_KEY = "shared_mix_orientation_tolerance";
+        _shareMixes = audioThreadingGroupObject[SHARED_MIX_KEY].toBool();
+
+        float positionTolerance = audioThreadingGroupObject[SHARED_MIX_POSITION_TOLERANCE_KEY]
+            .toDouble(DEFAULT_SHARED_MIX_POSITION_TOLERANCE);
+        float orientationTolerance = audioThreadingGroupObject[SHARED_MIX_ORIENTATION_TOLERANCE_KEY]
+            .toDouble(DEFAULT_SHARED_MIX_ORIENTATION_TOLERANCE);
+        if (positionTolerance < MIN_SHARED_MIX_POSITION_TOLERANCE || orientationTolerance < 0.0f ||
+            orientationTolerance > 180.0f) {
+            qCWarning(audio) << "Shared mix position tolerance must be at least" << MIN_SHARED_MIX_POSITION_TOLERANCE
+                << "and orientation tolerance must be between 0 and 180 degrees. Using default values.";
+        } else {
+            _sharedMixPositionTolerance = positionTolerance;
+            _sharedMixOrientationTolerance = orientationTolerance * RADIANS_PER_DEGREE;
+        }
+
+        qCDebug(audio) << "Shared mixes:" << (_shareMixes ? "enabled" : "disabled")
+            << "Position tolerance:" << _sharedMixPositionTolerance
+            << "Orientation tolerance:" << _sharedMixOrientationTolerance / RADIANS_PER_DEGREE;
+
+        const QString FOA_BUS_KEY = "foa_bus";
+        const QString FOA_BUS_HRTF_STREAMS_KEY = "foa_bus_hrtf_streams";
+        const QString FOA_BUS_ZONE_SIZE_KEY = "foa_bus_zone_size";
+        _useFOABus = audioThreadingGroupObject[FOA_BUS_KEY].toBool();
+
+        bool ok;
+        int hrtfStreams = audioThreadingGroupObject[FOA_BUS_HRTF_STREAMS_KEY].toString().toInt(&ok);
+        if (ok && hrtfStreams >= 0) {
+            _foaBusHRTFStreams = hrtfStreams;
+        }
+
+        float zoneSize = audioThreadingGroupObject[FOA_BUS_ZONE_SIZE_KEY].toDouble(DEFAULT_FOA_BUS_ZONE_SIZE);
+        if (zoneSize < MIN_FOA_BUS_ZONE_SIZE) {
+            qCWarning(audio) << "FOA bus zone size must be at least" << MIN_FOA_BUS_ZONE_SIZE << "meters. Using default value.";
+            zoneSize = DEFAULT_FOA_BUS_ZONE_SIZE;
+        }
+        _workerSharedData.foaBus.setZoneSize(zoneSize);
+
+        qCDebug(audio) << "FOA bus:" << (_useFOABus ? "enabled" : "disabled")
+            << "HRTF streams:" << _foaBusHRTFStreams << "Zone size:" << zoneSize;
     }
 
     if (settingsObject.contains(AUDIO_BUFFER_GROUP_KEY)) {
@@ -664,6 +782,45 @@ void AudioMixer::parseSettingsObject(const QJsonObject& settingsObject) {
             qCDebug(audio) << "Codec preference order changed to" << _codecPreferenceOrder;
         }
 
+        // tuning for the codecs with a variable bitrate, which applies to the encoders of listeners that connect later
+        const QString CODEC_BITRATE = "codec_bitrate";
+        if (audioEnvGroupObject[CODEC_BITRATE].isString()) {
+            bool ok = false;
+            int bitrate = audioEnvGroupObject[CODEC_BITRATE].toString().toInt(&ok);
+            if (ok && bitrate > 0) {
+                for (auto& codec : _availableCodecs) {
+                    codec.second->setEncoderBitrate(bitrate * BYTES_PER_KILOBIT * BITS_IN_BYTE);
+                }
+                qCDebug(audio) << "Codec bitrate changed to" << bitrate << "kbps per channel";
+            }
+        }
+
+        const QString CODEC_COMPLEXITY = "codec_complexity";
+        if (audioEnvGroupObject[CODEC_COMPLEXITY].isString()) {
+            bool ok = false;
+            int complexity = audioEnvGroupObject[CODEC_COMPLEXITY].toString().toInt(&ok);
+            if (ok) {
+                complexity = glm::clamp(complexity, 0, 10);
+                for (auto& codec : _availableCodecs) {
+                    codec.second->setEncoderComplexity(complexity);
+                }
+                qCDebug(audio) << "Codec complexity changed to" << complexity;
+            }
+        }
+
+        const QString CODEC_EXPECTED_PACKET_LOSS = "codec_expected_packet_loss";
+        if (audioEnvGroupObject[CODEC_EXPECTED_PACKET_LOSS].isString()) {
+            bool ok = false;
+            int packetLoss = audioEnvGroupObject[CODEC_EXPECTED_PACKET_LOSS].toString().toInt(&ok);
+            if (ok) {
+                packetLoss = glm::clamp(packetLoss, 0, 100);
+                for (auto& codec : _availableCodecs) {
+                    codec.second->setEncoderExpectedPacketLoss(packetLoss);
+                }
+                qCDebug(audio) << "Codec expected packet loss changed to" << packetLoss << "percent";
+            }
+        }
+
         const QString ATTENATION_PER_DOULING_IN_DISTANCE = "attenuation_per_doubling_in_distance";
         if (audioEnvGroupObject[ATTENATION_PER_DOULING_IN_DISTANCE].isString()) {
             bool ok = false;
@@ -53,6 +53,12 @@ public:
     static int getStaticJitterFrames() { return _numStaticJitterFrames; }
     static bool shouldMute(float quietestFrame) { return quietestFrame > _noiseMutingThreshold; }
     static float getAttenuationPerDoublingInDistance() { return _attenuationPerDoublingInDistance; }
+    static bool shouldBatchSends() { return _batchSends; }
+    static bool shouldShareMixes() { return _shareMixes; }
+    static float getSharedMixPositionTolerance() { return _sharedMixPositionTolerance; }
+    static float getSharedMixOrientationTolerance() { return _sharedMixOrientationTolerance; }
+    static bool shouldUseFOABus() { return _useFOABus; }
+    static int getFOABusHRTFStreams() { return _foaBusHRTFStreams; }
     static const std::vector<ZoneDescription>& getAudioZones() { return _audioZones; }
     static const std::vector<ZoneSettings>& getZoneSettings() { return _zoneSettings; }
     static const std::vector<ReverbSettings>& getReverbSettings() { return _zoneReverbSettings; }
@@ -141,6 +147,12 @@ private:
     static int _numStaticJitterFrames; // -1 denotes dynamic jitter buffering
     static float _noiseMutingThreshold;
     static float _attenuationPerDoublingInDistance;
+    static bool _batchSends;
+    static bool _shareMixes;
+    static float _sharedMixPositionTolerance; // meters
+    static float _sharedMixOrientationTolerance; // radians
+    static bool _useFOABus;
+    static int _foaBusHRTFStreams;
     static std::map<QString, CodecPluginPointer> _availableCodecs;
     static QStringList _codecPreferenceOrder;
 
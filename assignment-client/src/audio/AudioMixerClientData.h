@@ -19,6 +19,7 @@
 #include <QtCore/QJsonObject>
 
 #include <AABox.h>
+#include <AudioFOA.h>
 #include <AudioHRTF.h>
 #include <AudioLimiter.h>
 #include <UUIDHasher.h>
@@ -88,6 +89,8 @@ public:
     void setMasterInjectorGain(float gain) { _masterInjectorGain = gain; }
 
     AudioLimiter audioLimiter;
+    AudioFOA audioFOA; // renders the listener's zone of the FOA bus
+    int audioFOASilentBlocks { 0 }; // silent FOA bus blocks rendered since the last one with audio
 
     void setupCodec(CodecPluginPointer codec, const QString& codecName);
     void cleanupCodec();
@@ -100,6 +103,12 @@ public:
         // once you have encoded, you need to flush eventually.
         _shouldFlushEncoder = true;
     }
+    // reuse a frame encoded for another listener, only valid when hasStatelessEncoder()
+    void reuseEncodedFrame(const QByteArray& sharedEncodedBuffer, QByteArray& encodedBuffer) {
+        encodedBuffer = sharedEncodedBuffer;
+        _shouldFlushEncoder = true;
+    }
+    bool hasStatelessEncoder() const { return !_encoder || _encoder->isStateless(); }
     void encodeFrameOfZeros(QByteArray& encodedZeros);
     bool shouldFlushEncoder() { return _shouldFlushEncoder; }
 
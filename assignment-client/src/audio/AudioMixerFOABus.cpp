@@ -0,0 +1,98 @@
+//
+//  AudioMixerFOABus.cpp
+//  assignment-client/src/audio
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AudioMixerFOABus.h"
+
+#include <algorithm>
+
+#include "AudioMixerClientData.h"
+#include "InjectedAudioStream.h"
+
+// 21 bits per axis, biased so that negative zone coordinates pack correctly
+static const int64_t ZONE_COORD_BIAS = 1 << 20;
+static const int64_t ZONE_COORD_MASK = (1 << 21) - 1;
+
+uint64_t AudioMixerFOABus::keyForPosition(const glm::vec3& position) const {
+    glm::vec3 zone = glm::floor(position / _zoneSize);
+    uint64_t x = (uint64_t)(((int64_t)zone.x + ZONE_COORD_BIAS) & ZONE_COORD_MASK);
+    uint64_t y = (uint64_t)(((int64_t)zone.y + ZONE_COORD_BIAS) & ZONE_COORD_MASK);
+    uint64_t z = (uint64_t)(((int64_t)zone.z + ZONE_COORD_BIAS) & ZONE_COORD_MASK);
+    return (x << 42) | (y << 21) | z;
+}
+
+void AudioMixerFOABus::prepare(ConstIter begin, ConstIter end) {
+    size_t numSources = 0;
+    std::unordered_map<uint64_t, std::unique_ptr<Zone>> zones;
+
+    std::for_each(begin, end, [&](const SharedNodePointer& node) {
+        AudioMixerClientData* nodeData = static_cast<AudioMixerClientData*>(node->getLinkedData());
+        if (!nodeData) {
+            return;
+        }
+
+        for (const auto& stream : nodeData->getAudioStreams()) {
+            // stereo sources are not spatialized, they are always mixed directly
+            if (stream->isStereo()) {
+                continue;
+            }
+
+            // follow AudioMixerSlave::addStream: a missed frame repeats with a fade, except for injectors
+            float fadeFactor = 1.0f;
+            if (!stream->lastPopSucceeded()) {
+                bool isInjector = dynamic_cast<const InjectedAudioStream*>(stream.get());
+                if (stream->getLastPopOutput().isNull() || isInjector) {
+                    continue;
+                }
+                fadeFactor = calculateRepeatedFrameFadeFactor(stream->getConsecutiveNotMixedCount() - 1);
+                if (fadeFactor <= 0.0f) {
+                    continue;
+                }
+            }
+
+            if (numSources == _sources.size()) {
+                _sources.emplace_back();
+            }
+            Source& source = _sources[numSources++];
+            source.stream = stream.get();
+            source.fadeFactor = fadeFactor;
+
+            int16_t samples[NUM_FRAMES];
+            AudioRingBuffer::ConstIterator streamPopOutput = stream->getLastPopOutput();
+            streamPopOutput.readSamples(samples, NUM_FRAMES);
+
+            // the scale AudioFOA::render converts its input with
+            const float SAMPLE_SCALE = 1.0f / 32768.0f;
+            for (int i = 0; i < NUM_FRAMES; ++i) {
+                source.samples[i] = samples[i] * (fadeFactor * SAMPLE_SCALE);
+            }
+        }
+
+        // every listener needs its zone, keep the zones (and their allocations) that are still occupied
+        AvatarAudioStream* listenerStream = nodeData->getAvatarAudioStream();
+        if (node->getType() == NodeType::Agent && listenerStream) {
+            uint64_t key = keyForPosition(listenerStream->getPosition());
+            if (zones.find(key) == zones.end()) {
+                auto it = _zones.find(key);
+                auto& zone = zones[key];
+                zone = (it != _zones.end()) ? std::move(it->second) : std::unique_ptr<Zone>(new Zone);
+                zone->center = (glm::floor(listenerStream->getPosition() / _zoneSize) + 0.5f) * _zoneSize;
+                zone->isEncoded = false;
+            }
+        }
+    });
+
+    _sources.resize(numSources);
+    _zones = std::move(zones);
+}
+
+AudioMixerFOABus::Zone* AudioMixerFOABus::getZone(const glm::vec3& position) const {
+    auto it = _zones.find(keyForPosition(position));
+    return (it != _zones.end()) ? it->second.get() : nullptr;
+}
@@ -0,0 +1,90 @@
+//
+//  AudioMixerFOABus.h
+//  assignment-client/src/audio
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioMixerFOABus_h
+#define hifi_AudioMixerFOABus_h
+
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <AudioConstants.h>
+#include <NodeList.h>
+
+class PositionalAudioStream;
+
+// AudioMixerFOABus holds, for every zone of the world that has a listener in it, a first-order ambisonic
+// scene of the sources that are far from that zone.  Listeners in a zone render the nearest sources through
+// their own HRTFs and hear everything else through a single binaural render of their zone's scene, so the
+// per-listener cost stops growing with the number of sources.
+//
+// The bus is prepared on the mixer thread once per frame, before the slaves mix.  Zones are encoded lazily
+// by the first slave that mixes a listener in them (see AudioMixerSlave::encodeFOAZone).
+class AudioMixerFOABus {
+public:
+    using ConstIter = NodeList::const_iterator;
+
+    static const int NUM_CHANNELS = AudioConstants::AMBISONIC;
+    static const int NUM_FRAMES = AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL;
+
+    // a source that can be heard this frame, with its (mono, faded) samples for the frame
+    struct Source {
+        PositionalAudioStream* stream;
+        float fadeFactor;
+        float samples[NUM_FRAMES];
+    };
+
+    // a source encoded into a zone's scene
+    struct ZoneSource {
+        int sourceIndex;
+        bool isInjector;
+        float coefficients[NUM_CHANNELS]; // gain at the zone's center times the ambiX (ACN/SN3D) encoding
+    };
+
+    struct Zone {
+        glm::vec3 center;
+
+        std::mutex mutex;
+        bool isEncoded { false };
+
+        std::vector<ZoneSource> sources;
+        std::unordered_map<const PositionalAudioStream*, int> sourceIndices; // stream -> index in sources
+
+        // avatars and injectors are kept apart so that each listener's master gains can be applied
+        float avatarScene[NUM_CHANNELS][NUM_FRAMES];
+        float injectorScene[NUM_CHANNELS][NUM_FRAMES];
+    };
+
+    void setZoneSize(float zoneSize) { _zoneSize = zoneSize; }
+    float getZoneSize() const { return _zoneSize; }
+
+    // sources further than this from a zone's center are encoded into its scene
+    float getFarDistance() const { return 2.0f * _zoneSize; }
+
+    // collect the frame's sources and the zones of the frame's listeners
+    void prepare(ConstIter begin, ConstIter end);
+
+    // returns the zone holding position, which must be a listener's position from prepare
+    Zone* getZone(const glm::vec3& position) const;
+
+    const std::vector<Source>& getSources() const { return _sources; }
+
+private:
+    uint64_t keyForPosition(const glm::vec3& position) const;
+
+    std::vector<Source> _sources;
+    std::unordered_map<uint64_t, std::unique_ptr<Zone>> _zones;
+    float _zoneSize { 8.0f }; // meters
+};
+
+#endif // hifi_AudioMixerFOABus_h
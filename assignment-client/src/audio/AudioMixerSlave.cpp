@@ -25,6 +25,7 @@
 #include <plugins/PluginManager.h>
 #include <plugins/CodecPlugin.h>
 #include <udt/PacketHeaders.h>
+#include <GLMHelpers.h>
 #include <SharedUtil.h>
 #include <StDev.h>
 #include <UUID.h>
@@ -50,7 +51,7 @@ void sendEnvironmentPacket(const SharedNodePointer& node, AudioMixerClientData&
 
 // mix helpers
 inline float approximateGain(const AvatarAudioStream& listeningNodeStream, const PositionalAudioStream& streamToAdd);
-inline float computeGain(float masterAvatarGain, float masterInjectorGain, const AvatarAudioStream& listeningNodeStream,
+inline float computeGain(float masterAvatarGain, float masterInjectorGain, const glm::vec3& listenerPosition,
         const PositionalAudioStream& streamToAdd, const glm::vec3& relativePosition, float distance);
 inline float computeAzimuth(const AvatarAudioStream& listeningNodeStream, const PositionalAudioStream& streamToAdd,
         const glm::vec3& relativePosition);
@@ -68,6 +69,25 @@ void AudioMixerSlave::configureMix(ConstIter begin, ConstIter end, unsigned int
     _end = end;
     _frame = frame;
     _numToRetain = numToRetain;
+
+    if (AudioMixer::shouldBatchSends()) {
+        // mixes sent from this thread are flushed together in flushSends
+        _isBatchingSends = DependencyManager::get<NodeList>()->beginSendBatch();
+    }
+}
+
+void AudioMixerSlave::flushSends() {
+    if (!_isBatchingSends) {
+        return;
+    }
+
+    auto batchStats = DependencyManager::get<NodeList>()->endSendBatch();
+    _isBatchingSends = false;
+
+    ++stats.sendBatches;
+    stats.sendBatchDatagrams += batchStats.numDatagrams;
+    stats.sendBatchSyscalls += batchStats.numSyscalls;
+    stats.sendBatchSegmentedDatagrams += batchStats.numSegmentedDatagrams;
 }
 
 void AudioMixerSlave::mix(const SharedNodePointer& node) {
@@ -100,9 +120,14 @@ void AudioMixerSlave::mix(const SharedNodePointer& node) {
         bool mixHasAudio = prepareMix(node);
 
         // send audio packet
+        QByteArray encodedBuffer;
         if (mixHasAudio || data->shouldFlushEncoder()) {
-            QByteArray encodedBuffer;
-            if (mixHasAudio) {
+            if (mixHasAudio && _reusedMix && !_reusedMix->encodedBuffer.isEmpty() &&
+                _reusedMix->codecName == data->getCodecName() && data->hasStatelessEncoder()) {
+                // the same samples through the same stateless codec, reuse the encode
+                data->reuseEncodedFrame(_reusedMix->encodedBuffer, encodedBuffer);
+                ++stats.sharedEncodes;
+            } else if (mixHasAudio) {
                 // encode the audio
                 QByteArray decodedBuffer(reinterpret_cast<char*>(_bufferSamples), AudioConstants::NETWORK_FRAME_BYTES_STEREO);
                 data->encode(decodedBuffer, encodedBuffer);
@@ -117,6 +142,15 @@ void AudioMixerSlave::mix(const SharedNodePointer& node) {
             sendSilentPacket(node, *data);
         }
 
+        if (_publishedMix) {
+            // stateful codecs encode against per-listener history, so only stateless encodes are shared
+            if (mixHasAudio && data->hasStatelessEncoder()) {
+                _publishedMix->codecName = data->getCodecName();
+                _publishedMix->encodedBuffer = encodedBuffer;
+            }
+            _sharedData.sharedMixes.insert(SharedMixes::value_type(sharedMixKey(*avatarStream), std::move(_publishedMix)));
+        }
+
         // send environment packet
         sendEnvironmentPacket(node, *data);
 
@@ -313,6 +347,11 @@ bool AudioMixerSlave::prepareMix(const SharedNodePointer& listener) {
     // zero out the mix for this listener
     memset(_mixSamples, 0, sizeof(_mixSamples));
 
+    // streams are collected first and mixed once we know whether a co-located listener already mixed them
+    _pendingStreams.clear();
+    _reusedMix.reset();
+    _publishedMix.reset();
+
     bool isThrottling = _numToRetain != -1;
     bool isSoloing = !listenerData->getSoloedNodes().empty();
 
@@ -338,8 +377,8 @@ bool AudioMixerSlave::prepareMix(const SharedNodePointer& listener) {
         }
 
         if (!isThrottling) {
-            updateHRTFParameters(stream, *listenerAudioStream, listenerData->getMasterAvatarGain(),
-                                 listenerData->getMasterInjectorGain());
+            updateHRTFParameters(*stream.positionalStream, *stream.hrtf, *listenerAudioStream,
+                                 listenerData->getMasterAvatarGain(), listenerData->getMasterInjectorGain());
         }
         return false;
     });
@@ -363,8 +402,8 @@ bool AudioMixerSlave::prepareMix(const SharedNodePointer& listener) {
         }
 
         if (!isThrottling) {
-            updateHRTFParameters(stream, *listenerAudioStream, listenerData->getMasterAvatarGain(),
-                                 listenerData->getMasterInjectorGain());
+            updateHRTFParameters(*stream.positionalStream, *stream.hrtf, *listenerAudioStream,
+                                 listenerData->getMasterAvatarGain(), listenerData->getMasterInjectorGain());
         }
         return false;
     });
@@ -381,14 +420,13 @@ bool AudioMixerSlave::prepareMix(const SharedNodePointer& listener) {
             stream.approximateVolume = approximateVolume(stream, listenerAudioStream);
         } else {
             if (shouldBeSkipped(stream, *listener, *listenerAudioStream, *listenerData)) {
-                addStream(stream, *listenerAudioStream, 0.0f, 0.0f, isSoloing);
+                queueStream(stream, 0.0f, 0.0f);
                 streams.skipped.push_back(move(stream));
                 ++stats.activeToSkipped;
                 return true;
             }
 
-            addStream(stream, *listenerAudioStream, listenerData->getMasterAvatarGain(), listenerData->getMasterInjectorGain(),
-                      isSoloing);
+            queueStream(stream, listenerData->getMasterAvatarGain(), listenerData->getMasterInjectorGain());
 
             if (shouldBeInactive(stream)) {
                 // To reduce artifacts we still call render to flush the HRTF for every silent
@@ -423,8 +461,7 @@ bool AudioMixerSlave::prepareMix(const SharedNodePointer& listener) {
                 return true;
             }
 
-            addStream(stream, *listenerAudioStream, listenerData->getMasterAvatarGain(), listenerData->getMasterInjectorGain(),
-                      isSoloing);
+            queueStream(stream, listenerData->getMasterAvatarGain(), listenerData->getMasterInjectorGain());
 
             if (shouldBeInactive(stream)) {
                 // To reduce artifacts we still call render to flush the HRTF for every silent
@@ -467,36 +504,314 @@ bool AudioMixerSlave::prepareMix(const SharedNodePointer& listener) {
     // clear the newly ignored, un-ignored, ignoring, and un-ignoring streams now that we've processed them
     listenerData->clearStagedIgnoreChanges();
 
+    // soloing and echo mixes are specific to this listener, so they are never shared
+    bool canShareMix = AudioMixer::shouldShareMixes() && !isSoloing &&
+        std::none_of(_pendingStreams.begin(), _pendingStreams.end(), [&](const PendingStream& pending) {
+            return pending.positionalStream == listenerAudioStream;
+        });
+
+    if (canShareMix) {
+        _mixStreams.clear();
+        for (const auto& pending : _pendingStreams) {
+            _mixStreams.push_back({ pending.nodeStreamID.nodeLocalID, pending.nodeStreamID.streamID,
+                                    pending.masterAvatarGain, pending.masterInjectorGain, pending.hrtf->getGainAdjustment() });
+        }
+        std::sort(_mixStreams.begin(), _mixStreams.end(), [](const SharedMixStream& a, const SharedMixStream& b) {
+            return a.nodeLocalID < b.nodeLocalID || (a.nodeLocalID == b.nodeLocalID && a.streamID < b.streamID);
+        });
+
+        _reusedMix = findSharedMix(*listenerAudioStream);
+    }
+
+    bool hasAudio = false;
+    if (_reusedMix) {
+        // this listener's HRTFs are not rendered while it shares a mix, so flush their history (as for throttled
+        // streams) and keep their parameters current, so it can leave the shared mix without a stale tail or a jump
+        for (const auto& pending : _pendingStreams) {
+            pending.hrtf->reset();
+            updateHRTFParameters(*pending.positionalStream, *pending.hrtf, *listenerAudioStream,
+                                 pending.masterAvatarGain, pending.masterInjectorGain);
+        }
+
+        // run this listener's own limiter over the mix it hears, so its envelope is current when it leaves,
+        // but send the shared samples so that their encode can still be reused
+        memcpy(_mixSamples, _reusedMix->mixSamples, sizeof(_mixSamples));
+        listenerData->audioLimiter.render(_mixSamples, _bufferSamples, AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+        memcpy(_bufferSamples, _reusedMix->samples, sizeof(_bufferSamples));
+        hasAudio = _reusedMix->hasAudio;
+        ++stats.sharedMixListeners;
+    } else {
+        addPendingStreams(*listenerData, *listenerAudioStream, isSoloing);
+        ++stats.uniqueMixes;
+
+        // check for silent audio before limiting
+        // limiting uses a dither and can only guarantee abs(sample) <= 1
+        for (int i = 0; i < AudioConstants::NETWORK_FRAME_SAMPLES_STEREO; ++i) {
+            if (_mixSamples[i] != 0.0f) {
+                hasAudio = true;
+                break;
+            }
+        }
+
+        // use the per listener AudioLimiter to render the mixed data
+        listenerData->audioLimiter.render(_mixSamples, _bufferSamples, AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+
+        if (canShareMix) {
+            // published in mix() once it has been encoded
+            _publishedMix = std::make_shared<SharedMix>();
+            _publishedMix->position = listenerAudioStream->getPosition();
+            _publishedMix->orientation = listenerAudioStream->getOrientation();
+            _publishedMix->streams = _mixStreams;
+            _publishedMix->hasAudio = hasAudio;
+            memcpy(_publishedMix->mixSamples, _mixSamples, sizeof(_mixSamples));
+            memcpy(_publishedMix->samples, _bufferSamples, sizeof(_bufferSamples));
+        }
+    }
+
 #ifdef HIFI_AUDIO_MIXER_DEBUG
     auto mixEnd = p_high_resolution_clock::now();
     auto mixTime = std::chrono::duration_cast<std::chrono::nanoseconds>(mixEnd - mixStart);
     stats.mixTime += mixTime.count();
 #endif
 
-    // check for silent audio before limiting
-    // limiting uses a dither and can only guarantee abs(sample) <= 1
+    return hasAudio;
+}
+
+void AudioMixerSlave::queueStream(AudioMixerClientData::MixableStream& mixableStream,
+                                  float masterAvatarGain,
+                                  float masterInjectorGain) {
+    _pendingStreams.push_back({ mixableStream.positionalStream, mixableStream.hrtf.get(), mixableStream.nodeStreamID,
+                                masterAvatarGain, masterInjectorGain });
+}
+
+void AudioMixerSlave::addPendingStreams(AudioMixerClientData& listenerData,
+                                        AvatarAudioStream& listeningNodeStream,
+                                        bool isSoloing) {
+    int numHRTFStreams = AudioMixer::getFOABusHRTFStreams();
+
+    AudioMixerFOABus::Zone* zone = nullptr;
+    if (AudioMixer::shouldUseFOABus() && !isSoloing && (int)_pendingStreams.size() > numHRTFStreams) {
+        zone = _sharedData.foaBus.getZone(listeningNodeStream.getPosition());
+    }
+
+    if (!zone) {
+        // the bus isn't rendered for this listener, so it must start over when it is again
+        listenerData.audioFOA.reset();
+        for (const auto& pending : _pendingStreams) {
+            addStream(*pending.positionalStream, *pending.hrtf, listeningNodeStream,
+                      pending.masterAvatarGain, pending.masterInjectorGain, isSoloing);
+        }
+        return;
+    }
+
+    {
+        // the first listener mixed in a zone encodes its scene for the others
+        std::lock_guard<std::mutex> lock(zone->mutex);
+        if (!zone->isEncoded) {
+            encodeFOAZone(*zone);
+            zone->isEncoded = true;
+        }
+    }
+
+    // the nearest streams keep their HRTF
+    const glm::vec3& listenerPosition = listeningNodeStream.getPosition();
+    auto hrtfEnd = _pendingStreams.begin() + numHRTFStreams;
+    std::nth_element(_pendingStreams.begin(), hrtfEnd, _pendingStreams.end(),
+                     [&](const PendingStream& a, const PendingStream& b) {
+                         return glm::distance2(a.positionalStream->getPosition(), listenerPosition) <
+                             glm::distance2(b.positionalStream->getPosition(), listenerPosition);
+                     });
+
+    // the weight this listener hears each of the scene's sources at, relative to the scene's encoding
+    // (sources that are ignored, throttled, or on their own HRTF stay at 0)
+    _foaWeights.assign(zone->sources.size(), 0.0f);
+    for (auto it = _pendingStreams.begin(); it != _pendingStreams.end(); ++it) {
+        auto sourceIndex = zone->sourceIndices.find(it->positionalStream);
+        if (it < hrtfEnd || sourceIndex == zone->sourceIndices.end()) {
+            addStream(*it->positionalStream, *it->hrtf, listeningNodeStream,
+                      it->masterAvatarGain, it->masterInjectorGain, isSoloing);
+        } else {
+            bool isInjector = it->positionalStream->getType() == PositionalAudioStream::Injector;
+            float masterGain = isInjector ? it->masterInjectorGain : it->masterAvatarGain;
+            _foaWeights[sourceIndex->second] = masterGain * it->hrtf->getGainAdjustment() / HRTF_GAIN;
+
+            // drop the HRTF history, so this stream starts clean when it is near again
+            it->hrtf->reset();
+            ++stats.foaStreams;
+        }
+    }
+
+    // the scene at this listener's master gains, corrected for the sources heard differently
+    float masterAvatarGain = listenerData.getMasterAvatarGain();
+    float masterInjectorGain = listenerData.getMasterInjectorGain();
+    for (int channel = 0; channel < AudioMixerFOABus::NUM_CHANNELS; ++channel) {
+        for (int i = 0; i < AudioMixerFOABus::NUM_FRAMES; ++i) {
+            _foaScene[channel][i] = masterAvatarGain * zone->avatarScene[channel][i] +
+                masterInjectorGain * zone->injectorScene[channel][i];
+        }
+    }
+
+    const auto& sources = _sharedData.foaBus.getSources();
+    for (size_t j = 0; j < zone->sources.size(); ++j) {
+        const auto& zoneSource = zone->sources[j];
+        float delta = _foaWeights[j] - (zoneSource.isInjector ? masterInjectorGain : masterAvatarGain);
+        if (delta == 0.0f) {
+            continue;
+        }
+
+        const float* samples = sources[zoneSource.sourceIndex].samples;
+        for (int channel = 0; channel < AudioMixerFOABus::NUM_CHANNELS; ++channel) {
+            float gain = delta * zoneSource.coefficients[channel];
+            for (int i = 0; i < AudioMixerFOABus::NUM_FRAMES; ++i) {
+                _foaScene[channel][i] += gain * samples[i];
+            }
+        }
+    }
+
+    // convert to interleaved samples with a fixed headroom, a changing scale would not follow
+    // the gain interpolation across the block
+    const float FOA_BUS_HEADROOM = 4.0f;
+    const float FOA_BUS_SCALE = 32768.0f / FOA_BUS_HEADROOM;
     bool hasAudio = false;
-    for (int i = 0; i < AudioConstants::NETWORK_FRAME_SAMPLES_STEREO; ++i) {
-        if (_mixSamples[i] != 0.0f) {
-            hasAudio = true;
-            break;
+    for (int i = 0; i < AudioMixerFOABus::NUM_FRAMES; ++i) {
+        for (int channel = 0; channel < AudioMixerFOABus::NUM_CHANNELS; ++channel) {
+            float sample = glm::clamp(_foaScene[channel][i] * FOA_BUS_SCALE,
+                                      (float)AudioConstants::MIN_SAMPLE_VALUE, (float)AudioConstants::MAX_SAMPLE_VALUE);
+            int16_t value = (int16_t)sample;
+            _foaSamples[AudioMixerFOABus::NUM_CHANNELS * i + channel] = value;
+            hasAudio |= (value != 0);
         }
     }
 
-    // use the per listener AudioLimiter to render the mixed data
-    listenerData->audioLimiter.render(_mixSamples, _bufferSamples, AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+    if (hasAudio) {
+        listenerData.audioFOASilentBlocks = 0;
+    } else {
+        // keep rendering silence until the convolution tail of the last block with audio is flushed, then reset,
+        // so that the next block with audio doesn't start from stale history and orientation
+        const int FOA_TAIL_BLOCKS = (FOA_OVERLAP + AudioMixerFOABus::NUM_FRAMES - 1) / AudioMixerFOABus::NUM_FRAMES;
+        if (listenerData.audioFOASilentBlocks >= FOA_TAIL_BLOCKS) {
+            listenerData.audioFOA.reset();
+            return;
+        }
+        ++listenerData.audioFOASilentBlocks;
+    }
 
-    return hasAudio;
+    // the scene is world aligned, rotate it into the listener's frame
+    // and convert from Y-up (OpenGL) to Z-up (Ambisonic) coordinates
+    glm::quat relativeOrientation = glm::inverse(listeningNodeStream.getOrientation());
+    float qw = relativeOrientation.w;
+    float qx = -relativeOrientation.z;
+    float qy = -relativeOrientation.x;
+    float qz = relativeOrientation.y;
+
+    const int HRTF_DATASET_INDEX = 1;
+    listenerData.audioFOA.render(_foaSamples, _mixSamples, HRTF_DATASET_INDEX, qw, qx, qy, qz, FOA_BUS_HEADROOM,
+                                 AudioMixerFOABus::NUM_FRAMES);
+    ++stats.foaRenders;
+}
+
+void AudioMixerSlave::encodeFOAZone(AudioMixerFOABus::Zone& zone) {
+    auto& foaBus = _sharedData.foaBus;
+    const auto& sources = foaBus.getSources();
+    float farDistance = foaBus.getFarDistance();
+
+    zone.sources.clear();
+    zone.sourceIndices.clear();
+    memset(zone.avatarScene, 0, sizeof(zone.avatarScene));
+    memset(zone.injectorScene, 0, sizeof(zone.injectorScene));
+
+    for (int sourceIndex = 0; sourceIndex < (int)sources.size(); ++sourceIndex) {
+        const auto& source = sources[sourceIndex];
+
+        glm::vec3 relativePosition = source.stream->getPosition() - zone.center;
+        float distance = glm::length(relativePosition);
+        if (distance <= farDistance) {
+            continue;
+        }
+
+        // gain at the zone's center, master gains and gain adjustments are applied per listener
+        float gain = computeGain(1.0f, 1.0f, zone.center, *source.stream, relativePosition, distance);
+        if (gain == 0.0f) {
+            continue;
+        }
+
+        // ambiX channel order (W, Y, Z, X) and SN3D normalization, in Z-up (Ambisonic) coordinates
+        glm::vec3 direction = relativePosition / distance;
+        AudioMixerFOABus::ZoneSource zoneSource;
+        zoneSource.sourceIndex = sourceIndex;
+        zoneSource.isInjector = source.stream->getType() == PositionalAudioStream::Injector;
+        zoneSource.coefficients[0] = gain;
+        zoneSource.coefficients[1] = gain * -direction.x;
+        zoneSource.coefficients[2] = gain * direction.y;
+        zoneSource.coefficients[3] = gain * -direction.z;
+
+        auto scene = zoneSource.isInjector ? zone.injectorScene : zone.avatarScene;
+        for (int channel = 0; channel < AudioMixerFOABus::NUM_CHANNELS; ++channel) {
+            float coefficient = zoneSource.coefficients[channel];
+            for (int i = 0; i < AudioMixerFOABus::NUM_FRAMES; ++i) {
+                scene[channel][i] += coefficient * source.samples[i];
+            }
+        }
+
+        zone.sourceIndices[source.stream] = (int)zone.sources.size();
+        zone.sources.push_back(zoneSource);
+        ++stats.foaEncodes;
+    }
+}
+
+// bits per axis of a shared mix key, the remaining bits hold the yaw bucket
+static const int SHARED_MIX_KEY_AXIS_BITS = 18;
+static const int64_t SHARED_MIX_KEY_AXIS_BIAS = 1 << (SHARED_MIX_KEY_AXIS_BITS - 1);
+static const int64_t SHARED_MIX_KEY_AXIS_MASK = (1 << SHARED_MIX_KEY_AXIS_BITS) - 1;
+static const float MIN_SHARED_MIX_YAW_BUCKET = 1.0f * RADIANS_PER_DEGREE;
+
+uint64_t AudioMixerSlave::sharedMixKey(const AvatarAudioStream& listenerStream) const {
+    // listeners within tolerance of each other usually, but not always, share a key;
+    // candidates are checked against the actual tolerances in findSharedMix
+    glm::vec3 cell = glm::floor(listenerStream.getPosition() / AudioMixer::getSharedMixPositionTolerance());
+    uint64_t x = (uint64_t)(((int64_t)cell.x + SHARED_MIX_KEY_AXIS_BIAS) & SHARED_MIX_KEY_AXIS_MASK);
+    uint64_t y = (uint64_t)(((int64_t)cell.y + SHARED_MIX_KEY_AXIS_BIAS) & SHARED_MIX_KEY_AXIS_MASK);
+    uint64_t z = (uint64_t)(((int64_t)cell.z + SHARED_MIX_KEY_AXIS_BIAS) & SHARED_MIX_KEY_AXIS_MASK);
+
+    glm::vec3 front = listenerStream.getOrientation() * Vectors::FRONT;
+    float yawBucketSize = glm::max(AudioMixer::getSharedMixOrientationTolerance(), MIN_SHARED_MIX_YAW_BUCKET);
+    uint64_t yaw = (uint64_t)((atan2f(front.x, front.z) + PI) / yawBucketSize);
+
+    return (yaw << (3 * SHARED_MIX_KEY_AXIS_BITS)) | (x << (2 * SHARED_MIX_KEY_AXIS_BITS)) |
+        (y << SHARED_MIX_KEY_AXIS_BITS) | z;
+}
+
+std::shared_ptr<const AudioMixerSlave::SharedMix> AudioMixerSlave::findSharedMix(const AvatarAudioStream& listenerStream) const {
+    auto range = _sharedData.sharedMixes.equal_range(sharedMixKey(listenerStream));
+    for (auto it = range.first; it != range.second; ++it) {
+        const auto& sharedMix = it->second;
+
+        if (glm::distance(sharedMix->position, listenerStream.getPosition()) > AudioMixer::getSharedMixPositionTolerance()) {
+            continue;
+        }
+
+        float cosHalfAngle = glm::min(fabsf(glm::dot(sharedMix->orientation, listenerStream.getOrientation())), 1.0f);
+        if (2.0f * acosf(cosHalfAngle) > AudioMixer::getSharedMixOrientationTolerance()) {
+            continue;
+        }
+
+        if (sharedMix->streams == _mixStreams) {
+            return sharedMix;
+        }
+    }
+
+    return nullptr;
 }
 
-void AudioMixerSlave::addStream(AudioMixerClientData::MixableStream& mixableStream,
+void AudioMixerSlave::addStream(PositionalAudioStream& positionalStream,
+                                AudioHRTF& hrtf,
                                 AvatarAudioStream& listeningNodeStream,
                                 float masterAvatarGain,
                                 float masterInjectorGain,
                                 bool isSoloing) {
     ++stats.totalMixes;
 
-    auto streamToAdd = mixableStream.positionalStream;
+    auto streamToAdd = &positionalStream;
 
     // check if this is a server echo of a source back to itself
     bool isEcho = (streamToAdd == &listeningNodeStream);
@@ -506,8 +821,8 @@ void AudioMixerSlave::addStream(AudioMixerClientData::MixableStream& mixableStre
     float distance = glm::max(glm::length(relativePosition), EPSILON);
     float gain = isEcho ? 1.0f
                         : (isSoloing ? masterAvatarGain
-                                     : computeGain(masterAvatarGain, masterInjectorGain, listeningNodeStream, *streamToAdd,
-                                                   relativePosition, distance));
+                                     : computeGain(masterAvatarGain, masterInjectorGain, listeningNodeStream.getPosition(),
+                                                   *streamToAdd, relativePosition, distance));
     float azimuth = isEcho ? 0.0f : computeAzimuth(listeningNodeStream, listeningNodeStream, relativePosition);
 
     const int HRTF_DATASET_INDEX = 1;
@@ -536,7 +851,7 @@ void AudioMixerSlave::addStream(AudioMixerClientData::MixableStream& mixableStre
             // (this is not done for stereo streams since they do not go through the HRTF)
             if (!streamToAdd->isStereo() && !isEcho) {
                 static int16_t silentMonoBlock[AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL] = {};
-                mixableStream.hrtf->render(silentMonoBlock, _mixSamples, HRTF_DATASET_INDEX, azimuth, distance, gain,
+                hrtf.render(silentMonoBlock, _mixSamples, HRTF_DATASET_INDEX, azimuth, distance, gain,
                                            AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
 
                 ++stats.hrtfRenders;
@@ -554,7 +869,7 @@ void AudioMixerSlave::addStream(AudioMixerClientData::MixableStream& mixableStre
         streamPopOutput.readSamples(_bufferSamples, AudioConstants::NETWORK_FRAME_SAMPLES_STEREO);
 
         // stereo sources are not passed through HRTF
-        mixableStream.hrtf->mixStereo(_bufferSamples, _mixSamples, gain, AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+        hrtf.mixStereo(_bufferSamples, _mixSamples, gain, AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
 
         ++stats.manualStereoMixes;
     } else if (isEcho) {
@@ -562,24 +877,25 @@ void AudioMixerSlave::addStream(AudioMixerClientData::MixableStream& mixableStre
         streamPopOutput.readSamples(_bufferSamples, AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
 
         // echo sources are not passed through HRTF
-        mixableStream.hrtf->mixMono(_bufferSamples, _mixSamples, gain, AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+        hrtf.mixMono(_bufferSamples, _mixSamples, gain, AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
 
         ++stats.manualEchoMixes;
     } else {
 
         streamPopOutput.readSamples(_bufferSamples, AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
 
-        mixableStream.hrtf->render(_bufferSamples, _mixSamples, HRTF_DATASET_INDEX, azimuth, distance, gain,
+        hrtf.render(_bufferSamples, _mixSamples, HRTF_DATASET_INDEX, azimuth, distance, gain,
                                    AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
         ++stats.hrtfRenders;
     }
 }
 
-void AudioMixerSlave::updateHRTFParameters(AudioMixerClientData::MixableStream& mixableStream,
+void AudioMixerSlave::updateHRTFParameters(PositionalAudioStream& positionalStream,
+                                           AudioHRTF& hrtf,
                                            AvatarAudioStream& listeningNodeStream,
                                            float masterAvatarGain,
                                            float masterInjectorGain) {
-    auto streamToAdd = mixableStream.positionalStream;
+    auto streamToAdd = &positionalStream;
 
     // check if this is a server echo of a source back to itself
     bool isEcho = (streamToAdd == &listeningNodeStream);
@@ -587,11 +903,11 @@ void AudioMixerSlave::updateHRTFParameters(AudioMixerClientData::MixableStream&
     glm::vec3 relativePosition = streamToAdd->getPosition() - listeningNodeStream.getPosition();
 
     float distance = glm::max(glm::length(relativePosition), EPSILON);
-    float gain = isEcho ? 1.0f : computeGain(masterAvatarGain, masterInjectorGain, listeningNodeStream, *streamToAdd, 
-                                             relativePosition, distance);
+    float gain = isEcho ? 1.0f : computeGain(masterAvatarGain, masterInjectorGain, listeningNodeStream.getPosition(),
+                                             *streamToAdd, relativePosition, distance);
     float azimuth = isEcho ? 0.0f : computeAzimuth(listeningNodeStream, listeningNodeStream, relativePosition);
 
-    mixableStream.hrtf->setParameterHistory(azimuth, distance, gain);
+    hrtf.setParameterHistory(azimuth, distance, gain);
 
     ++stats.hrtfUpdates;
 }
@@ -728,7 +1044,7 @@ float approximateGain(const AvatarAudioStream& listeningNodeStream, const Positi
 
 float computeGain(float masterAvatarGain,
                   float masterInjectorGain,
-                  const AvatarAudioStream& listeningNodeStream,
+                  const glm::vec3& listenerPosition,
                   const PositionalAudioStream& streamToAdd,
                   const glm::vec3& relativePosition,
                   float distance) {
@@ -765,7 +1081,7 @@ float computeGain(float masterAvatarGain,
     float attenuationPerDoublingInDistance = AudioMixer::getAttenuationPerDoublingInDistance();
     for (const auto& settings : zoneSettings) {
         if (audioZones[settings.source].area.contains(streamToAdd.getPosition()) &&
-            audioZones[settings.listener].area.contains(listeningNodeStream.getPosition())) {
+            audioZones[settings.listener].area.contains(listenerPosition)) {
             attenuationPerDoublingInDistance = settings.coefficient;
             break;
         }
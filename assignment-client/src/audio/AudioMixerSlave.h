@@ -12,8 +12,15 @@
 #ifndef hifi_AudioMixerSlave_h
 #define hifi_AudioMixerSlave_h
 
+#include <memory>
+#include <vector>
+
+#include <tbb/concurrent_unordered_map.h>
 #include <tbb/concurrent_vector.h>
 
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
 #include <AABox.h>
 #include <AudioHRTF.h>
 #include <AudioRingBuffer.h>
@@ -23,6 +30,7 @@
 #include <PositionalAudioStream.h>
 
 #include "AudioMixerClientData.h"
+#include "AudioMixerFOABus.h"
 #include "AudioMixerStats.h"
 
 class AvatarAudioStream;
@@ -31,11 +39,41 @@ class AudioHRTF;
 class AudioMixerSlave {
 public:
     using ConstIter = NodeList::const_iterator;
-    
+
+    // a stream as heard by a listener, two listeners with the same set hear the same mix (from the same spot)
+    struct SharedMixStream {
+        Node::LocalID nodeLocalID;
+        StreamID streamID;
+        float masterAvatarGain;
+        float masterInjectorGain;
+        float gainAdjustment;
+
+        bool operator==(const SharedMixStream& other) const {
+            return nodeLocalID == other.nodeLocalID && streamID == other.streamID &&
+                masterAvatarGain == other.masterAvatarGain && masterInjectorGain == other.masterInjectorGain &&
+                gainAdjustment == other.gainAdjustment;
+        }
+    };
+
+    // a finished mix (and, for stateless codecs, its encode) that co-located listeners can reuse this frame
+    struct SharedMix {
+        glm::vec3 position;
+        glm::quat orientation;
+        std::vector<SharedMixStream> streams;
+        bool hasAudio { false };
+        float mixSamples[AudioConstants::NETWORK_FRAME_SAMPLES_STEREO]; // before the limiter
+        int16_t samples[AudioConstants::NETWORK_FRAME_SAMPLES_STEREO];
+        QString codecName;
+        QByteArray encodedBuffer;
+    };
+    using SharedMixes = tbb::concurrent_unordered_multimap<uint64_t, std::shared_ptr<const SharedMix>>;
+
     struct SharedData {
         AudioMixerClientData::ConcurrentAddedStreams addedStreams;
         std::vector<Node::LocalID> removedNodes;
         std::vector<NodeIDStreamID> removedStreams;
+        SharedMixes sharedMixes; // cleared before every round of mixing
+        AudioMixerFOABus foaBus;
     };
 
     AudioMixerSlave(SharedData& sharedData) : _sharedData(sharedData) {};
@@ -50,17 +88,34 @@ public:
     // returns true if a mixed packet was sent to the node
     void mix(const SharedNodePointer& node);
 
+    // send any packets batched by configureMix (call once the round of mixing is finished)
+    void flushSends();
+
     AudioMixerStats stats;
 
 private:
+    // a stream to add to the listener's mix, once all of the listener's streams have been sorted
+    struct PendingStream {
+        PositionalAudioStream* positionalStream;
+        AudioHRTF* hrtf;
+        NodeIDStreamID nodeStreamID;
+        float masterAvatarGain;
+        float masterInjectorGain;
+    };
+
     // create mix, returns true if mix has audio
     bool prepareMix(const SharedNodePointer& listener);
-    void addStream(AudioMixerClientData::MixableStream& mixableStream,
+    void queueStream(AudioMixerClientData::MixableStream& mixableStream, float masterAvatarGain, float masterInjectorGain);
+    void addPendingStreams(AudioMixerClientData& listenerData, AvatarAudioStream& listeningNodeStream, bool isSoloing);
+    void encodeFOAZone(AudioMixerFOABus::Zone& zone);
+    void addStream(PositionalAudioStream& positionalStream,
+                   AudioHRTF& hrtf,
                    AvatarAudioStream& listeningNodeStream,
                    float masterAvatarGain,
                    float masterInjectorGain,
                    bool isSoloing);
-    void updateHRTFParameters(AudioMixerClientData::MixableStream& mixableStream,
+    void updateHRTFParameters(PositionalAudioStream& positionalStream,
+                              AudioHRTF& hrtf,
                               AvatarAudioStream& listeningNodeStream,
                               float masterAvatarGain,
                               float masterInjectorGain);
@@ -68,15 +123,31 @@ private:
 
     void addStreams(Node& listener, AudioMixerClientData& listenerData);
 
+    // shared mixes
+    uint64_t sharedMixKey(const AvatarAudioStream& listenerStream) const;
+    std::shared_ptr<const SharedMix> findSharedMix(const AvatarAudioStream& listenerStream) const;
+
     // mixing buffers
     float _mixSamples[AudioConstants::NETWORK_FRAME_SAMPLES_STEREO];
     int16_t _bufferSamples[AudioConstants::NETWORK_FRAME_SAMPLES_STEREO];
+    std::vector<PendingStream> _pendingStreams;
+
+    // FOA bus buffers
+    std::vector<float> _foaWeights;
+    float _foaScene[AudioMixerFOABus::NUM_CHANNELS][AudioMixerFOABus::NUM_FRAMES];
+    int16_t _foaSamples[AudioConstants::NETWORK_FRAME_SAMPLES_AMBISONIC];
+
+    // shared mix state for the current listener
+    std::vector<SharedMixStream> _mixStreams;
+    std::shared_ptr<const SharedMix> _reusedMix;
+    std::shared_ptr<SharedMix> _publishedMix;
 
     // frame state
     ConstIter _begin;
     ConstIter _end;
     unsigned int _frame { 0 };
     int _numToRetain { -1 };
+    bool _isBatchingSends { false };
 
     SharedData& _sharedData;
 };
@@ -14,54 +14,14 @@
 #include <assert.h>
 #include <algorithm>
 
-void AudioMixerSlaveThread::run() {
-    while (true) {
-        wait();
-
-        // iterate over all available nodes
-        SharedNodePointer node;
-        while (try_pop(node)) {
-            (this->*_function)(node);
-        }
-
-        bool stopping = _stop;
-        notify(stopping);
-        if (stopping) {
-            return;
-        }
-    }
-}
-
-void AudioMixerSlaveThread::wait() {
-    {
-        Lock lock(_pool._mutex);
-        _pool._slaveCondition.wait(lock, [&] {
-            assert(_pool._numStarted <= _pool._numThreads);
-            return _pool._numStarted != _pool._numThreads;
-        });
-        ++_pool._numStarted;
-    }
-
-    if (_pool._configure) {
-        _pool._configure(*this);
-    }
-    _function = _pool._function;
-}
-
-void AudioMixerSlaveThread::notify(bool stopping) {
-    {
-        Lock lock(_pool._mutex);
-        assert(_pool._numFinished < _pool._numThreads);
-        ++_pool._numFinished;
-        if (stopping) {
-            ++_pool._numStopped;
-        }
-    }
-    _pool._poolCondition.notify_one();
-}
-
-bool AudioMixerSlaveThread::try_pop(SharedNodePointer& node) {
-    return _pool._queue.try_pop(node);
+// nodes are handed to slaves a few at a time, so that slaves which finish early can steal the rest
+static const size_t NODES_PER_CHUNK = 4;
+
+AudioMixerSlavePool::AudioMixerSlavePool(AudioMixerSlave::SharedData& sharedData, int numThreads) :
+    _scheduler(DependencyManager::get<WorkStealingScheduler>()),
+    _workerSharedData(sharedData)
+{
+    setNumThreads(numThreads);
 }
 
 void AudioMixerSlavePool::processPackets(ConstIter begin, ConstIter end) {
@@ -73,38 +33,31 @@ void AudioMixerSlavePool::processPackets(ConstIter begin, ConstIter end) {
 void AudioMixerSlavePool::mix(ConstIter begin, ConstIter end, unsigned int frame, int numToRetain) {
     _function = &AudioMixerSlave::mix;
     _configure = [=](AudioMixerSlave& slave) {
-        slave.configureMix(_begin, _end, frame, numToRetain);
+        slave.configureMix(begin, end, frame, numToRetain);
     };
 
     run(begin, end);
 }
 
 void AudioMixerSlavePool::run(ConstIter begin, ConstIter end) {
-    _begin = begin;
-    _end = end;
-
-    // fill the queue
-    std::for_each(_begin, _end, [&](const SharedNodePointer& node) {
-        _queue.push(node);
-    });
-
-    {
-        Lock lock(_mutex);
-
-        // run
-        _numStarted = _numFinished = 0;
-        _slaveCondition.notify_all();
-
-        // wait
-        _poolCondition.wait(lock, [&] {
-            assert(_numFinished <= _numThreads);
-            return _numFinished == _numThreads;
+    WorkStealingScheduler::Job job;
+    job.numItems = std::distance(begin, end);
+    job.chunkSize = NODES_PER_CHUNK;
+    job.maxParticipants = _numThreads;
+    job.begin = [&](int participant) {
+        _configure(*_slaves[participant]);
+    };
+    job.process = [&](int participant, size_t first, size_t last) {
+        AudioMixerSlave& slave = *_slaves[participant];
+        std::for_each(begin + first, begin + last, [&](const SharedNodePointer& node) {
+            (slave.*_function)(node);
         });
+    };
+    job.end = [&](int participant) {
+        _slaves[participant]->flushSends();
+    };
 
-        assert(_numStarted == _numThreads);
-    }
-
-    assert(_queue.empty());
+    _jobStats.accumulate(_scheduler->run(job));
 }
 
 void AudioMixerSlavePool::each(std::function<void(AudioMixerSlave& slave)> functor) {
@@ -113,29 +66,10 @@ void AudioMixerSlavePool::each(std::function<void(AudioMixerSlave& slave)> funct
     }
 }
 
-#ifdef DEBUG_EVENT_QUEUE
-void AudioMixerSlavePool::queueStats(QJsonObject& stats) {
-    unsigned i = 0;
-    for (auto& slave : _slaves) {
-        int queueSize = ::hifi::qt::getEventQueueSize(slave.get());
-        QString queueName = QString("audio_thread_event_queue_%1").arg(i);
-        stats[queueName] = queueSize;
-
-        i++;
-    }
-}
-#endif // DEBUG_EVENT_QUEUE
-
 void AudioMixerSlavePool::setNumThreads(int numThreads) {
     // clamp to allowed size
     {
-        int maxThreads = QThread::idealThreadCount();
-        if (maxThreads == -1) {
-            // idealThreadCount returns -1 if cores cannot be detected
-            static const int MAX_THREADS_IF_UNKNOWN = 4;
-            maxThreads = MAX_THREADS_IF_UNKNOWN;
-        }
-
+        int maxThreads = _scheduler->getMaxParticipants();
         int clampedThreads = std::min(std::max(1, numThreads), maxThreads);
         if (clampedThreads != numThreads) {
             qWarning("%s: clamped to %d (was %d)", __FUNCTION__, clampedThreads, numThreads);
@@ -143,57 +77,12 @@ void AudioMixerSlavePool::setNumThreads(int numThreads) {
         }
     }
 
-    resize(numThreads);
-}
-
-void AudioMixerSlavePool::resize(int numThreads) {
-    assert(_numThreads == (int)_slaves.size());
-
     qDebug("%s: set %d threads (was %d)", __FUNCTION__, numThreads, _numThreads);
 
-    Lock lock(_mutex);
-
-    if (numThreads > _numThreads) {
-        // start new slaves
-        for (int i = 0; i < numThreads - _numThreads; ++i) {
-            auto slave = new AudioMixerSlaveThread(*this, _workerSharedData);
-            slave->start();
-            _slaves.emplace_back(slave);
-        }
-    } else if (numThreads < _numThreads) {
-        auto extraBegin = _slaves.begin() + numThreads;
-
-        // mark slaves to stop...
-        auto slave = extraBegin;
-        while (slave != _slaves.end()) {
-            (*slave)->_stop = true;
-            ++slave;
-        }
-
-        // ...cycle them until they do stop...
-        _numStopped = 0;
-        while (_numStopped != (_numThreads - numThreads)) {
-            _numStarted = _numFinished = _numStopped;
-            _slaveCondition.notify_all();
-            _poolCondition.wait(lock, [&] {
-                assert(_numFinished <= _numThreads);
-                return _numFinished == _numThreads;
-            });
-        }
-
-        // ...wait for threads to finish...
-        slave = extraBegin;
-        while (slave != _slaves.end()) {
-            QThread* thread = reinterpret_cast<QThread*>(slave->get());
-            static const int MAX_THREAD_WAIT_TIME = 10;
-            thread->wait(MAX_THREAD_WAIT_TIME);
-            ++slave;
-        }
-
-        // ...and erase them
-        _slaves.erase(extraBegin, _slaves.end());
+    // slaves keep their stats and state between frames, so only add or remove what changed
+    while ((int)_slaves.size() < numThreads) {
+        _slaves.emplace_back(new AudioMixerSlave(_workerSharedData));
     }
-
-    _numThreads = _numStarted = _numFinished = numThreads;
-    assert(_numThreads == (int)_slaves.size());
+    _slaves.resize(numThreads);
+    _numThreads = numThreads;
 }
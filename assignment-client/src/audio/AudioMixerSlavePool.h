@@ -12,56 +12,23 @@
 #ifndef hifi_AudioMixerSlavePool_h
 #define hifi_AudioMixerSlavePool_h
 
-#include <condition_variable>
-#include <mutex>
+#include <functional>
+#include <memory>
 #include <vector>
 
 #include <QThread>
-#include <shared/QtHelpers.h>
-#include <TBBHelpers.h>
+#include <shared/WorkStealingScheduler.h>
 
 #include "AudioMixerSlave.h"
 
-class AudioMixerSlavePool;
-
-class AudioMixerSlaveThread : public QThread, public AudioMixerSlave {
-    Q_OBJECT
-    using ConstIter = NodeList::const_iterator;
-    using Mutex = std::mutex;
-    using Lock = std::unique_lock<Mutex>;
-
-public:
-    AudioMixerSlaveThread(AudioMixerSlavePool& pool, AudioMixerSlave::SharedData& sharedData)
-        : AudioMixerSlave(sharedData), _pool(pool) {}
-
-    void run() override final;
-
-private:
-    friend class AudioMixerSlavePool;
-
-    void wait();
-    void notify(bool stopping);
-    bool try_pop(SharedNodePointer& node);
-
-    AudioMixerSlavePool& _pool;
-    void (AudioMixerSlave::*_function)(const SharedNodePointer& node) { nullptr };
-    bool _stop { false };
-};
-
 // Slave pool for audio mixers
+//   Jobs run on the process' WorkStealingScheduler, with one slave per participant.
 //   AudioMixerSlavePool is not thread-safe! It should be instantiated and used from a single thread.
 class AudioMixerSlavePool {
-    using Queue = tbb::concurrent_queue<SharedNodePointer>;
-    using Mutex = std::mutex;
-    using Lock = std::unique_lock<Mutex>;
-    using ConditionVariable = std::condition_variable;
-
 public:
     using ConstIter = NodeList::const_iterator;
 
-    AudioMixerSlavePool(AudioMixerSlave::SharedData& sharedData, int numThreads = QThread::idealThreadCount())
-        : _workerSharedData(sharedData) { setNumThreads(numThreads); }
-    ~AudioMixerSlavePool() { resize(0); }
+    AudioMixerSlavePool(AudioMixerSlave::SharedData& sharedData, int numThreads = QThread::idealThreadCount());
 
     // process packets on slave threads
     void processPackets(ConstIter begin, ConstIter end);
@@ -72,38 +39,24 @@ public:
     // iterate over all slaves
     void each(std::function<void(AudioMixerSlave& slave)> functor);
 
-#ifdef DEBUG_EVENT_QUEUE
-    void queueStats(QJsonObject& stats);
-#endif
-
     void setNumThreads(int numThreads);
     int numThreads() { return _numThreads; }
 
+    // scheduler timing of the jobs run since the last reset
+    const WorkStealingScheduler::JobStats& getJobStats() const { return _jobStats; }
+    void resetJobStats() { _jobStats = WorkStealingScheduler::JobStats(); }
+
 private:
     void run(ConstIter begin, ConstIter end);
-    void resize(int numThreads);
-
-    std::vector<std::unique_ptr<AudioMixerSlaveThread>> _slaves;
 
-    friend void AudioMixerSlaveThread::wait();
-    friend void AudioMixerSlaveThread::notify(bool stopping);
-    friend bool AudioMixerSlaveThread::try_pop(SharedNodePointer& node);
+    QSharedPointer<WorkStealingScheduler> _scheduler;
+    std::vector<std::unique_ptr<AudioMixerSlave>> _slaves;
 
-    // synchronization state
-    Mutex _mutex;
-    ConditionVariable _slaveCondition;
-    ConditionVariable _poolCondition;
+    // job state
     void (AudioMixerSlave::*_function)(const SharedNodePointer& node);
     std::function<void(AudioMixerSlave&)> _configure;
     int _numThreads { 0 };
-    int _numStarted { 0 }; // guarded by _mutex
-    int _numFinished { 0 }; // guarded by _mutex
-    int _numStopped { 0 }; // guarded by _mutex
-
-    // frame state
-    Queue _queue;
-    ConstIter _begin;
-    ConstIter _end;
+    WorkStealingScheduler::JobStats _jobStats;
 
     AudioMixerSlave::SharedData& _workerSharedData;
 };
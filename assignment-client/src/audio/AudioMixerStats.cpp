@@ -36,6 +36,19 @@ void AudioMixerStats::reset() {
     inactive = 0;
     active = 0;
 
+    sendBatches = 0;
+    sendBatchDatagrams = 0;
+    sendBatchSyscalls = 0;
+    sendBatchSegmentedDatagrams = 0;
+
+    uniqueMixes = 0;
+    sharedMixListeners = 0;
+    sharedEncodes = 0;
+
+    foaEncodes = 0;
+    foaStreams = 0;
+    foaRenders = 0;
+
 #ifdef HIFI_AUDIO_MIXER_DEBUG
     mixTime = 0;
 #endif
@@ -66,6 +79,19 @@ void AudioMixerStats::accumulate(const AudioMixerStats& otherStats) {
     inactive += otherStats.inactive;
     active += otherStats.active;
 
+    sendBatches += otherStats.sendBatches;
+    sendBatchDatagrams += otherStats.sendBatchDatagrams;
+    sendBatchSyscalls += otherStats.sendBatchSyscalls;
+    sendBatchSegmentedDatagrams += otherStats.sendBatchSegmentedDatagrams;
+
+    uniqueMixes += otherStats.uniqueMixes;
+    sharedMixListeners += otherStats.sharedMixListeners;
+    sharedEncodes += otherStats.sharedEncodes;
+
+    foaEncodes += otherStats.foaEncodes;
+    foaStreams += otherStats.foaStreams;
+    foaRenders += otherStats.foaRenders;
+
 #ifdef HIFI_AUDIO_MIXER_DEBUG
     mixTime += otherStats.mixTime;
 #endif
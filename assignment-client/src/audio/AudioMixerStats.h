@@ -41,6 +41,19 @@ struct AudioMixerStats {
     int inactive { 0 };
     int active { 0 };
 
+    int sendBatches { 0 };
+    int sendBatchDatagrams { 0 };
+    int sendBatchSyscalls { 0 };
+    int sendBatchSegmentedDatagrams { 0 };
+
+    int uniqueMixes { 0 };
+    int sharedMixListeners { 0 };
+    int sharedEncodes { 0 };
+
+    int foaEncodes { 0 };
+    int foaStreams { 0 };
+    int foaRenders { 0 };
+
 #ifdef HIFI_AUDIO_MIXER_DEBUG
     uint64_t mixTime { 0 };
 #endif
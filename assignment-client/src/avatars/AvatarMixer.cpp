@@ -320,8 +320,12 @@ void AvatarMixer::start() {
         // this is where we need to put the real work...
         {
             auto start = usecTimestampNow();
+            _slaveSharedData.broadcastFrame = frame;
             nodeList->nestedEach([&](NodeList::const_iterator cbegin, NodeList::const_iterator cend) {
                 auto start = usecTimestampNow();
+                _slaveSharedData.spatialIndex.build(cbegin, cend);
+                _spatialIndexBuildElapsedTime += (usecTimestampNow() - start);
+
                 _slavePool.broadcastAvatarData(cbegin, cend, _lastFrameTimestamp, _maxKbpsPerNode, _throttlingRatio);
                 auto end = usecTimestampNow();
                 _broadcastAvatarDataInner += (end - start);
@@ -756,12 +760,19 @@ void AvatarMixer::sendStatsPacket() {
     statsObject["trailing_mix_ratio"] = _trailingMixRatio;
     statsObject["throttling_ratio"] = _throttlingRatio;
 
-#ifdef DEBUG_EVENT_QUEUE
-    QJsonObject qtStats;
-
-    _slavePool.queueStats(qtStats);
-    statsObject["avatar_thread_event_queue"] = qtStats;
-#endif
+    // scheduler stats
+    QJsonObject schedulerStats;
+    const auto& jobStats = _slavePool.getJobStats();
+    int numJobs = std::max(jobStats.numJobs, 1);
+    schedulerStats["avg_jobs_per_frame"] = (float)jobStats.numJobs / (float)_numTightLoopFrames;
+    schedulerStats["avg_participants_per_job"] = (float)jobStats.numParticipants / (float)numJobs;
+    schedulerStats["avg_steals_per_job"] = (float)jobStats.numSteals / (float)numJobs;
+    schedulerStats["avg_dispatch_usecs"] = (float)jobStats.dispatchUsecs / (float)numJobs;
+    schedulerStats["avg_barrier_usecs"] = (float)jobStats.barrierUsecs / (float)numJobs;
+    schedulerStats["avg_job_usecs"] = (float)jobStats.jobUsecs / (float)numJobs;
+    schedulerStats["pinned_threads"] = DependencyManager::get<WorkStealingScheduler>()->isThreadPinningEnabled();
+    statsObject["scheduler_stats"] = schedulerStats;
+    _slavePool.resetJobStats();
 
     // this things all occur on the frequency of the tight loop
     int tightLoopFrames = _numTightLoopFrames;
@@ -820,6 +831,7 @@ void AvatarMixer::sendStatsPacket() {
         slave.harvestStats(stats);
         aggregateStats += stats;
     });
+    aggregateStats.spatialIndexBuildElapsedTime = _spatialIndexBuildElapsedTime;
 
     QJsonObject slavesAggregatObject;
 
@@ -838,6 +850,9 @@ void AvatarMixer::sendStatsPacket() {
     slavesAggregatObject["sent_5_averageTraitsBytes"] = TIGHT_LOOP_STAT(aggregateStats.numTraitsBytesSent);
     slavesAggregatObject["sent_6_averageIdentityBytes"] = TIGHT_LOOP_STAT(aggregateStats.numIdentityBytesSent);
     slavesAggregatObject["sent_7_averageHeroAvatars"] = TIGHT_LOOP_STAT(aggregateStats.numHeroesIncluded);
+    slavesAggregatObject["sent_8_encodeCacheHits"] = TIGHT_LOOP_STAT(aggregateStats.numEncodeCacheHits);
+    slavesAggregatObject["sent_9_encodeCacheMisses"] = TIGHT_LOOP_STAT(aggregateStats.numEncodeCacheMisses);
+    slavesAggregatObject["sent_9_encodeCacheWasted"] = TIGHT_LOOP_STAT(aggregateStats.numEncodeCacheWasted);
 
     slavesAggregatObject["timing_1_processIncomingPackets"] = TIGHT_LOOP_STAT_UINT64(aggregateStats.processIncomingPacketsElapsedTime);
     slavesAggregatObject["timing_2_ignoreCalculation"] = TIGHT_LOOP_STAT_UINT64(aggregateStats.ignoreCalculationElapsedTime);
@@ -846,6 +861,25 @@ void AvatarMixer::sendStatsPacket() {
     slavesAggregatObject["timing_5_packetSending"] = TIGHT_LOOP_STAT_UINT64(aggregateStats.packetSendingElapsedTime);
     slavesAggregatObject["timing_6_jobElapsedTime"] = TIGHT_LOOP_STAT_UINT64(aggregateStats.jobElapsedTime);
 
+    if (_slaveSharedData.spatialIndex.isEnabled()) {
+        float averageSpatialIndexCandidates = averageNodes ? aggregateStats.numSpatialIndexCandidates / averageNodes : 0.0f;
+        slavesAggregatObject["spatial_1_averageCandidates"] = TIGHT_LOOP_STAT(averageSpatialIndexCandidates);
+        slavesAggregatObject["spatial_2_indexBuild"] = TIGHT_LOOP_STAT_UINT64(aggregateStats.spatialIndexBuildElapsedTime);
+        slavesAggregatObject["spatial_3_indexQuery"] = TIGHT_LOOP_STAT_UINT64(aggregateStats.spatialIndexQueryElapsedTime);
+    }
+
+    if (_slaveSharedData.batchSends) {
+        float averageDatagramsPerSyscall = aggregateStats.numSendBatchSyscalls ?
+            (float)aggregateStats.numSendBatchDatagrams / (float)aggregateStats.numSendBatchSyscalls : 0.0f;
+        float averageDatagramsPerBatch = aggregateStats.numSendBatches ?
+            (float)aggregateStats.numSendBatchDatagrams / (float)aggregateStats.numSendBatches : 0.0f;
+        slavesAggregatObject["send_batch_1_datagrams"] = TIGHT_LOOP_STAT(aggregateStats.numSendBatchDatagrams);
+        slavesAggregatObject["send_batch_2_syscalls"] = TIGHT_LOOP_STAT(aggregateStats.numSendBatchSyscalls);
+        slavesAggregatObject["send_batch_3_segmentedDatagrams"] = TIGHT_LOOP_STAT(aggregateStats.numSendBatchSegmentedDatagrams);
+        slavesAggregatObject["send_batch_4_averageDatagramsPerSyscall"] = averageDatagramsPerSyscall;
+        slavesAggregatObject["send_batch_5_averageDatagramsPerBatch"] = averageDatagramsPerBatch;
+    }
+
     statsObject["slaves_aggregate (per frame)"] = slavesAggregatObject;
 
     _handleViewFrustumPacketElapsedTime = 0;
@@ -909,6 +943,7 @@ void AvatarMixer::sendStatsPacket() {
     _broadcastAvatarDataLockWait = 0;
     _broadcastAvatarDataNodeTransform = 0;
     _broadcastAvatarDataNodeFunctor = 0;
+    _spatialIndexBuildElapsedTime = 0;
 
     _displayNameManagementElapsedTime = 0;
     _ignoreCalculationElapsedTime = 0;
@@ -1010,6 +1045,12 @@ void AvatarMixer::parseDomainServerSettings(const QJsonObject& domainSettings) {
         qCDebug(avatars) << "Avatar mixer will automatically determine number of threads to use. Using:" << _slavePool.numThreads() << "threads.";
     }
 
+    const QString PIN_THREADS = "pin_threads";
+    if (avatarMixerGroupObject[PIN_THREADS].toBool()) {
+        // the scheduler is shared with any other mixer in this process, so pinning is never turned back off here
+        DependencyManager::get<WorkStealingScheduler>()->setThreadPinning(true);
+    }
+
     {
         const QString CONNECTION_RATE = "connection_rate";
         auto nodeList = DependencyManager::get<NodeList>();
@@ -1029,6 +1070,25 @@ void AvatarMixer::parseDomainServerSettings(const QJsonObject& domainSettings) {
         }
     }
 
+    {   // Per-frame spatial index of avatars, so that listeners only consider nearby avatars every frame:
+        static const QString SPATIAL_INDEX_KEY = "spatial_index";
+        static const QString SPATIAL_INDEX_NEAR_RADIUS_KEY = "spatial_index_near_radius";
+        auto& spatialIndex = _slaveSharedData.spatialIndex;
+        spatialIndex.setEnabled(avatarMixerGroupObject[SPATIAL_INDEX_KEY].toBool(false));
+        if (avatarMixerGroupObject.contains(SPATIAL_INDEX_NEAR_RADIUS_KEY)) {
+            const float MIN_NEAR_RADIUS = 1.0f;
+            float nearRadius = float(avatarMixerGroupObject[SPATIAL_INDEX_NEAR_RADIUS_KEY].toDouble());
+            spatialIndex.setNearRadius(std::max(nearRadius, MIN_NEAR_RADIUS));
+        }
+        if (spatialIndex.isEnabled()) {
+            qCDebug(avatars) << "Avatar mixer spatial index enabled with a near radius of" << spatialIndex.getNearRadius() << "m";
+        }
+    }
+
+    static const QString BATCH_SENDS_KEY = "batch_sends";
+    _slaveSharedData.batchSends = avatarMixerGroupObject[BATCH_SENDS_KEY].toBool(false);
+    qCDebug(avatars) << "Avatar mixer batched sends" << (_slaveSharedData.batchSends ? "enabled" : "disabled");
+
     const QString AVATARS_SETTINGS_KEY = "avatars";
 
     static const QString MIN_HEIGHT_OPTION = "min_avatar_height";
@@ -1101,7 +1161,7 @@ void AvatarMixer::handleOctreePacket(QSharedPointer<ReceivedMessage> message, Sh
         const auto piggyBackedSizeWithHeader = message->getBytesLeftToRead();
         if (piggyBackedSizeWithHeader > 0) {
             // pull out the piggybacked packet and create a new QSharedPointer<NLPacket> for it
-            auto buffer = std::unique_ptr<char[]>(new char[piggyBackedSizeWithHeader]);
+            auto buffer = udt::PacketBuffer(new char[piggyBackedSizeWithHeader]);
             memcpy(buffer.get(), message->getRawMessage() + message->getPosition(), piggyBackedSizeWithHeader);
 
             auto newPacket = NLPacket::fromReceivedPacket(std::move(buffer), piggyBackedSizeWithHeader, message->getSenderSockAddr());
@@ -132,6 +132,7 @@ private:
     quint64 _broadcastAvatarDataLockWait { 0 };
     quint64 _broadcastAvatarDataNodeTransform { 0 };
     quint64 _broadcastAvatarDataNodeFunctor { 0 };
+    quint64 _spatialIndexBuildElapsedTime { 0 };
 
     quint64 _handleAdjustAvatarSortingElapsedTime { 0 };
     quint64 _handleViewFrustumPacketElapsedTime { 0 };
@@ -102,6 +102,7 @@ public:
 
     glm::vec3 getPosition() const { return _avatar ? _avatar->getClientGlobalPosition() : glm::vec3(0); }
     bool isRadiusIgnoring(const QUuid& other) const;
+    bool hasRadiusIgnoredOthers() const { return !_radiusIgnoredOthers.empty(); }
     void addToRadiusIgnoringSet(const QUuid& other);
     void removeFromRadiusIgnoringSet(const QUuid& other);
     void ignoreOther(SharedNodePointer self, SharedNodePointer other);
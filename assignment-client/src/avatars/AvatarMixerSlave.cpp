@@ -51,6 +51,25 @@ void AvatarMixerSlave::configureBroadcast(ConstIter begin, ConstIter end,
     _maxKbpsPerNode = maxKbpsPerNode;
     _throttlingRatio = throttlingRatio;
     _avatarHeroFraction = priorityReservedFraction;
+
+    if (_sharedData->batchSends) {
+        // avatar data packets sent from this thread are flushed together in flushSends
+        _isBatchingSends = DependencyManager::get<NodeList>()->beginSendBatch();
+    }
+}
+
+void AvatarMixerSlave::flushSends() {
+    if (!_isBatchingSends) {
+        return;
+    }
+
+    auto batchStats = DependencyManager::get<NodeList>()->endSendBatch();
+    _isBatchingSends = false;
+
+    _stats.numSendBatches++;
+    _stats.numSendBatchDatagrams += batchStats.numDatagrams;
+    _stats.numSendBatchSyscalls += batchStats.numSyscalls;
+    _stats.numSendBatchSegmentedDatagrams += batchStats.numSegmentedDatagrams;
 }
 
 void AvatarMixerSlave::harvestStats(AvatarMixerSlaveStats& stats) {
@@ -386,12 +405,22 @@ void AvatarMixerSlave::broadcastAvatarDataToAgent(const SharedNodePointer& node)
 
     avatarPriorityQueues[kNonhero].reserve(_end - _begin);
 
-    for (auto listedNode = _begin; listedNode != _end; ++listedNode) {
-        Node* otherNodeRaw = (*listedNode).data();
+    // whether the source avatar and this listener are inside one of their space bubbles
+    auto isInsideBubble = [&](const AvatarMixerClientData* sourceAvatarNodeData) {
+        // Don't bother with these checks if the other avatar has their bubble enabled and we're gettingAnyIgnored
+        if (destinationNodeData->isIgnoreRadiusEnabled() || (sourceAvatarNodeData->isIgnoreRadiusEnabled() && !getsAnyIgnored)) {
+            // Perform the collision check between the two bounding boxes
+            AABox sourceNodeBox = sourceAvatarNodeData->getAvatar().getDefaultBubbleBox();
+            return destinationNodeBox.touches(sourceNodeBox);
+        }
+        return false;
+    };
+
+    auto considerSourceAvatar = [&](const Node* otherNodeRaw) {
         if (otherNodeRaw->getType() != NodeType::Agent
             || !otherNodeRaw->getLinkedData()
             || otherNodeRaw == destinationNode) {
-            continue;
+            return;
         }
 
         auto sourceAvatarNode = otherNodeRaw;
@@ -417,14 +446,9 @@ void AvatarMixerSlave::broadcastAvatarDataToAgent(const SharedNodePointer& node)
             sendAvatar = false;
         } else {
             // Check to see if the space bubble is enabled
-            // Don't bother with these checks if the other avatar has their bubble enabled and we're gettingAnyIgnored
-            if (destinationNodeData->isIgnoreRadiusEnabled() || (sourceAvatarNodeData->isIgnoreRadiusEnabled() && !getsAnyIgnored)) {
-                // Perform the collision check between the two bounding boxes
-                AABox sourceNodeBox = sourceAvatarNodeData->getAvatar().getDefaultBubbleBox();
-                if (destinationNodeBox.touches(sourceNodeBox)) {
-                    destinationNodeData->ignoreOther(destinationNode, sourceAvatarNode);
-                    sendAvatar = getsAnyIgnored;
-                }
+            if (isInsideBubble(sourceAvatarNodeData)) {
+                destinationNodeData->ignoreOther(destinationNode, sourceAvatarNode);
+                sendAvatar = getsAnyIgnored;
             }
             // Not close enough to ignore
             if (sendAvatar) {
@@ -491,6 +515,45 @@ void AvatarMixerSlave::broadcastAvatarDataToAgent(const SharedNodePointer& node)
         }
 
         destinationNodeData->setPrevRequestsDomainListData(PALIsOpen);
+    };
+
+    // The spatial index only narrows the set of candidates when the PAL is closed (and wasn't just closed),
+    // since the PAL needs data about every avatar and closing it may require kill packets for any of them.
+    auto& spatialIndex = _sharedData->spatialIndex;
+    if (spatialIndex.isEnabled() && !PALIsOpen && !PALWasOpen) {
+        quint64 startSpatialQuery = usecTimestampNow();
+        _spatialCandidates.clear();
+        spatialIndex.query(cameraViews, destinationPosition, (uint32_t)destinationNode->getLocalID(), _spatialCandidates);
+        quint64 endSpatialQuery = usecTimestampNow();
+        _stats.spatialIndexQueryElapsedTime += (endSpatialQuery - startSpatialQuery);
+        _stats.numSpatialIndexCandidates += (int)_spatialCandidates.size();
+
+        for (const Node* candidate : _spatialCandidates) {
+            considerSourceAvatar(candidate);
+        }
+
+        // an avatar that left the bubble may be in a cell that was skipped this frame, it must still be un-ignored
+        if (destinationNodeData->hasRadiusIgnoredOthers()) {
+            quint64 startIgnoreCalculation = usecTimestampNow();
+            for (auto listedNode = _begin; listedNode != _end; ++listedNode) {
+                const Node* sourceAvatarNode = (*listedNode).data();
+                if (sourceAvatarNode->getType() != NodeType::Agent || !sourceAvatarNode->getLinkedData()
+                    || sourceAvatarNode == destinationNode
+                    || !destinationNodeData->isRadiusIgnoring(sourceAvatarNode->getUUID())) {
+                    continue;
+                }
+
+                auto sourceAvatarNodeData = reinterpret_cast<const AvatarMixerClientData*>(sourceAvatarNode->getLinkedData());
+                if (!isInsideBubble(sourceAvatarNodeData)) {
+                    destinationNodeData->removeFromRadiusIgnoringSet(sourceAvatarNode->getUUID());
+                }
+            }
+            _stats.ignoreCalculationElapsedTime += (usecTimestampNow() - startIgnoreCalculation);
+        }
+    } else {
+        for (auto listedNode = _begin; listedNode != _end; ++listedNode) {
+            considerSourceAvatar((*listedNode).data());
+        }
     }
 
     // loop through our sorted avatars and allocate our bandwidth to them accordingly
@@ -569,26 +632,70 @@ void AvatarMixerSlave::broadcastAvatarDataToAgent(const SharedNodePointer& node)
             AvatarDataPacket::SendStatus sendStatus;
             sendStatus.sendUUID = true;
 
-            do {
+            // Receiver-independent encodes are shared across listeners when they fit in the current packet,
+            // otherwise fall back to encoding for this receiver, which can split the data across packets.
+            // A miss isn't encoded when the avatar's last encode at this detail wouldn't have fit either.
+            bool usedCachedEncode = false;
+            if (MixerAvatar::isCacheableDetail(detail)) {
                 auto startSerialize = chrono::high_resolution_clock::now();
-                QByteArray bytes = sourceAvatar->toByteArray(detail, lastEncodeForOther, lastSentJointsForOther,
-                    sendStatus, dropFaceTracking, distanceAdjust, destinationPosition,
-                    &lastSentJointsForOther, avatarSpaceAvailable);
+                bool wasCached = false;
+                auto cachedEncode = sourceAvatar->getCachedEncode(detail, lastEncodeForOther,
+                    _sharedData->broadcastFrame, avatarSpaceAvailable, wasCached);
                 auto endSerialize = chrono::high_resolution_clock::now();
                 _stats.toByteArrayElapsedTime +=
                     (quint64)chrono::duration_cast<chrono::microseconds>(endSerialize - startSerialize).count();
 
-                avatarPacket->write(bytes);
-                avatarSpaceAvailable -= bytes.size();
-                numAvatarDataBytes += bytes.size();
-                if (!sendStatus || avatarSpaceAvailable < (int)AvatarDataPacket::MIN_BULK_PACKET_SIZE) {
-                    // Weren't able to fit everything.
-                    nodeList->sendPacket(std::move(avatarPacket), *destinationNode);
-                    ++numPacketsSent;
-                    avatarPacket = NLPacket::create(PacketType::BulkAvatarData);
-                    avatarSpaceAvailable = avatarPacketCapacity;
+                bool fits = !cachedEncode.bytes.isEmpty() && cachedEncode.bytes.size() <= avatarSpaceAvailable;
+                if (!fits && !wasCached && !cachedEncode.bytes.isEmpty()) {
+                    _stats.numEncodeCacheWasted++;
+                }
+
+                if (fits) {
+                    if (wasCached) {
+                        _stats.numEncodeCacheHits++;
+                    } else {
+                        _stats.numEncodeCacheMisses++;
+                    }
+                    usedCachedEncode = true;
+
+                    if (detail == AvatarData::SendAllData) {
+                        lastSentJointsForOther = cachedEncode.sentJoints;
+                    }
+
+                    avatarPacket->write(cachedEncode.bytes);
+                    avatarSpaceAvailable -= cachedEncode.bytes.size();
+                    numAvatarDataBytes += cachedEncode.bytes.size();
+                    if (avatarSpaceAvailable < (int)AvatarDataPacket::MIN_BULK_PACKET_SIZE) {
+                        nodeList->sendPacket(std::move(avatarPacket), *destinationNode);
+                        ++numPacketsSent;
+                        avatarPacket = NLPacket::create(PacketType::BulkAvatarData);
+                        avatarSpaceAvailable = avatarPacketCapacity;
+                    }
                 }
-            } while (!sendStatus);
+            }
+
+            if (!usedCachedEncode) {
+                do {
+                    auto startSerialize = chrono::high_resolution_clock::now();
+                    QByteArray bytes = sourceAvatar->toByteArray(detail, lastEncodeForOther, lastSentJointsForOther,
+                        sendStatus, dropFaceTracking, distanceAdjust, destinationPosition,
+                        &lastSentJointsForOther, avatarSpaceAvailable);
+                    auto endSerialize = chrono::high_resolution_clock::now();
+                    _stats.toByteArrayElapsedTime +=
+                        (quint64)chrono::duration_cast<chrono::microseconds>(endSerialize - startSerialize).count();
+
+                    avatarPacket->write(bytes);
+                    avatarSpaceAvailable -= bytes.size();
+                    numAvatarDataBytes += bytes.size();
+                    if (!sendStatus || avatarSpaceAvailable < (int)AvatarDataPacket::MIN_BULK_PACKET_SIZE) {
+                        // Weren't able to fit everything.
+                        nodeList->sendPacket(std::move(avatarPacket), *destinationNode);
+                        ++numPacketsSent;
+                        avatarPacket = NLPacket::create(PacketType::BulkAvatarData);
+                        avatarSpaceAvailable = avatarPacketCapacity;
+                    }
+                } while (!sendStatus);
+            }
 
             if (detail != AvatarData::NoData) {
                 _stats.numOthersIncluded++;
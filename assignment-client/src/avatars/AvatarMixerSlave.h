@@ -14,6 +14,8 @@
 
 #include <NodeList.h>
 
+#include "AvatarMixerSpatialIndex.h"
+
 class AvatarMixerClientData;
 
 class AvatarMixerSlaveStats {
@@ -40,6 +42,18 @@ public:
     quint64 toByteArrayElapsedTime { 0 };
     quint64 jobElapsedTime { 0 };
 
+    int numSpatialIndexCandidates { 0 };
+    int numEncodeCacheHits { 0 };
+    int numEncodeCacheMisses { 0 };
+    int numEncodeCacheWasted { 0 }; // misses encoded for a receiver that then had no room for them
+    quint64 spatialIndexBuildElapsedTime { 0 };
+    quint64 spatialIndexQueryElapsedTime { 0 };
+
+    int numSendBatches { 0 };
+    int numSendBatchDatagrams { 0 };
+    int numSendBatchSyscalls { 0 };
+    int numSendBatchSegmentedDatagrams { 0 };
+
     void reset() {
         // receiving job stats
         nodesProcessed = 0;
@@ -65,6 +79,18 @@ public:
         packetSendingElapsedTime = 0;
         toByteArrayElapsedTime = 0;
         jobElapsedTime = 0;
+
+        numSpatialIndexCandidates = 0;
+        numEncodeCacheHits = 0;
+        numEncodeCacheMisses = 0;
+        numEncodeCacheWasted = 0;
+        spatialIndexBuildElapsedTime = 0;
+        spatialIndexQueryElapsedTime = 0;
+
+        numSendBatches = 0;
+        numSendBatchDatagrams = 0;
+        numSendBatchSyscalls = 0;
+        numSendBatchSegmentedDatagrams = 0;
     }
 
     AvatarMixerSlaveStats& operator+=(const AvatarMixerSlaveStats& rhs) {
@@ -89,6 +115,18 @@ public:
         packetSendingElapsedTime += rhs.packetSendingElapsedTime;
         toByteArrayElapsedTime += rhs.toByteArrayElapsedTime;
         jobElapsedTime += rhs.jobElapsedTime;
+
+        numSpatialIndexCandidates += rhs.numSpatialIndexCandidates;
+        numEncodeCacheHits += rhs.numEncodeCacheHits;
+        numEncodeCacheMisses += rhs.numEncodeCacheMisses;
+        numEncodeCacheWasted += rhs.numEncodeCacheWasted;
+        spatialIndexBuildElapsedTime += rhs.spatialIndexBuildElapsedTime;
+        spatialIndexQueryElapsedTime += rhs.spatialIndexQueryElapsedTime;
+
+        numSendBatches += rhs.numSendBatches;
+        numSendBatchDatagrams += rhs.numSendBatchDatagrams;
+        numSendBatchSyscalls += rhs.numSendBatchSyscalls;
+        numSendBatchSegmentedDatagrams += rhs.numSendBatchSegmentedDatagrams;
         return *this;
     }
 };
@@ -100,6 +138,9 @@ struct SlaveSharedData {
     QStringList skeletonURLWhitelist;
     QUrl skeletonReplacementURL;
     EntityTreePointer entityTree;
+    AvatarMixerSpatialIndex spatialIndex;
+    uint32_t broadcastFrame { 0 }; // generation for the per-frame avatar encode caches
+    bool batchSends { false }; // flush each slave's broadcast packets together at the end of the frame
 };
 
 class AvatarMixerSlave {
@@ -116,6 +157,9 @@ public:
     void processIncomingPackets(const SharedNodePointer& node);
     void broadcastAvatarData(const SharedNodePointer& node);
 
+    // send any packets batched by configureBroadcast (call once the job is finished)
+    void flushSends();
+
     void harvestStats(AvatarMixerSlaveStats& stats);
 
 private:
@@ -142,6 +186,10 @@ private:
     float _maxKbpsPerNode { 0.0f };
     float _throttlingRatio { 0.0f };
     float _avatarHeroFraction { 0.4f };
+    bool _isBatchingSends { false };
+
+    // reused across listeners to avoid reallocating every frame
+    std::vector<const Node*> _spatialCandidates;
 
     AvatarMixerSlaveStats _stats;
     SlaveSharedData* _sharedData;
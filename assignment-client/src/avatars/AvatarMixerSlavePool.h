@@ -12,59 +12,25 @@
 #ifndef hifi_AvatarMixerSlavePool_h
 #define hifi_AvatarMixerSlavePool_h
 
-#include <condition_variable>
-#include <mutex>
+#include <functional>
+#include <memory>
 #include <vector>
 
 #include <QThread>
 
-#include <TBBHelpers.h>
 #include <NodeList.h>
-#include <shared/QtHelpers.h>
+#include <shared/WorkStealingScheduler.h>
 
 #include "AvatarMixerSlave.h"
 
-
-class AvatarMixerSlavePool;
-
-class AvatarMixerSlaveThread : public QThread, public AvatarMixerSlave {
-    Q_OBJECT
-    using ConstIter = NodeList::const_iterator;
-    using Mutex = std::mutex;
-    using Lock = std::unique_lock<Mutex>;
-
-public:
-    AvatarMixerSlaveThread(AvatarMixerSlavePool& pool, SlaveSharedData* slaveSharedData) :
-        AvatarMixerSlave(slaveSharedData), _pool(pool) {};
-
-    void run() override final;
-
-private:
-    friend class AvatarMixerSlavePool;
-
-    void wait();
-    void notify(bool stopping);
-    bool try_pop(SharedNodePointer& node);
-
-    AvatarMixerSlavePool& _pool;
-    void (AvatarMixerSlave::*_function)(const SharedNodePointer& node) { nullptr };
-    bool _stop { false };
-};
-
 // Slave pool for avatar mixers
+//   Jobs run on the process' WorkStealingScheduler, with one slave per participant.
 //   AvatarMixerSlavePool is not thread-safe! It should be instantiated and used from a single thread.
 class AvatarMixerSlavePool {
-    using Queue = tbb::concurrent_queue<SharedNodePointer>;
-    using Mutex = std::mutex;
-    using Lock = std::unique_lock<Mutex>;
-    using ConditionVariable = std::condition_variable;
-
 public:
     using ConstIter = NodeList::const_iterator;
 
-    AvatarMixerSlavePool(SlaveSharedData* slaveSharedData, int numThreads = QThread::idealThreadCount()) :
-        _slaveSharedData(slaveSharedData) { setNumThreads(numThreads); }
-    ~AvatarMixerSlavePool() { resize(0); }
+    AvatarMixerSlavePool(SlaveSharedData* slaveSharedData, int numThreads = QThread::idealThreadCount());
 
     // Jobs the slave pool can do...
     void processIncomingPackets(ConstIter begin, ConstIter end);
@@ -74,46 +40,31 @@ public:
     // iterate over all slaves
     void each(std::function<void(AvatarMixerSlave& slave)> functor);
 
-#ifdef DEBUG_EVENT_QUEUE
-    void queueStats(QJsonObject& stats);
-#endif
-
     void setNumThreads(int numThreads);
     int numThreads() const { return _numThreads; }
 
     void setPriorityReservedFraction(float fraction) { _priorityReservedFraction = fraction; }
     float getPriorityReservedFraction() const { return  _priorityReservedFraction; }
 
+    // scheduler timing of the jobs run since the last reset
+    const WorkStealingScheduler::JobStats& getJobStats() const { return _jobStats; }
+    void resetJobStats() { _jobStats = WorkStealingScheduler::JobStats(); }
+
 private:
     void run(ConstIter begin, ConstIter end);
-    void resize(int numThreads);
-
-    std::vector<std::unique_ptr<AvatarMixerSlaveThread>> _slaves;
 
-    friend void AvatarMixerSlaveThread::wait();
-    friend void AvatarMixerSlaveThread::notify(bool stopping);
-    friend bool AvatarMixerSlaveThread::try_pop(SharedNodePointer& node);
+    QSharedPointer<WorkStealingScheduler> _scheduler;
+    std::vector<std::unique_ptr<AvatarMixerSlave>> _slaves;
 
-    // synchronization state
-    Mutex _mutex;
-    ConditionVariable _slaveCondition;
-    ConditionVariable _poolCondition;
+    // job state
     void (AvatarMixerSlave::*_function)(const SharedNodePointer& node);
     std::function<void(AvatarMixerSlave&)> _configure;
+    WorkStealingScheduler::JobStats _jobStats;
 
     // Set from Domain Settings:
     float _priorityReservedFraction { 0.4f };
     int _numThreads { 0 };
 
-    int _numStarted { 0 }; // guarded by _mutex
-    int _numFinished { 0 }; // guarded by _mutex
-    int _numStopped { 0 }; // guarded by _mutex
-
-    // frame state
-    Queue _queue;
-    ConstIter _begin;
-    ConstIter _end;
-
     SlaveSharedData* _slaveSharedData;
 };
 
@@ -0,0 +1,127 @@
+//
+//  AvatarMixerSpatialIndex.cpp
+//  assignment-client/src/avatars
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AvatarMixerSpatialIndex.h"
+
+#include <algorithm>
+
+#include "AvatarMixerClientData.h"
+
+const float AvatarMixerSpatialIndex::DEFAULT_CELL_SIZE = 16.0f; // meters
+const float AvatarMixerSpatialIndex::DEFAULT_NEAR_RADIUS = 32.0f; // meters
+const uint32_t AvatarMixerSpatialIndex::FAR_IN_VIEW_REFRESH_FRAMES = 2;
+const uint32_t AvatarMixerSpatialIndex::FAR_OUT_OF_VIEW_REFRESH_FRAMES = 8;
+
+// slack added to a cell's bounding sphere so that avatars near its edge are not treated as far
+static const float CELL_AVATAR_RADIUS = 1.0f; // meters
+
+// 21 bits per axis, biased so that negative cell coordinates pack correctly
+static const int64_t CELL_COORD_BIAS = 1 << 20;
+static const int64_t CELL_COORD_MASK = (1 << 21) - 1;
+
+uint64_t AvatarMixerSpatialIndex::keyForPosition(const glm::vec3& position) const {
+    glm::vec3 cell = glm::floor(position / _cellSize);
+    uint64_t x = (uint64_t)(((int64_t)cell.x + CELL_COORD_BIAS) & CELL_COORD_MASK);
+    uint64_t y = (uint64_t)(((int64_t)cell.y + CELL_COORD_BIAS) & CELL_COORD_MASK);
+    uint64_t z = (uint64_t)(((int64_t)cell.z + CELL_COORD_BIAS) & CELL_COORD_MASK);
+    return (x << 42) | (y << 21) | z;
+}
+
+void AvatarMixerSpatialIndex::build(ConstIter begin, ConstIter end) {
+    _entries.clear();
+    _cells.clear();
+    _heroes.clear();
+    ++_frame;
+
+    if (!_enabled) {
+        return;
+    }
+
+    std::for_each(begin, end, [&](const SharedNodePointer& node) {
+        if (node->getType() != NodeType::Agent || !node->getLinkedData()) {
+            return;
+        }
+
+        auto nodeData = reinterpret_cast<const AvatarMixerClientData*>(node->getLinkedData());
+        const MixerAvatar* avatar = nodeData->getConstAvatarData();
+
+        // heroes are never bucketed, every listener considers them every frame
+        if (avatar->getHasPriority()) {
+            _heroes.push_back(node.data());
+            return;
+        }
+
+        glm::vec3 position = avatar->getClientGlobalPosition();
+        _entries.push_back({ keyForPosition(position), position, node.data() });
+    });
+
+    std::sort(_entries.begin(), _entries.end(), [](const Entry& left, const Entry& right) {
+        return left.key < right.key;
+    });
+
+    uint32_t cellBegin = 0;
+    while (cellBegin < (uint32_t)_entries.size()) {
+        uint64_t key = _entries[cellBegin].key;
+        glm::vec3 minCorner = _entries[cellBegin].position;
+        glm::vec3 maxCorner = minCorner;
+
+        uint32_t cellEnd = cellBegin + 1;
+        while (cellEnd < (uint32_t)_entries.size() && _entries[cellEnd].key == key) {
+            minCorner = glm::min(minCorner, _entries[cellEnd].position);
+            maxCorner = glm::max(maxCorner, _entries[cellEnd].position);
+            ++cellEnd;
+        }
+
+        Cell cell;
+        cell.center = 0.5f * (minCorner + maxCorner);
+        cell.radius = 0.5f * glm::length(maxCorner - minCorner) + CELL_AVATAR_RADIUS;
+        cell.begin = cellBegin;
+        cell.end = cellEnd;
+        // fold the key so that neighbouring far cells are refreshed on different frames
+        cell.phase = (uint32_t)(key ^ (key >> 21) ^ (key >> 42));
+        _cells.push_back(cell);
+
+        cellBegin = cellEnd;
+    }
+}
+
+void AvatarMixerSpatialIndex::query(const ConicalViewFrustums& views, const glm::vec3& listenerPosition,
+                                    uint32_t listenerSeed, std::vector<const Node*>& candidates) const {
+    candidates.insert(candidates.end(), _heroes.begin(), _heroes.end());
+
+    for (const auto& cell : _cells) {
+        bool isNear = glm::distance(listenerPosition, cell.center) - cell.radius <= _nearRadius;
+        bool isInView = false;
+
+        for (const auto& view : views) {
+            if (isNear) {
+                break;
+            }
+            glm::vec3 offset = cell.center - view.getPosition();
+            float distance = glm::length(offset);
+            if (distance - cell.radius <= _nearRadius) {
+                isNear = true;
+            } else if (!isInView) {
+                isInView = view.intersects(offset, distance, cell.radius);
+            }
+        }
+
+        if (!isNear) {
+            uint32_t refreshFrames = isInView ? FAR_IN_VIEW_REFRESH_FRAMES : FAR_OUT_OF_VIEW_REFRESH_FRAMES;
+            if ((cell.phase + _frame + listenerSeed) % refreshFrames != 0) {
+                continue;
+            }
+        }
+
+        for (uint32_t i = cell.begin; i < cell.end; ++i) {
+            candidates.push_back(_entries[i].node);
+        }
+    }
+}
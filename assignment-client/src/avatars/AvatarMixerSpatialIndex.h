@@ -0,0 +1,83 @@
+//
+//  AvatarMixerSpatialIndex.h
+//  assignment-client/src/avatars
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AvatarMixerSpatialIndex_h
+#define hifi_AvatarMixerSpatialIndex_h
+
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <NodeList.h>
+#include <shared/ConicalViewFrustum.h>
+
+// AvatarMixerSpatialIndex is a uniform grid of agent positions, rebuilt once per mixer frame
+// before the slaves broadcast.  Slaves query it per listener so that only avatars inside the
+// listener's priority horizon are considered every frame.  Avatars in distant cells are
+// handled as coarse buckets: each far cell is visited once every few frames (more often when
+// it is in view), with the listener's local ID used to spread those visits across frames.
+//
+// The index is built on the mixer thread and is read-only while the slaves run.
+class AvatarMixerSpatialIndex {
+public:
+    using ConstIter = NodeList::const_iterator;
+
+    static const float DEFAULT_CELL_SIZE;
+    static const float DEFAULT_NEAR_RADIUS;
+    static const uint32_t FAR_IN_VIEW_REFRESH_FRAMES;
+    static const uint32_t FAR_OUT_OF_VIEW_REFRESH_FRAMES;
+
+    void setEnabled(bool enabled) { _enabled = enabled; }
+    bool isEnabled() const { return _enabled; }
+
+    void setNearRadius(float nearRadius) { _nearRadius = nearRadius; }
+    float getNearRadius() const { return _nearRadius; }
+
+    void setCellSize(float cellSize) { _cellSize = cellSize; }
+    float getCellSize() const { return _cellSize; }
+
+    // collect all agents with avatar data from the frame's node range
+    void build(ConstIter begin, ConstIter end);
+
+    // append to candidates every source avatar that should be considered for this listener this frame
+    void query(const ConicalViewFrustums& views, const glm::vec3& listenerPosition, uint32_t listenerSeed,
+               std::vector<const Node*>& candidates) const;
+
+    size_t getNumEntries() const { return _entries.size(); }
+    size_t getNumCells() const { return _cells.size(); }
+
+private:
+    struct Entry {
+        uint64_t key;
+        glm::vec3 position;
+        const Node* node;
+    };
+
+    struct Cell {
+        glm::vec3 center;
+        float radius;
+        uint32_t begin;
+        uint32_t end;
+        uint32_t phase;
+    };
+
+    uint64_t keyForPosition(const glm::vec3& position) const;
+
+    std::vector<Entry> _entries;
+    std::vector<Cell> _cells;
+    std::vector<const Node*> _heroes;
+
+    uint32_t _frame { 0 };
+    float _cellSize { DEFAULT_CELL_SIZE };
+    float _nearRadius { DEFAULT_NEAR_RADIUS };
+    bool _enabled { false };
+};
+
+#endif // hifi_AvatarMixerSpatialIndex_h
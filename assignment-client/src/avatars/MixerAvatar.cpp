@@ -37,6 +37,71 @@ MixerAvatar::MixerAvatar() {
     connect(this, &MixerAvatar::startChallengeTimer, &_challengeTimer, static_cast<void(QTimer::*)()>(&QTimer::start));
 }
 
+uint32_t MixerAvatar::getChangedSinceMask(quint64 time) const {
+    // Mirrors the per-field tests toByteArray makes against lastSentTime when not sending all data.
+    return (rotationChangedSince(time) ? 1 << 0 : 0)
+        | (avatarBoundingBoxChangedSince(time) ? 1 << 1 : 0)
+        | (avatarScaleChangedSince(time) ? 1 << 2 : 0)
+        | (lookAtPositionChangedSince(time) ? 1 << 3 : 0)
+        | (audioLoudnessChangedSince(time) ? 1 << 4 : 0)
+        | (sensorToWorldMatrixChangedSince(time) ? 1 << 5 : 0)
+        | (additionalFlagsChangedSince(time) ? 1 << 6 : 0)
+        | (parentInfoChangedSince(time) ? 1 << 7 : 0)
+        | (tranlationChangedSince(time) ? 1 << 8 : 0)
+        | (faceTrackerInfoChangedSince(time) ? 1 << 9 : 0);
+}
+
+MixerAvatar::CachedEncode MixerAvatar::getCachedEncode(AvatarDataDetail detail, quint64 lastSentTime,
+                                                       uint32_t frame, int maxSize, bool& wasCached) const {
+    assert(isCacheableDetail(detail));
+
+    // only MinimumData depends on what the receiver was last sent
+    uint32_t baseline = detail == MinimumData ? getChangedSinceMask(lastSentTime) : 0;
+
+    std::lock_guard<std::mutex> lock(_encodeCacheMutex);
+    if (_encodeCacheFrame != frame) {
+        _encodeCache.clear();
+        _encodeCacheFrame = frame;
+    }
+
+    for (const auto& entry : _encodeCache) {
+        if (entry.detail == detail && entry.baseline == baseline) {
+            wasCached = true;
+            return entry.encode;
+        }
+    }
+
+    wasCached = false;
+
+    // the size is only a guess, so it is refreshed every few frames even when it keeps not fitting
+    static const uint32_t MAX_ENCODE_SIZE_AGE_FRAMES = 10;
+    const auto& lastEncodeSize = _lastEncodeSizes[detail];
+    if (lastEncodeSize.size > maxSize && frame - lastEncodeSize.frame < MAX_ENCODE_SIZE_AGE_FRAMES) {
+        return CachedEncode();
+    }
+
+    EncodeCacheEntry entry { detail, baseline, CachedEncode() };
+
+    AvatarDataPacket::SendStatus sendStatus;
+    sendStatus.sendUUID = true;
+
+    // SendAllData ignores the previous joint baseline, but toByteArray still reads one entry per joint
+    QVector<JointData>* sentJoints = nullptr;
+    if (detail == SendAllData) {
+        entry.encode.sentJoints.resize(getJointCount());
+        sentJoints = &entry.encode.sentJoints;
+    }
+
+    const bool dropFaceTracking = false;
+    const bool distanceAdjust = false;
+    entry.encode.bytes = toByteArray(detail, lastSentTime, entry.encode.sentJoints, sendStatus,
+                                     dropFaceTracking, distanceAdjust, glm::vec3(0.0f), sentJoints);
+    _lastEncodeSizes[detail] = { entry.encode.bytes.size(), frame };
+
+    _encodeCache.push_back(entry);
+    return entry.encode;
+}
+
 const char* MixerAvatar::stateToName(VerifyState state) {
     return QMetaEnum::fromType<VerifyState>().valueToKey(state);
 }
@@ -14,6 +14,8 @@
 #ifndef hifi_MixerAvatar_h
 #define hifi_MixerAvatar_h
 
+#include <mutex>
+
 #include <AvatarData.h>
 
 class ResourceRequest;
@@ -48,7 +50,39 @@ public:
     const QUuid& getScreenshareZone() const { return _screenshareZone; }
     void setScreenshareZone(QUuid zone) { _screenshareZone = zone; }
 
+    // An encode of this avatar that doesn't depend on the receiver, shared by all slaves for one broadcast frame.
+    struct CachedEncode {
+        QByteArray bytes;
+        QVector<JointData> sentJoints; // joint baseline a receiver adopts after a SendAllData encode
+    };
+
+    // PALMinimum, MinimumData and SendAllData encodes are the same for every receiver with the same
+    // changed-since baseline, so they are produced once per frame and spliced into each BulkAvatarData packet.
+    static bool isCacheableDetail(AvatarDataDetail detail) {
+        return detail == PALMinimum || detail == MinimumData || detail == SendAllData;
+    }
+    // On a miss, nothing is encoded (and an empty encode is returned) when this avatar's recent encode at this detail
+    // was larger than maxSize, since it would most likely not be used.
+    CachedEncode getCachedEncode(AvatarDataDetail detail, quint64 lastSentTime, uint32_t frame, int maxSize,
+                                 bool& wasCached) const;
+
 private:
+    uint32_t getChangedSinceMask(quint64 time) const;
+
+    struct EncodeCacheEntry {
+        AvatarDataDetail detail;
+        uint32_t baseline;
+        CachedEncode encode;
+    };
+    mutable std::mutex _encodeCacheMutex;
+    mutable std::vector<EncodeCacheEntry> _encodeCache; // guarded by _encodeCacheMutex
+    mutable uint32_t _encodeCacheFrame { 0 }; // guarded by _encodeCacheMutex
+    struct EncodeSize {
+        int size { 0 };
+        uint32_t frame { 0 };
+    };
+    mutable EncodeSize _lastEncodeSizes[SendAllData + 1]; // per detail, kept across frames, guarded by _encodeCacheMutex
+
     bool _needsHeroCheck { false };
     static const char* stateToName(VerifyState state);
     VerifyState _verifyState { nonCertified };
@@ -29,10 +29,12 @@ EntityTreeSendThread::EntityTreeSendThread(OctreeServer* myServer, const SharedN
 }
 
 void EntityTreeSendThread::resetState() {
-    qCDebug(entities) << "Clearing known EntityTreeSendThread state for" << _nodeUuid;
+    runOnNextStep([this] {
+        qCDebug(entities) << "Clearing known EntityTreeSendThread state for" << _nodeUuid;
 
-    _knownState.clear();
-    _traversal.reset();
+        _knownState.clear();
+        _traversal.reset();
+    });
 }
 
 void EntityTreeSendThread::preDistributionProcessing() {
@@ -377,7 +379,15 @@ bool EntityTreeSendThread::traverseTreeAndBuildNextPacketPayload(EncodeBitstream
                     // Record explicitly filtered-in entity so that extra entities can be flagged.
                     entityNodeData->insertSentFilteredEntity(entityID);
                 }
-                OctreeElement::AppendState appendEntityState = entity->appendEntityData(&_packetData, params, _extraEncodeData, entityNode->getCanGetAndSetPrivateUserData());
+                bool cacheHit = false;
+                OctreeElement::AppendState appendEntityState = entity->appendCachedEntityData(&_packetData, params, _extraEncodeData,
+                                                                                              entityNode->getCanGetAndSetPrivateUserData(),
+                                                                                              cacheHit);
+                if (cacheHit) {
+                    ++_totalEncodeCacheHits;
+                } else {
+                    ++_totalEncodeCacheMisses;
+                }
 
                 if (appendEntityState != OctreeElement::COMPLETED) {
                     if (appendEntityState == OctreeElement::PARTIAL) {
@@ -420,20 +430,24 @@ bool EntityTreeSendThread::traverseTreeAndBuildNextPacketPayload(EncodeBitstream
 
 void EntityTreeSendThread::editingEntityPointer(const EntityItemPointer& entity) {
     if (entity) {
-        if (!_sendQueue.contains(entity.get()) && _knownState.find(entity.get()) != _knownState.end()) {
-            const auto& view = _traversal.getCurrentView();
-            float priority = view.computePriority(entity);
-
-            // We can force a removal from _knownState if the current view is used and entity is out of view
-            if (priority == PrioritizedEntity::DO_NOT_SEND) {
-                _sendQueue.emplace(entity, PrioritizedEntity::FORCE_REMOVE, true);
-            } else if (priority == PrioritizedEntity::WHEN_IN_DOUBT_PRIORITY) {
-                _sendQueue.emplace(entity, PrioritizedEntity::WHEN_IN_DOUBT_PRIORITY, true);
+        runOnNextStep([this, entity] {
+            if (!_sendQueue.contains(entity.get()) && _knownState.find(entity.get()) != _knownState.end()) {
+                const auto& view = _traversal.getCurrentView();
+                float priority = view.computePriority(entity);
+
+                // We can force a removal from _knownState if the current view is used and entity is out of view
+                if (priority == PrioritizedEntity::DO_NOT_SEND) {
+                    _sendQueue.emplace(entity, PrioritizedEntity::FORCE_REMOVE, true);
+                } else if (priority == PrioritizedEntity::WHEN_IN_DOUBT_PRIORITY) {
+                    _sendQueue.emplace(entity, PrioritizedEntity::WHEN_IN_DOUBT_PRIORITY, true);
+                }
             }
-        }
+        });
     }
 }
 
 void EntityTreeSendThread::deletingEntityPointer(EntityItem* entity) {
-    _knownState.erase(entity);
+    runOnNextStep([this, entity] {
+        _knownState.erase(entity);
+    });
 }
@@ -11,16 +11,48 @@
 
 #include "MessagesMixer.h"
 
+#include <algorithm>
+
 #include <QtCore/QCoreApplication>
 #include <QtCore/QJsonObject>
 #include <QBuffer>
 #include <LogHandler.h>
 #include <MessagesClient.h>
 #include <NodeList.h>
+#include <SharedUtil.h>
+#include <shared/WorkStealingScheduler.h>
 #include <udt/PacketHeaders.h>
 
 const QString MESSAGES_MIXER_LOGGING_NAME = "messages-mixer";
 
+// below this many subscribers a message is sent from the mixer's thread, the fan-out isn't worth the hand-off
+static const size_t MIN_SUBSCRIBERS_FOR_PARALLEL_SEND = 32;
+static const size_t SUBSCRIBERS_PER_CHUNK = 8;
+
+// returns the size of a MessagesData packet's payload up to the end of the message, or 0 if it is malformed
+static int messageLengthWithoutSender(const QByteArray& packet) {
+    int position = 0;
+
+    quint16 channelLength;
+    if (packet.size() < position + (int)sizeof(channelLength)) {
+        return 0;
+    }
+    memcpy(&channelLength, packet.constData() + position, sizeof(channelLength));
+    position += sizeof(channelLength) + channelLength + sizeof(bool);
+
+    quint32 messageLength;
+    if (packet.size() < position + (int)sizeof(messageLength)) {
+        return 0;
+    }
+    memcpy(&messageLength, packet.constData() + position, sizeof(messageLength));
+    position += sizeof(messageLength);
+
+    if ((quint32)(packet.size() - position) < messageLength) {
+        return 0;
+    }
+    return position + (int)messageLength;
+}
+
 MessagesMixer::MessagesMixer(ReceivedMessage& message) : ThreadedAssignment(message)
 {
     connect(DependencyManager::get<NodeList>().data(), &NodeList::nodeKilled, this, &MessagesMixer::nodeKilled);
@@ -31,41 +63,130 @@ MessagesMixer::MessagesMixer(ReceivedMessage& message) : ThreadedAssignment(mess
 }
 
 void MessagesMixer::nodeKilled(SharedNodePointer killedNode) {
-    for (auto& channel : _channelSubscribers) {
-        channel.remove(killedNode->getUUID());
+    auto it = _subscriberChannels.find(killedNode->getUUID());
+    if (it == _subscriberChannels.end()) {
+        return;
+    }
+
+    for (const auto& channel : it.value()) {
+        auto channelIt = _channelSubscribers.find(channel);
+        if (channelIt != _channelSubscribers.end()) {
+            channelIt->remove(killedNode->getUUID());
+            if (channelIt->isEmpty()) {
+                _channelSubscribers.erase(channelIt);
+            }
+        }
+    }
+    _subscriberChannels.erase(it);
+}
+
+void MessagesMixer::removeSubscriber(const QString& channel, const QUuid& nodeID) {
+    auto channelIt = _channelSubscribers.find(channel);
+    if (channelIt != _channelSubscribers.end()) {
+        channelIt->remove(nodeID);
+        if (channelIt->isEmpty()) {
+            _channelSubscribers.erase(channelIt);
+        }
+    }
+
+    auto nodeIt = _subscriberChannels.find(nodeID);
+    if (nodeIt != _subscriberChannels.end()) {
+        nodeIt->remove(channel);
+        if (nodeIt->isEmpty()) {
+            _subscriberChannels.erase(nodeIt);
+        }
     }
 }
 
 void MessagesMixer::handleMessages(QSharedPointer<ReceivedMessage> receivedMessage, SharedNodePointer senderNode) {
-    QString channel, message;
-    QByteArray data;
-    QUuid senderID;
-    bool isText;
-    MessagesClient::decodeMessagesPacket(receivedMessage, channel, isText, message, data, senderID);
+    const QByteArray& packet = receivedMessage->getMessage();
+
+    // the message is forwarded as it was received, only the channel needs decoding
+    int messageLength = messageLengthWithoutSender(packet);
+    if (messageLength == 0) {
+        return;
+    }
+
+    quint16 channelLength;
+    memcpy(&channelLength, packet.constData(), sizeof(channelLength));
+    QString channel = QString::fromUtf8(packet.constData() + sizeof(channelLength), channelLength);
+
+    ChannelStats& stats = _channelStats[channel];
+    ++stats.messagesIn;
+    stats.bytesIn += packet.size();
 
+    auto channelIt = _channelSubscribers.find(channel);
+    if (channelIt == _channelSubscribers.end()) {
+        return;
+    }
+
+    auto nodeList = DependencyManager::get<NodeList>();
+    std::vector<SharedNodePointer> subscribers;
+    subscribers.reserve(channelIt->size());
+    for (const auto& nodeID : *channelIt) {
+        auto node = nodeList->nodeWithUUID(nodeID);
+        if (node && node->getActiveSocket()) {
+            subscribers.push_back(node);
+        }
+    }
+
+    if (subscribers.empty()) {
+        return;
+    }
+
+    // encode once, every subscriber's packet list is written from the same payload
+    QByteArray payload;
+    if (packet.size() >= messageLength + NUM_BYTES_RFC4122_UUID) {
+        payload = packet.left(messageLength + NUM_BYTES_RFC4122_UUID);
+    } else {
+        // the packet was missing the sender, forward the default like the clients decode it
+        payload.reserve(messageLength + NUM_BYTES_RFC4122_UUID);
+        payload.append(packet.constData(), messageLength);
+        payload.append(QUuid().toRfc4122());
+    }
+
+    sendToSubscribers(payload, subscribers);
+
+    stats.messagesOut += subscribers.size();
+    stats.bytesOut += (quint64)payload.size() * subscribers.size();
+}
+
+void MessagesMixer::sendToSubscribers(const QByteArray& payload, const std::vector<SharedNodePointer>& subscribers) {
     auto nodeList = DependencyManager::get<NodeList>();
 
-    nodeList->eachMatchingNode(
-        [&](const SharedNodePointer& node)->bool {
-        return node->getActiveSocket() && _channelSubscribers[channel].contains(node->getUUID());
-    },
-        [&](const SharedNodePointer& node) {
-        auto packetList = isText ? MessagesClient::encodeMessagesPacket(channel, message, senderID) :
-                                   MessagesClient::encodeMessagesDataPacket(channel, data, senderID);
+    // the packet lists are reliable, so each subscriber needs its own, but their contents come from the shared payload
+    auto sendTo = [&](const SharedNodePointer& node) {
+        auto packetList = NLPacketList::create(PacketType::MessagesData, QByteArray(), true, true);
+        packetList->write(payload);
         nodeList->sendPacketList(std::move(packetList), *node);
-    });
+    };
+
+    if (subscribers.size() < MIN_SUBSCRIBERS_FOR_PARALLEL_SEND) {
+        std::for_each(subscribers.begin(), subscribers.end(), sendTo);
+        return;
+    }
+
+    // building and signing the packets is spread over the scheduler's workers
+    auto scheduler = DependencyManager::get<WorkStealingScheduler>();
+    WorkStealingScheduler::Job job;
+    job.numItems = subscribers.size();
+    job.chunkSize = SUBSCRIBERS_PER_CHUNK;
+    job.maxParticipants = scheduler->getMaxParticipants();
+    job.process = [&](int participant, size_t first, size_t last) {
+        std::for_each(subscribers.begin() + first, subscribers.begin() + last, sendTo);
+    };
+    scheduler->run(job);
 }
 
 void MessagesMixer::handleMessagesSubscribe(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode) {
     QString channel = QString::fromUtf8(message->getMessage());
     _channelSubscribers[channel] << senderNode->getUUID();
+    _subscriberChannels[senderNode->getUUID()] << channel;
 }
 
 void MessagesMixer::handleMessagesUnsubscribe(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode) {
     QString channel = QString::fromUtf8(message->getMessage());
-    if (_channelSubscribers.contains(channel)) {
-        _channelSubscribers[channel].remove(senderNode->getUUID());
-    }
+    removeSubscriber(channel, senderNode->getUUID());
 }
 
 void MessagesMixer::sendStatsPacket() {
@@ -81,6 +202,27 @@ void MessagesMixer::sendStatsPacket() {
     });
 
     statsObject["messages"] = messagesMixerObject;
+
+    // per channel rates since the last stats packet
+    quint64 now = usecTimestampNow();
+    float elapsedSeconds = (_lastStatsTimestamp > 0) ? (float)(now - _lastStatsTimestamp) / USECS_PER_SECOND : 0.0f;
+    _lastStatsTimestamp = now;
+
+    QJsonObject channelsObject;
+    for (auto it = _channelStats.cbegin(); it != _channelStats.cend(); ++it) {
+        const ChannelStats& stats = it.value();
+        QJsonObject channelStats;
+        channelStats["subscribers"] = _channelSubscribers.value(it.key()).size();
+        if (elapsedSeconds > 0.0f) {
+            channelStats["messages_in_per_second"] = stats.messagesIn / elapsedSeconds;
+            channelStats["bytes_in_per_second"] = stats.bytesIn / elapsedSeconds;
+            channelStats["messages_out_per_second"] = stats.messagesOut / elapsedSeconds;
+            channelStats["bytes_out_per_second"] = stats.bytesOut / elapsedSeconds;
+        }
+        channelsObject[it.key()] = channelStats;
+    }
+    _channelStats.clear();
+    statsObject["messages_channels"] = channelsObject;
     ThreadedAssignment::addPacketStatsAndSendStatsPacket(statsObject);
 }
 
@@ -15,6 +15,11 @@
 #ifndef hifi_MessagesMixer_h
 #define hifi_MessagesMixer_h
 
+#include <vector>
+
+#include <QtCore/QHash>
+#include <QtCore/QSet>
+
 #include <ThreadedAssignment.h>
 
 /// Handles assignments of type MessagesMixer - distribution of avatar data to various clients
@@ -34,7 +39,23 @@ private slots:
     void handleMessagesUnsubscribe(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode);
 
 private:
-    QHash<QString,QSet<QUuid>> _channelSubscribers;
+    struct ChannelStats {
+        quint64 messagesIn { 0 };
+        quint64 bytesIn { 0 };
+        quint64 messagesOut { 0 };
+        quint64 bytesOut { 0 };
+    };
+
+    void removeSubscriber(const QString& channel, const QUuid& nodeID);
+    void sendToSubscribers(const QByteArray& payload, const std::vector<SharedNodePointer>& subscribers);
+
+    // subscribers by channel, and the reverse, the channels of each subscriber
+    QHash<QString, QSet<QUuid>> _channelSubscribers;
+    QHash<QUuid, QSet<QString>> _subscriberChannels;
+
+    // since the last stats packet
+    QHash<QString, ChannelStats> _channelStats;
+    quint64 _lastStatsTimestamp { 0 };
 };
 
 #endif // hifi_MessagesMixer_h
@@ -0,0 +1,211 @@
+//
+//  OctreeSendPool.cpp
+//  assignment-client/src/octree
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "OctreeSendPool.h"
+
+#include <algorithm>
+#include <assert.h>
+
+#include <QtCore/QThread>
+
+#include <SharedUtil.h>
+
+#include "OctreeSendThread.h"
+#include "OctreeServer.h"
+#include "OctreeServerConsts.h"
+
+int OctreeSendPool::defaultNumWorkers() {
+    int numCores = QThread::idealThreadCount();
+    if (numCores == -1) {
+        // idealThreadCount returns -1 if cores cannot be detected
+        static const int NUM_CORES_IF_UNKNOWN = 4;
+        numCores = NUM_CORES_IF_UNKNOWN;
+    }
+
+    // leave a core to the server's own thread and the inbound packet processor
+    return std::max(numCores - 1, 1);
+}
+
+OctreeSendPool::OctreeSendPool(OctreePointer tree, int numWorkers, int clientsPerTreeLock) :
+    _tree(tree),
+    _clientsPerTreeLock(std::max(clientsPerTreeLock, 1))
+{
+    numWorkers = std::max(numWorkers, 1);
+    _workers.reserve(numWorkers);
+    for (int i = 0; i < numWorkers; ++i) {
+        _workers.emplace_back([this] { workerLoop(); });
+    }
+}
+
+OctreeSendPool::~OctreeSendPool() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stop = true;
+    }
+    _workerCondition.notify_all();
+
+    for (auto& worker : _workers) {
+        worker.join();
+    }
+}
+
+void OctreeSendPool::addClient(OctreeSendThread* client) {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        assert(_clientIDs.find(client) == _clientIDs.end());
+
+        quint64 clientID = _nextClientID++;
+        _clientIDs[client] = clientID;
+        _clients[clientID].sender = client;
+        _schedule.push({ usecTimestampNow(), clientID });
+    }
+    _workerCondition.notify_one();
+}
+
+void OctreeSendPool::removeClient(OctreeSendThread* client) {
+    std::unique_lock<std::mutex> lock(_mutex);
+    auto it = _clientIDs.find(client);
+    if (it == _clientIDs.end()) {
+        return;
+    }
+
+    quint64 clientID = it->second;
+    _steppedCondition.wait(lock, [&] {
+        auto clientIt = _clients.find(clientID);
+        return clientIt == _clients.end() || !clientIt->second.isStepping;
+    });
+
+    // its scheduled step is dropped when it comes due
+    _clients.erase(clientID);
+    _clientIDs.erase(client);
+}
+
+OctreeSendPool::Stats OctreeSendPool::getStats() {
+    Stats stats;
+    stats.numWorkers = (int)_workers.size();
+    stats.numSteps = _numSteps.exchange(0);
+    stats.numTreeLocks = _numTreeLocks.exchange(0);
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    stats.numClients = (int)_clients.size();
+    stats.clients.reserve(_clients.size());
+    for (auto& it : _clients) {
+        Client& client = it.second;
+        float averageQueueDelay = client.queueDelay.getAverage();
+        stats.clients.push_back({ client.sender->getNodeUuid(), averageQueueDelay, client.maxQueueDelay });
+
+        stats.averageQueueDelay += averageQueueDelay;
+        stats.maxQueueDelay = std::max(stats.maxQueueDelay, client.maxQueueDelay);
+        client.maxQueueDelay = 0;
+    }
+    if (stats.numClients > 0) {
+        stats.averageQueueDelay /= stats.numClients;
+    }
+
+    return stats;
+}
+
+void OctreeSendPool::workerLoop() {
+    std::vector<BatchedStep> batch;
+    std::vector<OctreeSendThread*> traversing;
+
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (!_stop) {
+        if (_schedule.empty()) {
+            _workerCondition.wait(lock);
+            continue;
+        }
+
+        quint64 now = usecTimestampNow();
+        quint64 nextDeadline = _schedule.top().deadline;
+        if (nextDeadline > now) {
+            _workerCondition.wait_for(lock, std::chrono::microseconds(nextDeadline - now));
+            continue;
+        }
+
+        // take a batch of the clients that are due
+        batch.clear();
+        while (!_schedule.empty() && _schedule.top().deadline <= now && batch.size() < _clientsPerTreeLock) {
+            ScheduledStep step = _schedule.top();
+            _schedule.pop();
+
+            auto it = _clients.find(step.clientID);
+            if (it == _clients.end()) {
+                continue; // the client was removed
+            }
+
+            Client& client = it->second;
+            client.isStepping = true;
+
+            quint64 queueDelay = now - step.deadline;
+            client.queueDelay.updateAverage((float)queueDelay);
+            client.maxQueueDelay = std::max(client.maxQueueDelay, queueDelay);
+
+            batch.push_back({ step, client.sender });
+        }
+
+        // let another worker take the clients that are still due
+        bool hasMoreDue = !_schedule.empty() && _schedule.top().deadline <= now;
+        lock.unlock();
+        if (hasMoreDue) {
+            _workerCondition.notify_one();
+        }
+
+        stepBatch(batch, traversing);
+
+        lock.lock();
+        for (const auto& batchedStep : batch) {
+            auto it = _clients.find(batchedStep.step.clientID);
+            assert(it != _clients.end());
+            it->second.isStepping = false;
+
+            OctreeSendThread* sender = batchedStep.sender;
+            if (sender->isShuttingDown()) {
+                // the sender is removed from the server once it is done, signal while it can't be deleted under us
+                _clients.erase(it);
+                _clientIDs.erase(sender);
+                emit sender->finished();
+            } else {
+                // like the send threads did, the next step is one interval after this one started
+                _schedule.push({ now + OCTREE_SEND_INTERVAL_USECS, batchedStep.step.clientID });
+            }
+        }
+        _steppedCondition.notify_all();
+    }
+}
+
+void OctreeSendPool::stepBatch(const std::vector<BatchedStep>& batch, std::vector<OctreeSendThread*>& traversing) {
+    traversing.clear();
+    for (const auto& batchedStep : batch) {
+        if (batchedStep.sender->startStep()) {
+            traversing.push_back(batchedStep.sender);
+        }
+    }
+
+    if (traversing.empty()) {
+        return;
+    }
+
+    _numSteps += traversing.size();
+    ++_numTreeLocks;
+
+    quint64 lockStart = usecTimestampNow();
+    _tree->withReadLock([&] {
+        OctreeServer::trackTreeWaitTime((float)(usecTimestampNow() - lockStart));
+
+        for (auto sender : traversing) {
+            sender->traverseStep();
+        }
+    });
+
+    for (auto sender : traversing) {
+        sender->finishStep();
+    }
+}
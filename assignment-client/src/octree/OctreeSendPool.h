@@ -0,0 +1,107 @@
+//
+//  OctreeSendPool.h
+//  assignment-client/src/octree
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_OctreeSendPool_h
+#define hifi_OctreeSendPool_h
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <QtCore/QUuid>
+
+#include <Octree.h>
+#include <SimpleMovingAverage.h>
+
+class OctreeSendThread;
+
+// OctreeSendPool steps the senders of every client of an octree server on a fixed number of worker threads.
+//
+// Each client has a deadline for its next step, one send interval after its last one, and workers take the
+// clients that are due from a min-heap of deadlines.  A worker takes up to a batch of due clients at once and
+// traverses all of them under a single acquisition of the tree's read lock.  The time a client spends due but
+// not yet picked up by a worker is its queueing delay.
+class OctreeSendPool {
+public:
+    struct ClientStats {
+        QUuid nodeUUID;
+        float averageQueueDelay; // usecs
+        quint64 maxQueueDelay; // usecs
+    };
+
+    struct Stats {
+        int numWorkers { 0 };
+        int numClients { 0 };
+        quint64 numSteps { 0 };
+        quint64 numTreeLocks { 0 };
+        float averageQueueDelay { 0.0f }; // usecs, over the clients
+        quint64 maxQueueDelay { 0 }; // usecs
+        std::vector<ClientStats> clients;
+    };
+
+    static int defaultNumWorkers();
+
+    OctreeSendPool(OctreePointer tree, int numWorkers = defaultNumWorkers(), int clientsPerTreeLock = 8);
+    ~OctreeSendPool();
+
+    // the pool steps client until it is shutting down, then emits client->finished()
+    void addClient(OctreeSendThread* client);
+
+    // stops stepping client, waits for its current step (if any) to end
+    void removeClient(OctreeSendThread* client);
+
+    // returns the stats since the last call
+    Stats getStats();
+
+private:
+    struct Client {
+        OctreeSendThread* sender;
+        bool isStepping { false };
+        SimpleMovingAverage queueDelay;
+        quint64 maxQueueDelay { 0 };
+    };
+
+    struct ScheduledStep {
+        quint64 deadline;
+        quint64 clientID; // clients are keyed by id, a removed client's steps are dropped when they come due
+
+        bool operator>(const ScheduledStep& other) const { return deadline > other.deadline; }
+    };
+
+    struct BatchedStep {
+        ScheduledStep step;
+        OctreeSendThread* sender;
+    };
+
+    void workerLoop();
+    void stepBatch(const std::vector<BatchedStep>& batch, std::vector<OctreeSendThread*>& traversing);
+
+    OctreePointer _tree;
+    const size_t _clientsPerTreeLock;
+    std::vector<std::thread> _workers;
+
+    std::mutex _mutex;
+    std::condition_variable _workerCondition;
+    std::condition_variable _steppedCondition;
+    std::priority_queue<ScheduledStep, std::vector<ScheduledStep>, std::greater<ScheduledStep>> _schedule;
+    std::unordered_map<quint64, Client> _clients;
+    std::unordered_map<OctreeSendThread*, quint64> _clientIDs;
+    quint64 _nextClientID { 0 };
+    bool _stop { false };
+
+    std::atomic<quint64> _numSteps { 0 };
+    std::atomic<quint64> _numTreeLocks { 0 };
+};
+
+#endif // hifi_OctreeSendPool_h
@@ -11,13 +11,9 @@
 
 #include "OctreeSendThread.h"
 
-#include <chrono>
-#include <thread>
-
 #include <NodeList.h>
 #include <NumericalConstants.h>
 #include <udt/PacketHeaders.h>
-#include <PerfStat.h>
 
 #include "OctreeServer.h"
 #include "OctreeServerConsts.h"
@@ -33,15 +29,14 @@ OctreeSendThread::OctreeSendThread(OctreeServer* myServer, const SharedNodePoint
 {
     QString safeServerName("Octree");
 
-    // set our QThread object name so we can identify this thread while debugging
-    setObjectName(QString("Octree Send Thread (%1)").arg(uuidStringWithoutCurlyBraces(_nodeUuid)));
+    setObjectName(QString("Octree Sender (%1)").arg(uuidStringWithoutCurlyBraces(_nodeUuid)));
 
     if (_myServer) {
         safeServerName = _myServer->getMyServerName();
     }
 
     qDebug() << qPrintable(safeServerName)  << "server [" << _myServer << "]: client connected "
-                                            "- starting sending thread [" << this << "]";
+                                            "- starting sender [" << this << "]";
 
     OctreeServer::clientConnected();
 }
@@ -55,7 +50,7 @@ OctreeSendThread::~OctreeSendThread() {
     }
 
     qDebug() << qPrintable(safeServerName)  << "server [" << _myServer << "]: client disconnected "
-                                            "- ending sending thread [" << this << "]";
+                                            "- ending sender [" << this << "]";
 
     OctreeServer::clientDisconnected();
     OctreeServer::stopTrackingThread(this);
@@ -66,64 +61,79 @@ void OctreeSendThread::setIsShuttingDown() {
 }
 
 
-bool OctreeSendThread::process() {
+void OctreeSendThread::runOnNextStep(std::function<void()> work) {
+    std::lock_guard<std::mutex> lock(_pendingWorkMutex);
+    _pendingWork.push_back(std::move(work));
+}
+
+bool OctreeSendThread::startStep() {
+    _stepNode.reset();
+
     if (_isShuttingDown) {
         return false; // exit early if we're shutting down
     }
 
-    OctreeServer::didProcess(this);
+    std::vector<std::function<void()>> pendingWork;
+    {
+        std::lock_guard<std::mutex> lock(_pendingWorkMutex);
+        pendingWork.swap(_pendingWork);
+    }
+    for (auto& work : pendingWork) {
+        work();
+    }
 
-    quint64  start = usecTimestampNow();
+    OctreeServer::didProcess(this);
 
     // we'd better have a server at this point, or we're in trouble
     assert(_myServer);
 
     // don't do any send processing until the initial load of the octree is complete...
-    if (_myServer->isInitialLoadComplete()) {
-        if (auto node = _node.lock()) {
-            OctreeQueryNode* nodeData = static_cast<OctreeQueryNode*>(node->getLinkedData());
-
-            // If we don't have the OctreeQueryNode at all
-            // or it's uninitialized because we haven't received a query yet from the client
-            // or we don't know where we should send packets for this node
-            // or we're shutting down
-            // then we can't send an entity data packet
-            if (nodeData && nodeData->hasReceivedFirstQuery() && node->getActiveSocket() && !nodeData->isShuttingDown()) {
-                bool viewFrustumChanged = nodeData->updateCurrentViewFrustum();
-                packetDistributor(node, nodeData, viewFrustumChanged);
-            }
-        } else {
-            return false; // exit early if we're shutting down
-        }
+    if (!_myServer->isInitialLoadComplete()) {
+        return false;
     }
 
-    if (_isShuttingDown) {
-        return false; // exit early if we're shutting down
+    auto node = _node.lock();
+    if (!node) {
+        setIsShuttingDown(); // the node is gone, the pool stops stepping us
+        return false;
     }
 
-    // Only sleep if we're still running and we got the lock last time we tried, otherwise try to get the lock asap
-    if (isStillRunning()) {
-        // dynamically sleep until we need to fire off the next set of octree elements
-        int elapsed = (usecTimestampNow() - start);
-        int usecToSleep =  OCTREE_SEND_INTERVAL_USECS - elapsed;
-
-        if (usecToSleep <= 0) {
-            const int MIN_USEC_TO_SLEEP = 1;
-            usecToSleep = MIN_USEC_TO_SLEEP;
-        }
+    OctreeQueryNode* nodeData = static_cast<OctreeQueryNode*>(node->getLinkedData());
 
-        {
-            PerformanceWarning warn(false,"OctreeSendThread... usleep()",false,&_usleepTime,&_usleepCalls);
-            std::this_thread::sleep_for(std::chrono::microseconds(usecToSleep));
-        }
+    // If we don't have the OctreeQueryNode at all
+    // or it's uninitialized because we haven't received a query yet from the client
+    // or we don't know where we should send packets for this node
+    // or we're shutting down
+    // then we can't send an entity data packet
+    if (!nodeData || !nodeData->hasReceivedFirstQuery() || !node->getActiveSocket() || nodeData->isShuttingDown()) {
+        return false;
+    }
 
+    _stepViewFrustumChanged = nodeData->updateCurrentViewFrustum();
+    startPacketDistribution(node, nodeData, _stepViewFrustumChanged);
+    if (nodeData->isShuttingDown()) {
+        return false;
     }
 
-    return isStillRunning();  // keep running till they terminate us
+    _stepNode = node;
+    return true;
+}
+
+void OctreeSendThread::traverseStep() {
+    assert(_stepNode);
+    _stepTraverseStart = usecTimestampNow();
+
+    OctreeQueryNode* nodeData = static_cast<OctreeQueryNode*>(_stepNode->getLinkedData());
+    traverseTreeAndSendContents(_stepNode, nodeData, _stepViewFrustumChanged, _stepIsFullScene);
+}
+
+void OctreeSendThread::finishStep() {
+    assert(_stepNode);
+    OctreeQueryNode* nodeData = static_cast<OctreeQueryNode*>(_stepNode->getLinkedData());
+    finishPacketDistribution(_stepNode, nodeData);
+    _stepNode.reset();
 }
 
-AtomicUIntStat OctreeSendThread::_usleepTime { 0 };
-AtomicUIntStat OctreeSendThread::_usleepCalls { 0 };
 AtomicUIntStat OctreeSendThread::_totalBytes { 0 };
 AtomicUIntStat OctreeSendThread::_totalWastedBytes { 0 };
 AtomicUIntStat OctreeSendThread::_totalPackets { 0 };
@@ -131,6 +141,9 @@ AtomicUIntStat OctreeSendThread::_totalPackets { 0 };
 AtomicUIntStat OctreeSendThread::_totalSpecialBytes { 0 };
 AtomicUIntStat OctreeSendThread::_totalSpecialPackets { 0 };
 
+AtomicUIntStat OctreeSendThread::_totalEncodeCacheHits { 0 };
+AtomicUIntStat OctreeSendThread::_totalEncodeCacheMisses { 0 };
+
 
 int OctreeSendThread::handlePacketSend(SharedNodePointer node, OctreeQueryNode* nodeData, bool dontSuppressDuplicate) {
     OctreeServer::didHandlePacketSend(this);
@@ -302,13 +315,13 @@ int OctreeSendThread::handlePacketSend(SharedNodePointer node, OctreeQueryNode*
     return numPackets;
 }
 
-/// Version of octree element distributor that sends the deepest LOD level at once
-int OctreeSendThread::packetDistributor(SharedNodePointer node, OctreeQueryNode* nodeData, bool viewFrustumChanged) {
+/// Version of octree element distributor that sends the deepest LOD level at once, this is the part before the traversal
+void OctreeSendThread::startPacketDistribution(SharedNodePointer node, OctreeQueryNode* nodeData, bool viewFrustumChanged) {
     OctreeServer::didPacketDistributor(this);
 
     // if shutting down, exit early
     if (nodeData->isShuttingDown()) {
-        return 0;
+        return;
     }
 
     if (shouldStartNewTraversal(nodeData, viewFrustumChanged)) {
@@ -322,6 +335,7 @@ int OctreeSendThread::packetDistributor(SharedNodePointer node, OctreeQueryNode*
     _packetsSentThisInterval = 0;
 
     bool isFullScene = nodeData->shouldForceFullScene();
+    _stepIsFullScene = isFullScene;
     if (isFullScene) {
         // we're forcing a full scene, clear the force in OctreeQueryNode so we don't force it next time again
         nodeData->setShouldForceFullScene(false);
@@ -360,13 +374,10 @@ int OctreeSendThread::packetDistributor(SharedNodePointer node, OctreeQueryNode*
         // start tracking our stats
         nodeData->stats.sceneStarted(isFullScene, viewFrustumChanged, _myServer->getOctree()->getRoot());
     }
+}
 
-    quint64 start = usecTimestampNow();
-
-    _myServer->getOctree()->withReadLock([&]{
-        traverseTreeAndSendContents(node, nodeData, viewFrustumChanged, isFullScene);
-    });
-
+/// The part of the distributor after the traversal
+void OctreeSendThread::finishPacketDistribution(SharedNodePointer node, OctreeQueryNode* nodeData) {
     // Here's where we can/should allow the server to send other data...
     // send the environment packet
     // TODO: should we turn this into a while loop to better handle sending multiple special packets
@@ -406,7 +417,7 @@ int OctreeSendThread::packetDistributor(SharedNodePointer node, OctreeQueryNode*
     }
 
     quint64 end = usecTimestampNow();
-    int elapsedmsec = (end - start) / USECS_PER_MSEC;
+    int elapsedmsec = (end - _stepTraverseStart) / USECS_PER_MSEC;
     OctreeServer::trackLoopTime(elapsedmsec);
 
     // if we've sent everything, then we want to remember that we've sent all
@@ -416,13 +427,11 @@ int OctreeSendThread::packetDistributor(SharedNodePointer node, OctreeQueryNode*
 
         // If this was a full scene then make sure we really send out a stats packet at this point so that
         // the clients will know the scene is stable
-        if (isFullScene) {
+        if (_stepIsFullScene) {
             nodeData->stats.sceneCompleted();
             handlePacketSend(node, nodeData, true);
         }
     }
-
-    return _truePacketsSent;
 }
 
 bool OctreeSendThread::traverseTreeAndSendContents(SharedNodePointer node, OctreeQueryNode* nodeData, bool viewFrustumChanged, bool isFullScene) {
@@ -5,7 +5,7 @@
 //  Created by Brad Hefta-Gaub on 8/21/13.
 //  Copyright 2013 High Fidelity, Inc.
 //
-//  Threaded or non-threaded object for sending octree data packets to a client
+//  Object for sending octree data packets to a client, stepped by the server's OctreeSendPool
 //
 //  Distributed under the Apache License, Version 2.0.
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
@@ -15,8 +15,12 @@
 #define hifi_OctreeSendThread_h
 
 #include <atomic>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+#include <QtCore/QObject>
 
-#include <GenericThread.h>
 #include <Node.h>
 #include <OctreePacketData.h>
 #include "OctreeQueryNode.h"
@@ -26,8 +30,13 @@ class OctreeServer;
 
 using AtomicUIntStat = std::atomic<uintmax_t>;
 
-/// Threaded processor for sending octree packets to a single client
-class OctreeSendThread : public GenericThread {
+/// Processor for sending octree packets to a single client.
+///
+/// Senders no longer run on a thread of their own: the OctreeSendPool calls startStep(), traverseStep() and
+/// finishStep() once per send interval from one of its workers, with the tree read locked around traverseStep().
+/// A sender lives on the server's thread, so work its slots do on the traversal state is deferred to the
+/// next step with runOnNextStep().
+class OctreeSendThread : public QObject {
     Q_OBJECT
 public:
     OctreeSendThread(OctreeServer* myServer, const SharedNodePointer& node);
@@ -45,12 +54,25 @@ public:
     static AtomicUIntStat _totalSpecialBytes;
     static AtomicUIntStat _totalSpecialPackets;
 
-    static AtomicUIntStat _usleepTime;
-    static AtomicUIntStat _usleepCalls;
+    static AtomicUIntStat _totalEncodeCacheHits;
+    static AtomicUIntStat _totalEncodeCacheMisses;
+
+    /// Prepares the next send to this client, returns false if there is nothing to traverse.
+    bool startStep();
+
+    /// Traverses the tree and sends what fits in this interval, the caller must hold the tree's read lock.
+    void traverseStep();
+
+    /// Sends what is left after the traversal, only called if startStep() returned true.
+    void finishStep();
+
+signals:
+    /// emitted by the pool once it has stopped stepping this client
+    void finished();
 
 protected:
-    /// Implements generic processing behavior for this thread.
-    virtual bool process() override;
+    /// Queues work to run on the pool at the start of the next step
+    void runOnNextStep(std::function<void()> work);
 
     virtual bool traverseTreeAndSendContents(SharedNodePointer node, OctreeQueryNode* nodeData,
             bool viewFrustumChanged, bool isFullScene);
@@ -65,7 +87,8 @@ private:
     /// Called before a packetDistributor pass to allow for pre-distribution processing
     virtual void preDistributionProcessing() = 0;
     int handlePacketSend(SharedNodePointer node, OctreeQueryNode* nodeData, bool dontSuppressDuplicate = false);
-    int packetDistributor(SharedNodePointer node, OctreeQueryNode* nodeData, bool viewFrustumChanged);
+    void startPacketDistribution(SharedNodePointer node, OctreeQueryNode* nodeData, bool viewFrustumChanged);
+    void finishPacketDistribution(SharedNodePointer node, OctreeQueryNode* nodeData);
 
     virtual bool hasSomethingToSend(OctreeQueryNode* nodeData) = 0;
     virtual bool shouldStartNewTraversal(OctreeQueryNode* nodeData, bool viewFrustumChanged) = 0;
@@ -73,7 +96,16 @@ private:
     int _truePacketsSent { 0 }; // available for debug stats
     int _trueBytesSent { 0 }; // available for debug stats
     int _packetsSentThisInterval { 0 }; // used for bandwidth throttle condition
-    bool _isShuttingDown { false };
+    std::atomic<bool> _isShuttingDown { false };
+
+    // state of the current step, between startStep() and finishStep()
+    SharedNodePointer _stepNode;
+    bool _stepViewFrustumChanged { false };
+    bool _stepIsFullScene { false };
+    quint64 _stepTraverseStart { 0 };
+
+    std::mutex _pendingWorkMutex;
+    std::vector<std::function<void()>> _pendingWork;
 };
 
 #endif // hifi_OctreeSendThread_h
@@ -626,6 +626,11 @@ bool OctreeServer::handleHTTPRequest(HTTPConnection* connection, const QUrl& url
         statsString += QString("     Total Outbound Special Bytes: %1 bytes\r\n")
             .arg(locale.toString((uint)totalOutboundSpecialBytes).rightJustified(COLUMN_WIDTH, ' '));
 
+        statsString += QString("          Total Encode Cache Hits: %1 entities\r\n")
+            .arg(locale.toString((uint)OctreeSendThread::_totalEncodeCacheHits).rightJustified(COLUMN_WIDTH, ' '));
+        statsString += QString("        Total Encode Cache Misses: %1 entities\r\n")
+            .arg(locale.toString((uint)OctreeSendThread::_totalEncodeCacheMisses).rightJustified(COLUMN_WIDTH, ' '));
+
 
         statsString += QString("               Total Wasted Bytes: %1 bytes\r\n")
             .arg(locale.toString((uint)totalWastedBytes).rightJustified(COLUMN_WIDTH, ' '));
@@ -876,9 +881,9 @@ void OctreeServer::parsePayload() {
 OctreeServer::UniqueSendThread OctreeServer::createSendThread(const SharedNodePointer& node) {
     auto sendThread = newSendThread(node);
 
-    // we want to be notified when the thread finishes
-    connect(sendThread.get(), &GenericThread::finished, this, &OctreeServer::removeSendThread);
-    sendThread->initialize(true);
+    // we want to be notified when the pool is done with it
+    connect(sendThread.get(), &OctreeSendThread::finished, this, &OctreeServer::removeSendThread);
+    _sendPool->addClient(sendThread.get());
 
     return sendThread;
 }
@@ -886,8 +891,11 @@ OctreeServer::UniqueSendThread OctreeServer::createSendThread(const SharedNodePo
 void OctreeServer::removeSendThread() {
     // If the object has been deleted since the event was queued, sender() will return nullptr
     if (auto sendThread = qobject_cast<OctreeSendThread*>(sender())) {
-        // This deletes the unique_ptr, so sendThread is destructed after that line
-        _sendThreads.erase(sendThread->getNodeUuid());
+        auto it = _sendThreads.find(sendThread->getNodeUuid());
+        if (it != _sendThreads.end() && it->second.get() == sendThread) {
+            // This deletes the unique_ptr, so sendThread is destructed after that line
+            _sendThreads.erase(it);
+        }
     }
 }
 
@@ -902,7 +910,9 @@ void OctreeServer::handleOctreeQueryPacket(QSharedPointer<ReceivedMessage> messa
         if (it == _sendThreads.end()) {
             _sendThreads.emplace(senderNode->getUUID(), createSendThread(senderNode));
         } else if (it->second->isShuttingDown()) {
-            _sendThreads.erase(it); // Remove right away and wait on thread to be
+            // Remove right away, once the pool is done with its current step
+            _sendPool->removeClient(it->second.get());
+            _sendThreads.erase(it);
 
             _sendThreads.emplace(senderNode->getUUID(), createSendThread(senderNode));
         }
@@ -1061,6 +1071,19 @@ void OctreeServer::readConfiguration() {
         readOptionBool(QString("persistFileDownload"), settingsSectionObject, _persistFileDownload);
         qDebug() << "persistFileDownload=" << _persistFileDownload;
 
+        readOptionBool(QString("persistJournal"), settingsSectionObject, _persistJournal);
+        qDebug() << "persistJournal=" << _persistJournal;
+
+        int compactionInterval { -1 };
+        readOptionInt(QString("persistCompactionInterval"), settingsSectionObject, compactionInterval);
+        if (compactionInterval > 0) {
+            _persistCompactionInterval = std::chrono::milliseconds(compactionInterval);
+        }
+        qDebug() << "persistCompactionInterval=" << _persistCompactionInterval.count();
+
+        readOptionBool(QString("persistBinarySnapshot"), settingsSectionObject, _persistBinarySnapshot);
+        qDebug() << "persistBinarySnapshot=" << _persistBinarySnapshot;
+
     } else {
         qDebug("persistFilename= DISABLED");
     }
@@ -1097,6 +1120,12 @@ void OctreeServer::readConfiguration() {
                     packetsPerSecondTotalMax, _packetsTotalPerInterval);
 
 
+    readOptionInt(QString("sendWorkers"), settingsSectionObject, _numSendWorkers);
+    qDebug() << "sendWorkers=" << _numSendWorkers;
+
+    readOptionInt(QString("clientsPerTreeLock"), settingsSectionObject, _clientsPerTreeLock);
+    qDebug() << "clientsPerTreeLock=" << _clientsPerTreeLock;
+
     readAdditionalConfiguration(settingsSectionObject);
 }
 
@@ -1128,6 +1157,8 @@ void OctreeServer::domainSettingsRequestComplete() {
 
     readConfiguration();
 
+    _sendPool.reset(new OctreeSendPool(_tree, _numSendWorkers, _clientsPerTreeLock));
+
     // if we want Persistence, set up the local file and persist thread
     if (_wantPersist) {
         static const QString ENTITY_PERSIST_EXTENSION = ".json.gz";
@@ -1186,7 +1217,8 @@ void OctreeServer::domainSettingsRequestComplete() {
 
         // now set up PersistThread
         _persistManager = new OctreePersistThread(_tree, _persistAbsoluteFilePath, _persistInterval, _debugTimestampNow,
-                                                 _persistAsFileType);
+                                                 _persistAsFileType, _persistJournal, _persistCompactionInterval,
+                                                 _persistBinarySnapshot);
         _persistManager->moveToThread(&_persistThread);
         connect(&_persistThread, &QThread::finished, _persistManager, &QObject::deleteLater);
         connect(&_persistThread, &QThread::started, _persistManager, &OctreePersistThread::start);
@@ -1288,16 +1320,15 @@ void OctreeServer::aboutToFinish() {
         _octreeInboundPacketProcessor->terminating();
     }
 
-    // Shut down all the send threads
+    // Shut down all the senders
     for (auto& it : _sendThreads) {
         auto& sendThread = *it.second;
         sendThread.setIsShuttingDown();
-        sendThread.terminate();
     }
 
-    // Clear will destruct all the unique_ptr to OctreeSendThreads which will call the GenericThread's dtor
-    // which waits on the thread to be done before returning
-    _sendThreads.clear(); // Cleans up all the send threads.
+    // Stop the pool first, its dtor waits on the steps in progress, so that no sender is deleted while it is stepped
+    _sendPool.reset();
+    _sendThreads.clear(); // Cleans up all the senders.
 
     if (_persistManager) {
         _persistThread.quit();
@@ -1422,6 +1453,28 @@ void OctreeServer::sendStatsPacket() {
     statsArray1["5. clients"] = getCurrentClientCount();
     statsArray1["6. threads"] = threadsStats;
 
+    if (_sendPool) {
+        auto poolStats = _sendPool->getStats();
+
+        QJsonObject clientsStats;
+        for (const auto& clientStats : poolStats.clients) {
+            QJsonObject clientObject;
+            clientObject["avg_queue_delay_usecs"] = (double)clientStats.averageQueueDelay;
+            clientObject["max_queue_delay_usecs"] = (double)clientStats.maxQueueDelay;
+            clientsStats[uuidStringWithoutCurlyBraces(clientStats.nodeUUID)] = clientObject;
+        }
+
+        QJsonObject sendPoolStats;
+        sendPoolStats["1. workers"] = poolStats.numWorkers;
+        sendPoolStats["2. clients"] = poolStats.numClients;
+        sendPoolStats["3. steps"] = (double)poolStats.numSteps;
+        sendPoolStats["4. treeLocks"] = (double)poolStats.numTreeLocks;
+        sendPoolStats["5. avgQueueDelayUsecs"] = (double)poolStats.averageQueueDelay;
+        sendPoolStats["6. maxQueueDelayUsecs"] = (double)poolStats.maxQueueDelay;
+        sendPoolStats["7. clientQueueDelays"] = clientsStats;
+        statsArray1["7. sendPool"] = sendPoolStats;
+    }
+
     // Octree Stats
     QJsonObject octreeStats;
     octreeStats["1. elementCount"] = (double)OctreeElement::getNodeCount();
@@ -1436,6 +1489,8 @@ void OctreeServer::sendStatsPacket() {
     dataObject1["4. totalBytesOctalCodes"] = (double)OctreePacketData::getTotalBytesOfOctalCodes();
     dataObject1["5. totalBytesBitMasks"] = (double)OctreePacketData::getTotalBytesOfBitMasks();
     dataObject1["6. totalBytesBitMasks"] = (double)OctreePacketData::getTotalBytesOfColor();
+    dataObject1["7. encodeCacheHits"] = (double)OctreeSendThread::_totalEncodeCacheHits;
+    dataObject1["8. encodeCacheMisses"] = (double)OctreeSendThread::_totalEncodeCacheMisses;
 
     QJsonObject timingArray1;
     timingArray1["1. avgLoopTime"] = getAverageLoopTime();
@@ -23,6 +23,7 @@
 #include <ThreadedAssignment.h>
 
 #include "OctreePersistThread.h"
+#include "OctreeSendPool.h"
 #include "OctreeSendThread.h"
 #include "OctreeServerConsts.h"
 #include "OctreeInboundPacketProcessor.h"
@@ -195,6 +196,9 @@ protected:
 
     std::chrono::milliseconds _persistInterval;
     bool _persistFileDownload;
+    bool _persistJournal { false };
+    std::chrono::milliseconds _persistCompactionInterval { OctreePersistThread::DEFAULT_JOURNAL_COMPACTION_INTERVAL };
+    bool _persistBinarySnapshot { false };
     int _maxBackupVersions;
 
     time_t _started;
@@ -202,6 +206,9 @@ protected:
     QString _safeServerName;
     
     SendThreads _sendThreads;
+    std::unique_ptr<OctreeSendPool> _sendPool;
+    int _numSendWorkers { OctreeSendPool::defaultNumWorkers() };
+    int _clientsPerTreeLock { 8 };
 
     static int _clientCount;
     static SimpleMovingAverage _averageLoopTime;
@@ -125,7 +125,8 @@ void EntityScriptServer::handleEntityScriptGetStatusPacket(QSharedPointer<Receiv
         replyPacketList->writePrimitive(messageID);
 
         EntityScriptDetails details;
-        if (_entitiesScriptEngine->getEntityScriptDetails(entityID, details)) {
+        auto engine = engineForEntity(entityID);
+        if (engine && engine->getEntityScriptDetails(entityID, details)) {
             replyPacketList->writePrimitive(true);
             replyPacketList->writePrimitive(details.status);
             replyPacketList->writeString(details.errorInfo);
@@ -154,6 +155,11 @@ void EntityScriptServer::handleSettings() {
 
     auto entityScriptServerSettings = settingsObject[ENTITY_SCRIPT_SERVER_SETTINGS_KEY].toObject();
 
+    static const QString NUM_SCRIPT_ENGINES_OPTION = "num_script_engines";
+    if (entityScriptServerSettings.contains(NUM_SCRIPT_ENGINES_OPTION)) {
+        setNumShards(entityScriptServerSettings[NUM_SCRIPT_ENGINES_OPTION].toInt());
+    }
+
     static const QString MAX_ENTITY_PPS_OPTION = "max_total_entity_pps";
     static const QString ENTITY_PPS_PER_SCRIPT = "entity_pps_per_script";
 
@@ -170,7 +176,12 @@ void EntityScriptServer::handleSettings() {
 }
 
 void EntityScriptServer::updateEntityPPS() {
-    int numRunningScripts = _entitiesScriptEngine->getNumRunningEntityScripts();
+    int numRunningScripts = 0;
+    if (_shardRouter) {
+        for (const auto& shard : _shardRouter->getShards()) {
+            numRunningScripts += shard->getEngine()->getNumRunningEntityScripts();
+        }
+    }
     int pps;
     if (std::numeric_limits<int>::max() / _entityPPSPerScript < numRunningScripts) {
         qWarning() << QString("Integer multiplication would overflow, clamping to maxint: %1 * %2").arg(numRunningScripts).arg(_entityPPSPerScript);
@@ -231,7 +242,7 @@ void EntityScriptServer::pushLogs() {
 
 void EntityScriptServer::handleEntityScriptCallMethodPacket(QSharedPointer<ReceivedMessage> receivedMessage, SharedNodePointer senderNode) {
 
-    if (_entitiesScriptEngine && _entityViewer.getTree() && !_shuttingDown) {
+    if (_shardRouter && _entityViewer.getTree() && !_shuttingDown) {
         auto entityID = QUuid::fromRfc4122(receivedMessage->read(NUM_BYTES_RFC4122_UUID));
 
         auto method = receivedMessage->readString();
@@ -245,7 +256,7 @@ void EntityScriptServer::handleEntityScriptCallMethodPacket(QSharedPointer<Recei
             params << paramString;
         }
 
-        _entitiesScriptEngine->callEntityScriptMethod(entityID, method, params, senderNode->getUUID());
+        _shardRouter->callEntityScriptMethod(entityID, method, params, senderNode->getUUID());
     }
 }
 
@@ -276,8 +287,8 @@ void EntityScriptServer::run() {
         NodeType::EntityServer, NodeType::MessagesMixer, NodeType::AssetServer
     });
 
-    // Setup Script Engine
-    resetEntitiesScriptEngine();
+    // Setup Script Engines
+    resetEntitiesScriptEngines();
 
     auto entityScriptingInterface = DependencyManager::get<EntityScriptingInterface>();
     entityScriptingInterface->init();
@@ -439,7 +450,7 @@ void EntityScriptServer::selectAudioFormat(const QString& selectedCodecName) {
     }
 }
 
-void EntityScriptServer::resetEntitiesScriptEngine() {
+ScriptEnginePointer EntityScriptServer::createEntitiesScriptEngine(bool drivesEntityTree) {
     auto engineName = QString("about:Entities %1").arg(++_entitiesScriptEngineCount);
     auto newEngine = scriptEngineFactory(ScriptEngine::ENTITY_SERVER_SCRIPT, NO_SCRIPT, engineName);
 
@@ -456,48 +467,105 @@ void EntityScriptServer::resetEntitiesScriptEngine() {
     connect(newEngine.data(), &ScriptEngine::warningMessage, scriptEngines, &ScriptEngines::onWarningMessage);
     connect(newEngine.data(), &ScriptEngine::infoMessage, scriptEngines, &ScriptEngines::onInfoMessage);
 
-    connect(newEngine.data(), &ScriptEngine::update, this, [this] {
-        _entityViewer.queryOctree();
-        _entityViewer.getTree()->preUpdate();
-        _entityViewer.getTree()->update();
-    });
+    // the tree is shared by the shards, only one of them updates it
+    if (drivesEntityTree) {
+        connect(newEngine.data(), &ScriptEngine::update, this, [this] {
+            _entityViewer.queryOctree();
+            _entityViewer.getTree()->preUpdate();
+            _entityViewer.getTree()->update();
+        });
+    }
 
     scriptEngines->runScriptInitializers(newEngine);
     newEngine->runInThread();
-    auto newEngineSP = qSharedPointerCast<EntitiesScriptEngineProvider>(newEngine);
-    DependencyManager::get<EntityScriptingInterface>()->setEntitiesScriptEngine(newEngineSP);
 
-    if (_entitiesScriptEngine) {
-        disconnect(_entitiesScriptEngine.data(), &ScriptEngine::entityScriptDetailsUpdated,
-                   this, &EntityScriptServer::updateEntityPPS);
+    connect(newEngine.data(), &ScriptEngine::entityScriptDetailsUpdated,
+            this, &EntityScriptServer::updateEntityPPS);
+
+    return newEngine;
+}
+
+void EntityScriptServer::resetEntitiesScriptEngines() {
+    std::vector<EntityScriptShardPointer> shards;
+    shards.reserve(_numShards);
+    for (int i = 0; i < _numShards; ++i) {
+        shards.push_back(std::make_shared<EntityScriptShard>(createEntitiesScriptEngine(i == 0)));
     }
 
-    _entitiesScriptEngine.swap(newEngine);
-    connect(_entitiesScriptEngine.data(), &ScriptEngine::entityScriptDetailsUpdated,
-            this, &EntityScriptServer::updateEntityPPS);
+    if (_shardRouter) {
+        for (const auto& shard : _shardRouter->getShards()) {
+            disconnect(shard->getEngine().data(), &ScriptEngine::entityScriptDetailsUpdated,
+                       this, &EntityScriptServer::updateEntityPPS);
+        }
+    }
+
+    _shardRouter = QSharedPointer<EntityScriptShardRouter>::create(std::move(shards));
+    DependencyManager::get<EntityScriptingInterface>()->setEntitiesScriptEngine(_shardRouter);
 }
 
+void EntityScriptServer::setNumShards(int numShards) {
+    static const int MAX_NUM_SHARDS = 64;
+    numShards = std::min(std::max(numShards, 1), MAX_NUM_SHARDS);
+    if (numShards == _numShards) {
+        return;
+    }
+
+    qCDebug(entity_script_server) << "Running entity scripts on" << numShards << "script engines, was" << _numShards;
+    _numShards = numShards;
+
+    if (!_shardRouter || _shuttingDown) {
+        return;
+    }
+
+    // an entity's shard depends on the number of shards, restart the running scripts on their new shards
+    QList<EntityItemID> entityIDs;
+    for (const auto& shard : _shardRouter->getShards()) {
+        const auto& engine = shard->getEngine();
+        entityIDs += engine->getListOfEntityScriptIDs();
+        engine->unloadAllEntityScripts();
+        engine->stop();
+        engine->waitTillDoneRunning();
+    }
+
+    resetEntitiesScriptEngines();
+
+    for (const auto& entityID : entityIDs) {
+        checkAndCallPreload(entityID);
+    }
+}
+
+ScriptEnginePointer EntityScriptServer::engineForEntity(const EntityItemID& entityID) const {
+    return _shardRouter ? _shardRouter->shardForEntity(entityID).getEngine() : ScriptEnginePointer();
+}
 
 void EntityScriptServer::clear() {
-    // unload and stop the engine
-    if (_entitiesScriptEngine) {
-        // do this here (instead of in deleter) to avoid marshalling unload signals back to this thread
-        _entitiesScriptEngine->unloadAllEntityScripts();
-        _entitiesScriptEngine->stop();
-        _entitiesScriptEngine->waitTillDoneRunning();
+    // unload and stop the engines
+    if (_shardRouter) {
+        for (const auto& shard : _shardRouter->getShards()) {
+            const auto& engine = shard->getEngine();
+            // do this here (instead of in deleter) to avoid marshalling unload signals back to this thread
+            engine->unloadAllEntityScripts();
+            engine->stop();
+        }
+        for (const auto& shard : _shardRouter->getShards()) {
+            shard->getEngine()->waitTillDoneRunning();
+        }
     }
 
     _entityViewer.clear();
 
-    // reset the engine
+    // reset the engines
     if (!_shuttingDown) {
-        resetEntitiesScriptEngine();
+        resetEntitiesScriptEngines();
     }
 }
 
 void EntityScriptServer::shutdownScriptEngine() {
-    if (_entitiesScriptEngine) {
-        _entitiesScriptEngine->disconnectNonEssentialSignals(); // disconnect all slots/signals from the script engine, except essential
+    if (_shardRouter) {
+        for (const auto& shard : _shardRouter->getShards()) {
+            // disconnect all slots/signals from the script engine, except essential
+            shard->getEngine()->disconnectNonEssentialSignals();
+        }
     }
     _shuttingDown = true;
 
@@ -506,11 +574,12 @@ void EntityScriptServer::shutdownScriptEngine() {
     auto scriptEngines = DependencyManager::get<ScriptEngines>();
     scriptEngines->shutdownScripting();
 
-    _entitiesScriptEngine.clear();
+    _shardRouter.clear();
 
     auto entityScriptingInterface = DependencyManager::get<EntityScriptingInterface>();
     // our entity tree is going to go away so tell that to the EntityScriptingInterface
     entityScriptingInterface->setEntityTree(nullptr);
+    entityScriptingInterface->setEntitiesScriptEngine(nullptr);
 
     // Should always be true as they are singletons.
     if (entityScriptingInterface->getPacketSender() == &_entityEditSender) {
@@ -524,8 +593,9 @@ void EntityScriptServer::addingEntity(const EntityItemID& entityID) {
 }
 
 void EntityScriptServer::deletingEntity(const EntityItemID& entityID) {
-    if (_entityViewer.getTree() && !_shuttingDown && _entitiesScriptEngine) {
-        _entitiesScriptEngine->unloadEntityScript(entityID, true);
+    auto engine = engineForEntity(entityID);
+    if (_entityViewer.getTree() && !_shuttingDown && engine) {
+        engine->unloadEntityScript(entityID, true);
     }
 }
 
@@ -536,20 +606,21 @@ void EntityScriptServer::entityServerScriptChanging(const EntityItemID& entityID
 }
 
 void EntityScriptServer::checkAndCallPreload(const EntityItemID& entityID, bool forceRedownload) {
-    if (_entityViewer.getTree() && !_shuttingDown && _entitiesScriptEngine) {
+    auto engine = engineForEntity(entityID);
+    if (_entityViewer.getTree() && !_shuttingDown && engine) {
 
         EntityItemPointer entity = _entityViewer.getTree()->findEntityByEntityItemID(entityID);
         EntityScriptDetails details;
-        bool isRunning = _entitiesScriptEngine->getEntityScriptDetails(entityID, details);
+        bool isRunning = engine->getEntityScriptDetails(entityID, details);
         if (entity && (forceRedownload || !isRunning || details.scriptText != entity->getServerScripts())) {
             if (isRunning) {
-                _entitiesScriptEngine->unloadEntityScript(entityID, true);
+                engine->unloadEntityScript(entityID, true);
             }
 
             QString scriptUrl = entity->getServerScripts();
             if (!scriptUrl.isEmpty()) {
                 scriptUrl = DependencyManager::get<ResourceManager>()->normalizeURL(scriptUrl);
-                _entitiesScriptEngine->loadEntityScript(entityID, scriptUrl, forceRedownload);
+                engine->loadEntityScript(entityID, scriptUrl, forceRedownload);
             }
         }
     }
@@ -566,11 +637,38 @@ void EntityScriptServer::sendStatsPacket() {
 
     QJsonObject scriptEngineStats;
     int numberRunningScripts = 0;
-    const auto scriptEngine = _entitiesScriptEngine;
-    if (scriptEngine) {
-        numberRunningScripts = scriptEngine->getNumRunningEntityScripts();
+
+    quint64 now = usecTimestampNow();
+    float elapsedUsecs = (_lastStatsTimestamp > 0) ? (float)(now - _lastStatsTimestamp) : 0.0f;
+    _lastStatsTimestamp = now;
+
+    QJsonObject shardsStats;
+    const auto shardRouter = _shardRouter;
+    if (shardRouter) {
+        const auto& shards = shardRouter->getShards();
+        for (size_t i = 0; i < shards.size(); ++i) {
+            auto stats = shards[i]->getStats();
+            numberRunningScripts += stats.numRunningScripts;
+
+            // CPU time is sampled on the engine's thread, it lags the other stats by a stats interval
+            QJsonObject shardStats;
+            shardStats["number_running_scripts"] = stats.numRunningScripts;
+            shardStats["queue_depth"] = stats.queueDepth;
+            shardStats["max_queue_depth"] = stats.maxQueueDepth;
+            shardStats["method_calls"] = (double)stats.numMethodCalls;
+            shardStats["method_usecs"] = (double)stats.methodUsecs;
+            shardStats["cpu_usecs"] = (double)stats.cpuUsecs;
+            if (elapsedUsecs > 0.0f) {
+                shardStats["cpu_percent"] = 100.0f * stats.cpuUsecs / elapsedUsecs;
+            }
+            shardsStats[QString("shard_%1").arg(i)] = shardStats;
+
+            shards[i]->sampleCpuTime();
+        }
     }
     scriptEngineStats["number_running_scripts"] = numberRunningScripts;
+    scriptEngineStats["number_script_engines"] = _numShards;
+    scriptEngineStats["script_engines"] = shardsStats;
     statsObject["script_engine_stats"] = scriptEngineStats;
     
 
@@ -613,7 +711,7 @@ void EntityScriptServer::handleOctreePacket(QSharedPointer<ReceivedMessage> mess
             // pull out the piggybacked packet and create a new QSharedPointer<NLPacket> for it
             int piggyBackedSizeWithHeader = message->getSize() - statsMessageLength;
 
-            auto buffer = std::unique_ptr<char[]>(new char[piggyBackedSizeWithHeader]);
+            auto buffer = udt::PacketBuffer(new char[piggyBackedSizeWithHeader]);
             memcpy(buffer.get(), message->getRawMessage() + statsMessageLength, piggyBackedSizeWithHeader);
 
             auto newPacket = NLPacket::fromReceivedPacket(std::move(buffer), piggyBackedSizeWithHeader, message->getSenderSockAddr());
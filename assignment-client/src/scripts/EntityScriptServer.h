@@ -24,6 +24,7 @@
 #include <SimpleEntitySimulation.h>
 #include <ThreadedAssignment.h>
 #include "../entities/EntityTreeHeadlessViewer.h"
+#include "EntityScriptShard.h"
 
 class EntityScriptServer : public ThreadedAssignment {
     Q_OBJECT
@@ -61,7 +62,10 @@ private:
     void negotiateAudioFormat();
     void selectAudioFormat(const QString& selectedCodecName);
 
-    void resetEntitiesScriptEngine();
+    void resetEntitiesScriptEngines();
+    ScriptEnginePointer createEntitiesScriptEngine(bool drivesEntityTree);
+    void setNumShards(int numShards);
+    ScriptEnginePointer engineForEntity(const EntityItemID& entityID) const;
     void clear();
     void shutdownScriptEngine();
 
@@ -75,7 +79,12 @@ private:
     bool _shuttingDown { false };
 
     static int _entitiesScriptEngineCount;
-    ScriptEnginePointer _entitiesScriptEngine;
+
+    // entity scripts are spread over the engines of the shards, see EntityScriptShardRouter
+    int _numShards { 1 };
+    QSharedPointer<EntityScriptShardRouter> _shardRouter;
+    quint64 _lastStatsTimestamp { 0 };
+
     SimpleEntitySimulationPointer _entitySimulation;
     EntityEditPacketSender _entityEditSender;
     EntityTreeHeadlessViewer _entityViewer;
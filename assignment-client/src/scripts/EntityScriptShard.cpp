@@ -0,0 +1,124 @@
+//
+//  EntityScriptShard.cpp
+//  assignment-client/src/scripts
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "EntityScriptShard.h"
+
+#include <algorithm>
+#include <assert.h>
+
+#ifdef Q_OS_WIN
+#include <Windows.h>
+#else
+#include <time.h>
+#endif
+
+#include <QtCore/QHash>
+#include <QtCore/QThread>
+
+#include <SharedUtil.h>
+
+// the CPU time used by the calling thread
+static quint64 currentThreadCpuUsecs() {
+#ifdef Q_OS_WIN
+    FILETIME creationTime, exitTime, kernelTime, userTime;
+    if (!GetThreadTimes(GetCurrentThread(), &creationTime, &exitTime, &kernelTime, &userTime)) {
+        return 0;
+    }
+    // FILETIMEs are in 100ns units
+    auto toUsecs = [](const FILETIME& time) {
+        return ((quint64)time.dwHighDateTime << 32 | time.dwLowDateTime) / 10;
+    };
+    return toUsecs(kernelTime) + toUsecs(userTime);
+#else
+    timespec time;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time) != 0) {
+        return 0;
+    }
+    return (quint64)time.tv_sec * USECS_PER_SECOND + time.tv_nsec / NSECS_PER_USEC;
+#endif
+}
+
+EntityScriptShard::EntityScriptShard(ScriptEnginePointer engine) :
+    _engine(engine),
+    _counters(std::make_shared<Counters>())
+{
+}
+
+void EntityScriptShard::callEntityScriptMethod(const EntityItemID& entityID, const QString& methodName,
+                                               const QStringList& params, const QUuid& remoteCallerID) {
+    if (QThread::currentThread() == _engine->thread()) {
+        // a script calling an entity of its own shard, run it now like a single engine did
+        _engine->callEntityScriptMethod(entityID, methodName, params, remoteCallerID);
+        return;
+    }
+
+    auto counters = _counters;
+    int queueDepth = ++counters->queueDepth;
+    int maxQueueDepth = counters->maxQueueDepth;
+    while (queueDepth > maxQueueDepth && !counters->maxQueueDepth.compare_exchange_weak(maxQueueDepth, queueDepth)) {
+    }
+
+    // the call only runs inside the engine, so it can't outlive it
+    ScriptEngine* engine = _engine.data();
+    engine->executeOnScriptThread([=] {
+        --counters->queueDepth;
+
+        quint64 start = usecTimestampNow();
+        engine->callEntityScriptMethod(entityID, methodName, params, remoteCallerID);
+        counters->methodUsecs += usecTimestampNow() - start;
+        ++counters->numMethodCalls;
+    });
+}
+
+void EntityScriptShard::sampleCpuTime() {
+    auto counters = _counters;
+    _engine->executeOnScriptThread([counters] {
+        counters->threadCpuUsecs = currentThreadCpuUsecs();
+    });
+}
+
+EntityScriptShard::Stats EntityScriptShard::getStats() {
+    Stats stats;
+    stats.numRunningScripts = _engine->getNumRunningEntityScripts();
+    stats.queueDepth = _counters->queueDepth;
+    stats.maxQueueDepth = _counters->maxQueueDepth.exchange(stats.queueDepth);
+    stats.numMethodCalls = _counters->numMethodCalls.exchange(0);
+    stats.methodUsecs = _counters->methodUsecs.exchange(0);
+
+    quint64 threadCpuUsecs = _counters->threadCpuUsecs;
+    stats.cpuUsecs = threadCpuUsecs - std::min(_lastThreadCpuUsecs, threadCpuUsecs);
+    _lastThreadCpuUsecs = threadCpuUsecs;
+
+    return stats;
+}
+
+size_t EntityScriptShardRouter::shardIndexForEntity(const EntityItemID& entityID, size_t numShards) {
+    // qHash is seeded with 0, so an entity gets the same shard every time
+    return numShards > 0 ? qHash(entityID) % numShards : 0;
+}
+
+EntityScriptShardRouter::EntityScriptShardRouter(std::vector<EntityScriptShardPointer> shards) :
+    _shards(std::move(shards))
+{
+    assert(!_shards.empty());
+}
+
+EntityScriptShard& EntityScriptShardRouter::shardForEntity(const EntityItemID& entityID) const {
+    return *_shards[shardIndexForEntity(entityID, _shards.size())];
+}
+
+void EntityScriptShardRouter::callEntityScriptMethod(const EntityItemID& entityID, const QString& methodName,
+                                                     const QStringList& params, const QUuid& remoteCallerID) {
+    shardForEntity(entityID).callEntityScriptMethod(entityID, methodName, params, remoteCallerID);
+}
+
+QFuture<QVariant> EntityScriptShardRouter::getLocalEntityScriptDetails(const EntityItemID& entityID) {
+    return shardForEntity(entityID).getEngine()->getLocalEntityScriptDetails(entityID);
+}
@@ -0,0 +1,86 @@
+//
+//  EntityScriptShard.h
+//  assignment-client/src/scripts
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_EntityScriptShard_h
+#define hifi_EntityScriptShard_h
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include <EntitiesScriptEngineProvider.h>
+#include <ScriptEngine.h>
+
+// EntityScriptShard is one of the script engines of the entity script server, each running on its own thread.
+//
+// Entity method calls are queued onto the engine's thread, the shard counts the calls that are waiting there and
+// the time spent running them.  The CPU time of the engine's thread is sampled on that thread, see sampleCpuTime().
+class EntityScriptShard {
+public:
+    struct Stats {
+        int numRunningScripts { 0 };
+        int queueDepth { 0 };
+        int maxQueueDepth { 0 };
+        quint64 numMethodCalls { 0 };
+        quint64 methodUsecs { 0 };
+        quint64 cpuUsecs { 0 }; // as of the last completed sample
+    };
+
+    EntityScriptShard(ScriptEnginePointer engine);
+
+    const ScriptEnginePointer& getEngine() const { return _engine; }
+
+    void callEntityScriptMethod(const EntityItemID& entityID, const QString& methodName,
+                                const QStringList& params, const QUuid& remoteCallerID);
+
+    // queues a read of the CPU time of the engine's thread, its result is in the following stats
+    void sampleCpuTime();
+
+    // returns the stats since the last call
+    Stats getStats();
+
+private:
+    struct Counters {
+        std::atomic<int> queueDepth { 0 };
+        std::atomic<int> maxQueueDepth { 0 };
+        std::atomic<quint64> numMethodCalls { 0 };
+        std::atomic<quint64> methodUsecs { 0 };
+        std::atomic<quint64> threadCpuUsecs { 0 };
+    };
+
+    ScriptEnginePointer _engine;
+
+    // shared with the calls queued on the engine's thread, which may outlive the shard
+    std::shared_ptr<Counters> _counters;
+    quint64 _lastThreadCpuUsecs { 0 };
+};
+
+using EntityScriptShardPointer = std::shared_ptr<EntityScriptShard>;
+
+// EntityScriptShardRouter sends what is asked of the entity scripts to the shard that runs the entity's script.
+// An entity's shard is picked by a hash of its ID, so it is the same for the life of the shards.
+class EntityScriptShardRouter : public EntitiesScriptEngineProvider {
+public:
+    static size_t shardIndexForEntity(const EntityItemID& entityID, size_t numShards);
+
+    EntityScriptShardRouter(std::vector<EntityScriptShardPointer> shards);
+
+    const std::vector<EntityScriptShardPointer>& getShards() const { return _shards; }
+    EntityScriptShard& shardForEntity(const EntityItemID& entityID) const;
+
+    void callEntityScriptMethod(const EntityItemID& entityID, const QString& methodName,
+                                const QStringList& params = QStringList(), const QUuid& remoteCallerID = QUuid()) override;
+    QFuture<QVariant> getLocalEntityScriptDetails(const EntityItemID& entityID) override;
+
+private:
+    const std::vector<EntityScriptShardPointer> _shards;
+};
+
+#endif // hifi_EntityScriptShard_h
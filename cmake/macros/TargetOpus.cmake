@@ -0,0 +1,13 @@
+#
+#  Copyright 2019 High Fidelity, Inc.
+#
+#  Distributed under the Apache License, Version 2.0.
+#  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+#
+macro(TARGET_OPUS)
+    target_include_directories(${TARGET_NAME} SYSTEM PRIVATE "${VCPKG_INSTALL_ROOT}/include")
+    find_library(OPUS_LIBRARY_DEBUG opus PATHS ${VCPKG_INSTALL_ROOT}/debug/lib/ NO_DEFAULT_PATH)
+    find_library(OPUS_LIBRARY_RELEASE opus PATHS ${VCPKG_INSTALL_ROOT}/lib/ NO_DEFAULT_PATH)
+    select_library_configurations(OPUS)
+    target_link_libraries(${TARGET_NAME} ${OPUS_LIBRARIES})
+endmacro()
@@ -312,8 +312,14 @@ void DomainGatekeeper::updateNodePermissions() {
             userPerms = setPermissionsForUser(isLocalUser, verifiedUsername, connectingAddr.getAddress(), hardwareAddress, machineFingerprint);
         }
 
+        bool permissionsChanged = node->getPermissions().permissions != userPerms.permissions;
         node->setPermissions(userPerms);
 
+        if (permissionsChanged) {
+            // the permissions are part of what other nodes get in the domain list
+            _server->flagNodeChangedInDomainList(node);
+        }
+
         if (!userPerms.can(NodePermissions::Permission::canConnectToDomain)) {
             qDebug() << "node" << node->getUUID() << "no longer has permission to connect.";
             // hang up on this node
@@ -1072,8 +1072,12 @@ void DomainServer::processListRequestPacket(QSharedPointer<ReceivedMessage> mess
     NodeConnectionData nodeRequestData = NodeConnectionData::fromDataStream(packetStream, message->getSenderSockAddr(), false);
 
     // update this node's sockets in case they have changed
-    sendingNode->setPublicSocket(nodeRequestData.publicSockAddr);
-    sendingNode->setLocalSocket(nodeRequestData.localSockAddr);
+    if (sendingNode->getPublicSocket() != nodeRequestData.publicSockAddr ||
+        sendingNode->getLocalSocket() != nodeRequestData.localSockAddr) {
+        sendingNode->setPublicSocket(nodeRequestData.publicSockAddr);
+        sendingNode->setLocalSocket(nodeRequestData.localSockAddr);
+        flagNodeChangedInDomainList(sendingNode);
+    }
 
     DomainServerNodeData* nodeData = static_cast<DomainServerNodeData*>(sendingNode->getLinkedData());
 
@@ -1091,7 +1095,12 @@ void DomainServer::processListRequestPacket(QSharedPointer<ReceivedMessage> mess
     }
 
     // update the NodeInterestSet in case there have been any changes
-    nodeData->setNodeInterestSet(safeInterestSet);
+    if (safeInterestSet != nodeData->getNodeInterestSet()) {
+        nodeData->setNodeInterestSet(safeInterestSet);
+
+        // the nodes newly of interest may be older than the node's last domain list, resync it
+        nodeData->setNodeInterestSetGeneration(++_domainListGeneration);
+    }
 
     // update the connecting hostname in case it has changed
     nodeData->setPlaceName(nodeRequestData.placeName);
@@ -1099,7 +1108,8 @@ void DomainServer::processListRequestPacket(QSharedPointer<ReceivedMessage> mess
     // client-side send time of last connect/domain list request
     nodeData->setLastDomainCheckinTimestamp(nodeRequestData.lastPingTimestamp);
 
-    sendDomainListToNode(sendingNode, message->getFirstPacketReceiveTime(), message->getSenderSockAddr(), false);
+    sendDomainListToNode(sendingNode, message->getFirstPacketReceiveTime(), message->getSenderSockAddr(), false,
+                         nodeRequestData.domainListVersion);
 }
 
 bool DomainServer::isInInterestSet(const SharedNodePointer& nodeA, const SharedNodePointer& nodeB) {
@@ -1177,11 +1187,15 @@ void DomainServer::handleConnectedNode(SharedNodePointer newNode, quint64 reques
         newNode->setIsReplicated(true);
     }
 
+    // deltas from here on include this node
+    flagNodeChangedInDomainList(newNode);
+
     // send out this node to our other connected nodes
     broadcastNewNode(newNode);
 }
 
-void DomainServer::sendDomainListToNode(const SharedNodePointer& node, quint64 requestPacketReceiveTime, const HifiSockAddr &senderSockAddr, bool newConnection) {
+void DomainServer::sendDomainListToNode(const SharedNodePointer& node, quint64 requestPacketReceiveTime, const HifiSockAddr &senderSockAddr,
+                                        bool newConnection, quint64 acknowledgedDomainListVersion) {
     const int NUM_DOMAIN_LIST_EXTENDED_HEADER_BYTES = NUM_BYTES_RFC4122_UUID + NLPacket::NUM_BYTES_LOCALID +
         NUM_BYTES_RFC4122_UUID + NLPacket::NUM_BYTES_LOCALID + 4;
 
@@ -1192,6 +1206,10 @@ void DomainServer::sendDomainListToNode(const SharedNodePointer& node, quint64 r
     DomainServerNodeData* nodeData = static_cast<DomainServerNodeData*>(node->getLinkedData());
     auto limitedNodeList = DependencyManager::get<LimitedNodeList>();
 
+    // a node that has acknowledged a recent enough domain list only gets what changed since,
+    // anything else gets every node in its interest set
+    bool isDelta = !newConnection && canSendDomainListDelta(nodeData, acknowledgedDomainListVersion);
+
     extendedHeaderStream << limitedNodeList->getSessionUUID();
     extendedHeaderStream << limitedNodeList->getSessionLocalID();
     extendedHeaderStream << node->getUUID();
@@ -1202,6 +1220,9 @@ void DomainServer::sendDomainListToNode(const SharedNodePointer& node, quint64 r
     extendedHeaderStream << quint64(duration_cast<microseconds>(system_clock::now().time_since_epoch()).count());
     extendedHeaderStream << quint64(duration_cast<microseconds>(p_high_resolution_clock::now().time_since_epoch()).count()) - requestPacketReceiveTime;
     extendedHeaderStream << newConnection;
+    extendedHeaderStream << _domainListGeneration;
+    extendedHeaderStream << isDelta;
+    extendedHeaderStream << (isDelta ? acknowledgedDomainListVersion : quint64(0));
     auto domainListPackets = NLPacketList::create(PacketType::DomainList, extendedHeader);
 
     // always send the node their own UUID back
@@ -1210,12 +1231,44 @@ void DomainServer::sendDomainListToNode(const SharedNodePointer& node, quint64 r
     // store the nodeInterestSet on this DomainServerNodeData, in case it has changed
     auto& nodeInterestSet = nodeData->getNodeInterestSet();
 
+    if (isDelta) {
+        // the nodes removed since the acknowledged list come first, those that have come back since are re-added below
+        QList<QUuid> removedNodes;
+        for (auto it = _removedDomainListNodes.rbegin();
+             it != _removedDomainListNodes.rend() && it->generation > acknowledgedDomainListVersion; ++it) {
+            if (nodeInterestSet.contains(it->type) && !limitedNodeList->nodeWithUUID(it->uuid)) {
+                removedNodes.push_back(it->uuid);
+            }
+        }
+
+        domainListPackets->startSegment();
+        domainListStream << quint32(removedNodes.size());
+        domainListPackets->endSegment();
+
+        for (const auto& removedNode : removedNodes) {
+            domainListPackets->startSegment();
+            domainListStream << removedNode;
+            domainListPackets->endSegment();
+        }
+    }
+
     if (nodeInterestSet.size() > 0) {
 
         // DTLSServerSession* dtlsSession = _isUsingDTLS ? _dtlsSessions[senderSockAddr] : NULL;
         if (nodeData->isAuthenticated()) {
             // if this authenticated node has any interest types, send back those nodes as well
-            limitedNodeList->eachNode([this, node, &domainListPackets, &domainListStream](const SharedNodePointer& otherNode) {
+            limitedNodeList->eachNode([this, node, isDelta, acknowledgedDomainListVersion, &domainListPackets,
+                                       &domainListStream](const SharedNodePointer& otherNode) {
+                if (isDelta) {
+                    // skip the nodes that haven't changed since the acknowledged list
+                    // (nodes that haven't connected yet have no generation, they are always sent)
+                    auto otherNodeData = static_cast<DomainServerNodeData*>(otherNode->getLinkedData());
+                    quint64 otherNodeGeneration = otherNodeData ? otherNodeData->getDomainListGeneration() : 0;
+                    if (otherNodeGeneration != 0 && otherNodeGeneration <= acknowledgedDomainListVersion) {
+                        return;
+                    }
+                }
+
                 if (otherNode->getUUID() != node->getUUID() && isInInterestSet(node, otherNode)) {
                     // since we're about to add a node to the packet we start a segment
                     domainListPackets->startSegment();
@@ -1236,10 +1289,53 @@ void DomainServer::sendDomainListToNode(const SharedNodePointer& node, quint64 r
     // send an empty list to the node, in case there were no other nodes
     domainListPackets->closeCurrentPacket(true);
 
+    int domainListBytes = (int)domainListPackets->getDataSize();
+    nodeData->setLastDomainListBytes(domainListBytes);
+    ++_numDomainListCheckIns;
+    if (isDelta) {
+        ++_numDeltaDomainLists;
+    } else {
+        ++_numFullDomainLists;
+    }
+    _domainListBytesSent += domainListBytes;
+
     // write the PacketList to this node
     limitedNodeList->sendPacketList(std::move(domainListPackets), *node);
 }
 
+void DomainServer::flagNodeChangedInDomainList(const SharedNodePointer& node) {
+    auto nodeData = static_cast<DomainServerNodeData*>(node->getLinkedData());
+    if (nodeData) {
+        nodeData->setDomainListGeneration(++_domainListGeneration);
+    }
+}
+
+bool DomainServer::canSendDomainListDelta(DomainServerNodeData* nodeData, quint64 acknowledgedDomainListVersion) const {
+    // 0 means the node has no list (or has thrown away nodes from it), a version ahead of ours is from before a restart
+    if (acknowledgedDomainListVersion == 0 || acknowledgedDomainListVersion > _domainListGeneration) {
+        return false;
+    }
+
+    // the removals since the acknowledged list must still be known
+    if (acknowledgedDomainListVersion < _oldestDomainListDeltaGeneration) {
+        return false;
+    }
+
+    return acknowledgedDomainListVersion >= nodeData->getNodeInterestSetGeneration();
+}
+
+QJsonObject DomainServer::domainListStatsJSON() const {
+    QJsonObject statsJSON;
+    statsJSON["generation"] = (double)_domainListGeneration;
+    statsJSON["check_ins"] = (double)_numDomainListCheckIns;
+    statsJSON["full_lists"] = (double)_numFullDomainLists;
+    statsJSON["delta_lists"] = (double)_numDeltaDomainLists;
+    statsJSON["bytes_sent"] = (double)_domainListBytesSent;
+    statsJSON["bytes_per_check_in"] = _numDomainListCheckIns > 0 ?
+        (double)_domainListBytesSent / (double)_numDomainListCheckIns : 0.0;
+    return statsJSON;
+}
+
 QUuid DomainServer::connectionSecretForNodes(const SharedNodePointer& nodeA, const SharedNodePointer& nodeB) {
     DomainServerNodeData* nodeAData = static_cast<DomainServerNodeData*>(nodeA->getLinkedData());
     DomainServerNodeData* nodeBData = static_cast<DomainServerNodeData*>(nodeB->getLinkedData());
@@ -1882,6 +1978,7 @@ const char JSON_KEY_PENDING_CREDITS[] = "pending_credits";
 const char JSON_KEY_UPTIME[] = "uptime";
 const char JSON_KEY_USERNAME[] = "username";
 const char JSON_KEY_VERSION[] = "version";
+const char JSON_KEY_DOMAIN_LIST_BYTES[] = "domain_list_bytes";
 QJsonObject DomainServer::jsonObjectForNode(const SharedNodePointer& node) {
     QJsonObject nodeJson;
 
@@ -1909,6 +2006,7 @@ QJsonObject DomainServer::jsonObjectForNode(const SharedNodePointer& node) {
     // add the node username, if it exists
     nodeJson[JSON_KEY_USERNAME] = nodeData->getUsername();
     nodeJson[JSON_KEY_VERSION] = nodeData->getNodeVersion();
+    nodeJson[JSON_KEY_DOMAIN_LIST_BYTES] = nodeData->getLastDomainListBytes();
 
     SharedAssignmentPointer matchingAssignment = _allAssignments.value(nodeData->getAssignmentUUID());
     if (matchingAssignment) {
@@ -2160,6 +2258,7 @@ bool DomainServer::handleHTTPRequest(HTTPConnection* connection, const QUrl& url
             });
 
             rootJSON["nodes"] = nodesJSONArray;
+            rootJSON["domain_list"] = domainListStatsJSON();
 
             // print out the created JSON
             QJsonDocument nodesDocument(rootJSON);
@@ -3065,7 +3164,10 @@ void DomainServer::updateReplicatedNodes() {
                 qDebug() << "Setting node to replicated:"
                     << otherNode->getPermissions().getVerifiedUserName() << otherNode->getUUID();
             }
-            otherNode->setIsReplicated(shouldReplicate);
+            if (isReplicated != shouldReplicate) {
+                otherNode->setIsReplicated(shouldReplicate);
+                flagNodeChangedInDomainList(otherNode);
+            }
         }
     );
 }
@@ -3130,6 +3232,14 @@ void DomainServer::nodeKilled(SharedNodePointer node) {
         }
     }
 
+    // remember the removal for the delta domain lists, as long as they are likely to be needed
+    static const size_t MAX_REMOVED_DOMAIN_LIST_NODES = 1024;
+    _removedDomainListNodes.push_back({ ++_domainListGeneration, node->getUUID(), node->getType() });
+    if (_removedDomainListNodes.size() > MAX_REMOVED_DOMAIN_LIST_NODES) {
+        _oldestDomainListDeltaGeneration = _removedDomainListNodes.front().generation;
+        _removedDomainListNodes.pop_front();
+    }
+
     broadcastNodeDisconnect(node);
 }
 
@@ -12,6 +12,8 @@
 #ifndef hifi_DomainServer_h
 #define hifi_DomainServer_h
 
+#include <deque>
+
 #include <QtCore/QCoreApplication>
 #include <QtCore/QHash>
 #include <QtCore/QJsonObject>
@@ -50,6 +52,8 @@ using SubnetList = std::vector<Subnet>;
 
 const int INVALID_ICE_LOOKUP_ID = -1;
 
+class DomainServerNodeData;
+
 enum ReplicationServerDirection {
     Upstream,
     Downstream
@@ -181,7 +185,13 @@ private:
     void handleKillNode(SharedNodePointer nodeToKill);
     void broadcastNodeDisconnect(const SharedNodePointer& disconnnectedNode);
 
-    void sendDomainListToNode(const SharedNodePointer& node, quint64 requestPacketReceiveTime, const HifiSockAddr& senderSockAddr, bool newConnection);
+    void sendDomainListToNode(const SharedNodePointer& node, quint64 requestPacketReceiveTime, const HifiSockAddr& senderSockAddr,
+                              bool newConnection, quint64 acknowledgedDomainListVersion = 0);
+
+    // stamps node with a new domain list generation, so that it is part of the next delta domain lists
+    void flagNodeChangedInDomainList(const SharedNodePointer& node);
+    bool canSendDomainListDelta(DomainServerNodeData* nodeData, quint64 acknowledgedDomainListVersion) const;
+    QJsonObject domainListStatsJSON() const;
 
     bool isInInterestSet(const SharedNodePointer& nodeA, const SharedNodePointer& nodeB);
 
@@ -300,6 +310,24 @@ private:
     std::unordered_map<int, std::unique_ptr<QTemporaryFile>> _pendingContentFiles;
 
     QThread _assetClientThread;
+
+    struct RemovedDomainListNode {
+        quint64 generation;
+        QUuid uuid;
+        NodeType_t type;
+    };
+
+    // the generation of the domain list, bumped each time a node is added, changed or removed
+    quint64 _domainListGeneration { 1 };
+    // the removals that delta domain lists can still include, oldest first
+    std::deque<RemovedDomainListNode> _removedDomainListNodes;
+    // deltas can only be sent to nodes that received a list from this generation on
+    quint64 _oldestDomainListDeltaGeneration { 1 };
+
+    quint64 _numDomainListCheckIns { 0 };
+    quint64 _numFullDomainLists { 0 };
+    quint64 _numDeltaDomainLists { 0 };
+    quint64 _domainListBytesSent { 0 };
 };
 
 
@@ -75,6 +75,17 @@ public:
 
     bool hasCheckedIn() const { return _hasCheckedIn; }
     void setHasCheckedIn(bool hasCheckedIn) { _hasCheckedIn = hasCheckedIn; }
+
+    // the domain list generation at which this node last changed as other nodes see it, 0 until it has connected
+    quint64 getDomainListGeneration() const { return _domainListGeneration; }
+    void setDomainListGeneration(quint64 domainListGeneration) { _domainListGeneration = domainListGeneration; }
+
+    // the domain list generation at which this node's interest set last changed, older lists can't be updated with a delta
+    quint64 getNodeInterestSetGeneration() const { return _nodeInterestSetGeneration; }
+    void setNodeInterestSetGeneration(quint64 generation) { _nodeInterestSetGeneration = generation; }
+
+    int getLastDomainListBytes() const { return _lastDomainListBytes; }
+    void setLastDomainListBytes(int lastDomainListBytes) { _lastDomainListBytes = lastDomainListBytes; }
     
 private:
     QJsonObject overrideValuesIfNeeded(const QJsonObject& newStats);
@@ -102,6 +113,10 @@ private:
     bool _wasAssigned { false };
 
     bool _hasCheckedIn { false };
+
+    quint64 _domainListGeneration { 0 };
+    quint64 _nodeInterestSetGeneration { 0 };
+    int _lastDomainListBytes { 0 };
 };
 
 #endif // hifi_DomainServerNodeData_h
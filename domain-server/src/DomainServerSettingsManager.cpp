@@ -526,6 +526,21 @@ void DomainServerSettingsManager::setupConfigMap(const QString& userConfigFilena
             *newAdminRoles = adminRoles;
         }
 
+        if (oldVersion < 2.5) {
+            // prefer the opus codec, which is new, in a codec preference order that was set before it existed
+            const QString CODEC_PREFERENCE_ORDER_KEYPATH = "audio_env.codec_preference_order";
+            const QString OPUS_CODEC_NAME = "opus";
+
+            QVariant* codecPreferenceOrder = _configMap.valueForKeyPath(CODEC_PREFERENCE_ORDER_KEYPATH);
+            if (codecPreferenceOrder) {
+                QStringList codecs = codecPreferenceOrder->toString().split(",", QString::SkipEmptyParts);
+                if (!codecs.contains(OPUS_CODEC_NAME)) {
+                    codecs.prepend(OPUS_CODEC_NAME);
+                    *codecPreferenceOrder = codecs.join(",");
+                }
+            }
+        }
+
 
         // write the current description version to our settings
         *versionVariant = _descriptionVersion;
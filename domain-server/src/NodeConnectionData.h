@@ -35,6 +35,7 @@ public:
     quint32 connectReason;
     quint64 previousConnectionUpTime;
     QByteArray protocolVersion;
+    quint64 domainListVersion { 0 }; // version of the last domain list the node received, only in list requests
 };
 
 
@@ -147,6 +147,14 @@ Item {
                                     "Parabolas:\t" + root.parabolaPicksUpdated.x + "/" + root.parabolaPicksUpdated.y + "/" + root.parabolaPicksUpdated.z + "\n    " +
                                     "Colliders:\t" + root.collisionPicksUpdated.x + "/" + root.collisionPicksUpdated.y + "/" + root.collisionPicksUpdated.z
                     }
+                    StatText {
+                        visible: root.expanded
+                        text: "Pick time:\n    " +
+                                    "Styluses:\t" + root.stylusPicksTime.toFixed(2) + " ms\n    " +
+                                    "Rays:\t" + root.rayPicksTime.toFixed(2) + " ms\n    " +
+                                    "Parabolas:\t" + root.parabolaPicksTime.toFixed(2) + " ms\n    " +
+                                    "Colliders:\t" + root.collisionPicksTime.toFixed(2) + " ms"
+                    }
                     StatText {
                         visible: { root.eventQueueDebuggingOn && root.expanded }
                         text: { if (root.eventQueueDebuggingOn) {
@@ -25,16 +25,16 @@ PickRay RayPick::getMathematicalPick() const {
     return PickRay(origin, direction);
 }
 
-PickResultPointer RayPick::getEntityIntersection(const PickRay& pick) {
+PickFilter RayPick::getEntitySearchFilter() const {
     PickFilter searchFilter = getFilter();
     if (DependencyManager::get<PickManager>()->getForceCoarsePicking()) {
         searchFilter.setFlag(PickFilter::COARSE, true);
         searchFilter.setFlag(PickFilter::PRECISE, false);
     }
+    return searchFilter;
+}
 
-    RayToEntityIntersectionResult entityRes =
-        DependencyManager::get<EntityScriptingInterface>()->evalRayIntersectionVector(pick, searchFilter,
-            getIncludeItemsAs<EntityItemID>(), getIgnoreItemsAs<EntityItemID>());
+PickResultPointer RayPick::getEntityResult(const RayToEntityIntersectionResult& entityRes, const PickRay& pick) const {
     if (entityRes.intersects) {
         IntersectionType type = IntersectionType::ENTITY;
         if (getFilter().doesPickLocalEntities()) {
@@ -50,6 +50,36 @@ PickResultPointer RayPick::getEntityIntersection(const PickRay& pick) {
     }
 }
 
+PickResultPointer RayPick::getEntityIntersection(const PickRay& pick) {
+    RayToEntityIntersectionResult entityRes =
+        DependencyManager::get<EntityScriptingInterface>()->evalRayIntersectionVector(pick, getEntitySearchFilter(),
+            getIncludeItemsAs<EntityItemID>(), getIgnoreItemsAs<EntityItemID>());
+    return getEntityResult(entityRes, pick);
+}
+
+std::vector<PickResultPointer> RayPick::getEntityIntersections(const std::vector<std::shared_ptr<Pick<PickRay>>>& picks,
+        const std::vector<PickRay>& mathPicks) {
+    // every ray of the batch is found in one walk of the entity tree
+    std::vector<EntityRayQuery> queries(picks.size());
+    for (size_t i = 0; i < picks.size(); ++i) {
+        auto rayPick = std::static_pointer_cast<RayPick>(picks[i]);
+        queries[i].ray = mathPicks[i];
+        queries[i].searchFilter = rayPick->getEntitySearchFilter();
+        queries[i].entityIdsToInclude = rayPick->getIncludeItemsAs<EntityItemID>();
+        queries[i].entityIdsToDiscard = rayPick->getIgnoreItemsAs<EntityItemID>();
+    }
+
+    std::vector<RayToEntityIntersectionResult> entityResults =
+        DependencyManager::get<EntityScriptingInterface>()->evalRayIntersectionVectors(queries);
+
+    std::vector<PickResultPointer> results;
+    results.reserve(picks.size());
+    for (size_t i = 0; i < picks.size(); ++i) {
+        results.push_back(std::static_pointer_cast<RayPick>(picks[i])->getEntityResult(entityResults[i], mathPicks[i]));
+    }
+    return results;
+}
+
 PickResultPointer RayPick::getAvatarIntersection(const PickRay& pick) {
     bool precisionPicking = !(getFilter().isCoarse() || DependencyManager::get<PickManager>()->getForceCoarsePicking());
     RayToAvatarIntersectionResult avatarRes = DependencyManager::get<AvatarManager>()->findRayIntersectionVector(pick, getIncludeItemsAs<EntityItemID>(), getIgnoreItemsAs<EntityItemID>(), precisionPicking);
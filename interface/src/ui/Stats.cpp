@@ -173,6 +173,11 @@ void Stats::updateStats(bool force) {
         STAT_UPDATE(rayPicksUpdated, updatedPicks[PickQuery::Ray]);
         STAT_UPDATE(parabolaPicksUpdated, updatedPicks[PickQuery::Parabola]);
         STAT_UPDATE(collisionPicksUpdated, updatedPicks[PickQuery::Collision]);
+        std::vector<quint64> pickUsecs = pickManager->getUpdatedPickUsecs();
+        STAT_UPDATE_FLOAT(stylusPicksTime, (float)pickUsecs[PickQuery::Stylus] / USECS_PER_MSEC, 0.01f);
+        STAT_UPDATE_FLOAT(rayPicksTime, (float)pickUsecs[PickQuery::Ray] / USECS_PER_MSEC, 0.01f);
+        STAT_UPDATE_FLOAT(parabolaPicksTime, (float)pickUsecs[PickQuery::Parabola] / USECS_PER_MSEC, 0.01f);
+        STAT_UPDATE_FLOAT(collisionPicksTime, (float)pickUsecs[PickQuery::Collision] / USECS_PER_MSEC, 0.01f);
     }
 
     STAT_UPDATE(packetInCount, nodeList->getInboundPPS());
@@ -376,6 +376,18 @@ private: \
  *     </ul>
  *     <em>Read-only.</em>
  *     <p><strong>Note:</strong> Property not available in the API.</p>
+ * @property {number} stylusPicksTime - The time spent updating stylus picks in the most recent game loop, in ms.
+ *     <em>Read-only.</em>
+ *     <p><strong>Note:</strong> Property not available in the API.</p>
+ * @property {number} rayPicksTime - The time spent updating ray picks in the most recent game loop, in ms.
+ *     <em>Read-only.</em>
+ *     <p><strong>Note:</strong> Property not available in the API.</p>
+ * @property {number} parabolaPicksTime - The time spent updating parabola picks in the most recent game loop, in ms.
+ *     <em>Read-only.</em>
+ *     <p><strong>Note:</strong> Property not available in the API.</p>
+ * @property {number} collisionPicksTime - The time spent updating collision picks in the most recent game loop, in ms.
+ *     <em>Read-only.</em>
+ *     <p><strong>Note:</strong> Property not available in the API.</p>
  *
  * @property {boolean} eventQueueDebuggingOn - <code>true</code> if event queue statistics are provided, <code>false</code> if
  *     they're not.
@@ -584,6 +596,10 @@ class Stats : public QQuickItem {
     STATS_PROPERTY(QVector3D, rayPicksUpdated, QVector3D(0, 0, 0))
     STATS_PROPERTY(QVector3D, parabolaPicksUpdated, QVector3D(0, 0, 0))
     STATS_PROPERTY(QVector3D, collisionPicksUpdated, QVector3D(0, 0, 0))
+    STATS_PROPERTY(float, stylusPicksTime, 0)
+    STATS_PROPERTY(float, rayPicksTime, 0)
+    STATS_PROPERTY(float, parabolaPicksTime, 0)
+    STATS_PROPERTY(float, collisionPicksTime, 0)
 
     STATS_PROPERTY(int, mainThreadQueueDepth, -1);
     STATS_PROPERTY(int, nodeListThreadQueueDepth, -1);
@@ -1484,6 +1500,34 @@ signals:
      */
     void collisionPicksUpdatedChanged();
 
+    /**jsdoc
+     * Triggered when the value of the <code>stylusPicksTime</code> property changes.
+     * @function Stats.stylusPicksTimeChanged
+     * @returns {Signal}
+     */
+    void stylusPicksTimeChanged();
+
+    /**jsdoc
+     * Triggered when the value of the <code>rayPicksTime</code> property changes.
+     * @function Stats.rayPicksTimeChanged
+     * @returns {Signal}
+     */
+    void rayPicksTimeChanged();
+
+    /**jsdoc
+     * Triggered when the value of the <code>parabolaPicksTime</code> property changes.
+     * @function Stats.parabolaPicksTimeChanged
+     * @returns {Signal}
+     */
+    void parabolaPicksTimeChanged();
+
+    /**jsdoc
+     * Triggered when the value of the <code>collisionPicksTime</code> property changes.
+     * @function Stats.collisionPicksTimeChanged
+     * @returns {Signal}
+     */
+    void collisionPicksTimeChanged();
+
     /**jsdoc
      * Triggered when the value of the <code>mainThreadQueueDepth</code> property changes.
      * @function Stats.mainThreadQueueDepthChanged
@@ -89,9 +89,14 @@ void bakeAbsoluteDeltaAnim(std::vector<AnimPoseVec>& anim, const AnimPoseVec& ba
     }
 }
 
-static std::vector<AnimPoseVec> copyAndRetargetFromNetworkAnim(AnimationPointer networkAnim, AnimSkeleton::ConstPointer avatarSkeleton) {
+// retargets only the key frames of the animation's clip, the frames in between are interpolated from them when sampled
+static std::vector<AnimPoseVec> copyAndRetargetKeyFramesFromNetworkAnim(AnimationPointer networkAnim, AnimSkeleton::ConstPointer avatarSkeleton) {
     ASSERT(networkAnim && networkAnim->isLoaded() && avatarSkeleton);
     std::vector<AnimPoseVec> anim;
+    AnimCompressedClip::ConstPointer animClip = networkAnim->getClip();
+    if (!animClip) {
+        return anim;
+    }
 
     const HFMModel& animModel = networkAnim->getHFMModel();
     AnimSkeleton animSkeleton(animModel);
@@ -101,9 +106,15 @@ static std::vector<AnimPoseVec> copyAndRetargetFromNetworkAnim(AnimationPointer
     // build a mapping from animation joint indices to avatar joint indices by matching joints with the same name.
     std::vector<int> avatarToAnimJointIndexMap = buildJointIndexMap(animSkeleton, *avatarSkeleton);
 
-    const int animFrameCount = animModel.animationFrames.size();
+    const int animFrameCount = (int)animClip->getKeyFrames().size();
     anim.resize(animFrameCount);
 
+    AnimPoseVec animPoses;
+    AnimPoseVec animZeroPoses;
+    if (animFrameCount > 0) {
+        animClip->decodeKeyFrame(0, animZeroPoses);
+    }
+
     // find the size scale factor for translation in the animation.
     float boneLengthScale = 1.0f;
     const int avatarHipsIndex = avatarSkeleton->nameToJointIndex("Hips");
@@ -145,16 +156,14 @@ static std::vector<AnimPoseVec> copyAndRetargetFromNetworkAnim(AnimationPointer
     }
 
     for (int frame = 0; frame < animFrameCount; frame++) {
-        const HFMAnimationFrame& animFrame = animModel.animationFrames[frame];
-        ASSERT(frame >= 0 && frame < (int)animModel.animationFrames.size());
+        animClip->decodeKeyFrame(frame, animPoses);
 
-        // extract the full rotations from the animFrame (including pre and post rotations from the animModel).
+        // the full rotations of the key frame (the clip includes the pre and post rotations from the animModel).
         std::vector<glm::quat> animRotations;
         animRotations.reserve(animJointCount);
         for (int i = 0; i < animJointCount; i++) {
-            ASSERT(i >= 0 && i < (int)animModel.joints.size());
-            ASSERT(i >= 0 && i < (int)animFrame.rotations.size());
-            animRotations.push_back(animModel.joints[i].preRotation * animFrame.rotations[i] * animModel.joints[i].postRotation);
+            ASSERT(i >= 0 && i < (int)animPoses.size());
+            animRotations.push_back(animPoses[i].rot());
         }
 
         // convert rotations into absolute frame
@@ -201,12 +210,12 @@ static std::vector<AnimPoseVec> copyAndRetargetFromNetworkAnim(AnimationPointer
             int animJointIndex = avatarToAnimJointIndexMap[avatarJointIndex];
             if (animJointIndex >= 0) {
                 // This joint is in both animation and avatar.
-                ASSERT(animJointIndex >= 0 && animJointIndex < (int)animFrame.translations.size());
-                const glm::vec3& animTrans = animFrame.translations[animJointIndex];
+                ASSERT(animJointIndex >= 0 && animJointIndex < (int)animPoses.size());
+                const glm::vec3& animTrans = animPoses[animJointIndex].trans();
 
                 // retarget translation from animation to avatar
-                ASSERT(animJointIndex >= 0 && animJointIndex < (int)animModel.animationFrames[0].translations.size());
-                const glm::vec3& animZeroTrans = animModel.animationFrames[0].translations[animJointIndex];
+                ASSERT(animJointIndex >= 0 && animJointIndex < (int)animZeroPoses.size());
+                const glm::vec3& animZeroTrans = animZeroPoses[animJointIndex].trans();
                 relativeTranslation = avatarDefaultPose.trans() + boneLengthScale * (animTrans - animZeroTrans);
             } else {
                 // This joint is NOT in the animation at all.
@@ -223,6 +232,15 @@ static std::vector<AnimPoseVec> copyAndRetargetFromNetworkAnim(AnimationPointer
     return anim;
 }
 
+static AnimCompressedClip copyAndRetargetFromNetworkAnim(AnimationPointer networkAnim, AnimSkeleton::ConstPointer avatarSkeleton) {
+    AnimCompressedClip::ConstPointer animClip = networkAnim->getClip();
+    if (!animClip) {
+        return AnimCompressedClip();
+    }
+    return AnimCompressedClip(animClip->getNumFrames(), animClip->getKeyFrames(),
+                              copyAndRetargetKeyFramesFromNetworkAnim(networkAnim, avatarSkeleton));
+}
+
 AnimClip::AnimClip(const QString& id, const QString& url, float startFrame, float endFrame, float timeScale, bool loopFlag, bool mirrorFlag,
                    AnimBlendType blendType, const QString& baseURL, float baseFrame) :
     AnimNode(AnimNode::Type::Clip, id),
@@ -270,41 +288,48 @@ const AnimPoseVec& AnimClip::evaluate(const AnimVariantMap& animVars, const Anim
             _networkAnim.reset();
 
             // mirrorAnim will be re-built on demand, if needed.
-            _mirrorAnim.clear();
+            _mirrorAnim = AnimCompressedClip();
 
             _poses.resize(_skeleton->getNumJoints());
         }
     } else {
         // an additive blend type
         if (_networkAnim && _networkAnim->isLoaded() && _baseNetworkAnim && _baseNetworkAnim->isLoaded() && _skeleton) {
-            // loading is complete, copy & retarget animation.
-            _anim = copyAndRetargetFromNetworkAnim(_networkAnim, _skeleton);
+            // loading is complete, copy & retarget animation, baking the base pose into the key frames before they are compressed.
+            std::vector<AnimPoseVec> keyPoses = copyAndRetargetKeyFramesFromNetworkAnim(_networkAnim, _skeleton);
+            AnimCompressedClip::ConstPointer animClip = _networkAnim->getClip();
 
             // we no longer need the actual animation resource anymore.
             _networkAnim.reset();
 
             // mirrorAnim will be re-built on demand, if needed.
             // TODO: handle mirrored relative animations.
-            _mirrorAnim.clear();
+            _mirrorAnim = AnimCompressedClip();
 
             _poses.resize(_skeleton->getNumJoints());
 
             // copy & retarget baseAnim!
             auto baseAnim = copyAndRetargetFromNetworkAnim(_baseNetworkAnim, _skeleton);
+            AnimPoseVec basePoses;
+            baseAnim.sample((float)(int)_baseFrame, basePoses);
 
             if (_blendType == AnimBlendType_AddAbsolute) {
-                bakeAbsoluteDeltaAnim(_anim, baseAnim[(int)_baseFrame], _skeleton);
+                bakeAbsoluteDeltaAnim(keyPoses, basePoses, _skeleton);
             } else {
                 // AnimBlendType_AddRelative
-                bakeRelativeDeltaAnim(_anim, baseAnim[(int)_baseFrame]);
+                bakeRelativeDeltaAnim(keyPoses, basePoses);
+            }
+
+            if (animClip) {
+                _anim = AnimCompressedClip(animClip->getNumFrames(), animClip->getKeyFrames(), keyPoses);
             }
         }
     }
 
-    if (_anim.size()) {
+    if (_anim.getNumFrames() > 0) {
 
         // lazy creation of mirrored animation frames.
-        if (_mirrorFlag && _anim.size() != _mirrorAnim.size()) {
+        if (_mirrorFlag && _anim.getNumFrames() != _mirrorAnim.getNumFrames()) {
             buildMirrorAnim();
         }
 
@@ -318,15 +343,14 @@ const AnimPoseVec& AnimClip::evaluate(const AnimVariantMap& animVars, const Anim
 
         // It can be quite possible for the user to set _startFrame and _endFrame to
         // values before or past valid ranges.  We clamp the frames here.
-        int frameCount = (int)_anim.size();
+        int frameCount = _anim.getNumFrames();
         prevIndex = std::min(std::max(0, prevIndex), frameCount - 1);
         nextIndex = std::min(std::max(0, nextIndex), frameCount - 1);
 
-        const AnimPoseVec& prevFrame = _mirrorFlag ? _mirrorAnim[prevIndex] : _anim[prevIndex];
-        const AnimPoseVec& nextFrame = _mirrorFlag ? _mirrorAnim[nextIndex] : _anim[nextIndex];
+        const AnimCompressedClip& anim = _mirrorFlag ? _mirrorAnim : _anim;
         float alpha = glm::fract(_frame);
 
-        ::blend(_poses.size(), &prevFrame[0], &nextFrame[0], alpha, &_poses[0]);
+        anim.blend(prevIndex, nextIndex, alpha, _poses);
     }
 
     processOutputJoints(triggersOut);
@@ -344,12 +368,12 @@ void AnimClip::setCurrentFrameInternal(float frame) {
 void AnimClip::buildMirrorAnim() {
     assert(_skeleton);
 
-    _mirrorAnim.clear();
-    _mirrorAnim.reserve(_anim.size());
-    for (auto& relPoses : _anim) {
-        _mirrorAnim.push_back(relPoses);
-        _skeleton->mirrorRelativePoses(_mirrorAnim.back());
+    std::vector<AnimPoseVec> mirrorKeyPoses(_anim.getKeyFrames().size());
+    for (size_t key = 0; key < mirrorKeyPoses.size(); key++) {
+        _anim.decodeKeyFrame(key, mirrorKeyPoses[key]);
+        _skeleton->mirrorRelativePoses(mirrorKeyPoses[key]);
     }
+    _mirrorAnim = AnimCompressedClip(_anim.getNumFrames(), _anim.getKeyFrames(), mirrorKeyPoses);
 }
 
 const AnimPoseVec& AnimClip::getPosesInternal() const {
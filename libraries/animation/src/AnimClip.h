@@ -13,6 +13,7 @@
 
 #include <string>
 #include "AnimationCache.h"
+#include "AnimCompressedClip.h"
 #include "AnimNode.h"
 
 // Playback a single animation timeline.
@@ -71,9 +72,9 @@ protected:
 
     AnimPoseVec _poses;
 
-    // _anim[frame][joint]
-    std::vector<AnimPoseVec> _anim;
-    std::vector<AnimPoseVec> _mirrorAnim;
+    // the animation retargeted to _skeleton
+    AnimCompressedClip _anim;
+    AnimCompressedClip _mirrorAnim;
 
     QString _url;
     float _startFrame;
@@ -0,0 +1,450 @@
+//
+//  AnimCompressedClip.cpp
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AnimCompressedClip.h"
+
+#include <assert.h>
+#include <algorithm>
+#include <cmath>
+
+#include <GLMHelpers.h>
+
+#include "AnimUtil.h"
+
+static const int GROUP_SIZE = AnimCompressedClip::GROUP_SIZE;
+static const float ROTATION_QUANTIZATION = 32767.0f;
+static const float VECTOR_QUANTIZATION = 65535.0f;
+
+// true if every frame between prevFrame and nextFrame is within the tolerances of interpolating between the two
+static bool canInterpolate(const std::vector<AnimPoseVec>& frames, int prevFrame, int nextFrame,
+                           const AnimCompressedClip::Settings& settings) {
+    const float minRotationDot = cosf(0.5f * settings.rotationTolerance);
+    const AnimPoseVec& prevPoses = frames[prevFrame];
+    const AnimPoseVec& nextPoses = frames[nextFrame];
+    for (int frame = prevFrame + 1; frame < nextFrame; frame++) {
+        float alpha = (float)(frame - prevFrame) / (float)(nextFrame - prevFrame);
+        const AnimPoseVec& poses = frames[frame];
+        for (size_t joint = 0; joint < poses.size(); joint++) {
+            const AnimPose& prevPose = prevPoses[joint];
+            const AnimPose& nextPose = nextPoses[joint];
+            glm::quat rotation = safeLerp(prevPose.rot(), nextPose.rot(), alpha);
+            if (fabsf(glm::dot(rotation, glm::normalize(poses[joint].rot()))) < minRotationDot) {
+                return false;
+            }
+            glm::vec3 translation = glm::mix(prevPose.trans(), nextPose.trans(), alpha);
+            if (glm::distance(translation, poses[joint].trans()) > settings.translationTolerance) {
+                return false;
+            }
+            glm::vec3 scale = glm::mix(prevPose.scale(), nextPose.scale(), alpha);
+            if (glm::distance(scale, poses[joint].scale()) > settings.scaleTolerance) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+static int16_t quantizeRotationComponent(float value) {
+    return (int16_t)glm::clamp(roundf(value * ROTATION_QUANTIZATION), -ROTATION_QUANTIZATION, ROTATION_QUANTIZATION);
+}
+
+// values and rotations are [component][joint of the group], the components in x, y, z, w order
+static void dequantizeRotations(const int16_t* values, float* rotations) {
+#if GLM_ARCH & GLM_ARCH_SSE2_BIT
+    const __m128 scale = _mm_set1_ps(1.0f / ROTATION_QUANTIZATION);
+    for (int component = 0; component < 4; component++) {
+        __m128i packed = _mm_loadl_epi64((const __m128i*)(values + component * GROUP_SIZE));
+        // sign extend each value to 32 bits
+        __m128i wide = _mm_srai_epi32(_mm_unpacklo_epi16(packed, packed), 16);
+        _mm_storeu_ps(rotations + component * GROUP_SIZE, _mm_mul_ps(_mm_cvtepi32_ps(wide), scale));
+    }
+#else
+    for (int i = 0; i < 4 * GROUP_SIZE; i++) {
+        rotations[i] = (float)values[i] / ROTATION_QUANTIZATION;
+    }
+#endif
+}
+
+// values, minimums, steps and vectors are [component][joint of the group]
+static void dequantizeVectors(const uint16_t* values, const float* minimums, const float* steps, float* vectors) {
+#if GLM_ARCH & GLM_ARCH_SSE2_BIT
+    const __m128i zero = _mm_setzero_si128();
+    for (int component = 0; component < 3; component++) {
+        int offset = component * GROUP_SIZE;
+        __m128i packed = _mm_loadl_epi64((const __m128i*)(values + offset));
+        __m128 value = _mm_cvtepi32_ps(_mm_unpacklo_epi16(packed, zero));
+        value = _mm_add_ps(_mm_mul_ps(value, _mm_loadu_ps(steps + offset)), _mm_loadu_ps(minimums + offset));
+        _mm_storeu_ps(vectors + offset, value);
+    }
+#else
+    for (int i = 0; i < 3 * GROUP_SIZE; i++) {
+        vectors[i] = minimums[i] + (float)values[i] * steps[i];
+    }
+#endif
+}
+
+// lerps each rotation of a to that of b the short way round, as safeLerp() does, but leaves them unnormalized.
+// result may be a or b.
+static void lerpRotations(const float* a, const float* b, float alpha, float* result) {
+#if GLM_ARCH & GLM_ARCH_SSE2_BIT
+    __m128 ax = _mm_loadu_ps(a);
+    __m128 ay = _mm_loadu_ps(a + GROUP_SIZE);
+    __m128 az = _mm_loadu_ps(a + 2 * GROUP_SIZE);
+    __m128 aw = _mm_loadu_ps(a + 3 * GROUP_SIZE);
+    __m128 bx = _mm_loadu_ps(b);
+    __m128 by = _mm_loadu_ps(b + GROUP_SIZE);
+    __m128 bz = _mm_loadu_ps(b + 2 * GROUP_SIZE);
+    __m128 bw = _mm_loadu_ps(b + 3 * GROUP_SIZE);
+
+    __m128 dot = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ax, bx), _mm_mul_ps(ay, by)),
+                            _mm_add_ps(_mm_mul_ps(az, bz), _mm_mul_ps(aw, bw)));
+    __m128 sign = _mm_and_ps(_mm_cmplt_ps(dot, _mm_setzero_ps()), _mm_set1_ps(-0.0f));
+    bx = _mm_xor_ps(bx, sign);
+    by = _mm_xor_ps(by, sign);
+    bz = _mm_xor_ps(bz, sign);
+    bw = _mm_xor_ps(bw, sign);
+
+    __m128 t = _mm_set1_ps(alpha);
+    _mm_storeu_ps(result, _mm_add_ps(ax, _mm_mul_ps(_mm_sub_ps(bx, ax), t)));
+    _mm_storeu_ps(result + GROUP_SIZE, _mm_add_ps(ay, _mm_mul_ps(_mm_sub_ps(by, ay), t)));
+    _mm_storeu_ps(result + 2 * GROUP_SIZE, _mm_add_ps(az, _mm_mul_ps(_mm_sub_ps(bz, az), t)));
+    _mm_storeu_ps(result + 3 * GROUP_SIZE, _mm_add_ps(aw, _mm_mul_ps(_mm_sub_ps(bw, aw), t)));
+#else
+    for (int lane = 0; lane < GROUP_SIZE; lane++) {
+        float dot = 0.0f;
+        for (int component = 0; component < 4; component++) {
+            dot += a[component * GROUP_SIZE + lane] * b[component * GROUP_SIZE + lane];
+        }
+        float sign = dot < 0.0f ? -1.0f : 1.0f;
+        for (int component = 0; component < 4; component++) {
+            int i = component * GROUP_SIZE + lane;
+            result[i] = a[i] + (sign * b[i] - a[i]) * alpha;
+        }
+    }
+#endif
+}
+
+// result may be a or b
+static void lerpVectors(const float* a, const float* b, float alpha, float* result) {
+#if GLM_ARCH & GLM_ARCH_SSE2_BIT
+    __m128 t = _mm_set1_ps(alpha);
+    for (int component = 0; component < 3; component++) {
+        int offset = component * GROUP_SIZE;
+        __m128 va = _mm_loadu_ps(a + offset);
+        __m128 vb = _mm_loadu_ps(b + offset);
+        _mm_storeu_ps(result + offset, _mm_add_ps(va, _mm_mul_ps(_mm_sub_ps(vb, va), t)));
+    }
+#else
+    for (int i = 0; i < 3 * GROUP_SIZE; i++) {
+        result[i] = a[i] + (b[i] - a[i]) * alpha;
+    }
+#endif
+}
+
+static void normalizeRotations(float* rotations) {
+    // the padding at the end of the last group is all zeros
+    const float MIN_LENGTH = 1.0e-6f;
+#if GLM_ARCH & GLM_ARCH_SSE2_BIT
+    __m128 x = _mm_loadu_ps(rotations);
+    __m128 y = _mm_loadu_ps(rotations + GROUP_SIZE);
+    __m128 z = _mm_loadu_ps(rotations + 2 * GROUP_SIZE);
+    __m128 w = _mm_loadu_ps(rotations + 3 * GROUP_SIZE);
+    __m128 lengthSquared = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)),
+                                      _mm_add_ps(_mm_mul_ps(z, z), _mm_mul_ps(w, w)));
+    __m128 length = _mm_max_ps(_mm_sqrt_ps(lengthSquared), _mm_set1_ps(MIN_LENGTH));
+    _mm_storeu_ps(rotations, _mm_div_ps(x, length));
+    _mm_storeu_ps(rotations + GROUP_SIZE, _mm_div_ps(y, length));
+    _mm_storeu_ps(rotations + 2 * GROUP_SIZE, _mm_div_ps(z, length));
+    _mm_storeu_ps(rotations + 3 * GROUP_SIZE, _mm_div_ps(w, length));
+#else
+    for (int lane = 0; lane < GROUP_SIZE; lane++) {
+        float lengthSquared = 0.0f;
+        for (int component = 0; component < 4; component++) {
+            float value = rotations[component * GROUP_SIZE + lane];
+            lengthSquared += value * value;
+        }
+        float length = std::max(sqrtf(lengthSquared), MIN_LENGTH);
+        for (int component = 0; component < 4; component++) {
+            rotations[component * GROUP_SIZE + lane] /= length;
+        }
+    }
+#endif
+}
+
+AnimCompressedClip::AnimCompressedClip(const std::vector<AnimPoseVec>& frames, const Settings& settings) {
+    int numFrames = (int)frames.size();
+    std::vector<int> keyFrames;
+    if (numFrames > 0) {
+        // the first and last frames are always key frames, and each key frame is followed by the furthest frame that
+        // the frames in between can be interpolated from
+        int keyFrame = 0;
+        keyFrames.push_back(keyFrame);
+        while (keyFrame < numFrames - 1) {
+            int nextKeyFrame = keyFrame + 1;
+            if (settings.reduceKeyFrames) {
+                while (nextKeyFrame + 1 < numFrames && nextKeyFrame + 1 - keyFrame <= MAX_KEY_FRAME_GAP &&
+                       canInterpolate(frames, keyFrame, nextKeyFrame + 1, settings)) {
+                    nextKeyFrame++;
+                }
+            }
+            keyFrames.push_back(nextKeyFrame);
+            keyFrame = nextKeyFrame;
+        }
+    }
+
+    std::vector<AnimPoseVec> keyPoses;
+    keyPoses.reserve(keyFrames.size());
+    for (int keyFrame : keyFrames) {
+        keyPoses.push_back(frames[keyFrame]);
+    }
+    build(numFrames, keyFrames, keyPoses, settings);
+}
+
+AnimCompressedClip::AnimCompressedClip(int numFrames, const std::vector<int>& keyFrames,
+                                       const std::vector<AnimPoseVec>& keyPoses, const Settings& settings) {
+    assert(keyFrames.size() == keyPoses.size());
+    build(numFrames, keyFrames, keyPoses, settings);
+}
+
+static void padToGroups(std::vector<int>& joints) {
+    while (joints.size() % GROUP_SIZE != 0) {
+        joints.push_back(-1);
+    }
+}
+
+void AnimCompressedClip::build(int numFrames, const std::vector<int>& keyFrames, const std::vector<AnimPoseVec>& keyPoses,
+                               const Settings& settings) {
+    _numFrames = numFrames;
+    _keyFrames = keyFrames;
+    _constantPoses.clear();
+    _rotations = RotationTracks();
+    _translations = VectorTracks();
+    _scales = VectorTracks();
+    if (keyPoses.empty()) {
+        return;
+    }
+
+    // find the channels of each joint that change over the clip
+    _constantPoses = keyPoses[0];
+    const float minRotationDot = cosf(0.5f * settings.rotationTolerance);
+    for (int joint = 0; joint < (int)_constantPoses.size(); joint++) {
+        const AnimPose& firstPose = _constantPoses[joint];
+        bool rotates = false;
+        bool translates = false;
+        bool scales = false;
+        for (size_t key = 1; key < keyPoses.size(); key++) {
+            const AnimPose& pose = keyPoses[key][joint];
+            rotates = rotates || fabsf(glm::dot(glm::normalize(firstPose.rot()), glm::normalize(pose.rot()))) < minRotationDot;
+            translates = translates || glm::distance(firstPose.trans(), pose.trans()) > settings.translationTolerance;
+            scales = scales || glm::distance(firstPose.scale(), pose.scale()) > settings.scaleTolerance;
+        }
+        if (rotates) {
+            _rotations.joints.push_back(joint);
+        }
+        if (translates) {
+            _translations.joints.push_back(joint);
+        }
+        if (scales) {
+            _scales.joints.push_back(joint);
+        }
+    }
+    padToGroups(_rotations.joints);
+    padToGroups(_translations.joints);
+    padToGroups(_scales.joints);
+
+    const size_t rotationStride = _rotations.getNumGroups() * 4 * GROUP_SIZE;
+    _rotations.values.assign(keyPoses.size() * rotationStride, 0);
+    for (size_t key = 0; key < keyPoses.size(); key++) {
+        for (size_t i = 0; i < _rotations.joints.size(); i++) {
+            int joint = _rotations.joints[i];
+            if (joint < 0) {
+                continue;
+            }
+            int16_t* values = &_rotations.values[key * rotationStride + (i / GROUP_SIZE) * 4 * GROUP_SIZE + i % GROUP_SIZE];
+            glm::quat rotation = glm::normalize(keyPoses[key][joint].rot());
+            values[0] = quantizeRotationComponent(rotation.x);
+            values[GROUP_SIZE] = quantizeRotationComponent(rotation.y);
+            values[2 * GROUP_SIZE] = quantizeRotationComponent(rotation.z);
+            values[3 * GROUP_SIZE] = quantizeRotationComponent(rotation.w);
+        }
+    }
+
+    buildVectorTracks(_translations, keyPoses, false);
+    buildVectorTracks(_scales, keyPoses, true);
+}
+
+void AnimCompressedClip::buildVectorTracks(VectorTracks& tracks, const std::vector<AnimPoseVec>& keyPoses, bool isScale) {
+    auto channel = [isScale](const AnimPose& pose) -> const glm::vec3& {
+        return isScale ? pose.scale() : pose.trans();
+    };
+
+    const size_t stride = tracks.getNumGroups() * 3 * GROUP_SIZE;
+    tracks.minimums.assign(stride, 0.0f);
+    tracks.steps.assign(stride, 0.0f);
+    tracks.values.assign(keyPoses.size() * stride, 0);
+    for (size_t i = 0; i < tracks.joints.size(); i++) {
+        int joint = tracks.joints[i];
+        if (joint < 0) {
+            continue;
+        }
+
+        glm::vec3 minimum = channel(keyPoses[0][joint]);
+        glm::vec3 maximum = minimum;
+        for (const auto& poses : keyPoses) {
+            minimum = glm::min(minimum, channel(poses[joint]));
+            maximum = glm::max(maximum, channel(poses[joint]));
+        }
+        glm::vec3 step = (maximum - minimum) / VECTOR_QUANTIZATION;
+
+        size_t offset = (i / GROUP_SIZE) * 3 * GROUP_SIZE + i % GROUP_SIZE;
+        for (int component = 0; component < 3; component++) {
+            tracks.minimums[offset + component * GROUP_SIZE] = minimum[component];
+            tracks.steps[offset + component * GROUP_SIZE] = step[component];
+        }
+
+        for (size_t key = 0; key < keyPoses.size(); key++) {
+            const glm::vec3& value = channel(keyPoses[key][joint]);
+            uint16_t* values = &tracks.values[key * stride + offset];
+            for (int component = 0; component < 3; component++) {
+                float quantized = step[component] > 0.0f ? roundf((value[component] - minimum[component]) / step[component]) : 0.0f;
+                values[component * GROUP_SIZE] = (uint16_t)glm::clamp(quantized, 0.0f, VECTOR_QUANTIZATION);
+            }
+        }
+    }
+}
+
+size_t AnimCompressedClip::getByteSize() const {
+    return _keyFrames.size() * sizeof(int) +
+        _constantPoses.size() * sizeof(AnimPose) +
+        _rotations.joints.size() * sizeof(int) +
+        _rotations.values.size() * sizeof(int16_t) +
+        (_translations.joints.size() + _scales.joints.size()) * sizeof(int) +
+        (_translations.minimums.size() + _translations.steps.size()) * sizeof(float) +
+        (_scales.minimums.size() + _scales.steps.size()) * sizeof(float) +
+        (_translations.values.size() + _scales.values.size()) * sizeof(uint16_t);
+}
+
+AnimCompressedClip::Segment AnimCompressedClip::findSegment(float frame) const {
+    Segment segment;
+    if (_keyFrames.size() < 2) {
+        return segment;
+    }
+
+    // the first key frame after frame, where frames at or past the last key frame are in the last segment
+    auto nextKeyFrame = std::upper_bound(_keyFrames.begin() + 1, _keyFrames.end() - 1, frame,
+        [](float value, int keyFrame) { return value < (float)keyFrame; });
+    segment.nextKey = nextKeyFrame - _keyFrames.begin();
+    segment.prevKey = segment.nextKey - 1;
+
+    float prevFrame = (float)_keyFrames[segment.prevKey];
+    float nextFrame = (float)_keyFrames[segment.nextKey];
+    segment.alpha = glm::clamp((frame - prevFrame) / (nextFrame - prevFrame), 0.0f, 1.0f);
+    return segment;
+}
+
+void AnimCompressedClip::sampleRotations(size_t group, const Segment& segment, float rotations[4 * GROUP_SIZE]) const {
+    const size_t stride = _rotations.getNumGroups() * 4 * GROUP_SIZE;
+    const size_t offset = group * 4 * GROUP_SIZE;
+    dequantizeRotations(&_rotations.values[segment.prevKey * stride + offset], rotations);
+    if (segment.nextKey != segment.prevKey && segment.alpha > 0.0f) {
+        float nextRotations[4 * GROUP_SIZE];
+        dequantizeRotations(&_rotations.values[segment.nextKey * stride + offset], nextRotations);
+        lerpRotations(rotations, nextRotations, segment.alpha, rotations);
+    }
+}
+
+void AnimCompressedClip::sampleVectors(const VectorTracks& tracks, size_t group, const Segment& segment,
+                                       float vectors[3 * GROUP_SIZE]) const {
+    const size_t stride = tracks.getNumGroups() * 3 * GROUP_SIZE;
+    const size_t offset = group * 3 * GROUP_SIZE;
+    const float* minimums = &tracks.minimums[offset];
+    const float* steps = &tracks.steps[offset];
+    dequantizeVectors(&tracks.values[segment.prevKey * stride + offset], minimums, steps, vectors);
+    if (segment.nextKey != segment.prevKey && segment.alpha > 0.0f) {
+        float nextVectors[3 * GROUP_SIZE];
+        dequantizeVectors(&tracks.values[segment.nextKey * stride + offset], minimums, steps, nextVectors);
+        lerpVectors(vectors, nextVectors, segment.alpha, vectors);
+    }
+}
+
+void AnimCompressedClip::decode(const Segment& prev, const Segment& next, float alpha, AnimPoseVec& poses) const {
+    poses = _constantPoses;
+    if (_keyFrames.empty()) {
+        return;
+    }
+
+    bool isBlended = alpha > 0.0f;
+    float prevValues[4 * GROUP_SIZE];
+    float nextValues[4 * GROUP_SIZE];
+
+    for (size_t group = 0; group < _rotations.getNumGroups(); group++) {
+        sampleRotations(group, prev, prevValues);
+        if (isBlended) {
+            normalizeRotations(prevValues);
+            sampleRotations(group, next, nextValues);
+            normalizeRotations(nextValues);
+            lerpRotations(prevValues, nextValues, alpha, prevValues);
+        }
+        normalizeRotations(prevValues);
+
+        for (int lane = 0; lane < GROUP_SIZE; lane++) {
+            int joint = _rotations.joints[group * GROUP_SIZE + lane];
+            if (joint >= 0) {
+                poses[joint].rot() = glm::quat(prevValues[3 * GROUP_SIZE + lane], prevValues[lane],
+                                               prevValues[GROUP_SIZE + lane], prevValues[2 * GROUP_SIZE + lane]);
+            }
+        }
+    }
+
+    for (bool isScale : { false, true }) {
+        const VectorTracks& tracks = isScale ? _scales : _translations;
+        for (size_t group = 0; group < tracks.getNumGroups(); group++) {
+            sampleVectors(tracks, group, prev, prevValues);
+            if (isBlended) {
+                sampleVectors(tracks, group, next, nextValues);
+                lerpVectors(prevValues, nextValues, alpha, prevValues);
+            }
+
+            for (int lane = 0; lane < GROUP_SIZE; lane++) {
+                int joint = tracks.joints[group * GROUP_SIZE + lane];
+                if (joint >= 0) {
+                    glm::vec3 value(prevValues[lane], prevValues[GROUP_SIZE + lane], prevValues[2 * GROUP_SIZE + lane]);
+                    if (isScale) {
+                        poses[joint].scale() = value;
+                    } else {
+                        poses[joint].trans() = value;
+                    }
+                }
+            }
+        }
+    }
+}
+
+void AnimCompressedClip::decodeKeyFrame(size_t key, AnimPoseVec& poses) const {
+    assert(key < _keyFrames.size());
+    Segment segment;
+    segment.prevKey = key;
+    segment.nextKey = key;
+    decode(segment, segment, 0.0f, poses);
+}
+
+void AnimCompressedClip::sample(float frame, AnimPoseVec& poses) const {
+    Segment segment = findSegment(frame);
+    decode(segment, segment, 0.0f, poses);
+}
+
+void AnimCompressedClip::blend(int prevFrame, int nextFrame, float alpha, AnimPoseVec& poses) const {
+    if (nextFrame == prevFrame || nextFrame == prevFrame + 1) {
+        // both frames are in the same segment, or at its ends, and the blend is just another point on it
+        sample((float)prevFrame + alpha * (float)(nextFrame - prevFrame), poses);
+    } else {
+        // such as looping back from the end frame to the start frame
+        decode(findSegment((float)prevFrame), findSegment((float)nextFrame), alpha, poses);
+    }
+}
@@ -0,0 +1,115 @@
+//
+//  AnimCompressedClip.h
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AnimCompressedClip_h
+#define hifi_AnimCompressedClip_h
+
+#include <memory>
+#include <stdint.h>
+#include <vector>
+
+#include <QMetaType>
+
+#include "AnimPose.h"
+
+// The frames of an animation, kept small so that sampling many clips each frame reads as little memory as possible.
+//
+// Only the key frames are stored. With key frame reduction these are the frames that can't be rebuilt, within the
+// tolerances, by interpolating between their neighbors; the rest are interpolated when sampled. The channels of a joint
+// that don't change over the clip (often the translation and scale of all but the hips) are stored once, as a constant
+// pose. The channels that do change are quantized to 16 bits, rotations as the four components of the quaternion and
+// translations and scales within their range over the clip, and laid out structure-of-arrays, 4 joints to a group, so
+// that the joints of a group are decoded and interpolated together.
+class AnimCompressedClip {
+public:
+    using Pointer = std::shared_ptr<AnimCompressedClip>;
+    using ConstPointer = std::shared_ptr<const AnimCompressedClip>;
+
+    struct Settings {
+        bool reduceKeyFrames { true };
+        float rotationTolerance { 0.001f }; // radians
+        float translationTolerance { 0.001f }; // in the units of the poses
+        float scaleTolerance { 0.0001f };
+    };
+
+    static const int GROUP_SIZE = 4;
+    static const int MAX_KEY_FRAME_GAP = 30;
+
+    AnimCompressedClip() {}
+
+    // frames[frame][joint], where every frame has the same number of joints
+    AnimCompressedClip(const std::vector<AnimPoseVec>& frames, const Settings& settings = Settings());
+
+    // a clip numFrames long whose key frames have already been picked, such as those of another clip of the same
+    // animation, where keyPoses[i] are the poses at frame keyFrames[i]
+    AnimCompressedClip(int numFrames, const std::vector<int>& keyFrames, const std::vector<AnimPoseVec>& keyPoses,
+                       const Settings& settings = Settings());
+
+    int getNumFrames() const { return _numFrames; }
+    int getNumJoints() const { return (int)_constantPoses.size(); }
+    const std::vector<int>& getKeyFrames() const { return _keyFrames; }
+
+    // the memory used by the frames
+    size_t getByteSize() const;
+
+    // the poses at the key frame keyFrames[key]
+    void decodeKeyFrame(size_t key, AnimPoseVec& poses) const;
+
+    // the poses at frame, which may be fractional, from the key frames on either side of it
+    void sample(float frame, AnimPoseVec& poses) const;
+
+    // the poses alpha of the way from prevFrame to nextFrame, as ::blend() of the two frames would give
+    void blend(int prevFrame, int nextFrame, float alpha, AnimPoseVec& poses) const;
+
+protected:
+    // the key frames either side of a point in the clip, and how far it is from one to the other
+    struct Segment {
+        size_t prevKey { 0 };
+        size_t nextKey { 0 };
+        float alpha { 0.0f };
+    };
+
+    // quaternions of the animated rotations, values[key][group][component][joint of the group]
+    struct RotationTracks {
+        std::vector<int> joints; // padded to a whole number of groups with -1
+        std::vector<int16_t> values;
+        size_t getNumGroups() const { return joints.size() / GROUP_SIZE; }
+    };
+
+    // animated translations or scales, each component quantized within its range over the clip
+    struct VectorTracks {
+        std::vector<int> joints; // padded to a whole number of groups with -1
+        std::vector<float> minimums; // [group][component][joint of the group]
+        std::vector<float> steps; // the size of one quantization step, [group][component][joint of the group]
+        std::vector<uint16_t> values; // [key][group][component][joint of the group]
+        size_t getNumGroups() const { return joints.size() / GROUP_SIZE; }
+    };
+
+    void build(int numFrames, const std::vector<int>& keyFrames, const std::vector<AnimPoseVec>& keyPoses,
+               const Settings& settings);
+    static void buildVectorTracks(VectorTracks& tracks, const std::vector<AnimPoseVec>& keyPoses, bool isScale);
+    Segment findSegment(float frame) const;
+
+    // the poses alpha of the way from the point of the clip at prev to the point at next
+    void decode(const Segment& prev, const Segment& next, float alpha, AnimPoseVec& poses) const;
+
+    void sampleRotations(size_t group, const Segment& segment, float rotations[4 * GROUP_SIZE]) const;
+    void sampleVectors(const VectorTracks& tracks, size_t group, const Segment& segment, float vectors[3 * GROUP_SIZE]) const;
+
+    int _numFrames { 0 };
+    std::vector<int> _keyFrames;
+    AnimPoseVec _constantPoses; // the channels that aren't animated, and the rest of the pose
+    RotationTracks _rotations;
+    VectorTracks _translations;
+    VectorTracks _scales;
+};
+
+Q_DECLARE_METATYPE(AnimCompressedClip::ConstPointer)
+
+#endif // hifi_AnimCompressedClip_h
@@ -23,6 +23,25 @@
 #include <FBXSerializer.h>
 
 int animationPointerMetaTypeId = qRegisterMetaType<AnimationPointer>();
+int animCompressedClipPointerMetaTypeId = qRegisterMetaType<AnimCompressedClip::ConstPointer>();
+
+// the frames of an animation as relative poses of its joints, compressed for AnimClip to retarget and sample
+static AnimCompressedClip::ConstPointer buildClip(const HFMModel& hfmModel) {
+    std::vector<AnimPoseVec> frames;
+    frames.reserve(hfmModel.animationFrames.size());
+    for (const HFMAnimationFrame& animFrame : hfmModel.animationFrames) {
+        AnimPoseVec poses;
+        poses.reserve(hfmModel.joints.size());
+        for (int i = 0; i < (int)hfmModel.joints.size(); i++) {
+            const HFMJoint& joint = hfmModel.joints[i];
+            glm::quat rotation = i < animFrame.rotations.size() ? animFrame.rotations[i] : glm::quat();
+            glm::vec3 translation = i < animFrame.translations.size() ? animFrame.translations[i] : glm::vec3(0.0f);
+            poses.push_back(AnimPose(joint.preRotation * rotation * joint.postRotation, translation));
+        }
+        frames.push_back(std::move(poses));
+    }
+    return std::make_shared<AnimCompressedClip>(frames);
+}
 
 AnimationCache::AnimationCache(QObject* parent) :
     ResourceCache(parent)
@@ -78,7 +97,11 @@ void AnimationReader::run() {
                 QString errorStr("usupported format");
                 emit onError(299, errorStr);
             }
-            emit onSuccess(hfmModel);
+            AnimCompressedClip::ConstPointer clip;
+            if (hfmModel) {
+                clip = buildClip(*hfmModel);
+            }
+            emit onSuccess(hfmModel, clip);
         } else {
             throw QString("url is invalid");
         }
@@ -130,13 +153,15 @@ const QVector<HFMAnimationFrame>& Animation::getFramesReference() const {
 void Animation::downloadFinished(const QByteArray& data) {
     // parse the animation/fbx file on a background thread.
     AnimationReader* animationReader = new AnimationReader(_url, data);
-    connect(animationReader, SIGNAL(onSuccess(HFMModel::Pointer)), SLOT(animationParseSuccess(HFMModel::Pointer)));
+    connect(animationReader, SIGNAL(onSuccess(HFMModel::Pointer, AnimCompressedClip::ConstPointer)),
+            SLOT(animationParseSuccess(HFMModel::Pointer, AnimCompressedClip::ConstPointer)));
     connect(animationReader, SIGNAL(onError(int, QString)), SLOT(animationParseError(int, QString)));
     QThreadPool::globalInstance()->start(animationReader);
 }
 
-void Animation::animationParseSuccess(HFMModel::Pointer hfmModel) {
+void Animation::animationParseSuccess(HFMModel::Pointer hfmModel, AnimCompressedClip::ConstPointer clip) {
     _hfmModel = hfmModel;
+    _clip = clip;
     finishedLoading(true);
 }
 
@@ -20,6 +20,8 @@
 #include <hfm/HFM.h>
 #include <ResourceCache.h>
 
+#include "AnimCompressedClip.h"
+
 class Animation;
 
 using AnimationPointer = QSharedPointer<Animation>;
@@ -51,7 +53,7 @@ class Animation : public Resource {
 
 public:
 
-    Animation(const Animation& other) : Resource(other), _hfmModel(other._hfmModel) {}
+    Animation(const Animation& other) : Resource(other), _hfmModel(other._hfmModel), _clip(other._clip) {}
     Animation(const QUrl& url) : Resource(url) {}
 
     QString getType() const override { return "Animation"; }
@@ -65,17 +67,21 @@ public:
     Q_INVOKABLE QVector<HFMAnimationFrame> getFrames() const;
 
     const QVector<HFMAnimationFrame>& getFramesReference() const;
+
+    // the frames as relative poses of the animation's own joints, including their pre and post rotations
+    AnimCompressedClip::ConstPointer getClip() const { return _clip; }
     
 protected:
     virtual void downloadFinished(const QByteArray& data) override;
 
 protected slots:
-    void animationParseSuccess(HFMModel::Pointer hfmModel);
+    void animationParseSuccess(HFMModel::Pointer hfmModel, AnimCompressedClip::ConstPointer clip);
     void animationParseError(int error, QString str);
 
 private:
     
     HFMModel::Pointer _hfmModel;
+    AnimCompressedClip::ConstPointer _clip;
 };
 
 /// Reads geometry in a worker thread.
@@ -87,7 +93,7 @@ public:
     virtual void run() override;
 
 signals:
-    void onSuccess(HFMModel::Pointer hfmModel);
+    void onSuccess(HFMModel::Pointer hfmModel, AnimCompressedClip::ConstPointer clip);
     void onError(int error, QString str);
 
 private:
@@ -13,6 +13,7 @@
 #define hifi_AudioFOA_h
 
 #include <stdint.h>
+#include <string.h>
 
 static const int FOA_TAPS = 273;    // FIR coefs
 static const int FOA_NFFT = 512;    // FFT length
@@ -40,6 +41,14 @@ public:
     //
     void render(int16_t* input, float* output, int index, float qw, float qx, float qy, float qz, float gain, int numFrames);
 
+    // clear internal state, the next render starts from silence without interpolating its orientation
+    void reset() {
+        if (!_resetState) {
+            memset(_fftState, 0, sizeof(_fftState));
+            _resetState = true;
+        }
+    }
+
 private:
     AudioFOA(const AudioFOA&) = delete;
     AudioFOA& operator=(const AudioFOA&) = delete;
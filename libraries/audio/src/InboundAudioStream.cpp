@@ -148,7 +148,15 @@ int InboundAudioStream::parseData(ReceivedMessage& message) {
             // also result in allowing the codec to interpolate lost data. Then
             // fall through to the "on time" logic to actually handle this packet
             int packetsDropped = arrivalInfo._seqDiffFromExpected;
-            lostAudioData(packetsDropped);
+
+            // a codec may carry enough of the last lost packet in this one to rebuild it
+            QByteArray nextEncodedAudio;
+            bool isSilentFrame = message.getType() == PacketType::SilentAudioFrame
+                || message.getType() == PacketType::ReplicatedSilentAudioFrame;
+            if (!isSilentFrame && codecInPacket == _selectedCodecName) {
+                nextEncodedAudio = message.peek(message.getBytesLeftToRead());
+            }
+            lostAudioData(packetsDropped, nextEncodedAudio);
 
             // fall through to OnTime case
         }
@@ -244,7 +252,7 @@ int InboundAudioStream::parseStreamProperties(PacketType type, const QByteArray&
     }
 }
 
-int InboundAudioStream::lostAudioData(int numPackets) {
+int InboundAudioStream::lostAudioData(int numPackets, const QByteArray& nextEncodedAudio) {
     QByteArray decodedBuffer;
 
     while (numPackets--) {
@@ -256,7 +264,9 @@ int InboundAudioStream::lostAudioData(int numPackets) {
             qCInfo(audiostream, "Packet currently being unpacked or lost frame already being generated.  Not generating lost frame.");
             return 0;
         }
-        if (_decoder) {
+        if (_decoder && numPackets == 0 && !nextEncodedAudio.isEmpty()) {
+            _decoder->recoverFrame(nextEncodedAudio, decodedBuffer);
+        } else if (_decoder) {
             _decoder->lostFrame(decodedBuffer);
         } else {
             decodedBuffer.resize(AudioConstants::NETWORK_FRAME_BYTES_PER_CHANNEL * _numChannels);
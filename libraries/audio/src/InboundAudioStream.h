@@ -135,7 +135,8 @@ protected:
     virtual int parseAudioData(PacketType type, const QByteArray& packetAfterStreamProperties);
 
     /// produces audio data for lost network packets.
-    virtual int lostAudioData(int numPackets);
+    /// nextEncodedAudio is the audio of the packet that followed them, from which the codec may rebuild the last one
+    virtual int lostAudioData(int numPackets, const QByteArray& nextEncodedAudio = QByteArray());
 
     /// writes silent frames to the buffer that may be dropped to reduce latency caused by the buffer
     virtual int writeDroppableSilentFrames(int silentFrames);
@@ -154,6 +154,16 @@ EntityPropertyFlags EntityItem::getEntityProperties(EncodeBitstreamParams& param
     return requestedProperties;
 }
 
+EntityPropertyFlags EntityItem::getSentEntityProperties(EncodeBitstreamParams& params) const {
+    EntityPropertyFlags requestedProperties = getEntityProperties(params);
+
+    // these properties are not sent over the wire
+    requestedProperties -= PROP_ENTITY_HOST_TYPE;
+    requestedProperties -= PROP_OWNING_AVATAR_ID;
+    requestedProperties -= PROP_VISIBLE_IN_SECONDARY_CAMERA;
+    return requestedProperties;
+}
+
 OctreeElement::AppendState EntityItem::appendEntityData(OctreePacketData* packetData, EncodeBitstreamParams& params,
                                             EntityTreeElementExtraEncodeDataPointer entityTreeElementExtraEncodeData,
                                             const bool destinationNodeCanGetAndSetPrivateUserData) const {
@@ -187,12 +197,7 @@ OctreeElement::AppendState EntityItem::appendEntityData(OctreePacketData* packet
 
 
     EntityPropertyFlags propertyFlags(PROP_LAST_ITEM);
-    EntityPropertyFlags requestedProperties = getEntityProperties(params);
-
-    // these properties are not sent over the wire
-    requestedProperties -= PROP_ENTITY_HOST_TYPE;
-    requestedProperties -= PROP_OWNING_AVATAR_ID;
-    requestedProperties -= PROP_VISIBLE_IN_SECONDARY_CAMERA;
+    EntityPropertyFlags requestedProperties = getSentEntityProperties(params);
 
     // If we are being called for a subsequent pass at appendEntityData() that failed to completely encode this item,
     // then our entityTreeElementExtraEncodeData should include data about which properties we need to append.
@@ -398,6 +403,76 @@ OctreeElement::AppendState EntityItem::appendEntityData(OctreePacketData* packet
     return appendState;
 }
 
+OctreeElement::AppendState EntityItem::appendCachedEntityData(OctreePacketData* packetData, EncodeBitstreamParams& params,
+                                            EntityTreeElementExtraEncodeDataPointer entityTreeElementExtraEncodeData,
+                                            const bool destinationNodeCanGetAndSetPrivateUserData,
+                                            bool& cacheHit) const {
+    cacheHit = false;
+
+    // the rest of a partial encode is specific to the node it is sent to
+    if (entityTreeElementExtraEncodeData && entityTreeElementExtraEncodeData->entities.contains(getEntityItemID())) {
+        return appendEntityData(packetData, params, entityTreeElementExtraEncodeData,
+                                destinationNodeCanGetAndSetPrivateUserData);
+    }
+
+    // private user data is only sent to some nodes, only a cache that was encoded without it can be shared with every node
+    bool includesPrivateUserData = destinationNodeCanGetAndSetPrivateUserData && !getPrivateUserData().isEmpty();
+    quint64 lastEdited = getLastEdited();
+    quint64 lastUpdated = getLastUpdated();
+    quint64 lastSimulated = getLastSimulated();
+    // the entity server changes some properties, such as the simulation owner and velocities of entities it stops,
+    // without an edit
+    quint64 lastChangedOnServer = getLastChangedOnServer();
+    EntityPropertyFlags requestedProperties = getSentEntityProperties(params);
+
+    std::shared_ptr<const EncodedData> encodedData;
+    {
+        std::lock_guard<std::mutex> lock(_encodedDataMutex);
+        encodedData = _encodedData;
+    }
+
+    if (encodedData && encodedData->lastEdited == lastEdited && encodedData->lastUpdated == lastUpdated &&
+        encodedData->lastSimulated == lastSimulated && encodedData->lastChangedOnServer == lastChangedOnServer &&
+        encodedData->includesPrivateUserData == includesPrivateUserData &&
+        encodedData->requestedProperties == requestedProperties) {
+        // if the entity doesn't fit, the regular encode packs what it can of it
+        LevelDetails entityLevel = packetData->startLevel();
+        if (packetData->appendRawData(encodedData->bytes)) {
+            packetData->endLevel(entityLevel);
+            params.trackSend(getID(), lastEdited);
+            cacheHit = true;
+            return OctreeElement::COMPLETED;
+        }
+        packetData->discardLevel(entityLevel);
+    }
+
+    int startOfEntityData = packetData->getUncompressedByteOffset();
+    OctreeElement::AppendState appendState = appendEntityData(packetData, params, entityTreeElementExtraEncodeData,
+                                                              destinationNodeCanGetAndSetPrivateUserData);
+    if (appendState == OctreeElement::COMPLETED) {
+        int endOfEntityData = packetData->getUncompressedByteOffset();
+        auto newEncodedData = std::make_shared<EncodedData>();
+        newEncodedData->lastEdited = lastEdited;
+        newEncodedData->lastUpdated = lastUpdated;
+        newEncodedData->lastSimulated = lastSimulated;
+        newEncodedData->lastChangedOnServer = lastChangedOnServer;
+        newEncodedData->requestedProperties = requestedProperties;
+        newEncodedData->includesPrivateUserData = includesPrivateUserData;
+        newEncodedData->bytes = QByteArray((const char*)packetData->getUncompressedData(startOfEntityData),
+                                           endOfEntityData - startOfEntityData);
+
+        std::lock_guard<std::mutex> lock(_encodedDataMutex);
+        _encodedData = newEncodedData;
+    }
+
+    return appendState;
+}
+
+void EntityItem::invalidateEncodedDataCache() {
+    std::lock_guard<std::mutex> lock(_encodedDataMutex);
+    _encodedData.reset();
+}
+
 // TODO: My goal is to get rid of this concept completely. The old code (and some of the current code) used this
 // result to calculate if a packet being sent to it was potentially bad or corrupt. I've adjusted this to now
 // only consider the minimum header bytes as being required. But it would be preferable to completely eliminate
@@ -706,8 +781,10 @@ int EntityItem::readEntityDataFromBuffer(const unsigned char* data, int bytesLef
     int bytesRead = (int)parser.offset();
 #endif
 
-    auto nodeList = DependencyManager::get<NodeList>();
-    const QUuid& myNodeID = nodeList->getSessionUUID();
+    QUuid myNodeID;
+    if (!args.isPersistedData) {
+        myNodeID = DependencyManager::get<NodeList>()->getSessionUUID();
+    }
     bool weOwnSimulation = _simulationOwner.matchesValidID(myNodeID);
 
     // NOTE: the server is authoritative for changes to simOwnerID so we always unpack ownership data
@@ -970,6 +1047,7 @@ int EntityItem::readEntityDataFromBuffer(const unsigned char* data, int bytesLef
 
     if (overwriteLocalData &&
             !hasGrab &&
+            !args.isPersistedData &&
             (getDirtyFlags() & (Simulation::DIRTY_TRANSFORM | Simulation::DIRTY_VELOCITIES))) {
         // NOTE: This code is attempting to "repair" the old data we just got from the server to make it more
         // closely match where the entities should be if they'd stepped forward in time to "now". The server
@@ -1478,6 +1556,8 @@ bool EntityItem::stillWaitingToTakeOwnership(uint64_t timestamp) const {
 bool EntityItem::setProperties(const EntityItemProperties& properties) {
     bool somethingChanged = false;
 
+    invalidateEncodedDataCache();
+
     // Core
     SET_ENTITY_PROPERTY_FROM_PROPERTIES(simulationOwner, setSimulationOwner);
     SET_ENTITY_PROPERTY_FROM_PROPERTIES(parentID, setParentID);
@@ -2719,6 +2799,8 @@ void EntityItem::markAsChangedOnServer() {
     withWriteLock([&] {
         _changedOnServer = usecTimestampNow();
     });
+    // the encode is keyed on the change time too, but two changes can fall in the same usec
+    invalidateEncodedDataCache();
 }
 
 quint64 EntityItem::getLastChangedOnServer() const {
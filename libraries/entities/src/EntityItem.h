@@ -13,6 +13,7 @@
 #define hifi_EntityItem_h
 
 #include <memory>
+#include <mutex>
 #include <stdint.h>
 
 #include <glm/glm.hpp>
@@ -139,6 +140,14 @@ public:
                                                         EntityTreeElementExtraEncodeDataPointer entityTreeElementExtraEncodeData,
                                                         const bool destinationNodeCanGetAndSetPrivateUserData = false) const;
 
+    /// appendEntityData() for servers sending the entity to many nodes: a complete encode of the entity is kept and
+    /// copied into the packets of the nodes that ask for the same properties until the entity changes
+    OctreeElement::AppendState appendCachedEntityData(OctreePacketData* packetData, EncodeBitstreamParams& params,
+                                                      EntityTreeElementExtraEncodeDataPointer entityTreeElementExtraEncodeData,
+                                                      const bool destinationNodeCanGetAndSetPrivateUserData,
+                                                      bool& cacheHit) const;
+    void invalidateEncodedDataCache();
+
     virtual void appendSubclassData(OctreePacketData* packetData, EncodeBitstreamParams& params,
                                     EntityTreeElementExtraEncodeDataPointer entityTreeElementExtraEncodeData,
                                     EntityPropertyFlags& requestedProperties,
@@ -775,6 +784,21 @@ protected:
     mutable bool _needsRenderUpdate { false };
 
 private:
+    // the properties appendEntityData() encodes when it isn't continuing a partial encode
+    EntityPropertyFlags getSentEntityProperties(EncodeBitstreamParams& params) const;
+
+    struct EncodedData {
+        quint64 lastEdited;
+        quint64 lastUpdated;
+        quint64 lastSimulated;
+        quint64 lastChangedOnServer;
+        EntityPropertyFlags requestedProperties;
+        bool includesPrivateUserData;
+        QByteArray bytes;
+    };
+    mutable std::mutex _encodedDataMutex;
+    mutable std::shared_ptr<const EncodedData> _encodedData;
+
     static std::function<glm::quat(const glm::vec3&, const glm::quat&, BillboardMode, const glm::vec3&)> _getBillboardRotationOperator;
     static std::function<glm::vec3()> _getPrimaryViewFrustumPositionOperator;
 };
@@ -1279,6 +1279,31 @@ RayToEntityIntersectionResult EntityScriptingInterface::evalRayIntersectionWorke
     return result;
 }
 
+std::vector<RayToEntityIntersectionResult> EntityScriptingInterface::evalRayIntersectionVectors(std::vector<EntityRayQuery>& queries) {
+    PROFILE_RANGE(script_entities, __FUNCTION__);
+
+    std::vector<RayToEntityIntersectionResult> results(queries.size());
+    if (_entityTree) {
+        bool accurate = false;
+        _entityTree->evalRayIntersections(queries, Octree::Lock, &accurate);
+        for (size_t i = 0; i < queries.size(); ++i) {
+            const auto& query = queries[i];
+            auto& result = results[i];
+            result.accurate = accurate;
+            result.entityID = query.entityID;
+            result.distance = query.distance;
+            result.face = query.face;
+            result.surfaceNormal = query.surfaceNormal;
+            result.extraInfo = query.extraInfo;
+            result.intersects = !query.entityID.isNull();
+            if (result.intersects) {
+                result.intersection = query.ray.origin + (query.ray.direction * query.distance);
+            }
+        }
+    }
+    return results;
+}
+
 ParabolaToEntityIntersectionResult EntityScriptingInterface::evalParabolaIntersectionVector(const PickParabola& parabola, PickFilter searchFilter,
         const QVector<EntityItemID>& entityIdsToInclude, const QVector<EntityItemID>& entityIdsToDiscard) {
     PROFILE_RANGE(script_entities, __FUNCTION__);
@@ -184,6 +184,9 @@ public:
     ParabolaToEntityIntersectionResult evalParabolaIntersectionVector(const PickParabola& parabola, PickFilter searchFilter,
         const QVector<EntityItemID>& entityIdsToInclude, const QVector<EntityItemID>& entityIdsToDiscard);
 
+    // evaluates a batch of rays in one walk of the entity tree, returning their results in the same order
+    std::vector<RayToEntityIntersectionResult> evalRayIntersectionVectors(std::vector<EntityRayQuery>& queries);
+
     /**jsdoc
      * Gets the properties of multiple entities.
      * @function Entities.getMultipleEntityProperties
@@ -0,0 +1,279 @@
+//
+//  EntitySnapshot.cpp
+//  libraries/entities/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "EntitySnapshot.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <thread>
+
+#include <QtCore/QFile>
+#include <QtCore/QSaveFile>
+
+#include <udt/PacketHeaders.h>
+
+#include "EntitiesLogging.h"
+#include "EntityTreeElement.h"
+#include "EntityTypes.h"
+
+static const char SNAPSHOT_MAGIC[8] = { 'H', 'F', 'E', 'S', 'N', 'A', 'P', '\0' };
+static const quint32 SNAPSHOT_FORMAT_VERSION = 2;
+
+// upper bound for one encoded entity, the bitstream itself limits strings to 64KB each
+static const int MAX_SNAPSHOT_ENTITY_BYTES = 4 * 1024 * 1024;
+
+// don't bother spinning up decode threads for small domains
+static const size_t MIN_ENTITIES_PER_DECODE_THREAD = 256;
+
+// every record is the entity bitstream followed by the properties appendEntityData() leaves out
+enum SnapshotRecordFlags : quint8 {
+    VISIBLE_IN_SECONDARY_CAMERA = 1 << 0
+};
+static const int SNAPSHOT_RECORD_TRAILER_BYTES = sizeof(quint8);
+
+struct SnapshotFileHeader {
+    char magic[8];
+    quint32 formatVersion;
+    quint32 contentVersion;
+    quint8 persistID[16];
+    qint64 dataVersion;
+    quint64 numEntities;
+    quint8 sourceHash[EntitySnapshot::SOURCE_HASH_SIZE];
+    // byte offsets of the columns, each holding numEntities values
+    quint64 idsOffset;      // 16 byte ids
+    quint64 typesOffset;    // quint32 EntityTypes::EntityType
+    quint64 offsetsOffset;  // quint64 record offsets
+    quint64 sizesOffset;    // quint32 record sizes, trailer included
+};
+static_assert(sizeof(SnapshotFileHeader) == 96, "snapshot header must not have padding");
+
+static const int NUM_UUID_BYTES = 16;
+
+static quint64 alignedOffset(quint64 offset) {
+    const quint64 ALIGNMENT = 8;
+    return (offset + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+}
+
+static bool readFileHeader(const uchar* data, qint64 size, SnapshotFileHeader& fileHeader) {
+    if (size < (qint64)sizeof(SnapshotFileHeader)) {
+        return false;
+    }
+    memcpy(&fileHeader, data, sizeof(SnapshotFileHeader));
+    if (memcmp(fileHeader.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0
+        || fileHeader.formatVersion != SNAPSHOT_FORMAT_VERSION) {
+        return false;
+    }
+
+    // the columns must be inside the file
+    auto columnFits = [&](quint64 offset, quint64 valueSize) {
+        return offset <= (quint64)size && fileHeader.numEntities <= ((quint64)size - offset) / valueSize;
+    };
+    return columnFits(fileHeader.idsOffset, NUM_UUID_BYTES) && columnFits(fileHeader.typesOffset, sizeof(quint32))
+        && columnFits(fileHeader.offsetsOffset, sizeof(quint64)) && columnFits(fileHeader.sizesOffset, sizeof(quint32));
+}
+
+static void toHeader(const SnapshotFileHeader& fileHeader, EntitySnapshot::Header& header) {
+    header.persistID = QUuid::fromRfc4122(QByteArray((const char*)fileHeader.persistID, NUM_UUID_BYTES));
+    header.dataVersion = fileHeader.dataVersion;
+    header.contentVersion = (int)fileHeader.contentVersion;
+    header.numEntities = fileHeader.numEntities;
+    header.sourceHash = QByteArray((const char*)fileHeader.sourceHash, EntitySnapshot::SOURCE_HASH_SIZE);
+}
+
+bool EntitySnapshot::write(const QString& filename, const Header& header, const std::vector<EntityItemPointer>& entityItems) {
+    const quint64 numEntities = entityItems.size();
+
+    SnapshotFileHeader fileHeader;
+    memset(&fileHeader, 0, sizeof(fileHeader));
+    memcpy(fileHeader.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+    fileHeader.formatVersion = SNAPSHOT_FORMAT_VERSION;
+    fileHeader.contentVersion = (quint32)versionForPacketType(PacketType::EntityData);
+    memcpy(fileHeader.persistID, header.persistID.toRfc4122().constData(), NUM_UUID_BYTES);
+    fileHeader.dataVersion = header.dataVersion;
+    fileHeader.numEntities = numEntities;
+    memcpy(fileHeader.sourceHash, header.sourceHash.constData(), std::min((size_t)header.sourceHash.size(), sizeof(fileHeader.sourceHash)));
+    fileHeader.idsOffset = alignedOffset(sizeof(SnapshotFileHeader));
+    fileHeader.typesOffset = alignedOffset(fileHeader.idsOffset + numEntities * NUM_UUID_BYTES);
+    fileHeader.offsetsOffset = alignedOffset(fileHeader.typesOffset + numEntities * sizeof(quint32));
+    fileHeader.sizesOffset = alignedOffset(fileHeader.offsetsOffset + numEntities * sizeof(quint64));
+    const quint64 recordsOffset = alignedOffset(fileHeader.sizesOffset + numEntities * sizeof(quint32));
+
+    QByteArray ids(numEntities * NUM_UUID_BYTES, 0);
+    std::vector<quint32> types(numEntities);
+    std::vector<quint64> offsets(numEntities);
+    std::vector<quint32> sizes(numEntities);
+    QByteArray records;
+
+    OctreePacketData packetData(false, MAX_SNAPSHOT_ENTITY_BYTES);
+    EncodeBitstreamParams params;
+    for (quint64 i = 0; i < numEntities; ++i) {
+        const EntityItemPointer& entity = entityItems[i];
+
+        packetData.reset();
+        auto extraEncodeData = std::make_shared<EntityTreeElementExtraEncodeData>();
+        OctreeElement::AppendState appendState = entity->appendEntityData(&packetData, params, extraEncodeData, true);
+        if (appendState != OctreeElement::COMPLETED) {
+            qCWarning(entities) << "Entity" << entity->getEntityItemID() << "is too large for a snapshot, not writing"
+                << filename;
+            return false;
+        }
+
+        quint8 flags = 0;
+        if (entity->isVisibleInSecondaryCamera()) {
+            flags |= VISIBLE_IN_SECONDARY_CAMERA;
+        }
+
+        memcpy(ids.data() + i * NUM_UUID_BYTES, entity->getEntityItemID().toRfc4122().constData(), NUM_UUID_BYTES);
+        types[i] = (quint32)entity->getType();
+        offsets[i] = recordsOffset + records.size();
+        sizes[i] = (quint32)(packetData.getUncompressedSize() + SNAPSHOT_RECORD_TRAILER_BYTES);
+
+        records.append((const char*)packetData.getUncompressedData(), packetData.getUncompressedSize());
+        records.append((char)flags);
+    }
+
+    QSaveFile file(filename);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qCWarning(entities) << "Could not open entity snapshot" << filename << file.errorString();
+        return false;
+    }
+
+    auto writeColumn = [&](quint64 offset, const char* data, qint64 size) {
+        // pad up to the column's aligned offset
+        QByteArray padding((int)(offset - (quint64)file.pos()), 0);
+        return file.write(padding) == padding.size() && file.write(data, size) == size;
+    };
+
+    bool success = file.write((const char*)&fileHeader, sizeof(fileHeader)) == (qint64)sizeof(fileHeader)
+        && writeColumn(fileHeader.idsOffset, ids.constData(), ids.size())
+        && writeColumn(fileHeader.typesOffset, (const char*)types.data(), numEntities * sizeof(quint32))
+        && writeColumn(fileHeader.offsetsOffset, (const char*)offsets.data(), numEntities * sizeof(quint64))
+        && writeColumn(fileHeader.sizesOffset, (const char*)sizes.data(), numEntities * sizeof(quint32))
+        && writeColumn(recordsOffset, records.constData(), records.size());
+
+    if (!success || !file.commit()) {
+        qCWarning(entities) << "Failed to write entity snapshot" << filename << file.errorString();
+        return false;
+    }
+    return true;
+}
+
+bool EntitySnapshot::readHeader(const QString& filename, Header& header) {
+    QFile file(filename);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QByteArray data = file.read(sizeof(SnapshotFileHeader));
+    SnapshotFileHeader fileHeader;
+    if (data.size() < (int)sizeof(SnapshotFileHeader)
+        || !readFileHeader((const uchar*)data.constData(), file.size(), fileHeader)) {
+        qCWarning(entities) << "Invalid entity snapshot" << filename;
+        return false;
+    }
+
+    toHeader(fileHeader, header);
+    return header.contentVersion == (int)versionForPacketType(PacketType::EntityData);
+}
+
+bool EntitySnapshot::read(const QString& filename, Header& header, std::vector<EntityItemPointer>& entityItems) {
+    QFile file(filename);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qCWarning(entities) << "Could not open entity snapshot" << filename << file.errorString();
+        return false;
+    }
+
+    const qint64 fileSize = file.size();
+    const uchar* data = fileSize > 0 ? file.map(0, fileSize) : nullptr;
+    if (!data) {
+        qCWarning(entities) << "Could not map entity snapshot" << filename << file.errorString();
+        return false;
+    }
+
+    SnapshotFileHeader fileHeader;
+    if (!readFileHeader(data, fileSize, fileHeader)) {
+        qCWarning(entities) << "Invalid entity snapshot" << filename;
+        return false;
+    }
+
+    toHeader(fileHeader, header);
+    if (header.contentVersion != (int)versionForPacketType(PacketType::EntityData)) {
+        qCDebug(entities) << "Entity snapshot" << filename << "was written for bitstream version" << header.contentVersion;
+        return false;
+    }
+
+    const quint64 numEntities = fileHeader.numEntities;
+    std::vector<EntityItemPointer> decoded(numEntities);
+    std::atomic<bool> success { true };
+
+    auto decodeRange = [&](quint64 begin, quint64 end) {
+        for (quint64 i = begin; i < end && success; ++i) {
+            quint64 offset;
+            quint32 size;
+            memcpy(&offset, data + fileHeader.offsetsOffset + i * sizeof(quint64), sizeof(quint64));
+            memcpy(&size, data + fileHeader.sizesOffset + i * sizeof(quint32), sizeof(quint32));
+            if (size <= (quint32)SNAPSHOT_RECORD_TRAILER_BYTES || offset > (quint64)fileSize
+                || size > (quint64)fileSize - offset) {
+                success = false;
+                break;
+            }
+
+            const unsigned char* record = data + offset;
+            int bitstreamSize = (int)(size - SNAPSHOT_RECORD_TRAILER_BYTES);
+
+            // the index columns double as a check that the record is the one it claims to be
+            quint32 type;
+            memcpy(&type, data + fileHeader.typesOffset + i * sizeof(quint32), sizeof(quint32));
+            QUuid id = QUuid::fromRfc4122(QByteArray::fromRawData((const char*)data + fileHeader.idsOffset
+                + i * NUM_UUID_BYTES, NUM_UUID_BYTES));
+
+            EntityItemPointer entity = EntityTypes::constructEntityItem(record, bitstreamSize);
+            if (!entity || entity->getType() != (EntityTypes::EntityType)type || entity->getEntityItemID() != id) {
+                success = false;
+                break;
+            }
+
+            // decode as the server's own data, not as an update from a node
+            ReadBitstreamToTreeParams args(WANT_EXISTS_BITS, nullptr, QUuid(), SharedNodePointer());
+            args.isPersistedData = true;
+            entity->readEntityDataFromBuffer(record, bitstreamSize, args);
+
+            quint8 flags = record[bitstreamSize];
+            entity->setIsVisibleInSecondaryCamera((flags & VISIBLE_IN_SECONDARY_CAMERA) != 0);
+
+            decoded[i] = entity;
+        }
+    };
+
+    size_t numThreads = std::max<size_t>(1, std::thread::hardware_concurrency());
+    numThreads = std::min<size_t>(numThreads, numEntities / MIN_ENTITIES_PER_DECODE_THREAD);
+    if (numThreads <= 1) {
+        decodeRange(0, numEntities);
+    } else {
+        std::vector<std::thread> threads;
+        threads.reserve(numThreads);
+        quint64 entitiesPerThread = (numEntities + numThreads - 1) / numThreads;
+        for (quint64 begin = 0; begin < numEntities; begin += entitiesPerThread) {
+            threads.emplace_back(decodeRange, begin, std::min(begin + entitiesPerThread, numEntities));
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+
+    if (!success) {
+        qCWarning(entities) << "Failed to decode entity snapshot" << filename;
+        return false;
+    }
+
+    entityItems.insert(entityItems.end(), decoded.begin(), decoded.end());
+    return true;
+}
@@ -0,0 +1,52 @@
+//
+//  EntitySnapshot.h
+//  libraries/entities/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_EntitySnapshot_h
+#define hifi_EntitySnapshot_h
+
+#include <vector>
+
+#include <QtCore/QString>
+#include <QtCore/QUuid>
+
+#include "EntityItem.h"
+
+// EntitySnapshot is a binary companion to the JSON entities file, written by the entity server's persist thread.
+//
+// Each entity is stored as the same bitstream appendEntityData() sends to clients, so loading it skips the
+// gunzip / JSON / script value conversions of the JSON path.  The file starts with a fixed header followed by
+// columnar index arrays (ids, types, offsets, sizes) and then the entity records, which lets the file be mapped
+// and the records decoded in parallel.
+//
+// Snapshots are a cache of the JSON file: they record a hash of the JSON file they mirror, they are host-endian,
+// and they are only valid for the bitstream version they were written with.
+class EntitySnapshot {
+public:
+    struct Header {
+        QUuid persistID;
+        qint64 dataVersion { -1 };
+        int contentVersion { -1 };
+        quint64 numEntities { 0 };
+        QByteArray sourceHash; // SOURCE_HASH_SIZE bytes, the hash of the JSON file the snapshot mirrors
+    };
+
+    static const int SOURCE_HASH_SIZE = 16;
+
+    // writes entities to filename, fails (without touching filename) if any entity can't be fully encoded
+    static bool write(const QString& filename, const Header& header, const std::vector<EntityItemPointer>& entityItems);
+
+    // reads the header, fails if the file is not a snapshot of the current bitstream version
+    static bool readHeader(const QString& filename, Header& header);
+
+    // decodes every entity in the snapshot as persisted data, none are returned if any of them fails to decode
+    static bool read(const QString& filename, Header& header, std::vector<EntityItemPointer>& entityItems);
+};
+
+#endif // hifi_EntitySnapshot_h
@@ -10,7 +10,11 @@
 //
 
 #include "EntityTree.h"
+
+#include <algorithm>
+
 #include <QtCore/QDateTime>
+#include <QtCore/QDataStream>
 #include <QtCore/QQueue>
 #include <openssl/err.h>
 #include <openssl/pem.h>
@@ -40,6 +44,7 @@
 #include "LogHandler.h"
 #include "EntityEditFilters.h"
 #include "EntityDynamicFactoryInterface.h"
+#include "EntitySnapshot.h"
 
 static const quint64 DELETED_ENTITIES_EXTRA_USECS_TO_CONSIDER = USECS_PER_MSEC * 50;
 const float EntityTree::DEFAULT_MAX_TMP_ENTITY_LIFETIME = 60 * 60; // 1 hour
@@ -82,6 +87,7 @@ OctreeElementPointer EntityTree::createNewElement(unsigned char* octalCode) {
 
 void EntityTree::eraseDomainAndNonOwnedEntities() {
     emit clearingEntities();
+    journalNeedsSnapshot();
 
     if (_simulation) {
         // local-entities are not in the simulation, so we clear ALL
@@ -133,6 +139,7 @@ void EntityTree::eraseDomainAndNonOwnedEntities() {
 
 void EntityTree::eraseAllOctreeElements(bool createNewRoot) {
     emit clearingEntities();
+    journalNeedsSnapshot();
 
     if (_simulation) {
         _simulation->clearEntities();
@@ -302,7 +309,8 @@ void EntityTree::postAddEntity(EntityItemPointer entity) {
         addToNeedsParentFixupList(entity);
     }
 
-    _isDirty = true;
+    setJournaledDirtyBit();
+    journalEntityChanged(entity);
 
     // find and hook up any entities with this entity as a (previously) missing parent
     fixupNeedsParentFixups();
@@ -368,7 +376,8 @@ bool EntityTree::updateEntity(EntityItemPointer entity, const EntityItemProperti
                 if (entity->setProperties(tempProperties)) {
                     emit editingEntityPointer(entity);
                 }
-                _isDirty = true;
+                setJournaledDirtyBit();
+                journalEntityChanged(entity);
             }
         }
     } else {
@@ -503,7 +512,8 @@ bool EntityTree::updateEntity(EntityItemPointer entity, const EntityItemProperti
             }
         }
 
-        _isDirty = true;
+        setJournaledDirtyBit();
+        journalEntityChanged(entity);
 
         uint32_t newFlags = entity->getDirtyFlags() & ~preFlags;
         if (newFlags) {
@@ -742,6 +752,7 @@ void EntityTree::deleteEntitiesByPointer(const std::vector<EntityItemPointer>& e
     for (auto entity : entities) {
         if (entity->getElement()) {
             theOperator.addEntityToDeleteList(entity);
+            journalEntityDeleted(entity->getEntityItemID());
             emit deletingEntity(entity->getID());
             emit deletingEntityPointer(entity.get());
         }
@@ -750,7 +761,7 @@ void EntityTree::deleteEntitiesByPointer(const std::vector<EntityItemPointer>& e
     if (!theOperator.getEntities().empty()) {
         recurseTreeWithOperator(&theOperator);
         processRemovedEntities(theOperator);
-        _isDirty = true;
+        setJournaledDirtyBit();
     }
 }
 
@@ -869,6 +880,112 @@ EntityItemID EntityTree::evalRayIntersection(const glm::vec3& origin, const glm:
     return args.entityID;
 }
 
+// the distance at which ray enters cube, 0 if it starts inside it and FLT_MAX if it misses it
+static float rayEntryDistance(const AACube& cube, const EntityRayQuery& query, const glm::vec3& invDirection) {
+    if (cube.contains(query.ray.origin)) {
+        return 0.0f;
+    }
+    float boundDistance = FLT_MAX;
+    BoxFace face;
+    glm::vec3 surfaceNormal;
+    if (cube.findRayIntersection(query.ray.origin, query.ray.direction, invDirection, boundDistance, face, surfaceNormal)) {
+        return boundDistance;
+    }
+    return FLT_MAX;
+}
+
+// index into the queries and the distance at which that ray enters the element
+using RayEntry = std::pair<size_t, float>;
+
+static void evalRayIntersectionsInElement(const EntityTreeElementPointer& element, std::vector<EntityRayQuery>& queries,
+        const std::vector<glm::vec3>& invDirections, std::vector<RayEntry>& rays, int recursionCount) {
+    if (recursionCount > DANGEROUSLY_DEEP_RECURSION) {
+        HIFI_FCDEBUG(entities(), "EntityTree::evalRayIntersections() reached DANGEROUSLY_DEEP_RECURSION, bailing!");
+        return;
+    }
+
+    // rays may have hit something closer than this element since it was queued, while visiting its siblings
+    rays.erase(std::remove_if(rays.begin(), rays.end(), [&](const RayEntry& ray) {
+        return ray.second >= queries[ray.first].distance;
+    }), rays.end());
+    if (rays.empty()) {
+        return;
+    }
+
+    OctreeElementPointer hitElement;
+    for (const auto& ray : rays) {
+        EntityRayQuery& query = queries[ray.first];
+        EntityItemID entityID = element->evalRayIntersection(query.ray.origin, query.ray.direction, hitElement,
+            query.distance, query.face, query.surfaceNormal, query.entityIdsToInclude, query.entityIdsToDiscard,
+            query.searchFilter, query.extraInfo);
+        if (!entityID.isNull()) {
+            query.entityID = entityID;
+        }
+    }
+
+    struct ChildRays {
+        float distance { FLT_MAX }; // the nearest entry of any of its rays
+        EntityTreeElementPointer child;
+        std::vector<RayEntry> rays;
+    };
+    std::vector<ChildRays> children;
+    for (int i = 0; i < NUMBER_OF_CHILDREN; i++) {
+        EntityTreeElementPointer child = element->getChildAtIndex(i);
+        if (!child) {
+            continue;
+        }
+        ChildRays childRays;
+        childRays.child = child;
+        const AACube& cube = child->getAACube();
+        for (const auto& ray : rays) {
+            float entryDistance = rayEntryDistance(cube, queries[ray.first], invDirections[ray.first]);
+            if (entryDistance < queries[ray.first].distance) {
+                childRays.rays.emplace_back(ray.first, entryDistance);
+                childRays.distance = std::min(childRays.distance, entryDistance);
+            }
+        }
+        if (!childRays.rays.empty()) {
+            children.push_back(std::move(childRays));
+        }
+    }
+
+    std::sort(children.begin(), children.end(), [](const ChildRays& left, const ChildRays& right) {
+        return left.distance < right.distance;
+    });
+    for (auto& childRays : children) {
+        evalRayIntersectionsInElement(childRays.child, queries, invDirections, childRays.rays, recursionCount + 1);
+    }
+}
+
+void EntityTree::evalRayIntersections(std::vector<EntityRayQuery>& queries, Octree::lockType lockType, bool* accurateResult) {
+    std::vector<glm::vec3> invDirections;
+    invDirections.reserve(queries.size());
+    std::vector<RayEntry> rays;
+    rays.reserve(queries.size());
+    for (size_t i = 0; i < queries.size(); ++i) {
+        auto& query = queries[i];
+        query.entityID = EntityItemID();
+        query.distance = FLT_MAX;
+
+        // calculate dirReciprocal like this rather than with glm's scalar / vec3 template to avoid NaNs.
+        const glm::vec3& direction = query.ray.direction;
+        invDirections.emplace_back(direction.x == 0.0f ? 0.0f : 1.0f / direction.x,
+                                   direction.y == 0.0f ? 0.0f : 1.0f / direction.y,
+                                   direction.z == 0.0f ? 0.0f : 1.0f / direction.z);
+        // like the single ray walk, the root is always visited
+        rays.emplace_back(i, 0.0f);
+    }
+
+    bool requireLock = lockType == Octree::Lock;
+    bool lockResult = withReadLock([&] {
+        evalRayIntersectionsInElement(getRoot(), queries, invDirections, rays, 0);
+    }, requireLock);
+
+    if (accurateResult) {
+        *accurateResult = lockResult; // if user asked to accuracy or result, let them know this is accurate
+    }
+}
+
 class ParabolaArgs {
 public:
     // Inputs
@@ -2903,6 +3020,139 @@ void convertGrabUserDataToProperties(EntityItemProperties& properties) {
 }
 
 
+EntityItemPointer EntityTree::addEntityFromMap(QVariantMap& entityMap, int contentVersion, QScriptEngine& scriptEngine,
+                                               EntityItemID& entityItemID) {
+    // handle parentJointName for wearables
+    if (_myAvatar && entityMap.contains("parentJointName") && entityMap.contains("parentID") &&
+        QUuid(entityMap["parentID"].toString()) == AVATAR_SELF_ID) {
+
+        entityMap["parentJointIndex"] = _myAvatar->getJointIndex(entityMap["parentJointName"].toString());
+
+        qCDebug(entities) << "Found parentJointName " << entityMap["parentJointName"].toString() <<
+            " mapped it to parentJointIndex " << entityMap["parentJointIndex"].toInt();
+    }
+
+    QScriptValue entityScriptValue = variantMapToScriptValue(entityMap, scriptEngine);
+    EntityItemProperties properties;
+    EntityItemPropertiesFromScriptValueIgnoreReadOnly(entityScriptValue, properties);
+
+    if (entityMap.contains("id")) {
+        entityItemID = EntityItemID(QUuid(entityMap["id"].toString()));
+    } else {
+        entityItemID = EntityItemID(QUuid::createUuid());
+    }
+
+    // Convert old clientOnly bool to new entityHostType enum
+    // (must happen before setOwningAvatarID below)
+    if (contentVersion < (int)EntityVersion::EntityHostTypes) {
+        if (entityMap.contains("clientOnly")) {
+            properties.setEntityHostType(entityMap["clientOnly"].toBool() ? entity::HostType::AVATAR : entity::HostType::DOMAIN);
+        }
+    }
+
+    if (properties.getEntityHostType() == entity::HostType::AVATAR) {
+        auto nodeList = DependencyManager::get<NodeList>();
+        const QUuid myNodeID = nodeList->getSessionUUID();
+        properties.setOwningAvatarID(myNodeID);
+    }
+
+    // Fix for older content not containing mode fields in the zones
+    if (contentVersion < (int)EntityVersion::ZoneLightInheritModes && (properties.getType() == EntityTypes::EntityType::Zone)) {
+        // The legacy version had no keylight mode - this is set to on
+        properties.setKeyLightMode(COMPONENT_MODE_ENABLED);
+
+        // The ambient URL has been moved from "keyLight" to "ambientLight"
+        if (entityMap.contains("keyLight")) {
+            QVariantMap keyLightObject = entityMap["keyLight"].toMap();
+            properties.getAmbientLight().setAmbientURL(keyLightObject["ambientURL"].toString());
+        }
+
+        // Copy the skybox URL if the ambient URL is empty, as this is the legacy behaviour
+        // Use skybox value only if it is not empty, else set ambientMode to inherit (to use default URL)
+        properties.setAmbientLightMode(COMPONENT_MODE_ENABLED);
+        if (properties.getAmbientLight().getAmbientURL() == "") {
+            if (properties.getSkybox().getURL() != "") {
+                properties.getAmbientLight().setAmbientURL(properties.getSkybox().getURL());
+            } else {
+                properties.setAmbientLightMode(COMPONENT_MODE_INHERIT);
+            }
+        }
+
+        // The background should be enabled if the mode is skybox
+        // Note that if the values are default then they are not stored in the JSON file
+        if (entityMap.contains("backgroundMode") && (entityMap["backgroundMode"].toString() == "skybox")) {
+            properties.setSkyboxMode(COMPONENT_MODE_ENABLED);
+        } else {
+            properties.setSkyboxMode(COMPONENT_MODE_INHERIT);
+        }
+    }
+
+    // Convert old materials so that they use materialData instead of userData
+    if (contentVersion < (int)EntityVersion::MaterialData && properties.getType() == EntityTypes::EntityType::Material) {
+        if (properties.getMaterialURL().startsWith("userData")) {
+            QString materialURL = properties.getMaterialURL();
+            properties.setMaterialURL(materialURL.replace("userData", "materialData"));
+
+            QJsonObject userData = QJsonDocument::fromJson(properties.getUserData().toUtf8()).object();
+            QJsonObject materialData;
+            QJsonValue materialVersion = userData["materialVersion"];
+            if (!materialVersion.isNull()) {
+                materialData.insert("materialVersion", materialVersion);
+                userData.remove("materialVersion");
+            }
+            QJsonValue materials = userData["materials"];
+            if (!materials.isNull()) {
+                materialData.insert("materials", materials);
+                userData.remove("materials");
+            }
+
+            properties.setMaterialData(QJsonDocument(materialData).toJson());
+            properties.setUserData(QJsonDocument(userData).toJson());
+        }
+    }
+
+    // Convert old cloneable entities so they use cloneableData instead of userData
+    if (contentVersion < (int)EntityVersion::CloneableData) {
+        QJsonObject userData = QJsonDocument::fromJson(properties.getUserData().toUtf8()).object();
+        QJsonObject grabbableKey = userData["grabbableKey"].toObject();
+        QJsonValue cloneable = grabbableKey["cloneable"];
+        if (cloneable.isBool() && cloneable.toBool()) {
+            QJsonValue cloneLifetime = grabbableKey["cloneLifetime"];
+            QJsonValue cloneLimit = grabbableKey["cloneLimit"];
+            QJsonValue cloneDynamic = grabbableKey["cloneDynamic"];
+            QJsonValue cloneAvatarEntity = grabbableKey["cloneAvatarEntity"];
+
+            // This is cloneable, we need to convert the properties
+            properties.setCloneable(true);
+            properties.setCloneLifetime(cloneLifetime.toInt());
+            properties.setCloneLimit(cloneLimit.toInt());
+            properties.setCloneDynamic(cloneDynamic.toBool());
+            properties.setCloneAvatarEntity(cloneAvatarEntity.toBool());
+        }
+    }
+
+    // convert old grab-related userData to new grab properties
+    if (contentVersion < (int)EntityVersion::GrabProperties) {
+        convertGrabUserDataToProperties(properties);
+    }
+
+    // Zero out the spread values that were fixed in version ParticleEntityFix so they behave the same as before
+    if (contentVersion < (int)EntityVersion::ParticleEntityFix) {
+        properties.setRadiusSpread(0.0f);
+        properties.setAlphaSpread(0.0f);
+        properties.setColorSpread({0, 0, 0});
+    }
+
+    if (contentVersion < (int)EntityVersion::FixPropertiesFromCleanup) {
+        if (entityMap.contains("created")) {
+            quint64 created = QDateTime::fromString(entityMap["created"].toString().trimmed(), Qt::ISODate).toMSecsSinceEpoch() * 1000;
+            properties.setCreated(created);
+        }
+    }
+
+    return addEntity(entityItemID, properties);
+}
+
 bool EntityTree::readFromMap(QVariantMap& map) {
     // These are needed to deal with older content (before adding inheritance modes)
     int contentVersion = map["Version"].toInt();
@@ -2943,147 +3193,206 @@ bool EntityTree::readFromMap(QVariantMap& map) {
     foreach (QVariant entityVariant, entitiesQList) {
         // QVariantMap --> QScriptValue --> EntityItemProperties --> Entity
         QVariantMap entityMap = entityVariant.toMap();
+        EntityItemID entityItemID;
+        EntityItemPointer entity = addEntityFromMap(entityMap, contentVersion, scriptEngine, entityItemID);
+        if (!entity) {
+            qCDebug(entities) << "adding Entity failed:" << entityItemID << entityMap["type"].toString();
+            success = false;
+        }
 
-        // handle parentJointName for wearables
-        if (_myAvatar && entityMap.contains("parentJointName") && entityMap.contains("parentID") &&
-            QUuid(entityMap["parentID"].toString()) == AVATAR_SELF_ID) {
-
-            entityMap["parentJointIndex"] = _myAvatar->getJointIndex(entityMap["parentJointName"].toString());
+        if (entity) {
+            const QUuid& cloneOriginID = entity->getCloneOriginID();
+            if (!cloneOriginID.isNull()) {
+                cloneIDs[cloneOriginID].push_back(entity->getEntityItemID());
+            }
+        }
+    }
 
-            qCDebug(entities) << "Found parentJointName " << entityMap["parentJointName"].toString() <<
-                " mapped it to parentJointIndex " << entityMap["parentJointIndex"].toInt();
+    for (const auto& entityID : cloneIDs.keys()) {
+        auto entity = findEntityByID(entityID);
+        if (entity) {
+            entity->setCloneIDs(cloneIDs.value(entityID));
         }
+    }
 
-        QScriptValue entityScriptValue = variantMapToScriptValue(entityMap, scriptEngine);
-        EntityItemProperties properties;
-        EntityItemPropertiesFromScriptValueIgnoreReadOnly(entityScriptValue, properties);
+    return success;
+}
 
-        EntityItemID entityItemID;
-        if (entityMap.contains("id")) {
-            entityItemID = EntityItemID(QUuid(entityMap["id"].toString()));
-        } else {
-            entityItemID = EntityItemID(QUuid::createUuid());
-        }
+void EntityTree::journalEntityChanged(const EntityItemPointer& entity) {
+    if (_journalingEnabled && entity->isDomainEntity()) {
+        QMutexLocker locker(&_journalLock);
+        _journalDeletedEntities.remove(entity->getEntityItemID());
+        _journalChangedEntities.insert(entity->getEntityItemID());
+    }
+}
 
-        // Convert old clientOnly bool to new entityHostType enum
-        // (must happen before setOwningAvatarID below)
-        if (contentVersion < (int)EntityVersion::EntityHostTypes) {
-            if (entityMap.contains("clientOnly")) {
-                properties.setEntityHostType(entityMap["clientOnly"].toBool() ? entity::HostType::AVATAR : entity::HostType::DOMAIN);
-            }
-        }
+void EntityTree::journalEntityDeleted(const EntityItemID& entityID) {
+    if (_journalingEnabled) {
+        QMutexLocker locker(&_journalLock);
+        _journalChangedEntities.remove(entityID);
+        _journalDeletedEntities.insert(entityID);
+    }
+}
 
-        if (properties.getEntityHostType() == entity::HostType::AVATAR) {
-            auto nodeList = DependencyManager::get<NodeList>();
-            const QUuid myNodeID = nodeList->getSessionUUID();
-            properties.setOwningAvatarID(myNodeID);
+void EntityTree::journalNeedsSnapshot() {
+    if (_journalingEnabled) {
+        QMutexLocker locker(&_journalLock);
+        _journalChangedEntities.clear();
+        _journalDeletedEntities.clear();
+        _journalNeedsSnapshot = true;
+    }
+}
+
+bool EntityTree::takeJournalRecords(std::vector<OctreeJournal::Record>& records) {
+    QSet<EntityItemID> changedEntities;
+    QSet<EntityItemID> deletedEntities;
+    {
+        QMutexLocker locker(&_journalLock);
+        changedEntities.swap(_journalChangedEntities);
+        deletedEntities.swap(_journalDeletedEntities);
+        if (_journalNeedsSnapshot) {
+            _journalNeedsSnapshot = false;
+            return false;
         }
+    }
 
-        // Fix for older content not containing mode fields in the zones
-        if (contentVersion < (int)EntityVersion::ZoneLightInheritModes && (properties.getType() == EntityTypes::EntityType::Zone)) {
-            // The legacy version had no keylight mode - this is set to on
-            properties.setKeyLightMode(COMPONENT_MODE_ENABLED);
+    records.reserve(records.size() + changedEntities.size() + deletedEntities.size());
 
-            // The ambient URL has been moved from "keyLight" to "ambientLight"
-            if (entityMap.contains("keyLight")) {
-                QVariantMap keyLightObject = entityMap["keyLight"].toMap();
-                properties.getAmbientLight().setAmbientURL(keyLightObject["ambientURL"].toString());
+    // changed entities are written whole, with the same properties the snapshot would have for them
+    QScriptEngine scriptEngine;
+    withReadLock([&] {
+        foreach (const EntityItemID& entityID, changedEntities) {
+            EntityItemPointer entity = findEntityByEntityItemID(entityID);
+            if (!entity) {
+                deletedEntities.insert(entityID);
+                continue;
             }
 
-            // Copy the skybox URL if the ambient URL is empty, as this is the legacy behaviour
-            // Use skybox value only if it is not empty, else set ambientMode to inherit (to use default URL)
-            properties.setAmbientLightMode(COMPONENT_MODE_ENABLED);
-            if (properties.getAmbientLight().getAmbientURL() == "") {
-                if (properties.getSkybox().getURL() != "") {
-                    properties.getAmbientLight().setAmbientURL(properties.getSkybox().getURL());
-                } else {
-                    properties.setAmbientLightMode(COMPONENT_MODE_INHERIT);
-                }
-            }
+            QVariantMap entityMap = EntityItemNonDefaultPropertiesToScriptValue(&scriptEngine, entity->getProperties())
+                .toVariant().toMap();
 
-            // The background should be enabled if the mode is skybox
-            // Note that if the values are default then they are not stored in the JSON file
-            if (entityMap.contains("backgroundMode") && (entityMap["backgroundMode"].toString() == "skybox")) {
-                properties.setSkyboxMode(COMPONENT_MODE_ENABLED);
-            } else {
-                properties.setSkyboxMode(COMPONENT_MODE_INHERIT);
-            }
+            QByteArray data;
+            QDataStream stream(&data, QIODevice::WriteOnly);
+            stream << entityMap;
+            records.push_back({ OctreeJournal::RecordType::Update, entityID, data });
         }
+    });
 
-        // Convert old materials so that they use materialData instead of userData
-        if (contentVersion < (int)EntityVersion::MaterialData && properties.getType() == EntityTypes::EntityType::Material) {
-            if (properties.getMaterialURL().startsWith("userData")) {
-                QString materialURL = properties.getMaterialURL();
-                properties.setMaterialURL(materialURL.replace("userData", "materialData"));
+    foreach (const EntityItemID& entityID, deletedEntities) {
+        records.push_back({ OctreeJournal::RecordType::Delete, entityID, QByteArray() });
+    }
 
-                QJsonObject userData = QJsonDocument::fromJson(properties.getUserData().toUtf8()).object();
-                QJsonObject materialData;
-                QJsonValue materialVersion = userData["materialVersion"];
-                if (!materialVersion.isNull()) {
-                    materialData.insert("materialVersion", materialVersion);
-                    userData.remove("materialVersion");
-                }
-                QJsonValue materials = userData["materials"];
-                if (!materials.isNull()) {
-                    materialData.insert("materials", materials);
-                    userData.remove("materials");
-                }
+    return true;
+}
 
-                properties.setMaterialData(QJsonDocument(materialData).toJson());
-                properties.setUserData(QJsonDocument(userData).toJson());
-            }
-        }
+bool EntityTree::applyJournalRecords(const std::vector<OctreeJournal::Record>& records, int contentVersion) {
+    // NOTE: the tree must be write-locked before calling this method
+    QScriptEngine scriptEngine;
+    bool success = true;
 
-        // Convert old cloneable entities so they use cloneableData instead of userData
-        if (contentVersion < (int)EntityVersion::CloneableData) {
-            QJsonObject userData = QJsonDocument::fromJson(properties.getUserData().toUtf8()).object();
-            QJsonObject grabbableKey = userData["grabbableKey"].toObject();
-            QJsonValue cloneable = grabbableKey["cloneable"];
-            if (cloneable.isBool() && cloneable.toBool()) {
-                QJsonValue cloneLifetime = grabbableKey["cloneLifetime"];
-                QJsonValue cloneLimit = grabbableKey["cloneLimit"];
-                QJsonValue cloneDynamic = grabbableKey["cloneDynamic"];
-                QJsonValue cloneAvatarEntity = grabbableKey["cloneAvatarEntity"];
+    for (const auto& record : records) {
+        EntityItemPointer existingEntity = findEntityByEntityItemID(EntityItemID(record.id));
+        if (existingEntity) {
+            // update records hold the whole entity, so replace it rather than merge into it
+            deleteEntitiesByPointer({ existingEntity });
+        }
 
-                // This is cloneable, we need to convert the properties
-                properties.setCloneable(true);
-                properties.setCloneLifetime(cloneLifetime.toInt());
-                properties.setCloneLimit(cloneLimit.toInt());
-                properties.setCloneDynamic(cloneDynamic.toBool());
-                properties.setCloneAvatarEntity(cloneAvatarEntity.toBool());
-            }
+        if (record.type != OctreeJournal::RecordType::Update) {
+            continue;
         }
 
-        // convert old grab-related userData to new grab properties
-        if (contentVersion < (int)EntityVersion::GrabProperties) {
-            convertGrabUserDataToProperties(properties);
+        QVariantMap entityMap;
+        QDataStream stream(record.data);
+        stream >> entityMap;
+
+        EntityItemID entityItemID;
+        EntityItemPointer entity = addEntityFromMap(entityMap, contentVersion, scriptEngine, entityItemID);
+        if (!entity) {
+            qCDebug(entities) << "replaying journaled Entity failed:" << entityItemID;
+            success = false;
+            continue;
         }
 
-        // Zero out the spread values that were fixed in version ParticleEntityFix so they behave the same as before
-        if (contentVersion < (int)EntityVersion::ParticleEntityFix) {
-            properties.setRadiusSpread(0.0f);
-            properties.setAlphaSpread(0.0f);
-            properties.setColorSpread({0, 0, 0});
+        const QUuid& cloneOriginID = entity->getCloneOriginID();
+        if (!cloneOriginID.isNull()) {
+            EntityItemPointer cloneOrigin = findEntityByID(cloneOriginID);
+            if (cloneOrigin) {
+                cloneOrigin->addCloneID(entityItemID);
+            }
         }
+    }
+
+    return success;
+}
+
+bool EntityTree::writeToSnapshotFile(const QString& filename, const QByteArray& sourceHash) {
+    EntitySnapshot::Header header;
+    header.sourceHash = sourceHash;
+    std::vector<EntityItemPointer> snapshotEntities;
+    withReadLock([&] {
+        header.persistID = _persistID;
+        header.dataVersion = _persistDataVersion;
 
-        if (contentVersion < (int)EntityVersion::FixPropertiesFromCleanup) {
-            if (entityMap.contains("created")) {
-                quint64 created = QDateTime::fromString(entityMap["created"].toString().trimmed(), Qt::ISODate).toMSecsSinceEpoch() * 1000;
-                properties.setCreated(created);
+        QReadLocker locker(&_entityMapLock);
+        snapshotEntities.reserve(_entityMap.size());
+        foreach (const EntityItemPointer& entity, _entityMap) {
+            // like the JSON file, don't save entities whose parent we weren't able to resolve
+            if (entity->isParentIDValid()) {
+                snapshotEntities.push_back(entity);
             }
         }
+    });
 
-        EntityItemPointer entity = addEntity(entityItemID, properties);
-        if (!entity) {
-            qCDebug(entities) << "adding Entity failed:" << entityItemID << properties.getType();
+    // the entities are encoded under their own locks, so that edits aren't held up for the whole write.
+    // Edits that land in the meantime are journaled or dirty the tree, same as the ones made after the JSON write.
+    return EntitySnapshot::write(filename, header, snapshotEntities);
+}
+
+bool EntityTree::readSnapshotFileInfo(const QString& filename, QUuid& id, int64_t& dataVersion,
+                                      QByteArray& sourceHash) const {
+    EntitySnapshot::Header header;
+    if (!EntitySnapshot::readHeader(filename, header)) {
+        return false;
+    }
+    id = header.persistID;
+    dataVersion = header.dataVersion;
+    sourceHash = header.sourceHash;
+    return true;
+}
+
+bool EntityTree::readFromSnapshotFile(const QString& filename) {
+    // NOTE: the tree must be write-locked before calling this method
+    EntitySnapshot::Header header;
+    std::vector<EntityItemPointer> snapshotEntities;
+    if (!EntitySnapshot::read(filename, header, snapshotEntities)) {
+        return false;
+    }
+
+    _persistID = header.persistID;
+    _persistDataVersion = header.dataVersion;
+
+    QMap<QUuid, QVector<QUuid>> cloneIDs;
+    bool success = true;
+
+    // the entities were decoded in parallel, adding them to the tree is still done one at a time
+    for (const auto& entity : snapshotEntities) {
+        if (getContainingElement(entity->getEntityItemID())) {
+            qCDebug(entities) << "adding Entity failed:" << entity->getEntityItemID() << EntityTypes::getEntityTypeName(entity->getType());
             success = false;
+            continue;
         }
 
-        if (entity) {
-            const QUuid& cloneOriginID = entity->getCloneOriginID();
-            if (!cloneOriginID.isNull()) {
-                cloneIDs[cloneOriginID].push_back(entity->getEntityItemID());
-            }
+        if (entity->getCreated() == UNKNOWN_CREATED_TIME) {
+            entity->recordCreationTime();
+        }
+
+        AddEntityOperator theOperator(getThisPointer(), entity);
+        recurseTreeWithOperator(&theOperator);
+        postAddEntity(entity);
+
+        const QUuid& cloneOriginID = entity->getCloneOriginID();
+        if (!cloneOriginID.isNull()) {
+            cloneIDs[cloneOriginID].push_back(entity->getEntityItemID());
         }
     }
 
@@ -12,6 +12,9 @@
 #ifndef hifi_EntityTree_h
 #define hifi_EntityTree_h
 
+#include <atomic>
+
+#include <QMutex>
 #include <QSet>
 #include <QVector>
 
@@ -27,6 +30,7 @@ class EntityTree;
 using EntityTreePointer = std::shared_ptr<EntityTree>;
 
 class EntitySimulation;
+class QScriptEngine;
 
 namespace EntityQueryFilterSymbol {
     static const QString NonDefault = "+";
@@ -45,6 +49,23 @@ public:
     QHash<EntityItemID, EntityItemID>* map;
 };
 
+// One ray of a batch of rays evaluated together by EntityTree::evalRayIntersections
+class EntityRayQuery {
+public:
+    // Inputs
+    PickRay ray;
+    QVector<EntityItemID> entityIdsToInclude;
+    QVector<EntityItemID> entityIdsToDiscard;
+    PickFilter searchFilter;
+
+    // Outputs
+    EntityItemID entityID;
+    float distance { FLT_MAX };
+    BoxFace face { UNKNOWN_FACE };
+    glm::vec3 surfaceNormal;
+    QVariantMap extraInfo;
+};
+
 class EntityTree : public Octree, public SpatialParentTree {
     Q_OBJECT
 public:
@@ -99,6 +120,11 @@ public:
         BoxFace& face, glm::vec3& surfaceNormal, QVariantMap& extraInfo,
         Octree::lockType lockType = Octree::TryLock, bool* accurateResult = NULL);
 
+    // Finds the closest intersection of each ray in one walk of the tree rather than one walk per ray. Each element
+    // is visited with the rays that enter it before their closest hit so far, nearest element first.
+    void evalRayIntersections(std::vector<EntityRayQuery>& queries,
+        Octree::lockType lockType = Octree::TryLock, bool* accurateResult = NULL);
+
     virtual EntityItemID evalParabolaIntersection(const PickParabola& parabola,
         QVector<EntityItemID> entityIdsToInclude, QVector<EntityItemID> entityIdsToDiscard,
         PickFilter searchFilter, OctreeElementPointer& element, glm::vec3& intersection,
@@ -198,6 +224,15 @@ public:
     virtual bool readFromMap(QVariantMap& entityDescription) override;
     virtual bool writeToJSON(QString& jsonString, const OctreeElementPointer& element) override;
 
+    virtual void setJournalingEnabled(bool enabled) override { _journalingEnabled = enabled; }
+    virtual bool takeJournalRecords(std::vector<OctreeJournal::Record>& records) override;
+    virtual bool applyJournalRecords(const std::vector<OctreeJournal::Record>& records, int contentVersion) override;
+
+    virtual bool writeToSnapshotFile(const QString& filename, const QByteArray& sourceHash) override;
+    virtual bool readSnapshotFileInfo(const QString& filename, QUuid& id, int64_t& dataVersion,
+                                      QByteArray& sourceHash) const override;
+    virtual bool readFromSnapshotFile(const QString& filename) override;
+
 
     glm::vec3 getContentsDimensions();
     float getContentsLargestDimension();
@@ -307,6 +342,20 @@ protected:
 
     bool isScriptInWhitelist(const QString& scriptURL);
 
+    EntityItemPointer addEntityFromMap(QVariantMap& entityMap, int contentVersion, QScriptEngine& scriptEngine,
+                                       EntityItemID& entityItemID);
+
+    // record domain entity changes for the persist journal (server only, see takeJournalRecords)
+    void journalEntityChanged(const EntityItemPointer& entity);
+    void journalEntityDeleted(const EntityItemID& entityID);
+    void journalNeedsSnapshot();
+
+    std::atomic<bool> _journalingEnabled { false };
+    QMutex _journalLock;
+    QSet<EntityItemID> _journalChangedEntities;
+    QSet<EntityItemID> _journalDeletedEntities;
+    bool _journalNeedsSnapshot { false };
+
     QReadWriteLock _newlyCreatedHooksLock;
     QVector<NewlyCreatedEntityHook*> _newlyCreatedHooks;
 
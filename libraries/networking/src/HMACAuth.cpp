@@ -18,30 +18,126 @@
 #include "NetworkLogging.h"
 #include <cassert>
 
+static_assert(HMACAuth::MAX_HASH_LENGTH >= EVP_MAX_MD_SIZE, "HMACAuth::MAX_HASH_LENGTH is smaller than an OpenSSL digest");
+
 #if OPENSSL_VERSION_NUMBER >= 0x10100000
-HMACAuth::HMACAuth(AuthMethod authMethod)
-    : _hmacContext(HMAC_CTX_new())
-    , _authMethod(authMethod) { }
+static HMAC_CTX* newHMACContext() {
+    return HMAC_CTX_new();
+}
 
-HMACAuth::~HMACAuth()
-{
-    HMAC_CTX_free(_hmacContext);
+static void freeHMACContext(HMAC_CTX* context) {
+    HMAC_CTX_free(context);
+}
+
+static bool copyHMACContext(HMAC_CTX* destination, HMAC_CTX* source) {
+    return (bool) HMAC_CTX_copy(destination, source);
 }
 
 #else
 
-HMACAuth::HMACAuth(AuthMethod authMethod)
-    : _hmacContext(new HMAC_CTX())
-    , _authMethod(authMethod) {
-    HMAC_CTX_init(_hmacContext);
+static HMAC_CTX* newHMACContext() {
+    auto context = new HMAC_CTX();
+    HMAC_CTX_init(context);
+    return context;
 }
 
-HMACAuth::~HMACAuth() {
-    HMAC_CTX_cleanup(_hmacContext);
-    delete _hmacContext;
+static void freeHMACContext(HMAC_CTX* context) {
+    HMAC_CTX_cleanup(context);
+    delete context;
+}
+
+static bool copyHMACContext(HMAC_CTX* destination, HMAC_CTX* source) {
+    // the 1.0 copy initializes the destination without freeing what it held
+    HMAC_CTX_cleanup(destination);
+    HMAC_CTX_init(destination);
+    return (bool) HMAC_CTX_copy(destination, source);
 }
 #endif
 
+// a per thread context the keyed context is copied into, for one-shot hashes that don't hold the lock
+struct ScratchHMACContext {
+    ScratchHMACContext() : context(newHMACContext()) { }
+    ~ScratchHMACContext() { freeHMACContext(context); }
+    HMAC_CTX* context;
+};
+
+static const int SIP_HASH_KEY_LENGTH = 16;
+static const unsigned int SIP_HASH_LENGTH = 16;
+
+static inline uint64_t rotateLeft(uint64_t value, int bits) {
+    return (value << bits) | (value >> (64 - bits));
+}
+
+static inline uint64_t readLittleEndian64(const unsigned char* bytes) {
+    uint64_t value = 0;
+    for (int i = 7; i >= 0; --i) {
+        value = (value << 8) | bytes[i];
+    }
+    return value;
+}
+
+static inline void writeLittleEndian64(unsigned char* bytes, uint64_t value) {
+    for (int i = 0; i < 8; ++i) {
+        bytes[i] = (unsigned char)value;
+        value >>= 8;
+    }
+}
+
+static inline void sipRound(uint64_t& v0, uint64_t& v1, uint64_t& v2, uint64_t& v3) {
+    v0 += v1; v1 = rotateLeft(v1, 13); v1 ^= v0; v0 = rotateLeft(v0, 32);
+    v2 += v3; v3 = rotateLeft(v3, 16); v3 ^= v2;
+    v0 += v3; v3 = rotateLeft(v3, 21); v3 ^= v0;
+    v2 += v1; v1 = rotateLeft(v1, 17); v1 ^= v2; v2 = rotateLeft(v2, 32);
+}
+
+// SipHash-2-4 with its 128 bit output, as in the reference implementation
+static void sipHash128(const uint64_t key[2], const unsigned char* data, size_t dataLen, unsigned char* hashResult) {
+    uint64_t v0 = 0x736f6d6570736575ULL ^ key[0];
+    uint64_t v1 = 0x646f72616e646f6dULL ^ key[1] ^ 0xee;
+    uint64_t v2 = 0x6c7967656e657261ULL ^ key[0];
+    uint64_t v3 = 0x7465646279746573ULL ^ key[1];
+
+    const unsigned char* end = data + (dataLen & ~(size_t)7);
+    for (; data != end; data += 8) {
+        uint64_t block = readLittleEndian64(data);
+        v3 ^= block;
+        sipRound(v0, v1, v2, v3);
+        sipRound(v0, v1, v2, v3);
+        v0 ^= block;
+    }
+
+    uint64_t lastBlock = ((uint64_t)dataLen) << 56;
+    for (size_t i = 0; i < (dataLen & 7); ++i) {
+        lastBlock |= ((uint64_t)data[i]) << (8 * i);
+    }
+    v3 ^= lastBlock;
+    sipRound(v0, v1, v2, v3);
+    sipRound(v0, v1, v2, v3);
+    v0 ^= lastBlock;
+
+    v2 ^= 0xee;
+    for (int i = 0; i < 4; ++i) {
+        sipRound(v0, v1, v2, v3);
+    }
+    writeLittleEndian64(hashResult, v0 ^ v1 ^ v2 ^ v3);
+
+    v1 ^= 0xdd;
+    for (int i = 0; i < 4; ++i) {
+        sipRound(v0, v1, v2, v3);
+    }
+    writeLittleEndian64(hashResult + 8, v0 ^ v1 ^ v2 ^ v3);
+}
+
+HMACAuth::HMACAuth(AuthMethod authMethod)
+    : _hmacContext(newHMACContext())
+    , _keyedContext(newHMACContext())
+    , _authMethod(authMethod) { }
+
+HMACAuth::~HMACAuth() {
+    freeHMACContext(_hmacContext);
+    freeHMACContext(_keyedContext);
+}
+
 bool HMACAuth::setKey(const char* keyValue, int keyLen) {
     const EVP_MD* sslStruct = nullptr;
 
@@ -66,12 +162,28 @@ bool HMACAuth::setKey(const char* keyValue, int keyLen) {
         sslStruct = EVP_ripemd160();
         break;
 
+    case SipHash: {
+        if (keyLen != SIP_HASH_KEY_LENGTH) {
+            return false;
+        }
+
+        QMutexLocker lock(&_lock);
+        auto keyBytes = reinterpret_cast<const unsigned char*>(keyValue);
+        _sipHashKey[0] = readLittleEndian64(keyBytes);
+        _sipHashKey[1] = readLittleEndian64(keyBytes + 8);
+        _sipHashData.clear();
+        _hasKey = true;
+        return true;
+    }
+
     default:
         return false;
     }
 
     QMutexLocker lock(&_lock);
-    return (bool) HMAC_Init_ex(_hmacContext, keyValue, keyLen, sslStruct, nullptr);
+    _hasKey = HMAC_Init_ex(_hmacContext, keyValue, keyLen, sslStruct, nullptr)
+        && copyHMACContext(_keyedContext, _hmacContext);
+    return _hasKey;
 }
 
 bool HMACAuth::setKey(const QUuid& uidKey) {
@@ -81,13 +193,25 @@ bool HMACAuth::setKey(const QUuid& uidKey) {
 
 bool HMACAuth::addData(const char* data, int dataLen) {
     QMutexLocker lock(&_lock);
+    if (_authMethod == SipHash) {
+        _sipHashData.append(data, dataLen);
+        return true;
+    }
     return (bool) HMAC_Update(_hmacContext, reinterpret_cast<const unsigned char*>(data), dataLen);
 }
 
 HMACAuth::HMACHash HMACAuth::result() {
-    HMACHash hashValue(EVP_MAX_MD_SIZE);
+    HMACHash hashValue(MAX_HASH_LENGTH);
     unsigned int hashLen;
     QMutexLocker lock(&_lock);
+
+    if (_authMethod == SipHash) {
+        sipHash128(_sipHashKey, reinterpret_cast<const unsigned char*>(_sipHashData.constData()),
+                   _sipHashData.size(), &hashValue[0]);
+        hashValue.resize(SIP_HASH_LENGTH);
+        _sipHashData.clear();
+        return hashValue;
+    }
     
     auto hmacResult = HMAC_Final(_hmacContext, &hashValue[0], &hashLen);
     
@@ -105,13 +229,43 @@ HMACAuth::HMACHash HMACAuth::result() {
 }
 
 bool HMACAuth::calculateHash(HMACHash& hashResult, const char* data, int dataLen) {
-    QMutexLocker lock(&_lock);
-    if (!addData(data, dataLen)) {
-        qCWarning(networking) << "Error occured calling HMACAuth::addData()";
+    unsigned char hashBuffer[MAX_HASH_LENGTH];
+    unsigned int hashLength = 0;
+    if (!calculateHash(hashBuffer, hashLength, data, dataLen)) {
+        qCWarning(networking) << "Error occured calculating HMACAuth hash";
         assert(false);
         return false;
     }
 
-    hashResult = result();
+    hashResult.assign(hashBuffer, hashBuffer + hashLength);
     return true;
 }
+
+bool HMACAuth::calculateHash(unsigned char* hashResult, unsigned int& hashLength, const char* data, int dataLen) {
+    if (_authMethod == SipHash) {
+        uint64_t key[2];
+        {
+            QMutexLocker lock(&_lock);
+            if (!_hasKey) {
+                return false;
+            }
+            key[0] = _sipHashKey[0];
+            key[1] = _sipHashKey[1];
+        }
+
+        sipHash128(key, reinterpret_cast<const unsigned char*>(data), (size_t)dataLen, hashResult);
+        hashLength = SIP_HASH_LENGTH;
+        return true;
+    }
+
+    thread_local ScratchHMACContext scratch;
+    {
+        QMutexLocker lock(&_lock);
+        if (!_hasKey || !copyHMACContext(scratch.context, _keyedContext)) {
+            return false;
+        }
+    }
+
+    return HMAC_Update(scratch.context, reinterpret_cast<const unsigned char*>(data), dataLen)
+        && HMAC_Final(scratch.context, hashResult, &hashLength);
+}
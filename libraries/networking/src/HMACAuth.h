@@ -12,17 +12,23 @@
 #ifndef hifi_HMACAuth_h
 #define hifi_HMACAuth_h
 
+#include <cstdint>
 #include <vector>
 #include <memory>
+#include <QtCore/QByteArray>
 #include <QtCore/QMutex>
 
 class QUuid;
 
 class HMACAuth {
 public:
-    enum AuthMethod { MD5, SHA1, SHA224, SHA256, RIPEMD160 };
+    // SipHash is SipHash-2-4 with a 128 bit result, a keyed hash much cheaper than an HMAC on packet sized data.
+    // It needs a 16 byte key.
+    enum AuthMethod { MD5, SHA1, SHA224, SHA256, RIPEMD160, SipHash };
     using HMACHash = std::vector<unsigned char>;
-    
+
+    static const int MAX_HASH_LENGTH = 64;
+
     explicit HMACAuth(AuthMethod authMethod = MD5);
     ~HMACAuth();
 
@@ -30,6 +36,9 @@ public:
     bool setKey(const QUuid& uidKey);
     // Calculate complete hash in one.
     bool calculateHash(HMACHash& hashResult, const char* data, int dataLen);
+    // Calculate complete hash in one, into hashResult (at least MAX_HASH_LENGTH bytes), without allocating.
+    // Only setting up from the key takes the lock, so calls from several threads hash in parallel.
+    bool calculateHash(unsigned char* hashResult, unsigned int& hashLength, const char* data, int dataLen);
 
     // Append to data to be hashed.
     bool addData(const char* data, int dataLen);
@@ -38,10 +47,17 @@ public:
     // HMACAuth instance if this interface is used.
     HMACHash result();
 
+    AuthMethod getAuthMethod() const { return _authMethod; }
+
 private:
     QMutex _lock { QMutex::Recursive };
     struct hmac_ctx_st* _hmacContext;
+    struct hmac_ctx_st* _keyedContext; // as it was after setKey, copied by the one-shot calculateHash
     AuthMethod _authMethod;
+    bool _hasKey { false };
+
+    uint64_t _sipHashKey[2] { 0, 0 };
+    QByteArray _sipHashData; // addData() for SipHash collects the data, result() hashes it
 };
 
 #endif  // hifi_HMACAuth_h
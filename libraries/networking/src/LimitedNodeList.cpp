@@ -25,6 +25,7 @@
 
 #include <LogHandler.h>
 #include <shared/NetworkUtils.h>
+#include <shared/WorkStealingScheduler.h>
 #include <NumericalConstants.h>
 #include <SettingHandle.h>
 #include <SharedUtil.h>
@@ -49,6 +50,10 @@ static Setting::Handle<quint16> LIMITED_NODELIST_LOCAL_PORT("LimitedNodeList.Loc
 using namespace std::chrono_literals;
 static const std::chrono::milliseconds CONNECTION_RATE_INTERVAL_MS = 1s;
 
+// below this many hashes to check in a batch they are checked on the network thread, the hand-off isn't worth it
+static const size_t MIN_PACKETS_FOR_PARALLEL_VERIFICATION = 8;
+static const size_t PACKETS_PER_VERIFICATION_CHUNK = 4;
+
 LimitedNodeList::LimitedNodeList(int socketListenPort, int dtlsListenPort) :
     _nodeSocket(this),
     _packetReceiver(new PacketReceiver(this))
@@ -110,7 +115,9 @@ LimitedNodeList::LimitedNodeList(int socketListenPort, int dtlsListenPort) :
 
     // set our isPacketVerified method as the verify operator for the udt::Socket
     using std::placeholders::_1;
+    using std::placeholders::_2;
     _nodeSocket.setPacketFilterOperator(std::bind(&LimitedNodeList::isPacketVerified, this, _1));
+    _nodeSocket.setPacketBatchFilterOperator(std::bind(&LimitedNodeList::verifyPacketBatch, this, _1, _2));
 
     // set our socketBelongsToNode method as the connection creation filter operator for the udt::Socket
     _nodeSocket.setConnectionCreationFilterOperator(std::bind(&LimitedNodeList::sockAddrBelongsToNode, this, _1));
@@ -286,11 +293,127 @@ bool LimitedNodeList::packetVersionMatch(const udt::Packet& packet) {
     }
 }
 
+void LimitedNodeList::verifyPacketBatch(const std::vector<const udt::Packet*>& packets, std::vector<uint8_t>& verified) {
+    struct PendingHashCheck {
+        size_t index;
+        Node* sourceNode;
+        uint8_t matches;
+    };
+
+    verified.assign(packets.size(), 0);
+
+    // everything but the hashes is checked in order, on this thread
+    std::vector<PendingHashCheck> hashChecks;
+    std::vector<Node*> sourceNodes(packets.size(), nullptr);
+    for (size_t i = 0; i < packets.size(); ++i) {
+        const udt::Packet& packet = *packets[i];
+        bool needsHashCheck = false;
+
+        if (packetVersionMatch(packet) && packetSourceMatch(packet, sourceNodes[i], needsHashCheck)) {
+            if (needsHashCheck) {
+                hashChecks.push_back({ i, sourceNodes[i], 0 });
+            } else {
+                verified[i] = 1;
+            }
+        }
+    }
+
+    // the hashes of a batch are independent, so they are spread over the shared scheduler's workers when there is one -
+    // nodes are only deleted from this thread's event loop, so the source nodes outlive the checks
+    auto checkHashes = [&](size_t first, size_t last) {
+        for (size_t i = first; i < last; ++i) {
+            auto& check = hashChecks[i];
+            check.matches = packetHashMatch(*packets[check.index], *check.sourceNode);
+        }
+    };
+
+    if (hashChecks.size() >= MIN_PACKETS_FOR_PARALLEL_VERIFICATION && DependencyManager::isSet<WorkStealingScheduler>()) {
+        auto scheduler = DependencyManager::get<WorkStealingScheduler>();
+        WorkStealingScheduler::Job job;
+        job.numItems = hashChecks.size();
+        job.chunkSize = PACKETS_PER_VERIFICATION_CHUNK;
+        job.maxParticipants = scheduler->getMaxParticipants();
+        job.process = [&](int participant, size_t first, size_t last) {
+            checkHashes(first, last);
+        };
+        scheduler->run(job);
+    } else {
+        checkHashes(0, hashChecks.size());
+    }
+
+    for (const auto& check : hashChecks) {
+        if (check.matches) {
+            verified[check.index] = 1;
+        } else {
+            reportPacketHashMismatch(*packets[check.index], *check.sourceNode);
+        }
+    }
+
+    // No matter if these packets are handled or not, we update the timestamp for the last time we heard
+    // from their sending nodes
+    auto now = usecTimestampNow();
+    for (size_t i = 0; i < packets.size(); ++i) {
+        if (verified[i] && sourceNodes[i]) {
+            sourceNodes[i]->setLastHeardMicrostamp(now);
+        }
+    }
+}
+
 bool LimitedNodeList::packetSourceAndHashMatchAndTrackBandwidth(const udt::Packet& packet, Node* sourceNode) {
+    bool needsHashCheck = false;
+    if (!packetSourceMatch(packet, sourceNode, needsHashCheck)) {
+        return false;
+    }
+
+    if (needsHashCheck && !packetHashMatch(packet, *sourceNode)) {
+        reportPacketHashMismatch(packet, *sourceNode);
+        return false;
+    }
+
+    if (sourceNode) {
+        // No matter if this packet is handled or not, we update the timestamp for the last time we heard
+        // from this sending node
+        sourceNode->setLastHeardMicrostamp(usecTimestampNow());
+    }
+
+    return true;
+}
+
+bool LimitedNodeList::packetHashMatch(const udt::Packet& packet, const Node& sourceNode) const {
+    auto sourceNodeHMACAuth = sourceNode.getAuthenticateHash();
+    return sourceNodeHMACAuth && NLPacket::verificationHashMatches(packet, *sourceNodeHMACAuth);
+}
+
+void LimitedNodeList::reportPacketHashMismatch(const udt::Packet& packet, const Node& sourceNode) {
+    static QMultiMap<QUuid, PacketType> hashDebugSuppressMap;
+
+    PacketType headerType = NLPacket::typeInHeader(packet);
+    QUuid sourceID = sourceNode.getUUID();
+
+    if (!hashDebugSuppressMap.contains(sourceID, headerType)) {
+        QByteArray packetHeaderHash = NLPacket::verificationHashInHeader(packet);
+        QByteArray expectedHash;
+        if (auto sourceNodeHMACAuth = sourceNode.getAuthenticateHash()) {
+            expectedHash = NLPacket::hashForPacketAndHMAC(packet, *sourceNodeHMACAuth);
+        }
+
+        qCDebug(networking) << "Packet hash mismatch on" << headerType << "- Sender" << sourceID;
+        qCDebug(networking) << "Packet len:" << packet.getDataSize() << "Expected hash:" <<
+            expectedHash.toHex() << "Actual:" << packetHeaderHash.toHex();
+
+        hashDebugSuppressMap.insert(sourceID, headerType);
+    }
+}
+
+bool LimitedNodeList::packetSourceMatch(const udt::Packet& packet, Node*& sourceNode, bool& needsHashCheck) {
+    needsHashCheck = false;
 
     PacketType headerType = NLPacket::typeInHeader(packet);
 
     if (PacketTypeEnum::getNonSourcedPackets().contains(headerType)) {
+        // there is no sending node to track for a non-sourced packet
+        sourceNode = nullptr;
+
         if (PacketTypeEnum::getReplicatedPacketMapping().key(headerType) != PacketType::Unknown) {
             // this is a replicated packet type - make sure the socket that sent it to us matches
             // one from one of our current upstream nodes
@@ -345,34 +468,8 @@ bool LimitedNodeList::packetSourceAndHashMatchAndTrackBandwidth(const udt::Packe
             bool verificationEnabled = !(isDomainServer() && PacketTypeEnum::getDomainIgnoredVerificationPackets().contains(headerType))
                 && _useAuthentication;
 
-            if (verifiedPacket && verificationEnabled) {
-
-                QByteArray packetHeaderHash = NLPacket::verificationHashInHeader(packet);
-                QByteArray expectedHash;
-                auto sourceNodeHMACAuth = sourceNode->getAuthenticateHash();
-                if (sourceNode->getAuthenticateHash()) {
-                    expectedHash = NLPacket::hashForPacketAndHMAC(packet, *sourceNodeHMACAuth);
-                }
-
-                // check if the HMAC-md5 hash in the header matches the hash we would expect
-                if (!sourceNodeHMACAuth || packetHeaderHash != expectedHash) {
-                    static QMultiMap<QUuid, PacketType> hashDebugSuppressMap;
-
-                    if (!hashDebugSuppressMap.contains(sourceID, headerType)) {
-                        qCDebug(networking) << "Packet hash mismatch on" << headerType << "- Sender" << sourceID;
-                        qCDebug(networking) << "Packet len:" << packet.getDataSize() << "Expected hash:" <<
-                            expectedHash.toHex() << "Actual:" << packetHeaderHash.toHex();
-
-                        hashDebugSuppressMap.insert(sourceID, headerType);
-                    }
-
-                    return false;
-                }
-            }
-
-            // No matter if this packet is handled or not, we update the timestamp for the last time we heard
-            // from this sending node
-            sourceNode->setLastHeardMicrostamp(usecTimestampNow());
+            // the hash in the header is checked against the one we would expect by packetHashMatch
+            needsHashCheck = verifiedPacket && verificationEnabled;
 
             return true;
 
@@ -577,40 +674,22 @@ NodeData* LimitedNodeList::getOrCreateLinkedData(SharedNodePointer node) {
 }
 
 SharedNodePointer LimitedNodeList::nodeWithUUID(const QUuid& nodeUUID) {
-    QReadLocker readLocker(&_nodeMutex);
-
-    NodeHash::const_iterator it = _nodeHash.find(nodeUUID);
-    return it == _nodeHash.cend() ? SharedNodePointer() : it->second;
- }
+    return _nodeRegistry.getSnapshot()->nodeWithUUID(nodeUUID);
+}
 
 SharedNodePointer LimitedNodeList::nodeWithLocalID(Node::LocalID localID) const {
-    QReadLocker readLocker(&_nodeMutex);
-
-    LocalIDMapping::const_iterator idIter = _localIDMap.find(localID);
-    return idIter == _localIDMap.cend() ? nullptr : idIter->second;
+    return _nodeRegistry.getSnapshot()->nodeWithLocalID(localID);
 }
 
 void LimitedNodeList::eraseAllNodes(QString reason) {
-    std::vector<SharedNodePointer> killedNodes;
-
-    {
-        // iterate the current nodes - grab them so we can emit that they are dying
-        // and then remove them from the hash
-        QWriteLocker writeLocker(&_nodeMutex);
+    // remove the current nodes - and grab them so we can emit that they are dying
+    std::vector<SharedNodePointer> killedNodes = _nodeRegistry.clear();
 
-        if (_nodeHash.size() > 0) {
-            qCDebug(networking) << "LimitedNodeList::eraseAllNodes() removing all nodes from NodeList:" << reason;
-
-            killedNodes.reserve(_nodeHash.size());
-            for (auto& pair : _nodeHash) {
-                killedNodes.push_back(pair.second);
-            }
-        }
-        _localIDMap.clear();
-        _nodeHash.clear();
+    if (!killedNodes.empty()) {
+        qCDebug(networking) << "LimitedNodeList::eraseAllNodes() removing all nodes from NodeList:" << reason;
     }
 
-    foreach(const SharedNodePointer& killedNode, killedNodes) {
+    for (const SharedNodePointer& killedNode : killedNodes) {
         handleNodeKill(killedNode);
     }
 
@@ -628,13 +707,8 @@ void LimitedNodeList::reset(QString reason) {
 bool LimitedNodeList::killNodeWithUUID(const QUuid& nodeUUID, ConnectionID newConnectionID) {
     auto matchingNode = nodeWithUUID(nodeUUID);
 
-    if (matchingNode) {
-        {
-            QWriteLocker writeLocker(&_nodeMutex);
-            _localIDMap.unsafe_erase(matchingNode->getLocalID());
-            _nodeHash.unsafe_erase(matchingNode->getUUID());
-        }
-
+    // only the caller that actually removed the node handles its kill
+    if (matchingNode && _nodeRegistry.remove(matchingNode->getUUID())) {
         handleNodeKill(matchingNode, newConnectionID);
         return true;
     }
@@ -682,18 +756,17 @@ SharedNodePointer LimitedNodeList::addOrUpdateNode(const QUuid& uuid, NodeType_t
         matchingNode->setConnectionSecret(connectionSecret);
         matchingNode->setIsReplicated(isReplicated);
         matchingNode->setIsUpstream(isUpstream || NodeType::isUpstream(nodeType));
-        matchingNode->setLocalID(localID);
+        if (matchingNode->getLocalID() != localID) {
+            matchingNode->setLocalID(localID);
+            // re-index the node under its new local ID
+            _nodeRegistry.add(matchingNode);
+        }
 
         return matchingNode;
     }
 
     auto removeOldNode = [&](auto node) {
-        if (node) {
-            {
-                QWriteLocker writeLocker(&_nodeMutex);
-                _localIDMap.unsafe_erase(node->getLocalID());
-                _nodeHash.unsafe_erase(node->getUUID());
-            }
+        if (node && _nodeRegistry.remove(node->getUUID())) {
             handleNodeKill(node);
         }
     };
@@ -731,12 +804,10 @@ SharedNodePointer LimitedNodeList::addOrUpdateNode(const QUuid& uuid, NodeType_t
 
     SharedNodePointer newNodePointer(newNode, &QObject::deleteLater);
 
-
-    {
-        QReadLocker readLocker(&_nodeMutex);
-        // insert the new node and release our read lock
-        _nodeHash.insert({ newNode->getUUID(), newNodePointer });
-        _localIDMap.insert({ localID, newNodePointer });
+    if (_nodeRegistry.add(newNodePointer) != newNodePointer) {
+        // another thread added this node first, that one stays and is updated instead
+        return addOrUpdateNode(uuid, nodeType, publicSocket, localSocket, localID, isReplicated, isUpstream,
+                               connectionSecret, permissions);
     }
 
     qCDebug(networking) << "Added" << *newNode;
@@ -890,30 +961,16 @@ SharedNodePointer LimitedNodeList::soloNodeOfType(NodeType_t nodeType) {
 
 void LimitedNodeList::removeSilentNodes() {
 
-    QSet<SharedNodePointer> killedNodes;
-
     auto startedAt = usecTimestampNow();
 
-    eachNodeHashIterator([&](NodeHash::iterator& it){
-        SharedNodePointer node = it->second;
-        node->getMutex().lock();
-
-        if (!node->isForcedNeverSilent()
-            && (usecTimestampNow() - node->getLastHeardMicrostamp()) > (NODE_SILENCE_THRESHOLD_MSECS * USECS_PER_MSEC)) {
-            // call the NodeHash erase to get rid of this node
-            _localIDMap.unsafe_erase(node->getLocalID());
-            it = _nodeHash.unsafe_erase(it);
+    auto killedNodes = _nodeRegistry.removeIf([&](const SharedNodePointer& node) {
+        QMutexLocker nodeLocker(&node->getMutex());
 
-            killedNodes.insert(node);
-        } else {
-            // we didn't erase this node, push the iterator forwards
-            ++it;
-        }
-
-        node->getMutex().unlock();
+        return !node->isForcedNeverSilent()
+            && (usecTimestampNow() - node->getLastHeardMicrostamp()) > (NODE_SILENCE_THRESHOLD_MSECS * USECS_PER_MSEC);
     });
 
-    foreach(const SharedNodePointer& killedNode, killedNodes) {
+    for (const SharedNodePointer& killedNode : killedNodes) {
         auto now = usecTimestampNow();
         qCDebug(networking_ice) << "Removing silent node" << *killedNode << "\n"
             << "    Now: " << now << "\n"
@@ -1285,23 +1342,17 @@ void LimitedNodeList::sendPeerQueryToIceServer(const HifiSockAddr& iceServerSock
 }
 
 SharedNodePointer LimitedNodeList::findNodeWithAddr(const HifiSockAddr& addr) {
-    QReadLocker locker(&_nodeMutex);
-    auto it = std::find_if(std::begin(_nodeHash), std::end(_nodeHash), [&addr](const UUIDNodePair& pair) {
-        return pair.second->getPublicSocket() == addr
-            || pair.second->getLocalSocket() == addr
-            || pair.second->getSymmetricSocket() == addr;
+    auto snapshot = _nodeRegistry.getSnapshot();
+    auto it = std::find_if(snapshot->cbegin(), snapshot->cend(), [&addr](const SharedNodePointer& node) {
+        return node->getPublicSocket() == addr
+            || node->getLocalSocket() == addr
+            || node->getSymmetricSocket() == addr;
     });
-    return (it != std::end(_nodeHash)) ? it->second : SharedNodePointer();
+    return (it != snapshot->cend()) ? *it : SharedNodePointer();
 }
 
 bool LimitedNodeList::sockAddrBelongsToNode(const HifiSockAddr& sockAddr) {
-    QReadLocker locker(&_nodeMutex);
-    auto it = std::find_if(std::begin(_nodeHash), std::end(_nodeHash), [&sockAddr](const UUIDNodePair& pair) {
-        return pair.second->getPublicSocket() == sockAddr
-            || pair.second->getLocalSocket() == sockAddr
-            || pair.second->getSymmetricSocket() == sockAddr;
-    });
-    return it != std::end(_nodeHash);
+    return !findNodeWithAddr(sockAddr).isNull();
 }
 
 void LimitedNodeList::sendPacketToIceServer(PacketType packetType, const HifiSockAddr& iceServerSockAddr,
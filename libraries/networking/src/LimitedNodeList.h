@@ -40,6 +40,7 @@
 #include "Node.h"
 #include "NLPacket.h"
 #include "NLPacketList.h"
+#include "NodeRegistry.h"
 #include "PacketReceiver.h"
 #include "ReceivedMessage.h"
 #include "udt/ControlPacket.h"
@@ -70,9 +71,6 @@ using ConnectionID = int64_t;
 const ConnectionID NULL_CONNECTION_ID { -1 };
 const ConnectionID INITIAL_CONNECTION_ID { 0 };
 
-typedef std::pair<QUuid, SharedNodePointer> UUIDNodePair;
-typedef tbb::concurrent_unordered_map<QUuid, SharedNodePointer, UUIDHasher> NodeHash;
-
 typedef quint8 PingType_t;
 namespace PingType {
     const PingType_t Agnostic = 0;
@@ -166,7 +164,7 @@ public:
 
     std::function<void(Node*)> linkedDataCreateCallback;
 
-    size_t size() const { QReadLocker readLock(&_nodeMutex); return _nodeHash.size(); }
+    size_t size() const { return _nodeRegistry.getSnapshot()->size(); }
 
     SharedNodePointer nodeWithUUID(const QUuid& nodeUUID);
     SharedNodePointer nodeWithLocalID(Node::LocalID localID) const;
@@ -203,12 +201,14 @@ public:
     SharedNodePointer findNodeWithAddr(const HifiSockAddr& addr);
 
     using value_type = SharedNodePointer;
-    using const_iterator = std::vector<value_type>::const_iterator;
+    using const_iterator = NodeRegistrySnapshot::const_iterator;
+
+    // The nodes as of now, lock-free - the snapshot never changes and keeps its nodes alive while it is held,
+    // nodes added or removed later are only seen by later snapshots
+    NodeRegistrySnapshotPointer getNodesSnapshot() const { return _nodeRegistry.getSnapshot(); }
 
-    // Cede control of iteration under a single read lock (e.g. for use by thread pools)
-    // Use this for nested loops instead of taking nested read locks!
-    //   This allows multiple threads (i.e. a thread pool) to share a lock
-    //   without deadlocking when a dying node attempts to acquire a write lock
+    // Cede control of iteration over a single snapshot of the nodes (e.g. for use by thread pools)
+    // Use this for nested loops instead of nested eachNode calls, so every level sees the same nodes
     template<typename NestedNodeLambda>
     void nestedEach(NestedNodeLambda functor,
                     int* lockWaitOut = nullptr,
@@ -217,29 +217,18 @@ public:
         quint64 start, endTransform, endFunctor;
 
         start = usecTimestampNow();
-        std::vector<SharedNodePointer> nodes;
-        {
-            QReadLocker readLock(&_nodeMutex);
-            auto endLock = usecTimestampNow();
-            if (lockWaitOut) {
-                *lockWaitOut = (endLock - start);
-            }
+        auto snapshot = _nodeRegistry.getSnapshot();
+        endTransform = usecTimestampNow();
 
-            // Size of _nodeHash could change at any time,
-            // so reserve enough memory for the current size
-            // and then back insert all the nodes found
-            nodes.reserve(_nodeHash.size());
-            std::transform(_nodeHash.cbegin(), _nodeHash.cend(), std::back_inserter(nodes), [&](const NodeHash::value_type& it) {
-                return it.second;
-            });
-
-            endTransform = usecTimestampNow();
-            if (nodeTransformOut) {
-                *nodeTransformOut = (endTransform - endLock);
-            }
+        // there is no lock to wait on or copy to make anymore, report the snapshot load as both
+        if (lockWaitOut) {
+            *lockWaitOut = (endTransform - start);
+        }
+        if (nodeTransformOut) {
+            *nodeTransformOut = 0;
         }
 
-        functor(nodes.cbegin(), nodes.cend());
+        functor(snapshot->cbegin(), snapshot->cend());
         endFunctor = usecTimestampNow();
         if (functorOut) {
             *functorOut = (endFunctor - endTransform);
@@ -248,30 +237,30 @@ public:
 
     template<typename NodeLambda>
     void eachNode(NodeLambda functor) {
-        QReadLocker readLock(&_nodeMutex);
+        auto snapshot = _nodeRegistry.getSnapshot();
 
-        for (NodeHash::const_iterator it = _nodeHash.cbegin(); it != _nodeHash.cend(); ++it) {
-            functor(it->second);
+        for (const auto& node : *snapshot) {
+            functor(node);
         }
     }
 
     template<typename PredLambda, typename NodeLambda>
     void eachMatchingNode(PredLambda predicate, NodeLambda functor) {
-        QReadLocker readLock(&_nodeMutex);
+        auto snapshot = _nodeRegistry.getSnapshot();
 
-        for (NodeHash::const_iterator it = _nodeHash.cbegin(); it != _nodeHash.cend(); ++it) {
-            if (predicate(it->second)) {
-                functor(it->second);
+        for (const auto& node : *snapshot) {
+            if (predicate(node)) {
+                functor(node);
             }
         }
     }
 
     template<typename BreakableNodeLambda>
     void eachNodeBreakable(BreakableNodeLambda functor) {
-        QReadLocker readLock(&_nodeMutex);
+        auto snapshot = _nodeRegistry.getSnapshot();
 
-        for (NodeHash::const_iterator it = _nodeHash.cbegin(); it != _nodeHash.cend(); ++it) {
-            if (!functor(it->second)) {
+        for (const auto& node : *snapshot) {
+            if (!functor(node)) {
                 break;
             }
         }
@@ -279,25 +268,22 @@ public:
 
     template<typename PredLambda>
     SharedNodePointer nodeMatchingPredicate(const PredLambda predicate) {
-        QReadLocker readLock(&_nodeMutex);
+        auto snapshot = _nodeRegistry.getSnapshot();
 
-        for (NodeHash::const_iterator it = _nodeHash.cbegin(); it != _nodeHash.cend(); ++it) {
-            if (predicate(it->second)) {
-                return it->second;
+        for (const auto& node : *snapshot) {
+            if (predicate(node)) {
+                return node;
             }
         }
 
         return SharedNodePointer();
     }
 
-    // This is unsafe because it does not take a lock
-    // Must only be called when you know that a read lock on the node mutex is held
-    // and will be held for the duration of your iteration
+    // Kept for callers that iterate from inside nestedEach, reading the registry takes no lock so this is
+    // now the same as eachNode
     template<typename NodeLambda>
     void unsafeEachNode(NodeLambda functor) {
-        for (NodeHash::const_iterator it = _nodeHash.cbegin(); it != _nodeHash.cend(); ++it) {
-            functor(it->second);
-        }
+        eachNode(functor);
     }
 
     void putLocalPortIntoSharedMemory(const QString key, QObject* parent, quint16 localPort);
@@ -308,14 +294,25 @@ public:
     void flagTimeForConnectionStep(ConnectionStep connectionStep);
 
     udt::Socket::StatsVector sampleStatsForAllConnections() { return _nodeSocket.sampleStatsForAllConnections(); }
+    udt::Socket::ReceiveStats sampleReceiveStats() { return _nodeSocket.sampleReceiveStats(); }
+
+    // unreliable sends from the calling thread are batched until endSendBatch, see udt::Socket::beginSendBatch
+    bool beginSendBatch() { return _nodeSocket.beginSendBatch(); }
+    udt::Socket::SendBatchStats endSendBatch() { return _nodeSocket.endSendBatch(); }
 
     void setConnectionMaxBandwidth(int maxBandwidth) { _nodeSocket.setConnectionMaxBandwidth(maxBandwidth); }
 
-    void setPacketFilterOperator(udt::PacketFilterOperator filterOperator) { _nodeSocket.setPacketFilterOperator(filterOperator); }
+    // a custom filter also replaces the batched verification, every packet goes through filterOperator
+    void setPacketFilterOperator(udt::PacketFilterOperator filterOperator) {
+        _nodeSocket.setPacketFilterOperator(filterOperator);
+        _nodeSocket.setPacketBatchFilterOperator(nullptr);
+    }
     bool packetVersionMatch(const udt::Packet& packet);
 
     bool isPacketVerifiedWithSource(const udt::Packet& packet, Node* sourceNode = nullptr);
     bool isPacketVerified(const udt::Packet& packet) { return isPacketVerifiedWithSource(packet); }
+    // isPacketVerified for the packets of one socket read, with their hashes checked in parallel
+    void verifyPacketBatch(const std::vector<const udt::Packet*>& packets, std::vector<uint8_t>& verified);
     void setAuthenticatePackets(bool useAuthentication) { _useAuthentication = useAuthentication; }
     bool getAuthenticatePackets() const { return _useAuthentication; }
 
@@ -420,6 +417,10 @@ protected:
     void setLocalSocket(const HifiSockAddr& sockAddr);
 
     bool packetSourceAndHashMatchAndTrackBandwidth(const udt::Packet& packet, Node* sourceNode = nullptr);
+    // everything packetSourceAndHashMatchAndTrackBandwidth checks but the hash, sets needsHashCheck if it is still due
+    bool packetSourceMatch(const udt::Packet& packet, Node*& sourceNode, bool& needsHashCheck);
+    bool packetHashMatch(const udt::Packet& packet, const Node& sourceNode) const;
+    void reportPacketHashMismatch(const udt::Packet& packet, const Node& sourceNode);
     void processSTUNResponse(std::unique_ptr<udt::BasePacket> packet);
 
     void handleNodeKill(const SharedNodePointer& node, ConnectionID newConnectionID = NULL_CONNECTION_ID);
@@ -436,8 +437,7 @@ protected:
     void removeDelayedAdd(QUuid nodeUUID);
     bool isDelayedNode(QUuid nodeUUID);
 
-    NodeHash _nodeHash;
-    mutable QReadWriteLock _nodeMutex { QReadWriteLock::Recursive };
+    NodeRegistry _nodeRegistry;
     udt::Socket _nodeSocket;
     QUdpSocket* _dtlsSocket { nullptr };
     HifiSockAddr _localSockAddr;
@@ -461,16 +461,6 @@ protected:
     QMap<quint64, ConnectionStep> _lastConnectionTimes;
     bool _areConnectionTimesComplete = false;
 
-    template<typename IteratorLambda>
-    void eachNodeHashIterator(IteratorLambda functor) {
-        QWriteLocker writeLock(&_nodeMutex);
-        NodeHash::iterator it = _nodeHash.begin();
-
-        while (it != _nodeHash.end()) {
-            functor(it);
-        }
-    }
-
     std::unordered_map<QUuid, ConnectionID> _connectionIDs;
     quint64 _nodeConnectTimestamp{ 0 };
     quint64 _nodeDisconnectTimestamp{ 0 };
@@ -484,8 +474,6 @@ private slots:
 private:
     mutable QReadWriteLock _sessionUUIDLock;
     QUuid _sessionUUID;
-    using LocalIDMapping = tbb::concurrent_unordered_map<Node::LocalID, SharedNodePointer>;
-    LocalIDMapping _localIDMap;
     Node::LocalID _sessionLocalID { 0 };
     bool _flagTimeForConnectionStep { false }; // only keep track in interface
 
@@ -11,6 +11,9 @@
 
 #include "NLPacket.h"
 
+#include <algorithm>
+#include <cstring>
+
 #include "HMACAuth.h"
 
 int NLPacket::localHeaderSize(PacketType type) {
@@ -34,7 +37,7 @@ std::unique_ptr<NLPacket> NLPacket::create(PacketType type, qint64 size, bool is
     return packet;
 }
 
-std::unique_ptr<NLPacket> NLPacket::fromReceivedPacket(std::unique_ptr<char[]> data, qint64 size,
+std::unique_ptr<NLPacket> NLPacket::fromReceivedPacket(udt::PacketBuffer data, qint64 size,
                                                        const HifiSockAddr& senderSockAddr) {
     // Fail with null data
     Q_ASSERT(data);
@@ -89,7 +92,7 @@ NLPacket::NLPacket(const NLPacket& other) : Packet(other) {
     _sourceID = other._sourceID;
 }
 
-NLPacket::NLPacket(std::unique_ptr<char[]> data, qint64 size, const HifiSockAddr& senderSockAddr) :
+NLPacket::NLPacket(udt::PacketBuffer data, qint64 size, const HifiSockAddr& senderSockAddr) :
     Packet(std::move(data), size, senderSockAddr)
 {    
     // sanity check before we decrease the payloadSize with the payloadCapacity
@@ -164,6 +167,22 @@ QByteArray NLPacket::hashForPacketAndHMAC(const udt::Packet& packet, HMACAuth& h
     return QByteArray((const char*) hashResult.data(), (int) hashResult.size());
 }
 
+bool NLPacket::verificationHashMatches(const udt::Packet& packet, HMACAuth& hash) {
+    int hashOffset = Packet::totalHeaderSize(packet.isPartOfMessage()) + sizeof(PacketType) + sizeof(PacketVersion)
+        + NUM_BYTES_LOCALID;
+    int offset = hashOffset + NUM_BYTES_MD5_HASH;
+
+    unsigned char hashResult[HMACAuth::MAX_HASH_LENGTH];
+    unsigned int hashLength = 0;
+    if (packet.getDataSize() < offset
+        || !hash.calculateHash(hashResult, hashLength, packet.getData() + offset, packet.getDataSize() - offset)
+        || hashLength < NUM_BYTES_MD5_HASH) {
+        return false;
+    }
+
+    return memcmp(packet.getData() + hashOffset, hashResult, NUM_BYTES_MD5_HASH) == 0;
+}
+
 void NLPacket::writeTypeAndVersion() {
     auto headerOffset = Packet::totalHeaderSize(isPartOfMessage());
     
@@ -223,7 +242,13 @@ void NLPacket::writeVerificationHash(HMACAuth& hmacAuth) const {
     auto offset = Packet::totalHeaderSize(isPartOfMessage()) + sizeof(PacketType) + sizeof(PacketVersion)
                 + NUM_BYTES_LOCALID;
 
-    QByteArray verificationHash = hashForPacketAndHMAC(*this, hmacAuth);
-    
-    memcpy(_packet.get() + offset, verificationHash.data(), verificationHash.size());
+    int hashedOffset = offset + NUM_BYTES_MD5_HASH;
+
+    unsigned char hashResult[HMACAuth::MAX_HASH_LENGTH];
+    unsigned int hashLength = 0;
+    if (!hmacAuth.calculateHash(hashResult, hashLength, _packet.get() + hashedOffset, getDataSize() - hashedOffset)) {
+        return;
+    }
+
+    memcpy(_packet.get() + offset, hashResult, std::min<unsigned int>(hashLength, NUM_BYTES_MD5_HASH));
 }
@@ -25,6 +25,10 @@
 
 const QString UNKNOWN_NodeType_t_NAME = "Unknown";
 
+// how packets between nodes are signed with their connection secret - nodes only join a domain with a matching
+// protocol signature, so DomainListVersion is bumped whenever this changes
+static const HMACAuth::AuthMethod NODE_AUTH_METHOD = HMACAuth::SipHash;
+
 int NodePtrMetaTypeId = qRegisterMetaType<Node*>("Node*");
 int sharedPtrNodeMetaTypeId = qRegisterMetaType<QSharedPointer<Node>>("QSharedPointer<Node>");
 int sharedNodePtrMetaTypeId = qRegisterMetaType<SharedNodePointer>("SharedNodePointer");
@@ -213,7 +217,7 @@ void Node::setConnectionSecret(const QUuid& connectionSecret) {
     }
 
     if (!_authenticateHash) {
-        _authenticateHash.reset(new HMACAuth());
+        _authenticateHash.reset(new HMACAuth(NODE_AUTH_METHOD));
     }
 
     _connectionSecret = connectionSecret;
@@ -110,6 +110,9 @@ NodeList::NodeList(char newOwnerType, int socketListenPort, int dtlsListenPort)
     // anytime we get a new node we may need to re-send our set of ignored node IDs to it
     connect(this, &LimitedNodeList::nodeActivated, this, &NodeList::maybeSendIgnoreSetToNode);
 
+    // direct, so that a removal from the domain-server can be told apart from any other kill
+    connect(this, &LimitedNodeList::nodeKilled, this, &NodeList::forgetDomainListVersionOnKill, Qt::DirectConnection);
+
     // setup our timer to send keepalive pings (it's started and stopped on domain connect/disconnect)
     _keepAlivePingTimer.setInterval(KEEPALIVE_PING_INTERVAL_MS); // 1s, Qt::CoarseTimer acceptable
     connect(&_keepAlivePingTimer, &QTimer::timeout, this, &NodeList::sendKeepAlivePings);
@@ -466,7 +469,10 @@ void NodeList::sendDomainServerCheckIn() {
         packetStream << _ownerType.load() << publicSockAddr << localSockAddr << _nodeTypesOfInterest.toList();
         packetStream << DependencyManager::get<AddressManager>()->getPlaceName();
 
-        if (!domainIsConnected) {
+        if (domainIsConnected) {
+            // tell the domain-server which list we have, so it can send us only what changed since
+            packetStream << _domainListVersion.load();
+        } else {
             DataServerAccountInfo& accountInfo = accountManager->getAccountInfo();
             packetStream << accountInfo.getUsername();
 
@@ -707,6 +713,16 @@ void NodeList::processDomainServerList(QSharedPointer<ReceivedMessage> message)
     bool newConnection;
     packetStream >> newConnection;
 
+    quint64 domainListVersion;
+    packetStream >> domainListVersion;
+
+    bool isDelta;
+    packetStream >> isDelta;
+
+    // the version of the list this one is a delta from
+    quint64 domainListBaseVersion;
+    packetStream >> domainListBaseVersion;
+
     if (newConnection) {
         _nodeConnectTimestamp = usecTimestampNow();
         _connectReason = Connect;
@@ -786,10 +802,27 @@ void NodeList::processDomainServerList(QSharedPointer<ReceivedMessage> message)
     setPermissions(newPermissions);
     setAuthenticatePackets(isAuthenticated);
 
+    if (isDelta) {
+        // a delta starts with the nodes removed since the list it is a delta from
+        quint32 numRemovedNodes;
+        packetStream >> numRemovedNodes;
+
+        for (quint32 i = 0; i < numRemovedNodes; ++i) {
+            QUuid removedNodeUUID;
+            packetStream >> removedNodeUUID;
+            killNodeRemovedByDomain(removedNodeUUID);
+        }
+    }
+
     // pull each node in the packet
     while (packetStream.device()->pos() < message->getSize()) {
         parseNodeFromPacketStream(packetStream);
     }
+
+    // a delta only brings us up to date if we already have the list it is a delta from (or a newer one)
+    if (!isDelta || (_domainListVersion != 0 && domainListBaseVersion <= _domainListVersion)) {
+        _domainListVersion = domainListVersion;
+    }
 }
 
 void NodeList::processDomainServerAddedNode(QSharedPointer<ReceivedMessage> message) {
@@ -804,10 +837,26 @@ void NodeList::processDomainServerRemovedNode(QSharedPointer<ReceivedMessage> me
     // read the UUID from the packet, remove it if it exists
     QUuid nodeUUID = QUuid::fromRfc4122(message->readWithoutCopy(NUM_BYTES_RFC4122_UUID));
     qCDebug(networking) << "Received packet from domain-server to remove node with UUID" << uuidStringWithoutCurlyBraces(nodeUUID);
+    killNodeRemovedByDomain(nodeUUID);
+}
+
+void NodeList::killNodeRemovedByDomain(const QUuid& nodeUUID) {
+    // the domain-server no longer has this node either, so our domain list stays in sync with it
+    _isKillingNodeRemovedByDomain = true;
     killNodeWithUUID(nodeUUID);
+    _isKillingNodeRemovedByDomain = false;
+
     removeDelayedAdd(nodeUUID);
 }
 
+void NodeList::forgetDomainListVersionOnKill(SharedNodePointer killedNode) {
+    // the kill flag is only set on our thread
+    if (QThread::currentThread() != thread() || !_isKillingNodeRemovedByDomain) {
+        // we dropped a node the domain-server may still have, ask for the full list on our next check in
+        _domainListVersion = 0;
+    }
+}
+
 void NodeList::parseNodeFromPacketStream(QDataStream& packetStream) {
     NewNodeInfo info;
 
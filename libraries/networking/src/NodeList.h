@@ -147,6 +147,8 @@ private slots:
 
     void maybeSendIgnoreSetToNode(SharedNodePointer node);
 
+    void forgetDomainListVersionOnKill(SharedNodePointer killedNode);
+
 private:
     NodeList() : LimitedNodeList(INVALID_PORT, INVALID_PORT) { assert(false); } // Not implemented, needed for DependencyManager templates compile
     NodeList(char ownerType, int socketListenPort = INVALID_PORT, int dtlsListenPort = INVALID_PORT);
@@ -161,6 +163,7 @@ private:
     void sendDSPathQuery(const QString& newPath);
 
     void parseNodeFromPacketStream(QDataStream& packetStream);
+    void killNodeRemovedByDomain(const QUuid& nodeUUID);
 
     void pingPunchForInactiveNode(const SharedNodePointer& node);
 
@@ -176,6 +179,11 @@ private:
 
     bool _sendDomainServerCheckInEnabled { true };
 
+    // the version of the last domain list we have every node of, the domain-server sends only what changed since
+    // 0 asks for the full list, after we have dropped a node that the domain-server may still have
+    std::atomic<quint64> _domainListVersion { 0 };
+    bool _isKillingNodeRemovedByDomain { false };
+
     mutable QReadWriteLock _ignoredSetLock;
     tbb::concurrent_unordered_set<QUuid, UUIDHasher> _ignoredNodeIDs;
     mutable QReadWriteLock _personalMutedSetLock;
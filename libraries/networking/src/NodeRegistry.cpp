@@ -0,0 +1,126 @@
+//
+//  NodeRegistry.cpp
+//  libraries/networking/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "NodeRegistry.h"
+
+#include <algorithm>
+#include <iterator>
+
+SharedNodePointer NodeRegistrySnapshot::nodeWithUUID(const QUuid& nodeUUID) const {
+    auto it = _nodesByUUID.find(nodeUUID);
+    return it == _nodesByUUID.end() ? SharedNodePointer() : it->second;
+}
+
+SharedNodePointer NodeRegistrySnapshot::nodeWithLocalID(Node::LocalID localID) const {
+    auto it = _nodesByLocalID.find(localID);
+    return it == _nodesByLocalID.end() ? SharedNodePointer() : it->second;
+}
+
+static std::atomic<uint64_t> nextRegistryID { 1 };
+
+NodeRegistry::NodeRegistry() :
+    _registryID(nextRegistryID++),
+    _snapshot(build({}))
+{
+}
+
+NodeRegistrySnapshotPointer NodeRegistry::getSnapshot() const {
+    struct CachedSnapshot {
+        uint64_t registryID { 0 };
+        uint64_t generation { 0 };
+        NodeRegistrySnapshotPointer snapshot;
+    };
+    thread_local CachedSnapshot cached;
+
+    // the snapshot is published before the generation, so the one loaded below is at least this generation's
+    uint64_t generation = _generation.load(std::memory_order_acquire);
+    if (cached.registryID != _registryID || cached.generation != generation || !cached.snapshot) {
+        cached.registryID = _registryID;
+        cached.generation = generation;
+        cached.snapshot = std::atomic_load(&_snapshot);
+    }
+    return cached.snapshot;
+}
+
+SharedNodePointer NodeRegistry::add(const SharedNodePointer& node) {
+    std::lock_guard<std::mutex> lock(_writeMutex);
+    auto current = std::atomic_load(&_snapshot);
+
+    auto existing = current->nodeWithUUID(node->getUUID());
+    if (existing && existing != node) {
+        return existing;
+    }
+
+    std::vector<SharedNodePointer> nodes;
+    nodes.reserve(current->size() + 1);
+    std::copy_if(current->cbegin(), current->cend(), std::back_inserter(nodes), [&](const SharedNodePointer& other) {
+        return other->getUUID() != node->getUUID();
+    });
+    nodes.push_back(node);
+
+    publish(build(std::move(nodes)));
+    return node;
+}
+
+bool NodeRegistry::remove(const QUuid& nodeUUID) {
+    auto removed = removeIf([&](const SharedNodePointer& node) {
+        return node->getUUID() == nodeUUID;
+    });
+    return !removed.empty();
+}
+
+std::vector<SharedNodePointer> NodeRegistry::removeIf(NodePredicate predicate) {
+    std::lock_guard<std::mutex> lock(_writeMutex);
+    auto current = std::atomic_load(&_snapshot);
+
+    std::vector<SharedNodePointer> nodes;
+    std::vector<SharedNodePointer> removed;
+    nodes.reserve(current->size());
+    for (const auto& node : *current) {
+        if (predicate(node)) {
+            removed.push_back(node);
+        } else {
+            nodes.push_back(node);
+        }
+    }
+
+    if (!removed.empty()) {
+        publish(build(std::move(nodes)));
+    }
+    return removed;
+}
+
+std::vector<SharedNodePointer> NodeRegistry::clear() {
+    std::lock_guard<std::mutex> lock(_writeMutex);
+    auto current = std::atomic_load(&_snapshot);
+    if (current->empty()) {
+        return {};
+    }
+
+    publish(build({}));
+    return current->getNodes();
+}
+
+void NodeRegistry::publish(std::shared_ptr<NodeRegistrySnapshot> snapshot) {
+    std::atomic_store(&_snapshot, NodeRegistrySnapshotPointer(std::move(snapshot)));
+    _generation.fetch_add(1, std::memory_order_release);
+}
+
+std::shared_ptr<NodeRegistrySnapshot> NodeRegistry::build(std::vector<SharedNodePointer> nodes) {
+    auto snapshot = std::make_shared<NodeRegistrySnapshot>();
+    snapshot->_nodes = std::move(nodes);
+    snapshot->_nodesByUUID.reserve(snapshot->_nodes.size());
+    snapshot->_nodesByLocalID.reserve(snapshot->_nodes.size());
+    for (const auto& node : snapshot->_nodes) {
+        snapshot->_nodesByUUID[node->getUUID()] = node;
+        snapshot->_nodesByLocalID[node->getLocalID()] = node;
+    }
+    return snapshot;
+}
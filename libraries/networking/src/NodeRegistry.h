@@ -0,0 +1,94 @@
+//
+//  NodeRegistry.h
+//  libraries/networking/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_NodeRegistry_h
+#define hifi_NodeRegistry_h
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "Node.h"
+#include "UUIDHasher.h"
+
+// An immutable set of nodes, indexed by UUID and by local ID.
+class NodeRegistrySnapshot {
+public:
+    using const_iterator = std::vector<SharedNodePointer>::const_iterator;
+
+    const std::vector<SharedNodePointer>& getNodes() const { return _nodes; }
+    const_iterator cbegin() const { return _nodes.cbegin(); }
+    const_iterator cend() const { return _nodes.cend(); }
+    const_iterator begin() const { return _nodes.cbegin(); }
+    const_iterator end() const { return _nodes.cend(); }
+    size_t size() const { return _nodes.size(); }
+    bool empty() const { return _nodes.empty(); }
+
+    SharedNodePointer nodeWithUUID(const QUuid& nodeUUID) const;
+    SharedNodePointer nodeWithLocalID(Node::LocalID localID) const;
+
+private:
+    friend class NodeRegistry;
+
+    std::vector<SharedNodePointer> _nodes;
+    std::unordered_map<QUuid, SharedNodePointer, UUIDHasher> _nodesByUUID;
+    std::unordered_map<Node::LocalID, SharedNodePointer> _nodesByLocalID;
+};
+
+using NodeRegistrySnapshotPointer = std::shared_ptr<const NodeRegistrySnapshot>;
+
+// NodeRegistry holds the nodes of a LimitedNodeList, read-copy-update style.
+//
+// Readers get the current snapshot and never block: each thread keeps the last snapshot it read, and only reloads it
+// when the registry's generation (a single atomic) has moved on.  Writers are serialized, each change copies the
+// current snapshot, edits the copy and publishes it.  Nodes are added and removed rarely compared to how often they
+// are looked up and iterated, by every packet handler and mixer thread.
+//
+// A snapshot keeps its nodes alive, a thread that stops reading the registry holds on to the nodes of the last
+// snapshot it read until it reads again or exits.
+class NodeRegistry {
+public:
+    using NodePredicate = std::function<bool(const SharedNodePointer& node)>;
+
+    NodeRegistry();
+
+    NodeRegistrySnapshotPointer getSnapshot() const;
+
+    // adds the node, or re-indexes it if it is already there (its local ID may have changed), and returns it.
+    // If another node with the same UUID is already there, that node is kept and returned instead.
+    SharedNodePointer add(const SharedNodePointer& node);
+
+    // returns whether the node was there
+    bool remove(const QUuid& nodeUUID);
+
+    // removes the nodes predicate returns true for and returns them, predicate is called on every node under the
+    // writers' lock
+    std::vector<SharedNodePointer> removeIf(NodePredicate predicate);
+
+    // removes and returns every node
+    std::vector<SharedNodePointer> clear();
+
+    // the number of snapshots published since the registry was created
+    uint64_t getGeneration() const { return _generation.load(std::memory_order_acquire); }
+
+private:
+    void publish(std::shared_ptr<NodeRegistrySnapshot> snapshot);
+    static std::shared_ptr<NodeRegistrySnapshot> build(std::vector<SharedNodePointer> nodes);
+
+    const uint64_t _registryID; // unique in the process, thread caches are keyed by it
+    std::atomic<uint64_t> _generation { 0 };
+    NodeRegistrySnapshotPointer _snapshot; // only accessed with std::atomic_load/store
+    std::mutex _writeMutex;
+};
+
+#endif // hifi_NodeRegistry_h
@@ -119,6 +119,15 @@ void ThreadedAssignment::addPacketStatsAndSendStatsPacket(QJsonObject statsObjec
     ioStats["outbound_kbps"] = nodeList->getOutboundKbps();
     ioStats["outbound_pps"] = nodeList->getOutboundPPS();
 
+    auto receiveStats = nodeList->sampleReceiveStats();
+    ioStats["receive_batches"] = (double)receiveStats.numBatches;
+    ioStats["receive_average_batch_size"] = receiveStats.numBatches ?
+        (double)receiveStats.numBatchedDatagrams / receiveStats.numBatches : 0.0;
+    ioStats["receive_truncated_datagrams"] = (double)receiveStats.numTruncatedDatagrams;
+    quint64 bufferRequests = receiveStats.bufferPool.hits + receiveStats.bufferPool.misses;
+    ioStats["packet_buffer_pool_hit_rate"] = bufferRequests ? (double)receiveStats.bufferPool.hits / bufferRequests : 0.0;
+    ioStats["packet_buffers_in_use"] = (int)receiveStats.bufferPool.inUse;
+
     statsObject["io_stats"] = ioStats;
 
     QJsonObject assignmentStats;
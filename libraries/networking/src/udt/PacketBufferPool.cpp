@@ -0,0 +1,89 @@
+//
+//  PacketBufferPool.cpp
+//  libraries/networking/src/udt
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "PacketBufferPool.h"
+
+using namespace udt;
+
+const int PacketBufferPool::BUFFER_SIZE;
+const quint32 PacketBufferPool::NUM_BUFFERS;
+const quint32 PacketBufferPool::EMPTY_INDEX;
+
+static inline quint64 packHead(quint64 tag, quint32 index) {
+    return (tag << 32) | index;
+}
+
+void PacketBufferDeleter::operator()(char* buffer) const {
+    if (pool) {
+        pool->release(buffer);
+    } else {
+        delete[] buffer;
+    }
+}
+
+PacketBufferPool& PacketBufferPool::getInstance() {
+    // intentionally leaked so that packets destroyed during static destruction can still return their buffers
+    static PacketBufferPool* instance = new PacketBufferPool(NUM_BUFFERS);
+    return *instance;
+}
+
+PacketBufferPool::PacketBufferPool(quint32 numBuffers) :
+    _numBuffers(numBuffers),
+    _slab(new char[(size_t)numBuffers * BUFFER_SIZE]),
+    _next(new std::atomic<quint32>[numBuffers])
+{
+    // thread every buffer onto the free list in order
+    for (quint32 i = 0; i < _numBuffers; ++i) {
+        _next[i].store(i + 1 < _numBuffers ? i + 1 : EMPTY_INDEX, std::memory_order_relaxed);
+    }
+    _head.store(packHead(0, _numBuffers > 0 ? 0 : EMPTY_INDEX), std::memory_order_release);
+}
+
+PacketBuffer PacketBufferPool::acquire(qint64 size) {
+    if (size <= BUFFER_SIZE) {
+        quint64 head = _head.load(std::memory_order_acquire);
+        quint32 index = (quint32)head;
+        while (index != EMPTY_INDEX) {
+            // the tag in the upper half of the head guards against ABA when a buffer is popped and pushed back
+            quint32 next = _next[index].load(std::memory_order_relaxed);
+            if (_head.compare_exchange_weak(head, packHead((head >> 32) + 1, next),
+                                            std::memory_order_acquire, std::memory_order_acquire)) {
+                _hits.fetch_add(1, std::memory_order_relaxed);
+                _inUse.fetch_add(1, std::memory_order_relaxed);
+                return PacketBuffer(_slab.get() + (size_t)index * BUFFER_SIZE, PacketBufferDeleter(this));
+            }
+            index = (quint32)head;
+        }
+    }
+
+    _misses.fetch_add(1, std::memory_order_relaxed);
+    return PacketBuffer(new char[size]);
+}
+
+void PacketBufferPool::release(char* buffer) {
+    Q_ASSERT(buffer >= _slab.get() && buffer < _slab.get() + (size_t)_numBuffers * BUFFER_SIZE);
+    quint32 index = (quint32)((buffer - _slab.get()) / BUFFER_SIZE);
+
+    quint64 head = _head.load(std::memory_order_relaxed);
+    do {
+        _next[index].store((quint32)head, std::memory_order_relaxed);
+    } while (!_head.compare_exchange_weak(head, packHead((head >> 32) + 1, index),
+                                          std::memory_order_release, std::memory_order_relaxed));
+
+    _inUse.fetch_sub(1, std::memory_order_relaxed);
+}
+
+PacketBufferPool::Stats PacketBufferPool::sampleStats() {
+    Stats stats;
+    stats.hits = _hits.exchange(0, std::memory_order_relaxed);
+    stats.misses = _misses.exchange(0, std::memory_order_relaxed);
+    stats.inUse = _inUse.load(std::memory_order_relaxed);
+    return stats;
+}
@@ -0,0 +1,82 @@
+//
+//  PacketBufferPool.h
+//  libraries/networking/src/udt
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+
+#ifndef hifi_PacketBufferPool_h
+#define hifi_PacketBufferPool_h
+
+#include <atomic>
+#include <memory>
+
+#include <QtCore/QtGlobal>
+
+#include "Constants.h"
+
+namespace udt {
+
+class PacketBufferPool;
+
+// Returns pooled buffers to their pool, and frees anything else with delete[].
+struct PacketBufferDeleter {
+    PacketBufferDeleter() = default;
+    explicit PacketBufferDeleter(PacketBufferPool* pool) : pool(pool) {}
+
+    void operator()(char* buffer) const;
+
+    PacketBufferPool* pool { nullptr };
+};
+
+// Owning pointer to the memory backing a packet. Received packets adopt a pooled buffer when one is available.
+using PacketBuffer = std::unique_ptr<char[], PacketBufferDeleter>;
+
+// Fixed-size slab of MAX_PACKET_SIZE buffers shared by every receiving socket in the process.
+// Acquire and release are lock-free (a tagged Treiber stack over slab indices), so packets may be
+// destroyed on any thread. Requests that don't fit a slab buffer, or arrive while the slab is
+// exhausted, fall back to the heap.
+class PacketBufferPool {
+public:
+    struct Stats {
+        quint64 hits { 0 };
+        quint64 misses { 0 };
+        quint32 inUse { 0 };
+    };
+
+    static const int BUFFER_SIZE = MAX_PACKET_SIZE;
+    static const quint32 NUM_BUFFERS = 2048;
+
+    static PacketBufferPool& getInstance();
+
+    PacketBuffer acquire(qint64 size);
+
+    Stats sampleStats();
+
+private:
+    friend struct PacketBufferDeleter;
+
+    PacketBufferPool(quint32 numBuffers);
+
+    void release(char* buffer);
+
+    static const quint32 EMPTY_INDEX = 0xFFFFFFFF;
+
+    const quint32 _numBuffers;
+    std::unique_ptr<char[]> _slab;
+    std::unique_ptr<std::atomic<quint32>[]> _next;
+    std::atomic<quint64> _head; // (tag << 32) | index of the first free buffer
+
+    std::atomic<quint64> _hits { 0 };
+    std::atomic<quint64> _misses { 0 };
+    std::atomic<quint32> _inUse { 0 };
+};
+
+} // namespace udt
+
+#endif // hifi_PacketBufferPool_h
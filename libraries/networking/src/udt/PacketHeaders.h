@@ -377,7 +377,14 @@ enum class DomainListVersion : PacketVersion {
     GetMachineFingerprintFromUUIDSupport,
     AuthenticationOptional,
     HasTimestamp,
-    HasConnectReason
+    HasConnectReason,
+    HasDeltaUpdates,
+    HasSipHashVerification
+};
+
+enum class DomainListRequestVersion : PacketVersion {
+    PreDomainListVersion = 22,
+    HasDomainListVersion
 };
 
 enum class AudioVersion : PacketVersion {
@@ -13,7 +13,6 @@
 #define hifi_SendQueue_h
 
 #include <atomic>
-#include <condition_variable>
 #include <cstdint>
 #include <list>
 #include <memory>
@@ -40,6 +39,7 @@ class Packet;
 class PacketList;
 class Socket;
     
+// A SendQueue has no thread of its own, the SendScheduler steps it whenever it is due to send.
 class SendQueue : public QObject {
     Q_OBJECT
     
@@ -85,15 +85,23 @@ signals:
 
     void timeout();
     
-private slots:
-    void run();
-    
 private:
+    friend class SendScheduler;
+
+    enum class Wait {
+        None,
+        Empty, // everything sent has been ACKed, waiting for new packets before the queue goes inactive
+        Stuck // waiting for the ACK of sent packets, or for the flow window to open
+    };
+
     SendQueue(Socket* socket, HifiSockAddr dest, SequenceNumber currentSequenceNumber,
               MessageNumber currentMessageNumber, bool hasReceivedHandshakeACK);
     SendQueue(SendQueue& other) = delete;
     SendQueue(SendQueue&& other) = delete;
     
+    // sends what it can at now, returns false once the queue is stopped or nextStep with the time it wants to run next
+    bool step(p_high_resolution_clock::time_point now, p_high_resolution_clock::time_point& nextStep);
+
     void sendHandshake();
     
     int sendPacket(const Packet& packet);
@@ -102,7 +110,10 @@ private:
     int maybeSendNewPacket(); // Figures out what packet to send next
     bool maybeResendPacket(); // Determines whether to resend a packet and which one
     
-    bool isInactive(bool attemptedToSendPacket);
+    // starts a wait if there is nothing to send or resend, returns true if it did
+    bool maybeBeginWait(p_high_resolution_clock::time_point now);
+    // ends the current wait, returns true if the queue was deactivated
+    bool endWait(p_high_resolution_clock::time_point now);
     void deactivate(); // makes the queue inactive and cleans it up
 
     bool isFlowWindowFull() const;
@@ -114,6 +125,10 @@ private:
     
     Socket* _socket { nullptr }; // Socket to send packet on
     HifiSockAddr _destination; // Destination addr
+
+    std::mutex _pendingDestinationLock; // Protects the pending destination
+    HifiSockAddr _pendingDestination; // Set from the connection's thread, applied on the next step
+    bool _hasPendingDestination { false };
     
     std::atomic<uint32_t> _lastACKSequenceNumber { 0 }; // Last ACKed sequence number
     
@@ -134,11 +149,15 @@ private:
     using PacketResendPair = std::pair<uint8_t, std::unique_ptr<Packet>>; // Number of resend + packet ptr
     std::unordered_map<SequenceNumber, PacketResendPair> _sentPackets; // Packets waiting for ACK.
     
-    std::mutex _handshakeMutex; // Protects the handshake ACK condition_variable
     std::atomic<bool> _hasReceivedHandshakeACK { false }; // flag for receipt of handshake ACK from client
-    std::condition_variable _handshakeACKCondition;
-    
-    std::condition_variable_any _emptyCondition;
+    p_high_resolution_clock::time_point _nextHandshake; // when to re-send the handshake
+
+    // the state of the queue between steps, only touched by the step in progress
+    bool _hasStartedSending { false };
+    p_high_resolution_clock::time_point _nextPacketTimestamp; // when the next packet should go out
+    Wait _wait { Wait::None };
+    p_high_resolution_clock::time_point _waitDeadline;
+    std::chrono::microseconds _waitTimeout { 0 };
 
     std::chrono::high_resolution_clock::time_point _lastPacketSentAt;
 
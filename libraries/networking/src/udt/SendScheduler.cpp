@@ -0,0 +1,195 @@
+//
+//  SendScheduler.cpp
+//  libraries/networking/src/udt
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "SendScheduler.h"
+
+#include <algorithm>
+#include <assert.h>
+
+#include <QtCore/QThread>
+
+#include "SendQueue.h"
+
+using namespace udt;
+using namespace std::chrono;
+
+static const int DEFAULT_NUM_SEND_THREADS = 2;
+
+std::atomic<int> SendScheduler::_numThreadsForInstance { 0 };
+
+void SendScheduler::setNumThreads(int numThreads) {
+    _numThreadsForInstance = numThreads;
+}
+
+SendScheduler& SendScheduler::getInstance() {
+    // the scheduler is never destroyed, SendQueues can outlive static destruction on shutdown
+    static SendScheduler* instance = [] {
+        int numThreads = _numThreadsForInstance;
+        if (numThreads <= 0) {
+            // idealThreadCount returns -1 if cores cannot be detected
+            numThreads = std::min(DEFAULT_NUM_SEND_THREADS, std::max(QThread::idealThreadCount(), 1));
+        }
+        return new SendScheduler(numThreads);
+    }();
+    return *instance;
+}
+
+SendScheduler::SendScheduler(int numThreads) {
+    numThreads = std::max(numThreads, 1);
+    _threads.reserve(numThreads);
+    for (int i = 0; i < numThreads; ++i) {
+        _threads.emplace_back([this] { threadLoop(); });
+    }
+}
+
+SendScheduler::~SendScheduler() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stop = true;
+    }
+    _threadCondition.notify_all();
+
+    for (auto& thread : _threads) {
+        thread.join();
+    }
+}
+
+void SendScheduler::add(SendQueue* queue) {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        assert(_queueIDs.find(queue) == _queueIDs.end());
+
+        uint64_t queueID = _nextQueueID++;
+        _queueIDs[queue] = queueID;
+
+        QueueState& state = _queues[queueID];
+        state.queue = queue;
+        schedule(queueID, state, p_high_resolution_clock::now());
+    }
+    _threadCondition.notify_one();
+}
+
+void SendScheduler::remove(SendQueue* queue) {
+    std::unique_lock<std::mutex> lock(_mutex);
+    auto it = _queueIDs.find(queue);
+    if (it == _queueIDs.end()) {
+        return;
+    }
+
+    uint64_t queueID = it->second;
+    _steppedCondition.wait(lock, [&] {
+        return !_queues[queueID].isStepping;
+    });
+
+    // its scheduled step is dropped when it comes due
+    _queues.erase(queueID);
+    _queueIDs.erase(queue);
+}
+
+void SendScheduler::wake(SendQueue* queue) {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto it = _queueIDs.find(queue);
+        if (it == _queueIDs.end()) {
+            return;
+        }
+
+        QueueState& state = _queues[it->second];
+        if (state.isStepping) {
+            // the step may have already looked at what woke us, step again once it is done
+            state.wakeRequested = true;
+            return;
+        }
+
+        auto now = p_high_resolution_clock::now();
+        if (state.isScheduled && state.deadline <= now) {
+            return;
+        }
+        schedule(it->second, state, now);
+    }
+    _threadCondition.notify_one();
+}
+
+SendScheduler::Stats SendScheduler::sampleStats() {
+    Stats stats;
+    stats.numThreads = (int)_threads.size();
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    stats.numQueues = (int)_queues.size();
+    stats.numSteps = _numSteps;
+    stats.averageLatenessUsecs = (_numSteps > 0) ? _totalLatenessUsecs / _numSteps : 0;
+    stats.maxLatenessUsecs = _maxLatenessUsecs;
+
+    _numSteps = 0;
+    _totalLatenessUsecs = 0;
+    _maxLatenessUsecs = 0;
+
+    return stats;
+}
+
+void SendScheduler::schedule(uint64_t queueID, QueueState& state, TimePoint deadline) {
+    state.deadline = deadline;
+    state.isScheduled = true;
+    _schedule.push({ deadline, queueID, ++state.generation });
+}
+
+void SendScheduler::threadLoop() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (!_stop) {
+        if (_schedule.empty()) {
+            _threadCondition.wait(lock);
+            continue;
+        }
+
+        auto now = p_high_resolution_clock::now();
+        ScheduledStep step = _schedule.top();
+        if (step.deadline > now) {
+            // wait for a duration rather than until the deadline, the clock may not be the condition's clock
+            _threadCondition.wait_for(lock, step.deadline - now);
+            continue;
+        }
+        _schedule.pop();
+
+        auto it = _queues.find(step.queueID);
+        if (it == _queues.end() || it->second.generation != step.generation) {
+            continue; // the queue was removed, or woken and rescheduled
+        }
+
+        QueueState& state = it->second;
+        state.isScheduled = false;
+        state.isStepping = true;
+        state.wakeRequested = false;
+        SendQueue* queue = state.queue;
+
+        uint64_t lateness = duration_cast<microseconds>(now - step.deadline).count();
+        ++_numSteps;
+        _totalLatenessUsecs += lateness;
+        _maxLatenessUsecs = std::max(_maxLatenessUsecs, lateness);
+
+        // let another thread take the queues that are still due
+        bool hasMoreDue = !_schedule.empty() && _schedule.top().deadline <= now;
+        lock.unlock();
+        if (hasMoreDue) {
+            _threadCondition.notify_one();
+        }
+
+        TimePoint nextStep;
+        bool isActive = queue->step(now, nextStep);
+
+        lock.lock();
+        // the queue can't be removed while it is stepping
+        QueueState& steppedState = _queues[step.queueID];
+        steppedState.isStepping = false;
+        if (isActive) {
+            schedule(step.queueID, steppedState, steppedState.wakeRequested ? p_high_resolution_clock::now() : nextStep);
+        }
+        _steppedCondition.notify_all();
+    }
+}
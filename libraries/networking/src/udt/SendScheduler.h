@@ -0,0 +1,108 @@
+//
+//  SendScheduler.h
+//  libraries/networking/src/udt
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_SendScheduler_h
+#define hifi_SendScheduler_h
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <PortableHighResolutionClock.h>
+
+namespace udt {
+
+class SendQueue;
+
+// SendScheduler paces the SendQueues of every reliable connection in the process on a small, fixed number of threads.
+//
+// A queue runs in steps: each step sends what the queue's congestion control allows and returns the time the queue
+// wants to run next - its next packet send time, or the end of a wait for ACKs or new packets.  The scheduler keeps
+// a min-heap of those deadlines and runs each queue when it comes due, or earlier when the queue is woken (a packet
+// was queued, an ACK or NAK arrived, the handshake completed, or the queue was stopped).
+class SendScheduler {
+public:
+    using TimePoint = p_high_resolution_clock::time_point;
+
+    struct Stats {
+        int numThreads { 0 };
+        int numQueues { 0 };
+        uint64_t numSteps { 0 };
+        uint64_t averageLatenessUsecs { 0 }; // how late steps ran past their deadline
+        uint64_t maxLatenessUsecs { 0 };
+    };
+
+    // the number of threads the scheduler is created with, only has an effect before the first call to getInstance()
+    static void setNumThreads(int numThreads);
+
+    static SendScheduler& getInstance();
+
+    SendScheduler(int numThreads);
+    ~SendScheduler();
+
+    void add(SendQueue* queue);
+
+    // waits for a step of queue in progress, once this returns the queue is never stepped again
+    void remove(SendQueue* queue);
+
+    // runs queue as soon as possible
+    void wake(SendQueue* queue);
+
+    // returns the stats since the last call
+    Stats sampleStats();
+
+private:
+    struct ScheduledStep {
+        TimePoint deadline;
+        uint64_t queueID;
+        uint64_t generation; // the queue's generation when this was scheduled, older steps are dropped
+
+        bool operator>(const ScheduledStep& other) const { return deadline > other.deadline; }
+    };
+
+    struct QueueState {
+        SendQueue* queue;
+        uint64_t generation { 0 };
+        TimePoint deadline;
+        bool isScheduled { false };
+        bool isStepping { false };
+        bool wakeRequested { false };
+    };
+
+    void schedule(uint64_t queueID, QueueState& state, TimePoint deadline);
+    void threadLoop();
+
+    std::vector<std::thread> _threads;
+
+    std::mutex _mutex;
+    std::condition_variable _threadCondition;
+    std::condition_variable _steppedCondition;
+    std::priority_queue<ScheduledStep, std::vector<ScheduledStep>, std::greater<ScheduledStep>> _schedule;
+    std::unordered_map<uint64_t, QueueState> _queues;
+    std::unordered_map<SendQueue*, uint64_t> _queueIDs;
+    uint64_t _nextQueueID { 0 };
+    bool _stop { false };
+
+    // guarded by _mutex
+    uint64_t _numSteps { 0 };
+    uint64_t _totalLatenessUsecs { 0 };
+    uint64_t _maxLatenessUsecs { 0 };
+
+    static std::atomic<int> _numThreadsForInstance;
+};
+
+}
+
+#endif // hifi_SendScheduler_h
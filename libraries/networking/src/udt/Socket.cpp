@@ -15,6 +15,14 @@
 #include <sys/socket.h>
 #endif
 
+#if defined(Q_OS_LINUX)
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <netinet/udp.h>
+#include <errno.h>
+#include <string.h>
+#endif
+
 #include <QtCore/QThread>
 
 #include <shared/QtHelpers.h>
@@ -38,6 +46,48 @@ using namespace udt;
 #include <netinet/in.h>
 #endif
 
+#if defined(Q_OS_LINUX)
+
+// older userspace headers do not carry the UDP GSO definitions
+#ifndef SOL_UDP
+#define SOL_UDP 17
+#endif
+#ifndef UDP_SEGMENT
+#define UDP_SEGMENT 103
+#endif
+
+namespace {
+
+const int MAX_SEND_BATCH_SIZE = 64;
+
+// the kernel refuses GSO sends with more than 64 segments or more than one 64K datagram of payload
+const int MAX_SEGMENTS_PER_SEND = 64;
+const int MAX_SEGMENTED_SEND_BYTES = 65000;
+
+struct BatchedDatagram {
+    size_t offset;
+    int size;
+    sockaddr_in destination;
+};
+
+// unreliable datagrams queued by the current thread between Socket::beginSendBatch and Socket::endSendBatch
+struct SendBatch {
+    Socket* socket { nullptr };
+    std::vector<char> data;
+    std::vector<BatchedDatagram> datagrams;
+    Socket::SendBatchStats stats;
+};
+
+thread_local SendBatch sendBatch;
+
+bool isSameDestination(const sockaddr_in& left, const sockaddr_in& right) {
+    return left.sin_addr.s_addr == right.sin_addr.s_addr && left.sin_port == right.sin_port;
+}
+
+}
+
+#endif
+
 
 Socket::Socket(QObject* parent, bool shouldChangeSocketOptions) :
     QObject(parent),
@@ -69,6 +119,11 @@ void Socket::bind(const QHostAddress& address, quint16 port) {
         auto sd = _udpSocket.socketDescriptor();
         int val = IP_PMTUDISC_DONT;
         setsockopt(sd, IPPROTO_IP, IP_MTU_DISCOVER, &val, sizeof(val));
+
+        // kernels with UDP GSO (4.18+) know the UDP_SEGMENT option, older ones fail the lookup
+        int segmentSize = 0;
+        socklen_t segmentSizeLength = sizeof(segmentSize);
+        _useUDPSegmentation = getsockopt(sd, SOL_UDP, UDP_SEGMENT, &segmentSize, &segmentSizeLength) == 0;
 #elif defined(Q_OS_WIN)
         auto sd = _udpSocket.socketDescriptor();
         int val = 0; // false
@@ -151,6 +206,12 @@ qint64 Socket::writePacket(const Packet& packet, const HifiSockAddr& sockAddr) {
     // write the correct sequence number to the Packet here
     packet.writeSequenceNumber(sequenceNumber);
 
+#if defined(Q_OS_LINUX)
+    if (sendBatch.socket == this && queueBatchedDatagram(packet.getData(), packet.getDataSize(), sockAddr)) {
+        return packet.getDataSize();
+    }
+#endif
+
     return writeDatagram(packet.getData(), packet.getDataSize(), sockAddr);
 }
 
@@ -247,27 +308,33 @@ qint64 Socket::writeDatagram(const QByteArray& datagram, const HifiSockAddr& soc
     int pending = _udpSocket.bytesToWrite();
     if (bytesWritten < 0 || pending) {
         int wsaError = 0;
-        static std::atomic<int> previousWsaError (0);
 #ifdef WIN32
         wsaError = WSAGetLastError();
 #endif
-        QString errorString;
-        QDebug(&errorString) << "udt::writeDatagram (" << _udpSocket.state() << sockAddr << ") error - "
-            << wsaError << _udpSocket.error() << "(" << _udpSocket.errorString() << ")"
-            << (pending ? "pending bytes:" : "pending:") << pending;
+        QString errorDescription;
+        QDebug(&errorDescription) << _udpSocket.error() << "(" << _udpSocket.errorString() << ")";
+        logWriteDatagramError(sockAddr, wsaError, errorDescription, pending);
+    }
+
+    return bytesWritten;
+}
 
-        if (previousWsaError.exchange(wsaError) != wsaError) {
-            qCDebug(networking).noquote() << errorString;
+void Socket::logWriteDatagramError(const HifiSockAddr& sockAddr, int error, const QString& errorDescription, int pending) {
+    static std::atomic<int> previousError (0);
+
+    QString errorString;
+    QDebug(&errorString).noquote() << "udt::writeDatagram (" << _udpSocket.state() << sockAddr << ") error - "
+        << error << errorDescription << (pending ? "pending bytes:" : "pending:") << pending;
+
+    if (previousError.exchange(error) != error) {
+        qCDebug(networking).noquote() << errorString;
 #ifdef DEBUG_EVENT_QUEUE
-            int nodeListQueueSize = ::hifi::qt::getEventQueueSize(thread());
-            qCDebug(networking) << "Networking queue size - " << nodeListQueueSize << "writing datagram to" << sockAddr;
+        int nodeListQueueSize = ::hifi::qt::getEventQueueSize(thread());
+        qCDebug(networking) << "Networking queue size - " << nodeListQueueSize << "writing datagram to" << sockAddr;
 #endif  // DEBUG_EVENT_QUEUE
-        } else {
-            HIFI_FCDEBUG(networking(), errorString.toLatin1().constData());
-        }
+    } else {
+        HIFI_FCDEBUG(networking(), errorString.toLatin1().constData());
     }
-
-    return bytesWritten;
 }
 
 Connection* Socket::findOrCreateConnection(const HifiSockAddr& sockAddr, bool filterCreate) {
@@ -371,6 +438,8 @@ void Socket::readPendingDatagrams() {
     const auto abortTime = system_clock::now() + MAX_PROCESS_TIME;
     int packetSizeWithHeader = -1;
 
+    auto& bufferPool = PacketBufferPool::getInstance();
+
     while (_udpSocket.hasPendingDatagrams() &&
            (packetSizeWithHeader = _udpSocket.pendingDatagramSize()) != -1) {
         if (system_clock::now() > abortTime) {
@@ -393,8 +462,8 @@ void Socket::readPendingDatagrams() {
         // setup a HifiSockAddr to read into
         HifiSockAddr senderSockAddr;
 
-        // setup a buffer to read the packet into
-        auto buffer = std::unique_ptr<char[]>(new char[packetSizeWithHeader]);
+        // grab a buffer to read the packet into
+        auto buffer = bufferPool.acquire(packetSizeWithHeader);
 
         // pull the datagram
         auto sizeRead = _udpSocket.readDatagram(buffer.get(), packetSizeWithHeader,
@@ -410,75 +479,391 @@ void Socket::readPendingDatagrams() {
             continue;
         }
 
-        auto it = _unfilteredHandlers.find(senderSockAddr);
+        processReceivedDatagram(std::move(buffer), packetSizeWithHeader, senderSockAddr, receiveTime);
+
+#if defined(Q_OS_LINUX)
+        // QUdpSocket re-arms its read notifier in readDatagram, so anything else queued on the
+        // descriptor can now be drained in batches without stalling the next readyRead
+        readPendingDatagramsBatched(abortTime);
+#endif
+    }
+}
+
+#if defined(Q_OS_LINUX)
+void Socket::readPendingDatagramsBatched(std::chrono::system_clock::time_point abortTime) {
+    static const int MAX_BATCH_SIZE = 32;
+    static const int MAX_DATAGRAM_SIZE = 65536;
+    static const int OVERFLOW_SIZE = MAX_DATAGRAM_SIZE - PacketBufferPool::BUFFER_SIZE;
+
+    auto& bufferPool = PacketBufferPool::getInstance();
+    auto sd = _udpSocket.socketDescriptor();
+
+    // a datagram larger than a pooled buffer spills over into its slot of the overflow area, which is only address
+    // space until a datagram that large arrives
+    if (!_receiveOverflow) {
+        _receiveOverflow.reset(new char[MAX_BATCH_SIZE * OVERFLOW_SIZE]);
+    }
+
+    PacketBuffer buffers[MAX_BATCH_SIZE];
+    sockaddr_storage addresses[MAX_BATCH_SIZE];
+    iovec iovecs[MAX_BATCH_SIZE][2];
+    mmsghdr messages[MAX_BATCH_SIZE];
+
+    HifiSockAddr senderSockAddrs[MAX_BATCH_SIZE];
+    std::unique_ptr<Packet> packets[MAX_BATCH_SIZE];
+    std::vector<const Packet*> packetsToVerify;
+    std::vector<uint8_t> verified;
+    packetsToVerify.reserve(MAX_BATCH_SIZE);
+
+    int numReceived = 0;
+    do {
+        if (std::chrono::system_clock::now() > abortTime) {
+            break;
+        }
 
-        if (it != _unfilteredHandlers.end()) {
-            // we have a registered unfiltered handler for this HifiSockAddr - call that and return
-            if (it->second) {
-                auto basePacket = BasePacket::fromReceivedPacket(std::move(buffer), packetSizeWithHeader, senderSockAddr);
-                basePacket->setReceiveTime(receiveTime);
-                it->second(std::move(basePacket));
+        for (int i = 0; i < MAX_BATCH_SIZE; ++i) {
+            // buffers not handed off in the last batch are reused
+            if (!buffers[i]) {
+                buffers[i] = bufferPool.acquire(PacketBufferPool::BUFFER_SIZE);
             }
+            iovecs[i][0].iov_base = buffers[i].get();
+            iovecs[i][0].iov_len = PacketBufferPool::BUFFER_SIZE;
+            iovecs[i][1].iov_base = _receiveOverflow.get() + i * OVERFLOW_SIZE;
+            iovecs[i][1].iov_len = OVERFLOW_SIZE;
+
+            memset(&messages[i], 0, sizeof(mmsghdr));
+            messages[i].msg_hdr.msg_name = &addresses[i];
+            messages[i].msg_hdr.msg_namelen = sizeof(sockaddr_storage);
+            messages[i].msg_hdr.msg_iov = iovecs[i];
+            messages[i].msg_hdr.msg_iovlen = 2;
+        }
 
-            continue;
+        numReceived = recvmmsg(sd, messages, MAX_BATCH_SIZE, MSG_DONTWAIT, nullptr);
+        if (numReceived <= 0) {
+            // EAGAIN - nothing left to read
+            break;
         }
 
-        // check if this was a control packet or a data packet
-        bool isControlPacket = *reinterpret_cast<uint32_t*>(buffer.get()) & CONTROL_BIT_MASK;
+        _numReceiveBatches++;
+        _numBatchedDatagrams += numReceived;
 
-        if (isControlPacket) {
-            // setup a control packet from the data we just read
-            auto controlPacket = ControlPacket::fromReceivedPacket(std::move(buffer), packetSizeWithHeader, senderSockAddr);
-            controlPacket->setReceiveTime(receiveTime);
+        _readyReadBackupTimer->start();
+        auto receiveTime = p_high_resolution_clock::now();
 
-            // move this control packet to the matching connection, if there is one
-            auto connection = findOrCreateConnection(senderSockAddr, true);
+        for (int i = 0; i < numReceived; ++i) {
+            if (messages[i].msg_hdr.msg_flags & MSG_TRUNC) {
+                _numTruncatedDatagrams++;
+                HIFI_FCDEBUG(networking(), "udt::Socket::readPendingDatagramsBatched dropped a datagram larger than"
+                             << MAX_DATAGRAM_SIZE << "bytes from"
+                             << HifiSockAddr(reinterpret_cast<const sockaddr*>(&addresses[i])));
+            } else if (messages[i].msg_len > (unsigned int)PacketBufferPool::BUFFER_SIZE) {
+                // put the datagram back together in a buffer of its own, as readPendingDatagrams would have read it
+                auto buffer = bufferPool.acquire(messages[i].msg_len);
+                memcpy(buffer.get(), buffers[i].get(), PacketBufferPool::BUFFER_SIZE);
+                memcpy(buffer.get() + PacketBufferPool::BUFFER_SIZE, iovecs[i][1].iov_base,
+                       messages[i].msg_len - PacketBufferPool::BUFFER_SIZE);
+                buffers[i] = std::move(buffer);
+            }
+        }
 
-            if (connection) {
-                connection->processControl(move(controlPacket));
+        auto isUsable = [&](int i) {
+            // nothing we can use, or only part of a datagram, is dropped
+            return messages[i].msg_len > 0 && !(messages[i].msg_hdr.msg_flags & MSG_TRUNC);
+        };
+
+        // data packets of the batch are set up first, so that they can be verified together
+        packetsToVerify.clear();
+        for (int i = 0; i < numReceived; ++i) {
+            if (!isUsable(i)) {
+                continue;
             }
 
-        } else {
-            // setup a Packet from the data we just read
-            auto packet = Packet::fromReceivedPacket(std::move(buffer), packetSizeWithHeader, senderSockAddr);
-            packet->setReceiveTime(receiveTime);
+            qint64 sizeRead = messages[i].msg_len;
 
-            // save the sequence number in case this is the packet that sticks readyRead
-            _lastReceivedSequenceNumber = packet->getSequenceNumber();
+            senderSockAddrs[i] = HifiSockAddr(reinterpret_cast<const sockaddr*>(&addresses[i]));
 
-            // call our verification operator to see if this packet is verified
-            if (!_packetFilterOperator || _packetFilterOperator(*packet)) {
-                auto connection = findOrCreateConnection(senderSockAddr, true);
+            _lastPacketSizeRead = sizeRead;
+            _lastPacketSockAddr = senderSockAddrs[i];
 
-                if (packet->isReliable()) {
-                    // if this was a reliable packet then signal the matching connection with the sequence number
+            if (_packetBatchFilterOperator && isFilteredDataPacket(buffers[i].get(), senderSockAddrs[i])) {
+                packets[i] = createReceivedPacket(std::move(buffers[i]), sizeRead, senderSockAddrs[i], receiveTime);
+                packetsToVerify.push_back(packets[i].get());
+            }
+        }
 
-                    if (!connection || !connection->processReceivedSequenceNumber(packet->getSequenceNumber(),
-                                                                                  packet->getDataSize(),
-                                                                                  packet->getPayloadSize())) {
-                        // the connection could not be created or indicated that we should not continue processing this packet
-#ifdef UDT_CONNECTION_DEBUG
-                        qCDebug(networking) << "Can't process packet: version" << (unsigned int)NLPacket::versionInHeader(*packet)
-                            << ", type" << NLPacket::typeInHeader(*packet);
-#endif
-                        continue;
-                    }
-                } else if (connection) {
-                    connection->recordReceivedUnreliablePackets(packet->getWireSize(),
-                                                                packet->getPayloadSize());
-                }
+        if (!packetsToVerify.empty()) {
+            _packetBatchFilterOperator(packetsToVerify, verified);
+        }
 
-                if (packet->isPartOfMessage()) {
-                    auto connection = findOrCreateConnection(senderSockAddr, true);
-                    if (connection) {
-                        connection->queueReceivedMessagePacket(std::move(packet));
-                    }
-                } else if (_packetHandler) {
-                    // call the verified packet callback to let it handle this packet
-                    _packetHandler(std::move(packet));
+        // then everything is handled in the order it was received
+        size_t verifiedIndex = 0;
+        for (int i = 0; i < numReceived; ++i) {
+            if (packets[i]) {
+                if (verified[verifiedIndex++]) {
+                    processVerifiedPacket(std::move(packets[i]));
                 }
+                packets[i].reset();
+            } else if (isUsable(i)) {
+                processReceivedDatagram(std::move(buffers[i]), messages[i].msg_len, senderSockAddrs[i], receiveTime);
             }
         }
+    } while (numReceived == MAX_BATCH_SIZE);
+}
+#endif
+
+bool Socket::beginSendBatch() {
+#if defined(Q_OS_LINUX)
+    if (sendBatch.socket) {
+        // a batch left open on this thread goes out before the new one starts
+        sendBatch.socket->flushSendBatch();
+    }
+
+    sendBatch.socket = this;
+    sendBatch.stats = SendBatchStats();
+    return true;
+#else
+    return false;
+#endif
+}
+
+Socket::SendBatchStats Socket::endSendBatch() {
+    SendBatchStats stats;
+#if defined(Q_OS_LINUX)
+    if (sendBatch.socket == this) {
+        flushSendBatch();
+        stats = sendBatch.stats;
+        sendBatch.socket = nullptr;
+    }
+#endif
+    return stats;
+}
+
+#if defined(Q_OS_LINUX)
+bool Socket::queueBatchedDatagram(const char* data, qint64 size, const HifiSockAddr& sockAddr) {
+    bool isIPv4 = false;
+    quint32 address = sockAddr.getAddress().toIPv4Address(&isIPv4);
+
+    if (!isIPv4 || _udpSocket.state() != QAbstractSocket::BoundState
+        || _udpSocket.localAddress().protocol() != QAbstractSocket::IPv4Protocol) {
+        // leave anything we can't address directly (and the unbound error reporting) to writeDatagram
+        return false;
+    }
+
+    if (sendBatch.data.capacity() == 0) {
+        sendBatch.data.reserve(MAX_SEND_BATCH_SIZE * MAX_PACKET_SIZE);
+        sendBatch.datagrams.reserve(MAX_SEND_BATCH_SIZE);
+    }
+
+    BatchedDatagram datagram;
+    datagram.offset = sendBatch.data.size();
+    datagram.size = (int)size;
+    memset(&datagram.destination, 0, sizeof(sockaddr_in));
+    datagram.destination.sin_family = AF_INET;
+    datagram.destination.sin_addr.s_addr = htonl(address);
+    datagram.destination.sin_port = htons(sockAddr.getPort());
+
+    sendBatch.data.insert(sendBatch.data.end(), data, data + size);
+    sendBatch.datagrams.push_back(datagram);
+    sendBatch.stats.numDatagrams++;
+
+    if ((int)sendBatch.datagrams.size() >= MAX_SEND_BATCH_SIZE) {
+        flushSendBatch();
+    }
+
+    return true;
+}
+
+void Socket::flushSendBatch() {
+    auto& datagrams = sendBatch.datagrams;
+    if (datagrams.empty()) {
+        return;
+    }
+
+    mmsghdr messages[MAX_SEND_BATCH_SIZE];
+    iovec iovecs[MAX_SEND_BATCH_SIZE];
+    union {
+        char buffer[CMSG_SPACE(sizeof(uint16_t))];
+        cmsghdr align;
+    } controls[MAX_SEND_BATCH_SIZE];
+    int segmentsPerMessage[MAX_SEND_BATCH_SIZE];
+    size_t messageFirstDatagram[MAX_SEND_BATCH_SIZE];
+
+    bool useSegmentation = _useUDPSegmentation;
+    int numMessages = 0;
+
+    size_t index = 0;
+    while (index < datagrams.size()) {
+        const auto& first = datagrams[index];
+
+        // consecutive same-sized datagrams to one destination are contiguous in the batch buffer,
+        // so with GSO they can go out as a single message that the kernel splits back up
+        int numSegments = 1;
+        if (useSegmentation) {
+            while (index + numSegments < datagrams.size() && numSegments < MAX_SEGMENTS_PER_SEND
+                   && (numSegments + 1) * first.size <= MAX_SEGMENTED_SEND_BYTES
+                   && datagrams[index + numSegments].size == first.size
+                   && isSameDestination(datagrams[index + numSegments].destination, first.destination)) {
+                ++numSegments;
+            }
+        }
+
+        iovecs[numMessages].iov_base = &sendBatch.data[first.offset];
+        iovecs[numMessages].iov_len = numSegments * first.size;
+
+        auto& message = messages[numMessages];
+        memset(&message, 0, sizeof(mmsghdr));
+        message.msg_hdr.msg_name = const_cast<sockaddr_in*>(&first.destination);
+        message.msg_hdr.msg_namelen = sizeof(sockaddr_in);
+        message.msg_hdr.msg_iov = &iovecs[numMessages];
+        message.msg_hdr.msg_iovlen = 1;
+
+        if (numSegments > 1) {
+            message.msg_hdr.msg_control = controls[numMessages].buffer;
+            message.msg_hdr.msg_controllen = sizeof(controls[numMessages].buffer);
+
+            cmsghdr* cmsg = CMSG_FIRSTHDR(&message.msg_hdr);
+            cmsg->cmsg_level = SOL_UDP;
+            cmsg->cmsg_type = UDP_SEGMENT;
+            cmsg->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+            uint16_t segmentSize = (uint16_t)first.size;
+            memcpy(CMSG_DATA(cmsg), &segmentSize, sizeof(segmentSize));
+        }
+
+        segmentsPerMessage[numMessages] = numSegments;
+        messageFirstDatagram[numMessages] = index;
+        ++numMessages;
+        index += numSegments;
+    }
+
+    auto sd = _udpSocket.socketDescriptor();
+    int numSent = 0;
+    while (numSent < numMessages) {
+        int result = sendmmsg(sd, messages + numSent, numMessages - numSent, 0);
+        sendBatch.stats.numSyscalls++;
+
+        if (result < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+
+            // the first unsent message failed, drop it like writeDatagram would and carry on with the rest
+            int error = errno;
+
+            // only errors that say the kernel or device can't segment turn GSO off, a full buffer (EAGAIN, ENOBUFS)
+            // or an unreachable destination will pass
+            bool isSegmentationError = error == EINVAL || error == EIO || error == EOPNOTSUPP;
+            if (segmentsPerMessage[numSent] > 1 && isSegmentationError && _useUDPSegmentation.exchange(false)) {
+                qCWarning(networking) << "Socket::flushSendBatch disabling UDP segmentation after send error" << error;
+            }
+
+            const auto& failed = datagrams[messageFirstDatagram[numSent]];
+            QString errorDescription;
+            QDebug(&errorDescription) << "(" << strerror(error) << ") dropped" << segmentsPerMessage[numSent] << "datagram(s)";
+            logWriteDatagramError(HifiSockAddr(reinterpret_cast<const sockaddr*>(&failed.destination)), error,
+                                  errorDescription, 0);
+            ++numSent;
+            continue;
+        }
+
+        for (int i = numSent; i < numSent + result; ++i) {
+            if (segmentsPerMessage[i] > 1) {
+                sendBatch.stats.numSegmentedDatagrams += segmentsPerMessage[i];
+            }
+        }
+        numSent += result;
+    }
+
+    datagrams.clear();
+    sendBatch.data.clear();
+}
+#endif
+
+void Socket::processReceivedDatagram(PacketBuffer buffer, qint64 size, const HifiSockAddr& senderSockAddr,
+                                     p_high_resolution_clock::time_point receiveTime) {
+    auto it = _unfilteredHandlers.find(senderSockAddr);
+
+    if (it != _unfilteredHandlers.end()) {
+        // we have a registered unfiltered handler for this HifiSockAddr - call that and return
+        if (it->second) {
+            auto basePacket = BasePacket::fromReceivedPacket(std::move(buffer), size, senderSockAddr);
+            basePacket->setReceiveTime(receiveTime);
+            it->second(std::move(basePacket));
+        }
+
+        return;
+    }
+
+    // check if this was a control packet or a data packet
+    bool isControlPacket = *reinterpret_cast<uint32_t*>(buffer.get()) & CONTROL_BIT_MASK;
+
+    if (isControlPacket) {
+        // setup a control packet from the data we just read
+        auto controlPacket = ControlPacket::fromReceivedPacket(std::move(buffer), size, senderSockAddr);
+        controlPacket->setReceiveTime(receiveTime);
+
+        // move this control packet to the matching connection, if there is one
+        auto connection = findOrCreateConnection(senderSockAddr, true);
+
+        if (connection) {
+            connection->processControl(move(controlPacket));
+        }
+
+    } else {
+        auto packet = createReceivedPacket(std::move(buffer), size, senderSockAddr, receiveTime);
+
+        // call our verification operator to see if this packet is verified
+        if (!_packetFilterOperator || _packetFilterOperator(*packet)) {
+            processVerifiedPacket(std::move(packet));
+        }
+    }
+}
+
+bool Socket::isFilteredDataPacket(const char* data, const HifiSockAddr& senderSockAddr) const {
+    bool isControlPacket = *reinterpret_cast<const uint32_t*>(data) & CONTROL_BIT_MASK;
+    return !isControlPacket && _unfilteredHandlers.find(senderSockAddr) == _unfilteredHandlers.end();
+}
+
+std::unique_ptr<Packet> Socket::createReceivedPacket(PacketBuffer buffer, qint64 size, const HifiSockAddr& senderSockAddr,
+                                                     p_high_resolution_clock::time_point receiveTime) {
+    // setup a Packet from the data we just read
+    auto packet = Packet::fromReceivedPacket(std::move(buffer), size, senderSockAddr);
+    packet->setReceiveTime(receiveTime);
+
+    // save the sequence number in case this is the packet that sticks readyRead
+    _lastReceivedSequenceNumber = packet->getSequenceNumber();
+
+    return packet;
+}
+
+void Socket::processVerifiedPacket(std::unique_ptr<Packet> packet) {
+    const HifiSockAddr& senderSockAddr = packet->getSenderSockAddr();
+    auto connection = findOrCreateConnection(senderSockAddr, true);
+
+    if (packet->isReliable()) {
+        // if this was a reliable packet then signal the matching connection with the sequence number
+
+        if (!connection || !connection->processReceivedSequenceNumber(packet->getSequenceNumber(),
+                                                                      packet->getDataSize(),
+                                                                      packet->getPayloadSize())) {
+            // the connection could not be created or indicated that we should not continue processing this packet
+#ifdef UDT_CONNECTION_DEBUG
+            qCDebug(networking) << "Can't process packet: version" << (unsigned int)NLPacket::versionInHeader(*packet)
+                << ", type" << NLPacket::typeInHeader(*packet);
+#endif
+            return;
+        }
+    } else if (connection) {
+        connection->recordReceivedUnreliablePackets(packet->getWireSize(),
+                                                    packet->getPayloadSize());
+    }
+
+    if (packet->isPartOfMessage()) {
+        if (connection) {
+            connection->queueReceivedMessagePacket(std::move(packet));
+        }
+    } else if (_packetHandler) {
+        // call the verified packet callback to let it handle this packet
+        _packetHandler(std::move(packet));
     }
 }
 
@@ -516,6 +901,15 @@ ConnectionStats::Stats Socket::sampleStatsForConnection(const HifiSockAddr& dest
     }
 }
 
+Socket::ReceiveStats Socket::sampleReceiveStats() {
+    ReceiveStats stats;
+    stats.numBatches = _numReceiveBatches.exchange(0);
+    stats.numBatchedDatagrams = _numBatchedDatagrams.exchange(0);
+    stats.numTruncatedDatagrams = _numTruncatedDatagrams.exchange(0);
+    stats.bufferPool = PacketBufferPool::getInstance().sampleStats();
+    return stats;
+}
+
 Socket::StatsVector Socket::sampleStatsForAllConnections() {
     StatsVector result;
     Lock connectionsLock(_connectionsHashMutex);
@@ -14,6 +14,8 @@
 #ifndef hifi_Socket_h
 #define hifi_Socket_h
 
+#include <atomic>
+#include <chrono>
 #include <functional>
 #include <unordered_map>
 #include <mutex>
@@ -26,6 +28,7 @@
 #include "../HifiSockAddr.h"
 #include "TCPVegasCC.h"
 #include "Connection.h"
+#include "PacketBufferPool.h"
 
 //#define UDT_CONNECTION_DEBUG
 
@@ -39,6 +42,9 @@ class PacketList;
 class SequenceNumber;
 
 using PacketFilterOperator = std::function<bool(const Packet&)>;
+// filters the data packets of one receive batch at once, setting verified[i] to 1 for each packet that passes
+using PacketBatchFilterOperator = std::function<void(const std::vector<const Packet*>& packets,
+                                                     std::vector<uint8_t>& verified)>;
 using ConnectionCreationFilterOperator = std::function<bool(const HifiSockAddr&)>;
 
 using BasePacketHandler = std::function<void(std::unique_ptr<BasePacket>)>;
@@ -54,6 +60,19 @@ class Socket : public QObject {
 
 public:
     using StatsVector = std::vector<std::pair<HifiSockAddr, ConnectionStats::Stats>>;
+
+    struct ReceiveStats {
+        quint64 numBatches { 0 }; // recvmmsg calls that returned datagrams
+        quint64 numBatchedDatagrams { 0 }; // datagrams received through those calls
+        quint64 numTruncatedDatagrams { 0 }; // datagrams dropped because they didn't fit the receive buffers
+        PacketBufferPool::Stats bufferPool;
+    };
+
+    struct SendBatchStats {
+        int numDatagrams { 0 }; // unreliable datagrams queued in the batch
+        int numSyscalls { 0 }; // sendmmsg calls made to flush them
+        int numSegmentedDatagrams { 0 }; // datagrams that went out as part of a UDP GSO message
+    };
     
     Socket(QObject* object = 0, bool shouldChangeSocketOptions = true);
     
@@ -66,12 +85,21 @@ public:
     qint64 writePacketList(std::unique_ptr<PacketList> packetList, const HifiSockAddr& sockAddr);
     qint64 writeDatagram(const char* data, qint64 size, const HifiSockAddr& sockAddr);
     qint64 writeDatagram(const QByteArray& datagram, const HifiSockAddr& sockAddr);
+
+    // Unreliable packets written from the calling thread between beginSendBatch and endSendBatch are
+    // queued and flushed together (sendmmsg, with UDP GSO when available) instead of one syscall each.
+    // Returns false, and leaves the send path unchanged, where batching is not supported.
+    bool beginSendBatch();
+    SendBatchStats endSendBatch();
     
     void bind(const QHostAddress& address, quint16 port = 0);
     void rebind(quint16 port);
     void rebind();
 
     void setPacketFilterOperator(PacketFilterOperator filterOperator) { _packetFilterOperator = filterOperator; }
+    // used instead of the packet filter operator for datagrams read in batches, when set
+    void setPacketBatchFilterOperator(PacketBatchFilterOperator filterOperator)
+        { _packetBatchFilterOperator = filterOperator; }
     void setPacketHandler(PacketHandler handler) { _packetHandler = handler; }
     void setMessageHandler(MessageHandler handler) { _messageHandler = handler; }
     void setMessageFailureHandler(MessageFailureHandler handler) { _messageFailureHandler = handler; }
@@ -88,6 +116,7 @@ public:
     void messageFailed(Connection* connection, Packet::MessageNumber messageNumber);
     
     StatsVector sampleStatsForAllConnections();
+    ReceiveStats sampleReceiveStats();
 
 #if (PR_BUILD || DEV_BUILD)
     void sendFakedHandshakeRequest(const HifiSockAddr& sockAddr);
@@ -111,6 +140,19 @@ private slots:
 private:
     void setSystemBufferSizes();
     Connection* findOrCreateConnection(const HifiSockAddr& sockAddr, bool filterCreation = false);
+    void logWriteDatagramError(const HifiSockAddr& sockAddr, int error, const QString& errorDescription, int pending);
+
+    void processReceivedDatagram(PacketBuffer buffer, qint64 size, const HifiSockAddr& senderSockAddr,
+                                 p_high_resolution_clock::time_point receiveTime);
+    bool isFilteredDataPacket(const char* data, const HifiSockAddr& senderSockAddr) const;
+    std::unique_ptr<Packet> createReceivedPacket(PacketBuffer buffer, qint64 size, const HifiSockAddr& senderSockAddr,
+                                                 p_high_resolution_clock::time_point receiveTime);
+    void processVerifiedPacket(std::unique_ptr<Packet> packet);
+#if defined(Q_OS_LINUX)
+    void readPendingDatagramsBatched(std::chrono::system_clock::time_point abortTime);
+    bool queueBatchedDatagram(const char* data, qint64 size, const HifiSockAddr& sockAddr);
+    void flushSendBatch();
+#endif
    
     // privatized methods used by UDTTest - they are private since they must be called on the Socket thread
     ConnectionStats::Stats sampleStatsForConnection(const HifiSockAddr& destination);
@@ -123,6 +165,7 @@ private:
     
     QUdpSocket _udpSocket { this };
     PacketFilterOperator _packetFilterOperator;
+    PacketBatchFilterOperator _packetBatchFilterOperator;
     PacketHandler _packetHandler;
     MessageHandler _messageHandler;
     MessageFailureHandler _messageFailureHandler;
@@ -146,6 +189,13 @@ private:
     int _lastPacketSizeRead { 0 };
     SequenceNumber _lastReceivedSequenceNumber;
     HifiSockAddr _lastPacketSockAddr;
+
+    std::atomic<quint64> _numReceiveBatches { 0 };
+    std::atomic<quint64> _numBatchedDatagrams { 0 };
+    std::atomic<quint64> _numTruncatedDatagrams { 0 };
+    std::unique_ptr<char[]> _receiveOverflow; // where datagrams larger than a pooled buffer continue, see readPendingDatagramsBatched
+
+    std::atomic<bool> _useUDPSegmentation { false };
     
     friend UDTTest;
 };
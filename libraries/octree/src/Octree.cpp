@@ -273,11 +273,11 @@ int Octree::readElementData(const OctreeElementPointer& destinationElement, cons
             // wouldn't flag childElementAt as dirty, so we manually flag it here... if the element is to be rendered.
             if (childElementAt->getShouldRender() && !childElementAt->isRendered()) {
                 childElementAt->setDirtyBit(); // force dirty!
-                _isDirty = true;
+                setDirtyBit();
             }
         }
         if (destinationElement->isDirty()) {
-            _isDirty = true;
+            setDirtyBit();
         }
     }
 
@@ -311,7 +311,7 @@ int Octree::readElementData(const OctreeElementPointer& destinationElement, cons
                 childAt = destinationElement->addChildAtIndex(childIndex);
                 bool nodeIsDirty = destinationElement->isDirty();
                 if (nodeIsDirty) {
-                    _isDirty = true;
+                    setDirtyBit();
                 }
             }
 
@@ -330,7 +330,7 @@ int Octree::readElementData(const OctreeElementPointer& destinationElement, cons
             // subtree/element, because it shouldn't actually exist in the tree.
             if (!oneAtBit(childrenInTreeMask, i) && destinationElement->getChildAtIndex(i)) {
                 destinationElement->safeDeepDeleteChildAtIndex(i);
-                _isDirty = true; // by definition!
+                setDirtyBit(); // by definition!
             }
         }
     }
@@ -385,7 +385,7 @@ void Octree::readBitstreamToTree(const unsigned char * bitstream, uint64_t buffe
             // octal code is always relative to root!
             bitstreamRootElement = createMissingElement(args.destinationElement, (unsigned char*) bitstreamAt);
             if (bitstreamRootElement->isDirty()) {
-                _isDirty = true;
+                setDirtyBit();
             }
         }
 
@@ -411,7 +411,7 @@ void Octree::eraseAllOctreeElements(bool createNewRoot) {
         _rootElement.reset(); // this will recurse and delete all children
     }
 
-    _isDirty = true;
+    setDirtyBit();
 }
 
 // Note: this is an expensive call. Don't call it unless you really need to reaverage the entire tree (from startElement)
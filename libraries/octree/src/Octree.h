@@ -26,6 +26,7 @@
 
 #include "OctreeElement.h"
 #include "OctreeElementBag.h"
+#include "OctreeJournal.h"
 #include "OctreePacketData.h"
 #include "OctreeSceneStats.h"
 #include "OctreeUtils.h"
@@ -109,6 +110,9 @@ public:
     SharedNodePointer sourceNode;
     int elementsPerPacket = 0;
     int entitiesPerPacket = 0;
+    // the data was persisted by this server rather than sent by a node: it isn't weighed against the simulation
+    // ownership of this node, nor extrapolated to the time it is read
+    bool isPersistedData = false;
 
     ReadBitstreamToTreeParams(
         bool includeExistsBits = WANT_EXISTS_BITS,
@@ -152,7 +156,7 @@ public:
 
     OctreeElementPointer getRoot() { return _rootElement; }
 
-    virtual void eraseDomainAndNonOwnedEntities() { _isDirty = true; };
+    virtual void eraseDomainAndNonOwnedEntities() { setDirtyBit(); };
     virtual void eraseAllOctreeElements(bool createNewRoot = true);
 
     virtual void readBitstreamToTree(const unsigned char* bitstream,  uint64_t bufferSizeBytes, ReadBitstreamToTreeParams& args);
@@ -175,8 +179,13 @@ public:
     void recurseTreeWithOperator(RecurseOctreeOperator* operatorObject);
 
     bool isDirty() const { return _isDirty; }
-    void clearDirtyBit() { _isDirty = false; }
-    void setDirtyBit() { _isDirty = true; }
+    void clearDirtyBit() { _isDirty = false; _hasUnjournaledChanges = false; }
+    void setDirtyBit() { _isDirty = true; _hasUnjournaledChanges = true; }
+
+    // for changes that the persist journal records (see takeJournalRecords), the tree is dirty but the journal still
+    // covers everything that changed since the last persist
+    void setJournaledDirtyBit() { _isDirty = true; }
+    bool hasUnjournaledChanges() const { return _hasUnjournaledChanges; }
 
     // output hints from the encode process
     typedef enum {
@@ -260,6 +269,22 @@ public:
     virtual quint64 getAverageFilterTime() const { return 0; }
 
     void incrementPersistDataVersion() { _persistDataVersion++; }
+    QUuid getPersistID() const { return _persistID; }
+    int getPersistDataVersion() const { return _persistDataVersion; }
+
+    // incremental persistence between full snapshots, see OctreePersistThread
+    virtual void setJournalingEnabled(bool enabled) { }
+    // moves the changes recorded since the last call into records, returns false if a full snapshot is needed instead
+    virtual bool takeJournalRecords(std::vector<OctreeJournal::Record>& records) { return false; }
+    // re-applies journaled changes on top of a freshly loaded snapshot, the tree must be write locked
+    virtual bool applyJournalRecords(const std::vector<OctreeJournal::Record>& records, int contentVersion) { return false; }
+
+    // binary snapshots next to the persist file, see OctreePersistThread
+    virtual bool writeToSnapshotFile(const QString& filename, const QByteArray& sourceHash) { return false; }
+    virtual bool readSnapshotFileInfo(const QString& filename, QUuid& id, int64_t& dataVersion,
+                                      QByteArray& sourceHash) const { return false; }
+    // the tree must be write locked
+    virtual bool readFromSnapshotFile(const QString& filename) { return false; }
 
 
 protected:
@@ -278,6 +303,7 @@ protected:
     int _persistDataVersion { 0 };
 
     bool _isDirty;
+    bool _hasUnjournaledChanges { true };
     bool _shouldReaverage;
 
     bool _isViewing;
@@ -0,0 +1,157 @@
+//
+//  OctreeJournal.cpp
+//  libraries/octree/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "OctreeJournal.h"
+
+#include <QtCore/QDataStream>
+
+#include "OctreeLogging.h"
+
+static const quint32 JOURNAL_MAGIC = 0x48464a4c; // "HFJL"
+static const quint32 JOURNAL_FORMAT_VERSION = 1;
+
+// type, id, data size and checksum
+static const int RECORD_OVERHEAD_BYTES = sizeof(quint8) + 16 + sizeof(quint32) + sizeof(quint16);
+
+static quint16 recordChecksum(const OctreeJournal::Record& record, const QByteArray& idBytes) {
+    QByteArray checked;
+    checked.reserve(1 + idBytes.size() + record.data.size());
+    checked.append((char)record.type);
+    checked.append(idBytes);
+    checked.append(record.data);
+    return qChecksum(checked.constData(), checked.size());
+}
+
+bool OctreeJournal::reset(const Header& header) {
+    close();
+
+    _file.setFileName(_filename);
+    if (!_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qCWarning(octree) << "Could not open journal" << _filename << _file.errorString();
+        return false;
+    }
+
+    QDataStream stream(&_file);
+    stream << JOURNAL_MAGIC << JOURNAL_FORMAT_VERSION;
+    stream.writeRawData(header.persistID.toRfc4122().constData(), 16);
+    stream << header.dataVersion << (qint32)header.contentVersion;
+
+    if (stream.status() != QDataStream::Ok || !_file.flush()) {
+        qCWarning(octree) << "Could not write journal header to" << _filename;
+        close();
+        return false;
+    }
+
+    _size = _file.size();
+    _numRecords = 0;
+    return true;
+}
+
+void OctreeJournal::close() {
+    if (_file.isOpen()) {
+        _file.close();
+    }
+    _size = 0;
+    _numRecords = 0;
+}
+
+bool OctreeJournal::remove() {
+    close();
+    return !QFile::exists(_filename) || QFile::remove(_filename);
+}
+
+bool OctreeJournal::append(const std::vector<Record>& records) {
+    if (!_file.isOpen()) {
+        return false;
+    }
+
+    // build the whole batch first so that it hits the file in a single write
+    QByteArray batch;
+    QDataStream stream(&batch, QIODevice::WriteOnly);
+    for (const auto& record : records) {
+        QByteArray idBytes = record.id.toRfc4122();
+        stream << (quint8)record.type;
+        stream.writeRawData(idBytes.constData(), idBytes.size());
+        stream << (quint32)record.data.size();
+        stream.writeRawData(record.data.constData(), record.data.size());
+        stream << recordChecksum(record, idBytes);
+    }
+
+    if (_file.write(batch) != batch.size() || !_file.flush()) {
+        qCWarning(octree) << "Failed to append" << records.size() << "records to journal" << _filename
+            << _file.errorString();
+        return false;
+    }
+
+    _size += batch.size();
+    _numRecords += (int)records.size();
+    return true;
+}
+
+bool OctreeJournal::read(const QString& filename, Header& header, std::vector<Record>& records) {
+    QFile file(filename);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QDataStream stream(&file);
+    quint32 magic { 0 };
+    quint32 formatVersion { 0 };
+    stream >> magic >> formatVersion;
+    if (magic != JOURNAL_MAGIC || formatVersion != JOURNAL_FORMAT_VERSION) {
+        qCWarning(octree) << "Ignoring journal with unknown format" << filename;
+        return false;
+    }
+
+    QByteArray persistID(16, 0);
+    qint32 contentVersion { 0 };
+    stream.readRawData(persistID.data(), 16);
+    stream >> header.dataVersion >> contentVersion;
+    header.persistID = QUuid::fromRfc4122(persistID);
+    header.contentVersion = contentVersion;
+    if (stream.status() != QDataStream::Ok) {
+        return false;
+    }
+
+    while (!stream.atEnd()) {
+        if (file.bytesAvailable() < RECORD_OVERHEAD_BYTES) {
+            qCWarning(octree) << "Journal" << filename << "ends with a partial record, ignoring it";
+            break;
+        }
+
+        quint8 type { 0 };
+        QByteArray idBytes(16, 0);
+        quint32 dataSize { 0 };
+        stream >> type;
+        stream.readRawData(idBytes.data(), 16);
+        stream >> dataSize;
+
+        if (dataSize + sizeof(quint16) > (quint64)file.bytesAvailable()) {
+            qCWarning(octree) << "Journal" << filename << "ends with a partial record, ignoring it";
+            break;
+        }
+
+        Record record { (RecordType)type, QUuid::fromRfc4122(idBytes), QByteArray((int)dataSize, 0) };
+        stream.readRawData(record.data.data(), (int)dataSize);
+
+        quint16 checksum { 0 };
+        stream >> checksum;
+        if (stream.status() != QDataStream::Ok || checksum != recordChecksum(record, idBytes)
+            || (record.type != RecordType::Update && record.type != RecordType::Delete)) {
+            qCWarning(octree) << "Journal" << filename << "has a corrupt record after" << records.size()
+                << "records, ignoring the rest";
+            break;
+        }
+
+        records.push_back(std::move(record));
+    }
+
+    return true;
+}
@@ -0,0 +1,69 @@
+//
+//  OctreeJournal.h
+//  libraries/octree/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_OctreeJournal_h
+#define hifi_OctreeJournal_h
+
+#include <vector>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QFile>
+#include <QtCore/QString>
+#include <QtCore/QUuid>
+
+// OctreeJournal is an append-only binary log of element changes made since the last full snapshot
+// of an octree was persisted.  The header ties the journal to the snapshot it applies on top of
+// (persist ID and data version), so a journal left behind by an older or replaced snapshot is
+// never replayed.  Each record carries a checksum; replay stops at the first torn or corrupt record.
+class OctreeJournal {
+public:
+    enum class RecordType : quint8 {
+        Update = 1, // data holds the full serialized element
+        Delete = 2
+    };
+
+    struct Record {
+        RecordType type;
+        QUuid id;
+        QByteArray data;
+    };
+
+    struct Header {
+        QUuid persistID;
+        qint64 dataVersion { 0 };
+        int contentVersion { 0 };
+    };
+
+    OctreeJournal(const QString& filename) : _filename(filename) {}
+
+    const QString& getFilename() const { return _filename; }
+
+    // start a new, empty journal on top of the snapshot described by header
+    bool reset(const Header& header);
+    bool isOpen() const { return _file.isOpen(); }
+    void close();
+    bool remove();
+
+    bool append(const std::vector<Record>& records);
+
+    qint64 getSize() const { return _size; }
+    int getNumRecords() const { return _numRecords; }
+
+    // reads the header and every intact record of the journal at filename
+    static bool read(const QString& filename, Header& header, std::vector<Record>& records);
+
+private:
+    QString _filename;
+    QFile _file;
+    qint64 _size { 0 };
+    int _numRecords { 0 };
+};
+
+#endif // hifi_OctreeJournal_h
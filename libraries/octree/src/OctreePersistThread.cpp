@@ -11,6 +11,7 @@
 
 #include "OctreePersistThread.h"
 
+#include <algorithm>
 #include <chrono>
 #include <thread>
 
@@ -18,11 +19,13 @@
 #include <fstream>
 #include <time.h>
 
+#include <QCryptographicHash>
 #include <QDateTime>
 #include <QDebug>
 #include <QDir>
 #include <QDirIterator>
 #include <QFile>
+#include <QFileInfo>
 #include <QJsonArray>
 #include <QJsonObject>
 #include <QJsonDocument>
@@ -38,13 +41,21 @@
 #include "OctreeDataUtils.h"
 
 constexpr std::chrono::seconds OctreePersistThread::DEFAULT_PERSIST_INTERVAL { 30 };
+constexpr std::chrono::seconds OctreePersistThread::DEFAULT_JOURNAL_COMPACTION_INTERVAL { 600 };
 constexpr std::chrono::milliseconds TIME_BETWEEN_PROCESSING { 10 };
 
 constexpr int MAX_OCTREE_REPLACEMENT_BACKUP_FILES_COUNT { 20 };
 constexpr int64_t MAX_OCTREE_REPLACEMENT_BACKUP_FILES_SIZE_BYTES { 50 * 1000 * 1000 };
 
+static const QString JOURNAL_EXTENSION = ".journal";
+static const QString BINARY_SNAPSHOT_EXTENSION = ".snapshot";
+
+// the journal is compacted into a snapshot once it outgrows the last snapshot (or this, for tiny domains)
+constexpr qint64 MIN_JOURNAL_COMPACTION_SIZE_BYTES { 1000 * 1000 };
+
 OctreePersistThread::OctreePersistThread(OctreePointer tree, const QString& filename, std::chrono::milliseconds persistInterval,
-                                         bool debugTimestampNow, QString persistAsFileType) :
+                                         bool debugTimestampNow, QString persistAsFileType, bool useJournal,
+                                         std::chrono::milliseconds journalCompactionInterval, bool useBinarySnapshot) :
     _tree(tree),
     _filename(filename),
     _persistInterval(persistInterval),
@@ -53,11 +64,17 @@ OctreePersistThread::OctreePersistThread(OctreePointer tree, const QString& file
     _loadTimeUSecs(0),
     _debugTimestampNow(debugTimestampNow),
     _lastTimeDebug(0),
-    _persistAsFileType(persistAsFileType)
+    _persistAsFileType(persistAsFileType),
+    _useJournal(useJournal),
+    _journalCompactionInterval(journalCompactionInterval),
+    _lastSnapshot(std::chrono::steady_clock::now()),
+    _journal(fileNameWithoutExtension(filename, PERSIST_EXTENSIONS) + "." + persistAsFileType + JOURNAL_EXTENSION),
+    _useBinarySnapshot(useBinarySnapshot)
 {
     // in case the persist filename has an extension that doesn't match the file type
     QString sansExt = fileNameWithoutExtension(_filename, PERSIST_EXTENSIONS);
     _filename = sansExt + "." + _persistAsFileType;
+    _binarySnapshotFilename = sansExt + BINARY_SNAPSHOT_EXTENSION;
 }
 
 void OctreePersistThread::start() {
@@ -72,29 +89,38 @@ void OctreePersistThread::start() {
     auto packet = NLPacket::create(PacketType::OctreeDataFileRequest, -1, true, false);
 
     OctreeUtils::RawOctreeData data;
-    qCDebug(octree) << "Reading octree data from" << _filename;
-    QFile file(_filename);
-    if (file.open(QIODevice::ReadOnly)) {
-        QByteArray jsonData(file.readAll());
-        file.close();
-        if (!gunzip(jsonData, _cachedJSONData)) {
-            _cachedJSONData = jsonData;
-        }
+    if (_useBinarySnapshot && readBinarySnapshotInfo(data)) {
+        qCDebug(octree) << "Current octree binary snapshot: ID(" << data.id << ") DataVersion(" << data.dataVersion << ")";
+        _loadFromBinarySnapshot = true;
+        packet->writePrimitive(true);
+        auto id = data.id.toRfc4122();
+        packet->write(id);
+        packet->writePrimitive(data.dataVersion);
+    } else {
+        qCDebug(octree) << "Reading octree data from" << _filename;
+        QFile file(_filename);
+        if (file.open(QIODevice::ReadOnly)) {
+            QByteArray jsonData(file.readAll());
+            file.close();
+            if (!gunzip(jsonData, _cachedJSONData)) {
+                _cachedJSONData = jsonData;
+            }
 
-        if (data.readOctreeDataInfoFromData(_cachedJSONData)) {
-            qCDebug(octree) << "Current octree data: ID(" << data.id << ") DataVersion(" << data.dataVersion << ")";
-            packet->writePrimitive(true);
-            auto id = data.id.toRfc4122();
-            packet->write(id);
-            packet->writePrimitive(data.dataVersion);
+            if (data.readOctreeDataInfoFromData(_cachedJSONData)) {
+                qCDebug(octree) << "Current octree data: ID(" << data.id << ") DataVersion(" << data.dataVersion << ")";
+                packet->writePrimitive(true);
+                auto id = data.id.toRfc4122();
+                packet->write(id);
+                packet->writePrimitive(data.dataVersion);
+            } else {
+                _cachedJSONData.clear();
+                qCWarning(octree) << "No octree data found";
+                packet->writePrimitive(false);
+            }
         } else {
-            _cachedJSONData.clear();
-            qCWarning(octree) << "No octree data found";
+            qCWarning(octree) << "Couldn't access file" << _filename << file.errorString();
             packet->writePrimitive(false);
         }
-    } else {
-        qCWarning(octree) << "Couldn't access file" << _filename << file.errorString();
-        packet->writePrimitive(false);
     }
 
     qCDebug(octree) << "Sending OctreeDataFileRequest to DS";
@@ -114,6 +140,11 @@ void OctreePersistThread::handleOctreeDataFileReply(QSharedPointer<ReceivedMessa
     bool hasValidOctreeData { false };
     if (includesNewData) {
         _cachedJSONData.clear();
+        if (_loadFromBinarySnapshot) {
+            // the snapshot is older than the replacement data
+            _loadFromBinarySnapshot = false;
+            QFile::remove(_binarySnapshotFilename);
+        }
         replacementData = message->readAll();
         replaceData(replacementData);
         hasValidOctreeData = data.readOctreeDataInfoFromFile(_filename);
@@ -153,12 +184,27 @@ void OctreePersistThread::handleOctreeDataFileReply(QSharedPointer<ReceivedMessa
     _tree->withWriteLock([&] {
         PerformanceWarning warn(true, "Loading Octree File", true);
 
-        if (_cachedJSONData.isEmpty()) {
+        if (_loadFromBinarySnapshot) {
+            qCDebug(octree) << "Reading octree binary snapshot from" << _binarySnapshotFilename;
+            persistentFileRead = _tree->readFromSnapshotFile(_binarySnapshotFilename);
+            if (!persistentFileRead) {
+                qCWarning(octree) << "Failed to read binary snapshot" << _binarySnapshotFilename << ", falling back to"
+                    << _filename;
+                _loadFromBinarySnapshot = false;
+                // drop whatever part of the snapshot was added
+                _tree->eraseAllOctreeElements();
+                persistentFileRead = _tree->readFromFile(_filename.toLocal8Bit().constData());
+            }
+        } else if (_cachedJSONData.isEmpty()) {
             persistentFileRead = _tree->readFromFile(_filename.toLocal8Bit().constData());
         } else {
             QDataStream jsonStream(_cachedJSONData);
             persistentFileRead = _tree->readFromStream(-1, jsonStream);
         }
+
+        if (_useJournal && replacementData.isNull()) {
+            replayJournal();
+        }
         _tree->pruneTree();
     });
 
@@ -168,6 +214,22 @@ void OctreePersistThread::handleOctreeDataFileReply(QSharedPointer<ReceivedMessa
 
     _tree->clearDirtyBit(); // the tree is clean since we just loaded it
 
+    if (_useBinarySnapshot && !_loadFromBinarySnapshot && persistentFileRead) {
+        // convert the JSON data we just loaded so that the next start can use the snapshot
+        writeBinarySnapshot();
+    }
+
+    if (_useJournal) {
+        // start tracking edits only now, so that the load itself is not journaled
+        _tree->setJournalingEnabled(true);
+        if (_snapshotNeeded) {
+            // replayed changes are only in the journal, fold them into a new snapshot at the first persist
+            _tree->setDirtyBit();
+        } else {
+            resetJournal();
+        }
+    }
+
     unsigned long nodeCount = OctreeElement::getNodeCount();
     unsigned long internalNodeCount = OctreeElement::getInternalNodeCount();
     unsigned long leafNodeCount = OctreeElement::getLeafNodeCount();
@@ -303,24 +365,168 @@ void OctreePersistThread::cleanupOldReplacementBackups() {
 
 void OctreePersistThread::persist() {
     if (_tree->isDirty() && _initialLoadComplete) {
+        if (_useJournal && persistToJournal()) {
+            // the domain-server's backups still get the latest entities at every persist, as without the journal
+            sendLatestEntityDataToDS();
+            return;
+        }
+        persistSnapshot();
+    }
+}
 
-        _tree->withWriteLock([&] {
-            qCDebug(octree) << "pruning Octree before saving...";
-            _tree->pruneTree();
-            qCDebug(octree) << "DONE pruning Octree before saving...";
-        });
+bool OctreePersistThread::persistToJournal() {
+    auto now = std::chrono::steady_clock::now();
+    bool shouldCompact = _snapshotNeeded || !_journal.isOpen() || now - _lastSnapshot > _journalCompactionInterval
+        || _journal.getSize() > std::max(_lastSnapshotSize, MIN_JOURNAL_COMPACTION_SIZE_BYTES);
+    if (shouldCompact) {
+        return false;
+    }
 
-        _tree->incrementPersistDataVersion();
+    // only changes that the tree journals can be persisted as records, anything else needs a full snapshot
+    bool journalCoversChanges = false;
+    _tree->withReadLock([&] {
+        journalCoversChanges = !_tree->hasUnjournaledChanges();
+        if (journalCoversChanges) {
+            // clear first, so that anything edited while the records are gathered stays dirty for the next round
+            _tree->clearDirtyBit();
+        }
+    });
+    if (!journalCoversChanges) {
+        return false;
+    }
 
-        qCDebug(octree) << "Saving Octree data to:" << _filename;
-        if (_tree->writeToFile(_filename.toLocal8Bit().constData(), nullptr, _persistAsFileType)) {
-            _tree->clearDirtyBit(); // tree is clean after saving
-            qCDebug(octree) << "DONE persisting Octree data to" << _filename;
-        } else {
-            qCWarning(octree) << "Failed to persist Octree data to" << _filename;
+    std::vector<OctreeJournal::Record> records;
+    if (!_tree->takeJournalRecords(records)) {
+        // the tree was replaced or cleared wholesale, the changes can't be expressed as a journal
+        return false;
+    }
+
+    if (records.empty()) {
+        return true;
+    }
+
+    if (!_journal.append(records)) {
+        // the changes have been taken from the tree, the snapshot is the only place left for them
+        return false;
+    }
+
+    qCDebug(octree) << "Journaled" << records.size() << "changes to" << _journal.getFilename()
+        << "(" << _journal.getNumRecords() << "records," << _journal.getSize() << "bytes since the last snapshot)";
+    return true;
+}
+
+void OctreePersistThread::persistSnapshot() {
+    _tree->withWriteLock([&] {
+        qCDebug(octree) << "pruning Octree before saving...";
+        _tree->pruneTree();
+        qCDebug(octree) << "DONE pruning Octree before saving...";
+    });
+
+    _tree->incrementPersistDataVersion();
+
+    qCDebug(octree) << "Saving Octree data to:" << _filename;
+    if (_tree->writeToFile(_filename.toLocal8Bit().constData(), nullptr, _persistAsFileType)) {
+        _tree->clearDirtyBit(); // tree is clean after saving
+        qCDebug(octree) << "DONE persisting Octree data to" << _filename;
+
+        if (_useBinarySnapshot) {
+            writeBinarySnapshot();
         }
 
-        sendLatestEntityDataToDS();
+        if (_useJournal) {
+            // everything journaled so far is now in the snapshot
+            resetJournal();
+        }
+    } else {
+        qCWarning(octree) << "Failed to persist Octree data to" << _filename;
+    }
+
+    sendLatestEntityDataToDS();
+}
+
+void OctreePersistThread::replayJournal() {
+    // NOTE: the tree must be write-locked, with the snapshot this journal was written against already loaded
+    OctreeJournal::Header header;
+    std::vector<OctreeJournal::Record> records;
+    if (!OctreeJournal::read(_journal.getFilename(), header, records)) {
+        return;
+    }
+
+    if (header.persistID != _tree->getPersistID() || header.dataVersion != _tree->getPersistDataVersion()) {
+        qCDebug(octree) << "Ignoring journal" << _journal.getFilename() << "written against other octree data"
+            << header.persistID << header.dataVersion;
+        return;
+    }
+
+    if (records.empty()) {
+        return;
+    }
+
+    qCDebug(octree) << "Replaying" << records.size() << "journaled changes from" << _journal.getFilename();
+    if (!_tree->applyJournalRecords(records, header.contentVersion)) {
+        qCWarning(octree) << "Some journaled changes could not be replayed from" << _journal.getFilename();
+    }
+
+    _snapshotNeeded = true;
+}
+
+void OctreePersistThread::resetJournal() {
+    OctreeJournal::Header header;
+    header.persistID = _tree->getPersistID();
+    header.dataVersion = _tree->getPersistDataVersion();
+    header.contentVersion = _tree->expectedVersion();
+
+    if (!_journal.reset(header)) {
+        qCWarning(octree) << "Journal unavailable, persisting full snapshots of" << _filename;
+    }
+
+    _lastSnapshot = std::chrono::steady_clock::now();
+    _lastSnapshotSize = QFileInfo(_filename).size();
+    _snapshotNeeded = false;
+}
+
+static QByteArray hashPersistFile(const QString& filename) {
+    QFile file(filename);
+    QCryptographicHash hash(QCryptographicHash::Md5);
+    if (!file.open(QIODevice::ReadOnly) || !hash.addData(&file)) {
+        return QByteArray();
+    }
+    return hash.result();
+}
+
+bool OctreePersistThread::readBinarySnapshotInfo(OctreeUtils::RawOctreeData& data) {
+    if (!QFile::exists(_binarySnapshotFilename)) {
+        return false;
+    }
+
+    QUuid id;
+    int64_t dataVersion;
+    QByteArray sourceHash;
+    if (!_tree->readSnapshotFileInfo(_binarySnapshotFilename, id, dataVersion, sourceHash)) {
+        qCDebug(octree) << "Ignoring unusable binary snapshot" << _binarySnapshotFilename;
+        return false;
+    }
+
+    // the JSON file is the source of truth, it may have been replaced or restored since the snapshot was written
+    if (!QFile::exists(_filename) || hashPersistFile(_filename) != sourceHash) {
+        qCDebug(octree) << "Ignoring binary snapshot" << _binarySnapshotFilename << "that doesn't match" << _filename;
+        return false;
+    }
+
+    data.id = id;
+    data.dataVersion = dataVersion;
+    return true;
+}
+
+void OctreePersistThread::writeBinarySnapshot() {
+    PerformanceWarning warn(true, "Writing Octree Binary Snapshot", true);
+    QByteArray sourceHash = hashPersistFile(_filename);
+    if (!sourceHash.isEmpty() && _tree->writeToSnapshotFile(_binarySnapshotFilename, sourceHash)) {
+        qCDebug(octree) << "DONE writing binary snapshot to" << _binarySnapshotFilename;
+    } else {
+        // a stale snapshot must not be loaded over newer JSON data
+        QFile::remove(_binarySnapshotFilename);
+        qCWarning(octree) << "Failed to write binary snapshot to" << _binarySnapshotFilename;
     }
 }
 
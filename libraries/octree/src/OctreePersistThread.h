@@ -17,6 +17,8 @@
 #include <QString>
 #include <GenericThread.h>
 #include "Octree.h"
+#include "OctreeDataUtils.h"
+#include "OctreeJournal.h"
 
 class OctreePersistThread : public QObject {
     Q_OBJECT
@@ -31,12 +33,16 @@ public:
     };
 
     static const std::chrono::seconds DEFAULT_PERSIST_INTERVAL;
+    static const std::chrono::seconds DEFAULT_JOURNAL_COMPACTION_INTERVAL;
 
     OctreePersistThread(OctreePointer tree,
                         const QString& filename,
                         std::chrono::milliseconds persistInterval = DEFAULT_PERSIST_INTERVAL,
                         bool debugTimestampNow = false,
-                        QString persistAsFileType = "json.gz");
+                        QString persistAsFileType = "json.gz",
+                        bool useJournal = false,
+                        std::chrono::milliseconds journalCompactionInterval = DEFAULT_JOURNAL_COMPACTION_INTERVAL,
+                        bool useBinarySnapshot = false);
 
     bool isInitialLoadComplete() const { return _initialLoadComplete; }
     quint64 getLoadElapsedTime() const { return _loadTimeUSecs; }
@@ -59,6 +65,12 @@ protected slots:
 
 protected:
     void persist();
+    bool persistToJournal();
+    void persistSnapshot();
+    void replayJournal();
+    void resetJournal();
+    bool readBinarySnapshotInfo(OctreeUtils::RawOctreeData& data);
+    void writeBinarySnapshot();
     bool backupCurrentFile();
     void cleanupOldReplacementBackups();
 
@@ -79,6 +91,19 @@ private:
 
     QString _persistAsFileType;
     QByteArray _cachedJSONData;
+
+    // between full snapshots, edits are appended to a journal next to the persist file
+    bool _useJournal;
+    std::chrono::milliseconds _journalCompactionInterval;
+    std::chrono::steady_clock::time_point _lastSnapshot;
+    qint64 _lastSnapshotSize { 0 };
+    bool _snapshotNeeded { false };
+    OctreeJournal _journal;
+
+    // a binary snapshot is written next to every full snapshot, and loaded instead of it when current
+    bool _useBinarySnapshot;
+    QString _binarySnapshotFilename;
+    bool _loadFromBinarySnapshot { false };
 };
 
 #endif // hifi_OctreePersistThread_h
@@ -16,6 +16,10 @@ class Encoder {
 public:
     virtual ~Encoder() { }
     virtual void encode(const QByteArray& decodedBuffer, QByteArray& encodedBuffer) = 0;
+
+    // an encoder that keeps no state between frames produces the same output for the same input,
+    // so its output can be shared by all listeners using the codec
+    virtual bool isStateless() const { return false; }
 };
 
 class Decoder {
@@ -24,6 +28,10 @@ public:
     virtual void decode(const QByteArray& encodedBuffer, QByteArray& decodedBuffer) = 0;
 
     virtual void lostFrame(QByteArray& decodedBuffer) = 0;
+
+    // produces the frame lost just before encodedBuffer, from whatever redundancy the codec carries in the frame
+    // that follows it; codecs without any only interpolate the lost frame
+    virtual void recoverFrame(const QByteArray& encodedBuffer, QByteArray& decodedBuffer) { lostFrame(decodedBuffer); }
 };
 
 class CodecPlugin : public Plugin {
@@ -32,4 +40,10 @@ public:
     virtual Decoder* createDecoder(int sampleRate, int numChannels) = 0;
     virtual void releaseEncoder(Encoder* encoder) = 0;
     virtual void releaseDecoder(Decoder* decoder) = 0;
+
+    // tuning for codecs with a variable bitrate, applied to the encoders created afterwards;
+    // codecs with a fixed bitrate ignore it
+    virtual void setEncoderBitrate(int bitsPerSecondPerChannel) {}
+    virtual void setEncoderComplexity(int complexity) {}
+    virtual void setEncoderExpectedPacketLoss(int percent) {}
 };
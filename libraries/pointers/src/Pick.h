@@ -11,6 +11,7 @@
 #include <memory>
 #include <stdint.h>
 #include <bitset>
+#include <vector>
 
 #include <QtCore/QUuid>
 #include <QVector>
@@ -228,6 +229,18 @@ public:
     virtual PickResultPointer getAvatarIntersection(const T& pick) = 0;
     virtual PickResultPointer getHUDIntersection(const T& pick) = 0;
 
+    // Finds the entity intersections of a batch of picks of this pick's type, returning them in the same order. Types
+    // whose picks can share one walk of the entity tree override this, by default each pick is evaluated on its own.
+    virtual std::vector<PickResultPointer> getEntityIntersections(const std::vector<std::shared_ptr<Pick<T>>>& picks,
+            const std::vector<T>& mathPicks) {
+        std::vector<PickResultPointer> results;
+        results.reserve(picks.size());
+        for (size_t i = 0; i < picks.size(); ++i) {
+            results.push_back(picks[i]->getEntityIntersection(mathPicks[i]));
+        }
+        return results;
+    }
+
     QVariantMap toVariantMap() const override {
         QVariantMap properties = PickQuery::toVariantMap();
 
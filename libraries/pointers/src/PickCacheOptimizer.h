@@ -8,8 +8,12 @@
 #ifndef hifi_PickCacheOptimizer_h
 #define hifi_PickCacheOptimizer_h
 
+#include <algorithm>
 #include <unordered_map>
 
+#include <DependencyManager.h>
+#include <shared/WorkStealingScheduler.h>
+
 #include "Pick.h"
 
 typedef struct PickCacheKey {
@@ -31,27 +35,54 @@ namespace std {
     };
 }
 
+// below this many entity picks in a batch they are evaluated on the calling thread, the hand-off isn't worth it
+static const size_t MIN_PICKS_FOR_PARALLEL_ENTITY_PICKS = 8;
+static const size_t ENTITY_PICKS_PER_CHUNK = 4;
+// the picks updated in a batch, sized to what's left of the frame's time budget once the cost of a pick is known
+static const size_t MIN_PICKS_PER_BATCH = 4;
+static const size_t MAX_PICKS_PER_BATCH = 64;
+
 // T is a mathematical representation of a Pick (a MathPick)
 // For example: RayPicks use T = PickRay
 template<typename T>
 class PickCacheOptimizer {
 
 public:
-    QVector3D update(std::unordered_map<uint32_t, std::shared_ptr<PickQuery>>& picks, uint32_t& nextToUpdate, uint64_t expiry, bool shouldPickHUD);
+    QVector3D update(std::unordered_map<uint32_t, std::shared_ptr<PickQuery>>& picks, uint32_t& nextToUpdate, uint64_t expiry,
+        bool shouldPickHUD, bool parallelEntityPicks = false);
 
 protected:
     typedef std::unordered_map<T, std::unordered_map<PickCacheKey, PickResultPointer>> PickCache;
 
+    struct PendingPick {
+        uint32_t id;
+        std::shared_ptr<Pick<T>> pick;
+        T mathPick;
+    };
+
     // Returns true if this pick exists in the cache, and if it does, update res if the cached result is closer
     bool checkAndCompareCachedResults(T& pick, PickCache& cache, PickResultPointer& res, const PickCacheKey& key);
     void cacheResult(const bool intersects, const PickResultPointer& resTemp, const PickCacheKey& key, PickResultPointer& res, T& mathPick, PickCache& cache, const std::shared_ptr<Pick<T>> pick);
+
+    // Evaluates the entity intersections of all the picks at once, caching one result per distinct pick and key.
+    // Returns the index of the pick each result was found for, in order.
+    std::vector<size_t> updateEntityIntersections(const std::vector<PendingPick>& pendingPicks, PickCache& cache, bool parallel);
+    std::vector<PickResultPointer> getEntityIntersections(const std::vector<std::shared_ptr<Pick<T>>>& picks,
+        const std::vector<T>& mathPicks, bool parallel);
 };
 
 template<typename T>
 bool PickCacheOptimizer<T>::checkAndCompareCachedResults(T& pick, PickCache& cache, PickResultPointer& res, const PickCacheKey& key) {
-    if (cache.find(pick) != cache.end() && cache[pick].find(key) != cache[pick].end()) {
-        res = res->compareAndProcessNewResult(cache[pick][key]);
-        return true;
+    auto cachedPick = cache.find(pick);
+    if (cachedPick != cache.end()) {
+        auto cachedResult = cachedPick->second.find(key);
+        if (cachedResult != cachedPick->second.end()) {
+            // an entity pick that found no result at all is cached as null
+            if (cachedResult->second) {
+                res = res->compareAndProcessNewResult(cachedResult->second);
+            }
+            return true;
+        }
     }
     return false;
 }
@@ -66,9 +97,76 @@ void PickCacheOptimizer<T>::cacheResult(const bool needToCompareResults, const P
     }
 }
 
+template<typename T>
+std::vector<PickResultPointer> PickCacheOptimizer<T>::getEntityIntersections(const std::vector<std::shared_ptr<Pick<T>>>& picks,
+        const std::vector<T>& mathPicks, bool parallel) {
+    if (!parallel || picks.size() < MIN_PICKS_FOR_PARALLEL_ENTITY_PICKS || !DependencyManager::isSet<WorkStealingScheduler>()) {
+        return picks.front()->getEntityIntersections(picks, mathPicks);
+    }
+
+    // each chunk of the batch is evaluated together, on whichever participant takes it
+    std::vector<PickResultPointer> results(picks.size());
+    auto scheduler = DependencyManager::get<WorkStealingScheduler>();
+    WorkStealingScheduler::Job job;
+    job.numItems = picks.size();
+    job.chunkSize = ENTITY_PICKS_PER_CHUNK;
+    job.maxParticipants = scheduler->getMaxParticipants();
+    job.process = [&](int participant, size_t first, size_t last) {
+        std::vector<std::shared_ptr<Pick<T>>> chunkPicks(picks.begin() + first, picks.begin() + last);
+        std::vector<T> chunkMathPicks(mathPicks.begin() + first, mathPicks.begin() + last);
+        auto chunkResults = chunkPicks.front()->getEntityIntersections(chunkPicks, chunkMathPicks);
+        std::copy(chunkResults.begin(), chunkResults.end(), results.begin() + first);
+    };
+    scheduler->run(job);
+    return results;
+}
+
+template<typename T>
+std::vector<size_t> PickCacheOptimizer<T>::updateEntityIntersections(const std::vector<PendingPick>& pendingPicks, PickCache& cache,
+        bool parallel) {
+    std::vector<std::shared_ptr<Pick<T>>> picks;
+    std::vector<T> mathPicks;
+    std::vector<PickCacheKey> keys;
+    std::vector<size_t> foundFor;
+    for (size_t i = 0; i < pendingPicks.size(); ++i) {
+        const auto& pendingPick = pendingPicks[i];
+        const auto& pick = pendingPick.pick;
+        if (!pick->isEnabled() || pick->getMaxDistance() < 0.0f || !pendingPick.mathPick) {
+            continue;
+        }
+        if (pick->getFilter().doesPickDomainEntities() || pick->getFilter().doesPickAvatarEntities() || pick->getFilter().doesPickLocalEntities()) {
+            PickCacheKey entityKey = { pick->getFilter().getEntityFlags(), pick->getIncludeItems(), pick->getIgnoreItems() };
+            auto& cachedResults = cache[pendingPick.mathPick];
+            if (cachedResults.find(entityKey) == cachedResults.end()) {
+                // reserve the entry so that identical picks are only evaluated once
+                cachedResults[entityKey] = PickResultPointer();
+                picks.push_back(pick);
+                mathPicks.push_back(pendingPick.mathPick);
+                keys.push_back(entityKey);
+                foundFor.push_back(i);
+            }
+        }
+    }
+
+    if (picks.empty()) {
+        return foundFor;
+    }
+
+    std::vector<PickResultPointer> entityResults = getEntityIntersections(picks, mathPicks, parallel);
+    for (size_t i = 0; i < picks.size(); ++i) {
+        const auto& entityRes = entityResults[i];
+        if (entityRes && !entityRes->doesIntersect()) {
+            cache[mathPicks[i]][keys[i]] = picks[i]->getDefaultResult(mathPicks[i].toVariantMap());
+        } else {
+            cache[mathPicks[i]][keys[i]] = entityRes;
+        }
+    }
+    return foundFor;
+}
+
 template<typename T>
 QVector3D PickCacheOptimizer<T>::update(std::unordered_map<uint32_t, std::shared_ptr<PickQuery>>& picks,
-        uint32_t& nextToUpdate, uint64_t expiry, bool shouldPickHUD) {
+        uint32_t& nextToUpdate, uint64_t expiry, bool shouldPickHUD, bool parallelEntityPicks) {
     QVector3D numIntersectionsComputed;
     PickCache results;
     const uint32_t INVALID_PICK_ID = 0;
@@ -79,63 +177,92 @@ QVector3D PickCacheOptimizer<T>::update(std::unordered_map<uint32_t, std::shared
             itr = picks.begin();
         }
     }
+
+    // The picks are updated in batches, so that the entity intersections of a batch can be found together rather than
+    // each pick walking the entity tree on its own. Each batch is only as large as the time left is likely to allow,
+    // so that little of the costly work is done for picks the budget won't reach.
+    uint64_t start = usecTimestampNow();
     uint32_t numUpdates = 0;
-    while(numUpdates < picks.size()) {
-        std::shared_ptr<Pick<T>> pick = std::static_pointer_cast<Pick<T>>(itr->second);
-        T mathematicalPick = pick->getMathematicalPick();
-        PickResultPointer res = pick->getDefaultResult(mathematicalPick.toVariantMap());
+    std::vector<PendingPick> pendingPicks;
+    while (numUpdates < picks.size()) {
+        size_t batchSize = MIN_PICKS_PER_BATCH;
+        if (numUpdates > 0) {
+            uint64_t now = usecTimestampNow();
+            uint64_t usecsPerPick = std::max((now - start) / numUpdates, (uint64_t)1);
+            uint64_t usecsLeft = expiry > now ? expiry - now : 0;
+            batchSize = (size_t)std::min(std::max(usecsLeft / usecsPerPick, (uint64_t)MIN_PICKS_PER_BATCH), (uint64_t)MAX_PICKS_PER_BATCH);
+        }
+        batchSize = std::min(batchSize, picks.size() - numUpdates);
 
-        if (!pick->isEnabled() || pick->getMaxDistance() < 0.0f || !mathematicalPick) {
-            pick->setPickResult(res);
-        } else {
-            if (pick->getFilter().doesPickDomainEntities() || pick->getFilter().doesPickAvatarEntities() || pick->getFilter().doesPickLocalEntities()) {
-                PickCacheKey entityKey = { pick->getFilter().getEntityFlags(), pick->getIncludeItems(), pick->getIgnoreItems() };
-                if (!checkAndCompareCachedResults(mathematicalPick, results, res, entityKey)) {
-                    PickResultPointer entityRes = pick->getEntityIntersection(mathematicalPick);
-                    numIntersectionsComputed[0]++;
-                    if (entityRes) {
-                        cacheResult(entityRes->doesIntersect(), entityRes, entityKey, res, mathematicalPick, results, pick);
-                    }
-                }
+        pendingPicks.clear();
+        for (size_t i = 0; i < batchSize; ++i) {
+            std::shared_ptr<Pick<T>> pick = std::static_pointer_cast<Pick<T>>(itr->second);
+            pendingPicks.push_back({ itr->first, pick, pick->getMathematicalPick() });
+            ++itr;
+            if (itr == picks.end()) {
+                itr = picks.begin();
             }
+        }
 
-            if (pick->getFilter().doesPickAvatars()) {
-                PickCacheKey avatarKey = { pick->getFilter().getAvatarFlags(), pick->getIncludeItems(), pick->getIgnoreItems() };
-                if (!checkAndCompareCachedResults(mathematicalPick, results, res, avatarKey)) {
-                    PickResultPointer avatarRes = pick->getAvatarIntersection(mathematicalPick);
-                    numIntersectionsComputed[1]++;
-                    if (avatarRes) {
-                        cacheResult(avatarRes->doesIntersect(), avatarRes, avatarKey, res, mathematicalPick, results, pick);
+        // only the entity results of the picks that are updated count as computed
+        std::vector<size_t> entityResultsFoundFor = updateEntityIntersections(pendingPicks, results, parallelEntityPicks);
+        size_t numEntityResultsUsed = 0;
+
+        bool expired = false;
+        for (size_t i = 0; i < pendingPicks.size() && !expired; ++i) {
+            auto& pendingPick = pendingPicks[i];
+            std::shared_ptr<Pick<T>> pick = pendingPick.pick;
+            T& mathematicalPick = pendingPick.mathPick;
+            PickResultPointer res = pick->getDefaultResult(mathematicalPick.toVariantMap());
+
+            if (!pick->isEnabled() || pick->getMaxDistance() < 0.0f || !mathematicalPick) {
+                pick->setPickResult(res);
+            } else {
+                if (pick->getFilter().doesPickDomainEntities() || pick->getFilter().doesPickAvatarEntities() || pick->getFilter().doesPickLocalEntities()) {
+                    PickCacheKey entityKey = { pick->getFilter().getEntityFlags(), pick->getIncludeItems(), pick->getIgnoreItems() };
+                    checkAndCompareCachedResults(mathematicalPick, results, res, entityKey);
+                }
+
+                if (pick->getFilter().doesPickAvatars()) {
+                    PickCacheKey avatarKey = { pick->getFilter().getAvatarFlags(), pick->getIncludeItems(), pick->getIgnoreItems() };
+                    if (!checkAndCompareCachedResults(mathematicalPick, results, res, avatarKey)) {
+                        PickResultPointer avatarRes = pick->getAvatarIntersection(mathematicalPick);
+                        numIntersectionsComputed[1]++;
+                        if (avatarRes) {
+                            cacheResult(avatarRes->doesIntersect(), avatarRes, avatarKey, res, mathematicalPick, results, pick);
+                        }
                     }
                 }
-            }
 
-            // Can't intersect with HUD in desktop mode
-            if (pick->getFilter().doesPickHUD() && shouldPickHUD) {
-                PickCacheKey hudKey = { pick->getFilter().getHUDFlags(), QVector<QUuid>(), QVector<QUuid>() };
-                if (!checkAndCompareCachedResults(mathematicalPick, results, res, hudKey)) {
-                    PickResultPointer hudRes = pick->getHUDIntersection(mathematicalPick);
-                    numIntersectionsComputed[2]++;
-                    if (hudRes) {
-                        cacheResult(true, hudRes, hudKey, res, mathematicalPick, results, pick);
+                // Can't intersect with HUD in desktop mode
+                if (pick->getFilter().doesPickHUD() && shouldPickHUD) {
+                    PickCacheKey hudKey = { pick->getFilter().getHUDFlags(), QVector<QUuid>(), QVector<QUuid>() };
+                    if (!checkAndCompareCachedResults(mathematicalPick, results, res, hudKey)) {
+                        PickResultPointer hudRes = pick->getHUDIntersection(mathematicalPick);
+                        numIntersectionsComputed[2]++;
+                        if (hudRes) {
+                            cacheResult(true, hudRes, hudKey, res, mathematicalPick, results, pick);
+                        }
                     }
                 }
+
+                if (pick->getMaxDistance() == 0.0f || (pick->getMaxDistance() > 0.0f && res->checkOrFilterAgainstMaxDistance(pick->getMaxDistance()))) {
+                    pick->setPickResult(res);
+                } else {
+                    pick->setPickResult(pick->getDefaultResult(mathematicalPick.toVariantMap()));
+                }
             }
 
-            if (pick->getMaxDistance() == 0.0f || (pick->getMaxDistance() > 0.0f && res->checkOrFilterAgainstMaxDistance(pick->getMaxDistance()))) {
-                pick->setPickResult(res);
-            } else {
-                pick->setPickResult(pick->getDefaultResult(mathematicalPick.toVariantMap()));
+            while (numEntityResultsUsed < entityResultsFoundFor.size() && entityResultsFoundFor[numEntityResultsUsed] <= i) {
+                ++numEntityResultsUsed;
             }
-        }
 
-        ++itr;
-        if (itr == picks.end()) {
-            itr = picks.begin();
+            ++numUpdates;
+            nextToUpdate = i + 1 < pendingPicks.size() ? pendingPicks[i + 1].id : itr->first;
+            expired = usecTimestampNow() > expiry;
         }
-        nextToUpdate = itr->first;
-        ++numUpdates;
-        if (usecTimestampNow() > expiry) {
+        numIntersectionsComputed[0] += numEntityResultsUsed;
+        if (expired) {
             break;
         }
     }
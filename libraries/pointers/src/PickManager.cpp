@@ -161,22 +161,30 @@ void PickManager::update() {
     {
         PROFILE_RANGE_EX(picks, "StylusPicks", 0xffff0000, (uint64_t)_totalPickCounts[PickQuery::Stylus]);
         PerformanceTimer perfTimer("StylusPicks");
+        quint64 start = usecTimestampNow();
         _updatedPickCounts[PickQuery::Stylus] = _stylusPickCacheOptimizer.update(cachedPicks[PickQuery::Stylus], _nextPickToUpdate[PickQuery::Stylus], expiry, false);
+        _updatedPickUsecs[PickQuery::Stylus] = usecTimestampNow() - start;
     }
     {
         PROFILE_RANGE_EX(picks, "RayPicks", 0xffff0000, (uint64_t)_totalPickCounts[PickQuery::Ray]);
         PerformanceTimer perfTimer("RayPicks");
-        _updatedPickCounts[PickQuery::Ray] = _rayPickCacheOptimizer.update(cachedPicks[PickQuery::Ray], _nextPickToUpdate[PickQuery::Ray], expiry, shouldPickHUD);
+        quint64 start = usecTimestampNow();
+        _updatedPickCounts[PickQuery::Ray] = _rayPickCacheOptimizer.update(cachedPicks[PickQuery::Ray], _nextPickToUpdate[PickQuery::Ray], expiry, shouldPickHUD, _parallelEntityPicking);
+        _updatedPickUsecs[PickQuery::Ray] = usecTimestampNow() - start;
     }
     {
         PROFILE_RANGE_EX(picks, "ParabolaPicks", 0xffff0000, (uint64_t)_totalPickCounts[PickQuery::Parabola]);
         PerformanceTimer perfTimer("ParabolaPicks");
-        _updatedPickCounts[PickQuery::Parabola] = _parabolaPickCacheOptimizer.update(cachedPicks[PickQuery::Parabola], _nextPickToUpdate[PickQuery::Parabola], expiry, shouldPickHUD);
+        quint64 start = usecTimestampNow();
+        _updatedPickCounts[PickQuery::Parabola] = _parabolaPickCacheOptimizer.update(cachedPicks[PickQuery::Parabola], _nextPickToUpdate[PickQuery::Parabola], expiry, shouldPickHUD, _parallelEntityPicking);
+        _updatedPickUsecs[PickQuery::Parabola] = usecTimestampNow() - start;
     }
     {
         PROFILE_RANGE_EX(picks, "CollisionPicks", 0xffff0000, (uint64_t)_totalPickCounts[PickQuery::Collision]);
         PerformanceTimer perfTimer("CollisionPicks");
+        quint64 start = usecTimestampNow();
         _updatedPickCounts[PickQuery::Collision] = _collisionPickCacheOptimizer.update(cachedPicks[PickQuery::Collision], _nextPickToUpdate[PickQuery::Collision], expiry, false);
+        _updatedPickUsecs[PickQuery::Collision] = usecTimestampNow() - start;
     }
 }
 
@@ -69,15 +69,23 @@ public:
 
     const std::vector<QVector3D>& getUpdatedPickCounts() { return _updatedPickCounts; }
     const std::vector<int>& getTotalPickCounts() { return _totalPickCounts; }
+    // how long the most recent update spent on each type of pick
+    const std::vector<quint64>& getUpdatedPickUsecs() { return _updatedPickUsecs; }
+
+    bool getParallelEntityPicking() const { return _parallelEntityPicking; }
 
 public slots:
     void setForceCoarsePicking(bool forceCoarsePicking) { _forceCoarsePicking = forceCoarsePicking; }
+    // spread the entity intersections of each batch of picks over the WorkStealingScheduler workers, if there are any
+    void setParallelEntityPicking(bool parallelEntityPicking) { _parallelEntityPicking = parallelEntityPicking; }
 
 protected:
     std::vector<QVector3D> _updatedPickCounts { PickQuery::NUM_PICK_TYPES };
     std::vector<int> _totalPickCounts { 0, 0, 0, 0 };
+    std::vector<quint64> _updatedPickUsecs { 0, 0, 0, 0 };
 
     bool _forceCoarsePicking { false };
+    bool _parallelEntityPicking { false };
     std::function<bool()> _shouldPickHUDOperator;
     std::function<glm::vec2(const glm::vec3&)> _calculatePos2DFromHUDOperator;
 
@@ -56,35 +56,70 @@ Duration::Duration(const QLoggingCategory& category,
                    uint32_t argbColor,
                    uint64_t payload,
                    const QVariantMap& baseArgs) :
-    DurationBase(category, name) {
-    if (tracingEnabled() && category.isDebugEnabled()) {
+    _category(category) {
+    auto tracer = tracing::Tracer::getActive();
+    if (tracer && category.isDebugEnabled()) {
+        _nameID = tracer->internName(name);
+        begin(tracer, name, argbColor, payload, baseArgs);
+    }
+}
+
+Duration::Duration(const QLoggingCategory& category,
+                   const char* name,
+                   uint32_t argbColor,
+                   uint64_t payload,
+                   const QVariantMap& baseArgs) :
+    _category(category) {
+    auto tracer = tracing::Tracer::getActive();
+    if (tracer && category.isDebugEnabled()) {
+        _nameID = tracer->internName(name);
+#if defined(NSIGHT_TRACING)
+        begin(tracer, QString(name), argbColor, payload, baseArgs);
+#else
+        begin(tracer, baseArgs.empty() ? QString() : QString(name), argbColor, payload, baseArgs);
+#endif
+    }
+}
+
+void Duration::begin(tracing::Tracer* tracer, const QString& name, uint32_t argbColor, uint64_t payload,
+                     const QVariantMap& baseArgs) {
+    if (baseArgs.empty()) {
+        tracer->traceDuration(_category, _nameID, tracing::DurationBegin, payload);
+    } else {
+        // arbitrary args don't fit the thread buffers
         QVariantMap args = baseArgs;
         args["nv_payload"] = QVariant::fromValue(payload);
-        tracing::traceEvent(_category, _name, tracing::DurationBegin, "", args);
+        tracer->traceEvent(_category, name, tracing::DurationBegin, "", args);
+    }
 
 #if defined(NSIGHT_TRACING)
-        nvtxEventAttributes_t eventAttrib{ 0 };
-        eventAttrib.version = NVTX_VERSION;
-        eventAttrib.size = NVTX_EVENT_ATTRIB_STRUCT_SIZE;
-        eventAttrib.colorType = NVTX_COLOR_ARGB;
-        eventAttrib.color = argbColor;
-        eventAttrib.messageType = NVTX_MESSAGE_TYPE_ASCII;
-        eventAttrib.message.ascii = name.toUtf8().data();
-        eventAttrib.payload.llValue = payload;
-        eventAttrib.payloadType = NVTX_PAYLOAD_TYPE_UNSIGNED_INT64;
+    nvtxEventAttributes_t eventAttrib{ 0 };
+    eventAttrib.version = NVTX_VERSION;
+    eventAttrib.size = NVTX_EVENT_ATTRIB_STRUCT_SIZE;
+    eventAttrib.colorType = NVTX_COLOR_ARGB;
+    eventAttrib.color = argbColor;
+    eventAttrib.messageType = NVTX_MESSAGE_TYPE_ASCII;
+    eventAttrib.message.ascii = name.toUtf8().data();
+    eventAttrib.payload.llValue = payload;
+    eventAttrib.payloadType = NVTX_PAYLOAD_TYPE_UNSIGNED_INT64;
 
-        nvtxRangePushEx(&eventAttrib);
+    nvtxRangePushEx(&eventAttrib);
 #endif
-    }
 }
 
 Duration::~Duration() {
-    if (tracingEnabled() && _category.isDebugEnabled()) {
-        tracing::traceEvent(_category, _name, tracing::DurationEnd);
+    if (_nameID == tracing::Tracer::INVALID_NAME_ID) {
+        return;
+    }
+
+    // the tracer may have been stopped since the range began
+    auto tracer = tracing::Tracer::getActive();
+    if (tracer) {
+        tracer->traceDuration(_category, _nameID, tracing::DurationEnd);
+    }
 #ifdef NSIGHT_TRACING
-        nvtxRangePop();
+    nvtxRangePop();
 #endif
-    }
 }
 
 // FIXME
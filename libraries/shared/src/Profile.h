@@ -45,13 +45,22 @@ protected:
     const QLoggingCategory& _category;
 };
 
-class Duration : public DurationBase {
+// Durations are recorded in the tracer's per-thread buffers, see Tracer::traceDuration.
+// Prefer the const char* constructor (as PROFILE_RANGE with a literal does), which never builds a QString.
+class Duration {
 public:
     Duration(const QLoggingCategory& category, const QString& name, uint32_t argbColor = 0xff0000ff, uint64_t payload = 0, const QVariantMap& args = QVariantMap());
+    Duration(const QLoggingCategory& category, const char* name, uint32_t argbColor = 0xff0000ff, uint64_t payload = 0, const QVariantMap& args = QVariantMap());
     ~Duration();
 
     static uint64_t beginRange(const QLoggingCategory& category, const char* name, uint32_t argbColor);
     static void endRange(const QLoggingCategory& category, uint64_t rangeId);
+
+private:
+    void begin(tracing::Tracer* tracer, const QString& name, uint32_t argbColor, uint64_t payload, const QVariantMap& args);
+
+    const QLoggingCategory& _category;
+    tracing::Tracer::NameID _nameID { tracing::Tracer::INVALID_NAME_ID };
 };
 
 class ConditionalDuration : public DurationBase {
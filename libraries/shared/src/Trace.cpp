@@ -8,7 +8,10 @@
 
 #include "Trace.h"
 
+#include <algorithm>
 #include <chrono>
+#include <string>
+#include <unordered_map>
 
 #include <QtCore/QDebug>
 #include <QtCore/QCoreApplication>
@@ -40,6 +43,200 @@ bool tracing::enabled() {
     return DependencyManager::get<Tracer>()->isEnabled();
 }
 
+const Tracer::NameID Tracer::INVALID_NAME_ID = (Tracer::NameID)-1;
+const size_t Tracer::THREAD_BUFFER_SIZE = 1 << 14; // must be a power of two
+
+std::atomic<Tracer*> Tracer::_activeTracer { nullptr };
+
+static std::atomic<uint64_t> nextTracerGeneration { 1 };
+
+struct Tracer::ThreadBuffer {
+    struct Event {
+        int64_t timestamp;
+        uint64_t payload;
+        const QLoggingCategory* category;
+        NameID name;
+        EventType type;
+    };
+
+    // An event slot is a seqlock: sequence is the index of the event it holds plus one, and 0 while the owning thread
+    // writes it, so that a reader can tell when the event it copied was overwritten. The fields are atomics so that
+    // copying one while it is written is defined; relaxed accesses to them cost the same as plain ones.
+    struct Slot {
+        std::atomic<uint64_t> sequence { 0 };
+        std::atomic<int64_t> timestamp;
+        std::atomic<uint64_t> payload;
+        std::atomic<const QLoggingCategory*> category;
+        std::atomic<NameID> name;
+        std::atomic<EventType> type;
+    };
+
+    ThreadBuffer(qint64 processID, qint64 threadID) :
+        events(THREAD_BUFFER_SIZE), processID(processID), threadID(threadID) {}
+
+    void write(uint64_t index, const Event& event) {
+        auto& slot = events[index & (THREAD_BUFFER_SIZE - 1)];
+        slot.sequence.store(0, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        slot.timestamp.store(event.timestamp, std::memory_order_relaxed);
+        slot.payload.store(event.payload, std::memory_order_relaxed);
+        slot.category.store(event.category, std::memory_order_relaxed);
+        slot.name.store(event.name, std::memory_order_relaxed);
+        slot.type.store(event.type, std::memory_order_relaxed);
+        slot.sequence.store(index + 1, std::memory_order_release);
+    }
+
+    // false if the slot no longer holds the event at index, or it was overwritten while being read
+    bool read(uint64_t index, Event& event) const {
+        const auto& slot = events[index & (THREAD_BUFFER_SIZE - 1)];
+        if (slot.sequence.load(std::memory_order_acquire) != index + 1) {
+            return false;
+        }
+        event.timestamp = slot.timestamp.load(std::memory_order_relaxed);
+        event.payload = slot.payload.load(std::memory_order_relaxed);
+        event.category = slot.category.load(std::memory_order_relaxed);
+        event.name = slot.name.load(std::memory_order_relaxed);
+        event.type = slot.type.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return slot.sequence.load(std::memory_order_relaxed) == index + 1;
+    }
+
+    std::vector<Slot> events;
+    std::atomic<uint64_t> head { 0 }; // only advanced by the owning thread
+    uint64_t tail { 0 }; // guarded by the tracer's _eventsMutex
+
+    const qint64 processID;
+    const qint64 threadID;
+
+    // name caches, only used by the owning thread
+    std::unordered_map<const char*, std::pair<std::string, NameID>> charNames;
+    QHash<QString, NameID> stringNames;
+};
+
+Tracer::Tracer() : _generation(nextTracerGeneration++) {
+}
+
+Tracer::~Tracer() {
+    Tracer* self = this;
+    _activeTracer.compare_exchange_strong(self, nullptr);
+}
+
+Tracer::ThreadBuffer& Tracer::getThreadBuffer() {
+    // the calling thread's buffer, replaced whenever the thread records to a different tracer
+    static thread_local uint64_t threadGeneration { 0 };
+    static thread_local std::shared_ptr<ThreadBuffer> threadBuffer;
+
+    if (threadGeneration != _generation) {
+        threadBuffer = std::make_shared<ThreadBuffer>(QCoreApplication::applicationPid(), int64_t(QThread::currentThreadId()));
+        threadGeneration = _generation;
+
+        std::lock_guard<std::mutex> guard(_eventsMutex);
+        _threadBuffers.push_back(threadBuffer);
+    }
+    return *threadBuffer;
+}
+
+Tracer::NameID Tracer::internName(const QString& name) {
+    auto& buffer = getThreadBuffer();
+    auto cached = buffer.stringNames.find(name);
+    if (cached != buffer.stringNames.end()) {
+        return cached.value();
+    }
+
+    NameID nameID;
+    {
+        std::lock_guard<std::mutex> guard(_namesMutex);
+        auto existing = _nameIDs.find(name);
+        if (existing != _nameIDs.end()) {
+            nameID = existing.value();
+        } else {
+            nameID = (NameID)_names.size();
+            _names.push_back(name);
+            _nameIDs.insert(name, nameID);
+        }
+    }
+    buffer.stringNames.insert(name, nameID);
+    return nameID;
+}
+
+Tracer::NameID Tracer::internName(const char* name) {
+    auto& buffer = getThreadBuffer();
+    auto cached = buffer.charNames.find(name);
+    // names are usually literals, but the pointer may also be a reused buffer, so compare the contents too
+    if (cached != buffer.charNames.end() && cached->second.first == name) {
+        return cached->second.second;
+    }
+
+    NameID nameID = internName(QString(name));
+    buffer.charNames[name] = { std::string(name), nameID };
+    return nameID;
+}
+
+void Tracer::traceDuration(const QLoggingCategory& category, NameID name, EventType type, uint64_t payload) {
+    if (!_enabled || name == INVALID_NAME_ID) {
+        return;
+    }
+
+    auto& buffer = getThreadBuffer();
+    uint64_t head = buffer.head.load(std::memory_order_relaxed);
+    buffer.write(head, { now(), payload, &category, name, type });
+    buffer.head.store(head + 1, std::memory_order_release);
+}
+
+void Tracer::mergeThreadBuffers(bool keepEvents) {
+    std::vector<QString> names;
+    if (keepEvents) {
+        std::lock_guard<std::mutex> guard(_namesMutex);
+        names = _names;
+    }
+
+    std::vector<ThreadBuffer::Event> events;
+    for (auto& buffer : _threadBuffers) {
+        uint64_t head = buffer->head.load(std::memory_order_acquire);
+        uint64_t oldest = head > THREAD_BUFFER_SIZE ? head - THREAD_BUFFER_SIZE : 0;
+        uint64_t begin = std::max(buffer->tail, oldest);
+        _droppedEvents += begin - buffer->tail;
+        buffer->tail = head;
+
+        if (!keepEvents || begin == head) {
+            continue;
+        }
+
+        // if the owning thread is still recording it may wrap over the first events while they are copied
+        events.clear();
+        for (uint64_t i = begin; i < head; ++i) {
+            ThreadBuffer::Event event;
+            if (buffer->read(i, event)) {
+                events.push_back(event);
+            } else {
+                ++_droppedEvents;
+            }
+        }
+
+        for (const auto& event : events) {
+            QVariantMap args;
+            if (event.type == DurationBegin) {
+                args["nv_payload"] = QVariant::fromValue(event.payload);
+            }
+            _events.push_back({
+                "",
+                event.name < names.size() ? names[event.name] : QString(),
+                event.type,
+                event.timestamp,
+                buffer->processID,
+                buffer->threadID,
+                *event.category,
+                args,
+                QVariantMap()
+            });
+        }
+    }
+
+    // the buffers of threads that have exited have nothing more to record
+    _threadBuffers.erase(std::remove_if(_threadBuffers.begin(), _threadBuffers.end(),
+        [](const std::shared_ptr<ThreadBuffer>& buffer) { return buffer.use_count() == 1; }), _threadBuffers.end());
+}
+
 void Tracer::startTracing() {
     std::lock_guard<std::mutex> guard(_eventsMutex);
     if (_enabled) {
@@ -47,8 +244,11 @@ void Tracer::startTracing() {
         return;
     }
 
+    mergeThreadBuffers(false);
     _events.clear();
+    _droppedEvents = 0;
     _enabled = true;
+    _activeTracer.store(this, std::memory_order_release);
 }
 
 void Tracer::stopTracing() {
@@ -58,6 +258,13 @@ void Tracer::stopTracing() {
         return;
     }
     _enabled = false;
+    Tracer* self = this;
+    _activeTracer.compare_exchange_strong(self, nullptr);
+
+    mergeThreadBuffers(true);
+    if (_droppedEvents > 0) {
+        qCWarning(shared) << "Tracer dropped" << _droppedEvents << "events from full thread buffers";
+    }
 }
 
 void TraceEvent::writeJson(QTextStream& out) const {
@@ -115,6 +322,7 @@ void Tracer::serialize(const QString& filename) {
     std::list<TraceEvent> currentEvents;
     {
         std::lock_guard<std::mutex> guard(_eventsMutex);
+        mergeThreadBuffers(true);
         currentEvents.swap(_events);
         for (auto& event : _metadataEvents) {
             currentEvents.push_back(event);
@@ -10,8 +10,12 @@
 #ifndef hifi_Trace_h
 #define hifi_Trace_h
 
+#include <atomic>
 #include <cstdint>
+#include <list>
+#include <memory>
 #include <mutex>
+#include <vector>
 
 #include <QtCore/QString>
 #include <QtCore/QVariantMap>
@@ -78,7 +82,19 @@ struct TraceEvent {
 
 class Tracer : public Dependency {
 public:
+    using NameID = uint32_t;
+    static const NameID INVALID_NAME_ID;
+    // events kept per thread between merges, older events are dropped once a thread's buffer wraps
+    static const size_t THREAD_BUFFER_SIZE;
+
+    Tracer();
+    ~Tracer();
+
     static int64_t now();
+
+    // the tracer that is currently recording, if any.  Tracing must be stopped before its tracer is released.
+    static Tracer* getActive() { return _activeTracer.load(std::memory_order_acquire); }
+
     void traceEvent(const QLoggingCategory& category, 
         const QString& name, EventType type,
         const QString& id = "", 
@@ -90,22 +106,45 @@ public:
         const QString& id = "", 
         const QVariantMap& args = QVariantMap(), const QVariantMap& extra = QVariantMap());
 
+    // Durations are recorded into a fixed size buffer owned by the calling thread, with interned names and a
+    // POD payload, so they take no locks and make no allocations.  The buffers are merged into the trace when
+    // tracing is stopped or serialized.
+    NameID internName(const char* name);
+    NameID internName(const QString& name);
+    void traceDuration(const QLoggingCategory& category, NameID name, EventType type, uint64_t payload = 0);
+
     void startTracing();
     void stopTracing();
     void serialize(const QString& file);
     bool isEnabled() const { return _enabled; }
+    uint64_t getDroppedEventCount() const { return _droppedEvents; }
 
 private:
+    struct ThreadBuffer;
+
     void traceEvent(const QLoggingCategory& category, 
         const QString& name, EventType type,
         qint64 timestamp, qint64 processID, qint64 threadID,
         const QString& id = "",
         const QVariantMap& args = QVariantMap(), const QVariantMap& extra = QVariantMap());
 
-    bool _enabled { false };
+    ThreadBuffer& getThreadBuffer();
+    // moves the events recorded in the thread buffers to _events (or drops them), requires _eventsMutex
+    void mergeThreadBuffers(bool keepEvents);
+
+    static std::atomic<Tracer*> _activeTracer;
+
+    const uint64_t _generation;
+    std::atomic<bool> _enabled { false };
     std::list<TraceEvent> _events;
     std::list<TraceEvent> _metadataEvents;
+    std::vector<std::shared_ptr<ThreadBuffer>> _threadBuffers;
+    uint64_t _droppedEvents { 0 };
     std::mutex _eventsMutex;
+
+    std::vector<QString> _names;
+    QHash<QString, NameID> _nameIDs;
+    std::mutex _namesMutex;
 };
 
 inline void traceEvent(const QLoggingCategory& category, int64_t timestamp, const QString& name, EventType type, const QString& id = "", const QVariantMap& args = {}, const QVariantMap& extra = {}) {
@@ -11,9 +11,47 @@
 
 #include "TriangleSet.h"
 
+#include <algorithm>
+
 #include "GLMHelpers.h"
 
-#include <list>
+// the surface area heuristic picks each split from this many buckets of triangle centroids along the widest axis
+static const int NUM_SAH_BINS = 12;
+
+// Below this depth ranges are split in half rather than by the surface area heuristic, which bounds the depth
+// of the tree, and so the stack it is traversed with, whatever the triangles.
+static const int MAX_SAH_DEPTH = 32;
+static const int MAX_TREE_DEPTH = MAX_SAH_DEPTH + 32;
+static const int MAX_TRAVERSAL_STACK = 4 * MAX_TREE_DEPTH;
+
+namespace {
+
+struct TraversalEntry {
+    int32_t nodeIndex;
+    float entryDistance;
+};
+
+float halfSurfaceArea(const glm::vec3& minimum, const glm::vec3& maximum) {
+    glm::vec3 dimensions = maximum - minimum;
+    return dimensions.x * dimensions.y + dimensions.y * dimensions.z + dimensions.z * dimensions.x;
+}
+
+// orders the children in hitMask nearest first, returning how many there are
+int sortChildren(uint32_t hitMask, const float entryDistances[], int childOrder[]) {
+    int numChildren = 0;
+    for (int i = 0; hitMask != 0; ++i, hitMask >>= 1) {
+        if (hitMask & 1) {
+            int j = numChildren++;
+            for (; j > 0 && entryDistances[childOrder[j - 1]] > entryDistances[i]; --j) {
+                childOrder[j] = childOrder[j - 1];
+            }
+            childOrder[j] = i;
+        }
+    }
+    return numChildren;
+}
+
+}
 
 void TriangleSet::insert(const Triangle& t) {
     _isBalanced = false;
@@ -29,7 +67,8 @@ void TriangleSet::clear() {
     _bounds.clear();
     _isBalanced = false;
 
-    _triangleTree.clear();
+    _nodes.clear();
+    _packets.clear();
 }
 
 bool TriangleSet::convexHullContains(const glm::vec3& point) const {
@@ -52,17 +91,28 @@ bool TriangleSet::convexHullContains(const glm::vec3& point) const {
 void TriangleSet::debugDump() {
     qDebug() << __FUNCTION__;
     qDebug() << "bounds:" << getBounds();
-    qDebug() << "triangles:" << size() << "at top level....";
-    qDebug() << "----- _triangleTree -----";
-    _triangleTree.debugDump();
+    qDebug() << "triangles:" << size();
+    qDebug() << "nodes:" << _nodes.size() << "triangle packets:" << _packets.size();
 }
 
 void TriangleSet::balanceTree() {
-    _triangleTree.reset(_bounds);
+    _nodes.clear();
+    _packets.clear();
+
+    if (!_triangles.empty()) {
+        std::vector<BuildTriangle> buildTriangles(_triangles.size());
+        for (size_t i = 0; i < _triangles.size(); i++) {
+            const Triangle& triangle = _triangles[i];
+            BuildTriangle& buildTriangle = buildTriangles[i];
+            buildTriangle.minimum = glm::min(glm::min(triangle.v0, triangle.v1), triangle.v2);
+            buildTriangle.maximum = glm::max(glm::max(triangle.v0, triangle.v1), triangle.v2);
+            buildTriangle.centroid = 0.5f * (buildTriangle.minimum + buildTriangle.maximum);
+            buildTriangle.index = (int32_t)i;
+        }
 
-    // insert all the triangles
-    for (size_t i = 0; i < _triangles.size(); i++) {
-        _triangleTree.insert(i);
+        _packets.reserve(_triangles.size() / 2 + 1);
+        _nodes.reserve(_packets.capacity() / 2 + 1);
+        buildNode(buildTriangles, 0, buildTriangles.size(), 0);
     }
 
     _isBalanced = true;
@@ -72,255 +122,375 @@ void TriangleSet::balanceTree() {
 #endif
 }
 
-// With an octree: 8 ^ MAX_DEPTH = 4096 leaves
-//static const int MAX_DEPTH = 4;
-// With a k-d tree: 2 ^ MAX_DEPTH = 4096 leaves
-static const int MAX_DEPTH = 12;
-
-TriangleSet::TriangleTreeCell::TriangleTreeCell(std::vector<Triangle>& allTriangles, const AABox& bounds, int depth) :
-    _allTriangles(allTriangles)
-{
-    reset(bounds, depth);
-}
-
-void TriangleSet::TriangleTreeCell::clear() {
-    _population = 0;
-    _triangleIndices.clear();
-    _bounds.clear();
-    _children.first.reset();
-    _children.second.reset();
-}
+int32_t TriangleSet::buildNode(std::vector<BuildTriangle>& buildTriangles, size_t begin, size_t end, int depth) {
+    int32_t nodeIndex = (int32_t)_nodes.size();
+    _nodes.emplace_back();
+
+    // split the range into as many as BVH_WIDTH children, splitting the largest one each time,
+    // until every child fits in a single packet
+    std::pair<size_t, size_t> childRanges[BVH_WIDTH];
+    int numChildren = 1;
+    childRanges[0] = { begin, end };
+    while (numChildren < BVH_WIDTH) {
+        int largestChild = -1;
+        size_t largestSize = BVH_WIDTH;
+        for (int i = 0; i < numChildren; i++) {
+            size_t childSize = childRanges[i].second - childRanges[i].first;
+            if (childSize > largestSize) {
+                largestChild = i;
+                largestSize = childSize;
+            }
+        }
+        if (largestChild < 0) {
+            break;
+        }
 
-void TriangleSet::TriangleTreeCell::reset(const AABox& bounds, int depth) {
-    clear();
-    _bounds = bounds;
-    _depth = depth;
-}
+        auto& largestRange = childRanges[largestChild];
+        size_t middle = splitRange(buildTriangles, largestRange.first, largestRange.second, depth);
+        childRanges[numChildren++] = { middle, largestRange.second };
+        largestRange.second = middle;
+    }
 
-void TriangleSet::TriangleTreeCell::debugDump() {
-    qDebug() << __FUNCTION__;
-    qDebug() << "               bounds:" << getBounds();
-    qDebug() << "                depth:" << _depth;
-    qDebug() << "           population:" << _population << "this level or below"
-             << " ---- triangleIndices:" << _triangleIndices.size() << "in this cell";
+    BVHNode node;
+    node.numChildren = numChildren;
+    for (int i = 0; i < BVH_WIDTH; i++) {
+        if (i >= numChildren) {
+            node.minX[i] = node.minY[i] = node.minZ[i] = 0.0f;
+            node.maxX[i] = node.maxY[i] = node.maxZ[i] = 0.0f;
+            node.children[i] = -1;
+            continue;
+        }
 
-    int numChildren = 0;
-    if (_children.first) {
-        numChildren++;
-    } else if (_children.second) {
-        numChildren++;
-    }
-    qDebug() << "child cells:" << numChildren;
-    if (_depth < MAX_DEPTH) {
-        if (_children.first) {
-            qDebug() << "child: 0";
-            _children.first->debugDump();
+        const auto& range = childRanges[i];
+        glm::vec3 minimum(FLT_MAX);
+        glm::vec3 maximum(-FLT_MAX);
+        for (size_t j = range.first; j < range.second; j++) {
+            minimum = glm::min(minimum, buildTriangles[j].minimum);
+            maximum = glm::max(maximum, buildTriangles[j].maximum);
         }
-        if (_children.second) {
-            qDebug() << "child: 1";
-            _children.second->debugDump();
+        node.minX[i] = minimum.x;
+        node.minY[i] = minimum.y;
+        node.minZ[i] = minimum.z;
+        node.maxX[i] = maximum.x;
+        node.maxY[i] = maximum.y;
+        node.maxZ[i] = maximum.z;
+
+        if (range.second - range.first <= (size_t)BVH_WIDTH) {
+            node.children[i] = buildPacket(buildTriangles, range.first, range.second);
+            node.leafMask |= 1 << i;
+        } else {
+            node.children[i] = buildNode(buildTriangles, range.first, range.second, depth + 1);
         }
     }
+
+    // building the children may have moved the nodes
+    _nodes[nodeIndex] = node;
+    return nodeIndex;
 }
 
-std::pair<AABox, AABox> TriangleSet::TriangleTreeCell::getTriangleTreeCellChildBounds() {
-    std::pair<AABox, AABox> toReturn;
-    int axis = 0;
-    // find biggest axis
-    glm::vec3 dimensions = _bounds.getDimensions();
-    for (int i = 0; i < 3; i++) {
-        if (dimensions[i] >= dimensions[(i + 1) % 3] && dimensions[i] >= dimensions[(i + 2) % 3]) {
-            axis = i;
-            break;
-        }
+size_t TriangleSet::splitRange(std::vector<BuildTriangle>& buildTriangles, size_t begin, size_t end, int depth) {
+    glm::vec3 centroidMinimum(FLT_MAX);
+    glm::vec3 centroidMaximum(-FLT_MAX);
+    for (size_t i = begin; i < end; i++) {
+        centroidMinimum = glm::min(centroidMinimum, buildTriangles[i].centroid);
+        centroidMaximum = glm::max(centroidMaximum, buildTriangles[i].centroid);
     }
 
-    // The new boxes are half the size in the largest dimension
-    glm::vec3 newDimensions = dimensions;
-    newDimensions[axis] *= 0.5f;
-    toReturn.first.setBox(_bounds.getCorner(), newDimensions);
-    glm::vec3 offset = glm::vec3(0.0f);
-    offset[axis] = newDimensions[axis];
-    toReturn.second.setBox(_bounds.getCorner() + offset, newDimensions);
-    return toReturn;
-}
+    glm::vec3 extent = centroidMaximum - centroidMinimum;
+    int axis = 2;
+    if (extent.x >= extent.y && extent.x >= extent.z) {
+        axis = 0;
+    } else if (extent.y >= extent.z) {
+        axis = 1;
+    }
 
-void TriangleSet::TriangleTreeCell::insert(size_t triangleIndex) {
-    _population++;
+    auto first = buildTriangles.begin() + begin;
+    auto last = buildTriangles.begin() + end;
+    auto splitInHalf = [&] {
+        auto middle = first + (end - begin) / 2;
+        std::nth_element(first, middle, last, [axis](const BuildTriangle& a, const BuildTriangle& b) {
+            return a.centroid[axis] < b.centroid[axis];
+        });
+        return begin + (end - begin) / 2;
+    };
+
+    if (depth >= MAX_SAH_DEPTH || extent[axis] <= 0.0f) {
+        return splitInHalf();
+    }
 
-    // if we're not yet at the max depth, then check which child the triangle fits in
-    if (_depth < MAX_DEPTH) {
-        const Triangle& triangle = _allTriangles[triangleIndex];
-        auto childBounds = getTriangleTreeCellChildBounds();
+    struct Bin {
+        glm::vec3 minimum { FLT_MAX };
+        glm::vec3 maximum { -FLT_MAX };
+        size_t count { 0 };
+    };
+    Bin bins[NUM_SAH_BINS];
+
+    float binScale = (float)NUM_SAH_BINS / extent[axis];
+    float binOrigin = centroidMinimum[axis];
+    auto binOf = [&](const BuildTriangle& buildTriangle) {
+        return std::min((int)((buildTriangle.centroid[axis] - binOrigin) * binScale), NUM_SAH_BINS - 1);
+    };
+
+    for (auto it = first; it != last; ++it) {
+        Bin& bin = bins[binOf(*it)];
+        bin.minimum = glm::min(bin.minimum, it->minimum);
+        bin.maximum = glm::max(bin.maximum, it->maximum);
+        bin.count++;
+    }
 
-        auto insertOperator = [&](const AABox& childBound, std::shared_ptr<TriangleTreeCell>& child) {
-            // if the child AABox would contain the triangle...
-            if (childBound.contains(triangle)) {
-                // if the child cell doesn't yet exist, create it...
-                if (!child) {
-                    child = std::make_shared<TriangleTreeCell>(_allTriangles, childBound, _depth + 1);
-                }
+    // the cost of the triangles right of each split, then the cheapest split sweeping from the left
+    float rightCosts[NUM_SAH_BINS];
+    Bin right;
+    for (int i = NUM_SAH_BINS - 1; i > 0; i--) {
+        right.minimum = glm::min(right.minimum, bins[i].minimum);
+        right.maximum = glm::max(right.maximum, bins[i].maximum);
+        right.count += bins[i].count;
+        rightCosts[i] = right.count > 0 ? right.count * halfSurfaceArea(right.minimum, right.maximum) : 0.0f;
+    }
 
-                // insert the triangleIndex in the child cell
-                child->insert(triangleIndex);
-                return true;
-            }
-            return false;
-        };
-        if (insertOperator(childBounds.first, _children.first) || insertOperator(childBounds.second, _children.second)) {
-            return;
+    Bin left;
+    int bestSplit = -1;
+    float bestCost = FLT_MAX;
+    for (int i = 1; i < NUM_SAH_BINS; i++) {
+        left.minimum = glm::min(left.minimum, bins[i - 1].minimum);
+        left.maximum = glm::max(left.maximum, bins[i - 1].maximum);
+        left.count += bins[i - 1].count;
+        float leftCost = left.count > 0 ? left.count * halfSurfaceArea(left.minimum, left.maximum) : 0.0f;
+        if (leftCost + rightCosts[i] < bestCost) {
+            bestCost = leftCost + rightCosts[i];
+            bestSplit = i;
         }
     }
-    // either we're at max depth, or the triangle doesn't fit in one of our
-    // children and so we want to just record it here
-    _triangleIndices.push_back(triangleIndex);
-}
 
-bool TriangleSet::findRayIntersection(const glm::vec3& origin, const glm::vec3& direction, const glm::vec3& invDirection, float& distance,
-                                      BoxFace& face, Triangle& triangle, bool precision, bool allowBackface) {
-    if (!_isBalanced) {
-        balanceTree();
+    auto middle = std::partition(first, last, [&](const BuildTriangle& buildTriangle) {
+        return binOf(buildTriangle) < bestSplit;
+    });
+    if (middle == first || middle == last) {
+        return splitInHalf();
     }
+    return begin + (middle - first);
+}
 
-    float localDistance = distance;
-    int trianglesTouched = 0;
-    bool hit = _triangleTree.findRayIntersection(origin, direction, invDirection, localDistance, face, triangle, precision, trianglesTouched, allowBackface);
-    if (hit) {
-        distance = localDistance;
+int32_t TriangleSet::buildPacket(const std::vector<BuildTriangle>& buildTriangles, size_t begin, size_t end) {
+    TrianglePacket packet;
+    for (int lane = 0; lane < BVH_WIDTH; lane++) {
+        glm::vec3 v0(0.0f);
+        glm::vec3 edge1(0.0f);
+        glm::vec3 edge2(0.0f);
+        int32_t triangleIndex = -1;
+        if (begin + lane < end) {
+            triangleIndex = buildTriangles[begin + lane].index;
+            const Triangle& triangle = _triangles[triangleIndex];
+            v0 = triangle.v0;
+            edge1 = triangle.v1 - triangle.v0;
+            edge2 = triangle.v2 - triangle.v0;
+        }
+
+        packet.v0X[lane] = v0.x;
+        packet.v0Y[lane] = v0.y;
+        packet.v0Z[lane] = v0.z;
+        packet.edge1X[lane] = edge1.x;
+        packet.edge1Y[lane] = edge1.y;
+        packet.edge1Z[lane] = edge1.z;
+        packet.edge2X[lane] = edge2.x;
+        packet.edge2Y[lane] = edge2.y;
+        packet.edge2Z[lane] = edge2.z;
+        packet.triangleIndices[lane] = triangleIndex;
     }
 
-#if WANT_DEBUGGING
-    if (precision) {
-        qDebug() << "trianglesTouched :" << trianglesTouched << "out of:" << _triangleTree._population << "_triangles.size:" << _triangles.size();
+    _packets.push_back(packet);
+    return (int32_t)_packets.size() - 1;
+}
+
+uint32_t TriangleSet::findRayChildIntersections(const BVHNode& node, const glm::vec3& origin, const glm::vec3& invDirection,
+                                                float maxDistance, float entryDistances[BVH_WIDTH]) const {
+#if GLM_ARCH & GLM_ARCH_SSE2_BIT
+    // slab test against all four children
+    __m128 t0 = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(node.minX), _mm_set1_ps(origin.x)), _mm_set1_ps(invDirection.x));
+    __m128 t1 = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(node.maxX), _mm_set1_ps(origin.x)), _mm_set1_ps(invDirection.x));
+    __m128 entry = _mm_min_ps(t0, t1);
+    __m128 exit = _mm_max_ps(t0, t1);
+
+    t0 = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(node.minY), _mm_set1_ps(origin.y)), _mm_set1_ps(invDirection.y));
+    t1 = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(node.maxY), _mm_set1_ps(origin.y)), _mm_set1_ps(invDirection.y));
+    entry = _mm_max_ps(entry, _mm_min_ps(t0, t1));
+    exit = _mm_min_ps(exit, _mm_max_ps(t0, t1));
+
+    t0 = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(node.minZ), _mm_set1_ps(origin.z)), _mm_set1_ps(invDirection.z));
+    t1 = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(node.maxZ), _mm_set1_ps(origin.z)), _mm_set1_ps(invDirection.z));
+    entry = _mm_max_ps(entry, _mm_min_ps(t0, t1));
+    exit = _mm_min_ps(exit, _mm_max_ps(t0, t1));
+
+    // a ray that starts inside a box enters it at 0
+    entry = _mm_max_ps(entry, _mm_setzero_ps());
+    exit = _mm_min_ps(exit, _mm_set1_ps(maxDistance));
+    _mm_storeu_ps(entryDistances, entry);
+
+    __m128i lanes = _mm_setr_epi32(0, 1, 2, 3);
+    __m128 isChild = _mm_castsi128_ps(_mm_cmplt_epi32(lanes, _mm_set1_epi32(node.numChildren)));
+    return (uint32_t)_mm_movemask_ps(_mm_and_ps(_mm_cmple_ps(entry, exit), isChild));
+#else
+    uint32_t hitMask = 0;
+    for (int i = 0; i < node.numChildren; i++) {
+        glm::vec3 t0 = (glm::vec3(node.minX[i], node.minY[i], node.minZ[i]) - origin) * invDirection;
+        glm::vec3 t1 = (glm::vec3(node.maxX[i], node.maxY[i], node.maxZ[i]) - origin) * invDirection;
+        glm::vec3 entries = glm::min(t0, t1);
+        glm::vec3 exits = glm::max(t0, t1);
+        float entry = std::max(std::max(entries.x, entries.y), std::max(entries.z, 0.0f));
+        float exit = std::min(std::min(exits.x, exits.y), std::min(exits.z, maxDistance));
+        entryDistances[i] = entry;
+        if (entry <= exit) {
+            hitMask |= 1 << i;
+        }
     }
+    return hitMask;
 #endif
-    return hit;
 }
 
-// Determine of the given ray (origin/direction) in model space intersects with any triangles
-// in the set. If an intersection occurs, the distance and surface normal will be provided.
-bool TriangleSet::TriangleTreeCell::findRayIntersectionInternal(const glm::vec3& origin, const glm::vec3& direction,
-                                                                  float& distance, BoxFace& face, Triangle& triangle, bool precision,
-                                                                  int& trianglesTouched, bool allowBackface) {
-    bool intersectedSomething = false;
-    float bestDistance = FLT_MAX;
-    Triangle bestTriangle;
-
-    if (precision) {
-        for (const auto& triangleIndex : _triangleIndices) {
-            const auto& thisTriangle = _allTriangles[triangleIndex];
-            float thisTriangleDistance;
-            trianglesTouched++;
-            if (findRayTriangleIntersection(origin, direction, thisTriangle, thisTriangleDistance, allowBackface)) {
-                if (thisTriangleDistance < bestDistance) {
-                    bestDistance = thisTriangleDistance;
-                    bestTriangle = thisTriangle;
-                    intersectedSomething = true;
-                }
-            }
-        }
+// The four triangle version of findRayTriangleIntersection, which finds the same hits.
+bool TriangleSet::findRayPacketIntersection(const TrianglePacket& packet, const glm::vec3& origin, const glm::vec3& direction,
+                                            float& distance, int32_t& triangleIndex, bool allowBackface) const {
+#if GLM_ARCH & GLM_ARCH_SSE2_BIT
+    __m128 directionX = _mm_set1_ps(direction.x);
+    __m128 directionY = _mm_set1_ps(direction.y);
+    __m128 directionZ = _mm_set1_ps(direction.z);
+    __m128 edge1X = _mm_load_ps(packet.edge1X);
+    __m128 edge1Y = _mm_load_ps(packet.edge1Y);
+    __m128 edge1Z = _mm_load_ps(packet.edge1Z);
+    __m128 edge2X = _mm_load_ps(packet.edge2X);
+    __m128 edge2Y = _mm_load_ps(packet.edge2Y);
+    __m128 edge2Z = _mm_load_ps(packet.edge2Z);
+    __m128 epsilon = _mm_set1_ps(EPSILON);
+    __m128 zero = _mm_setzero_ps();
+    __m128 one = _mm_set1_ps(1.0f);
+
+    // P = cross(direction, edge2)
+    __m128 pX = _mm_sub_ps(_mm_mul_ps(directionY, edge2Z), _mm_mul_ps(edge2Y, directionZ));
+    __m128 pY = _mm_sub_ps(_mm_mul_ps(directionZ, edge2X), _mm_mul_ps(edge2Z, directionX));
+    __m128 pZ = _mm_sub_ps(_mm_mul_ps(directionX, edge2Y), _mm_mul_ps(edge2X, directionY));
+    __m128 det = _mm_add_ps(_mm_add_ps(_mm_mul_ps(edge1X, pX), _mm_mul_ps(edge1Y, pY)), _mm_mul_ps(edge1Z, pZ));
+
+    // degenerate lanes have a det of 0, so never hit
+    __m128 hits;
+    if (allowBackface) {
+        __m128 absDet = _mm_andnot_ps(_mm_set1_ps(-0.0f), det);
+        hits = _mm_cmpge_ps(absDet, epsilon);
     } else {
-        intersectedSomething = true;
-        bestDistance = distance;
+        hits = _mm_cmpge_ps(det, epsilon);
     }
-
-    if (intersectedSomething) {
-        distance = bestDistance;
-        triangle = bestTriangle;
+    __m128 invDet = _mm_div_ps(one, det);
+
+    // T = origin - v0
+    __m128 tX = _mm_sub_ps(_mm_set1_ps(origin.x), _mm_load_ps(packet.v0X));
+    __m128 tY = _mm_sub_ps(_mm_set1_ps(origin.y), _mm_load_ps(packet.v0Y));
+    __m128 tZ = _mm_sub_ps(_mm_set1_ps(origin.z), _mm_load_ps(packet.v0Z));
+    __m128 u = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(tX, pX), _mm_mul_ps(tY, pY)), _mm_mul_ps(tZ, pZ)), invDet);
+    hits = _mm_and_ps(hits, _mm_and_ps(_mm_cmpge_ps(u, zero), _mm_cmple_ps(u, one)));
+
+    // Q = cross(T, edge1)
+    __m128 qX = _mm_sub_ps(_mm_mul_ps(tY, edge1Z), _mm_mul_ps(edge1Y, tZ));
+    __m128 qY = _mm_sub_ps(_mm_mul_ps(tZ, edge1X), _mm_mul_ps(edge1Z, tX));
+    __m128 qZ = _mm_sub_ps(_mm_mul_ps(tX, edge1Y), _mm_mul_ps(edge1X, tY));
+    __m128 v = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(directionX, qX), _mm_mul_ps(directionY, qY)),
+                                     _mm_mul_ps(directionZ, qZ)), invDet);
+    hits = _mm_and_ps(hits, _mm_and_ps(_mm_cmpge_ps(v, zero), _mm_cmple_ps(_mm_add_ps(u, v), one)));
+
+    __m128 t = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(edge2X, qX), _mm_mul_ps(edge2Y, qY)), _mm_mul_ps(edge2Z, qZ)),
+                          invDet);
+    hits = _mm_and_ps(hits, _mm_and_ps(_mm_cmpgt_ps(t, epsilon), _mm_cmplt_ps(t, _mm_set1_ps(distance))));
+
+    int hitMask = _mm_movemask_ps(hits);
+    if (hitMask == 0) {
+        return false;
     }
 
-    return intersectedSomething;
+    alignas(16) float distances[BVH_WIDTH];
+    _mm_store_ps(distances, t);
+    for (int lane = 0; lane < BVH_WIDTH; lane++) {
+        if ((hitMask & (1 << lane)) && distances[lane] < distance) {
+            distance = distances[lane];
+            triangleIndex = packet.triangleIndices[lane];
+        }
+    }
+    return true;
+#else
+    bool hit = false;
+    for (int lane = 0; lane < BVH_WIDTH && packet.triangleIndices[lane] >= 0; lane++) {
+        float triangleDistance;
+        if (findRayTriangleIntersection(origin, direction, _triangles[packet.triangleIndices[lane]], triangleDistance,
+                                        allowBackface) && triangleDistance < distance) {
+            distance = triangleDistance;
+            triangleIndex = packet.triangleIndices[lane];
+            hit = true;
+        }
+    }
+    return hit;
+#endif
 }
 
-bool TriangleSet::TriangleTreeCell::findRayIntersection(const glm::vec3& origin, const glm::vec3& direction, const glm::vec3& invDirection,
-                                                        float& distance, BoxFace& face, Triangle& triangle, bool precision, int& trianglesTouched,
-                                                        bool allowBackface) {
-    if (_population < 1) {
-        return false; // no triangles below here, so we can't intersect
+// Determine of the given ray (origin/direction) in model space intersects with any triangles
+// in the set. If an intersection occurs, the distance and surface normal will be provided.
+// Without precision, the distance is that of the nearest leaf of the tree the ray enters.
+bool TriangleSet::findRayIntersection(const glm::vec3& origin, const glm::vec3& direction, const glm::vec3& invDirection, float& distance,
+                                      BoxFace& face, Triangle& triangle, bool precision, bool allowBackface) {
+    if (!_isBalanced) {
+        balanceTree();
+    }
+    if (_nodes.empty()) {
+        return false;
     }
 
-    float bestLocalDistance = FLT_MAX;
-    BoxFace bestLocalFace;
-    Triangle bestLocalTriangle;
+    float bestDistance = FLT_MAX;
+    int32_t bestTriangleIndex = -1;
     bool intersects = false;
 
-    // Check our local triangle set first
-    // The distance passed in here is the distance to our bounding box.  If !precision, that distance is used
-    {
-        float internalDistance = distance;
-        BoxFace internalFace { UNKNOWN_FACE };
-        Triangle internalTriangle;
-        if (findRayIntersectionInternal(origin, direction, internalDistance, internalFace, internalTriangle, precision, trianglesTouched, allowBackface)) {
-            bestLocalDistance = internalDistance;
-            bestLocalFace = internalFace;
-            bestLocalTriangle = internalTriangle;
-            intersects = true;
+    TraversalEntry stack[MAX_TRAVERSAL_STACK];
+    int stackSize = 0;
+    stack[stackSize++] = { 0, 0.0f };
+
+    while (stackSize > 0) {
+        TraversalEntry entry = stack[--stackSize];
+        // we can skip a node the ray enters after the best intersection so far
+        if (entry.entryDistance > bestDistance) {
+            continue;
         }
-    }
 
-    // if we're not yet at the max depth, then check our children
-    if (_depth < MAX_DEPTH) {
-        std::list<SortedTriangleCell> sortedTriangleCells;
-        auto sortingOperator = [&](std::shared_ptr<TriangleTreeCell>& child) {
-            if (child) {
-                float priority = FLT_MAX;
-                if (child->getBounds().contains(origin)) {
-                    priority = 0.0f;
-                } else {
-                    float childBoundDistance = FLT_MAX;
-                    BoxFace childBoundFace;
-                    glm::vec3 childBoundNormal;
-                    if (child->getBounds().findRayIntersection(origin, direction, invDirection, childBoundDistance, childBoundFace, childBoundNormal)) {
-                        // We only need to add this cell if it's closer than the local triangle set intersection (if there was one)
-                        if (childBoundDistance < bestLocalDistance) {
-                            priority = childBoundDistance;
-                        }
-                    }
-                }
+        const BVHNode& node = _nodes[entry.nodeIndex];
+        float entryDistances[BVH_WIDTH];
+        uint32_t hitMask = findRayChildIntersections(node, origin, invDirection, bestDistance, entryDistances);
 
-                if (priority < FLT_MAX) {
-                    if (sortedTriangleCells.size() > 0 && priority < sortedTriangleCells.front().first) {
-                        sortedTriangleCells.emplace_front(priority, child);
-                    } else {
-                        sortedTriangleCells.emplace_back(priority, child);
-                    }
-                }
-            }
-        };
-        sortingOperator(_children.first);
-        sortingOperator(_children.second);
-
-        for (auto it = sortedTriangleCells.begin(); it != sortedTriangleCells.end(); ++it) {
-            const SortedTriangleCell& sortedTriangleCell = *it;
-            float childDistance = sortedTriangleCell.first;
-            // We can exit once childDistance > bestLocalDistance
-            if (childDistance > bestLocalDistance) {
-                break;
+        int childOrder[BVH_WIDTH];
+        int numHitChildren = sortChildren(hitMask, entryDistances, childOrder);
+
+        // test the leaves nearest first, then push the nodes farthest first so that the nearest is visited next
+        for (int i = 0; i < numHitChildren; i++) {
+            int child = childOrder[i];
+            if (!(node.leafMask & (1 << child))) {
+                continue;
             }
-            // If we're inside the child cell and !precision, we need the actual distance to the cell bounds
-            if (!precision && childDistance < EPSILON) {
-                BoxFace childBoundFace;
-                glm::vec3 childBoundNormal;
-                sortedTriangleCell.second->getBounds().findRayIntersection(origin, direction, invDirection, childDistance, childBoundFace, childBoundNormal);
+            if (precision) {
+                intersects |= findRayPacketIntersection(_packets[node.children[child]], origin, direction,
+                                                        bestDistance, bestTriangleIndex, allowBackface);
+            } else if (entryDistances[child] < bestDistance) {
+                bestDistance = entryDistances[child];
+                intersects = true;
             }
-            BoxFace childFace;
-            Triangle childTriangle;
-            if (sortedTriangleCell.second->findRayIntersection(origin, direction, invDirection, childDistance, childFace, childTriangle, precision, trianglesTouched)) {
-                if (childDistance < bestLocalDistance) {
-                    bestLocalDistance = childDistance;
-                    bestLocalFace = childFace;
-                    bestLocalTriangle = childTriangle;
-                    intersects = true;
-                    break;
-                }
+        }
+        for (int i = numHitChildren - 1; i >= 0; i--) {
+            int child = childOrder[i];
+            if (!(node.leafMask & (1 << child)) && entryDistances[child] <= bestDistance) {
+                assert(stackSize < MAX_TRAVERSAL_STACK);
+                stack[stackSize++] = { node.children[child], entryDistances[child] };
             }
         }
     }
 
     if (intersects) {
-        distance = bestLocalDistance;
-        face = bestLocalFace;
-        triangle = bestLocalTriangle;
+        distance = bestDistance;
+        face = UNKNOWN_FACE;
+        if (bestTriangleIndex >= 0) {
+            triangle = _triangles[bestTriangleIndex];
+        }
     }
     return intersects;
 }
@@ -330,146 +500,88 @@ bool TriangleSet::findParabolaIntersection(const glm::vec3& origin, const glm::v
     if (!_isBalanced) {
         balanceTree();
     }
-
-    float localDistance = parabolicDistance;
-    int trianglesTouched = 0;
-    bool hit = _triangleTree.findParabolaIntersection(origin, velocity, acceleration, localDistance, face, triangle, precision, trianglesTouched, allowBackface);
-    if (hit) {
-        parabolicDistance = localDistance;
-    }
-
-#if WANT_DEBUGGING
-    if (precision) {
-        qDebug() << "trianglesTouched :" << trianglesTouched << "out of:" << _triangleTree._population << "_triangles.size:" << _triangles.size();
+    if (_nodes.empty()) {
+        return false;
     }
-#endif
-    return hit;
-}
 
-bool TriangleSet::TriangleTreeCell::findParabolaIntersectionInternal(const glm::vec3& origin, const glm::vec3& velocity,
-                                                                       const glm::vec3& acceleration, float& parabolicDistance,
-                                                                       BoxFace& face, Triangle& triangle, bool precision,
-                                                                       int& trianglesTouched, bool allowBackface) {
-    bool intersectedSomething = false;
     float bestDistance = FLT_MAX;
-    Triangle bestTriangle;
-
-    if (precision) {
-        for (const auto& triangleIndex : _triangleIndices) {
-            const auto& thisTriangle = _allTriangles[triangleIndex];
-            float thisTriangleDistance;
-            trianglesTouched++;
-            if (findParabolaTriangleIntersection(origin, velocity, acceleration, thisTriangle, thisTriangleDistance, allowBackface)) {
-                if (thisTriangleDistance < bestDistance) {
-                    bestDistance = thisTriangleDistance;
-                    bestTriangle = thisTriangle;
-                    intersectedSomething = true;
-                }
-            }
-        }
-    } else {
-        intersectedSomething = true;
-        bestDistance = parabolicDistance;
-    }
-
-    if (intersectedSomething) {
-        parabolicDistance = bestDistance;
-        triangle = bestTriangle;
-    }
-
-    return intersectedSomething;
-}
-
-bool TriangleSet::TriangleTreeCell::findParabolaIntersection(const glm::vec3& origin, const glm::vec3& velocity,
-                                                               const glm::vec3& acceleration, float& parabolicDistance,
-                                                               BoxFace& face, Triangle& triangle, bool precision,
-                                                               int& trianglesTouched, bool allowBackface) {
-    if (_population < 1) {
-        return false; // no triangles below here, so we can't intersect
-    }
-
-    float bestLocalDistance = FLT_MAX;
-    BoxFace bestLocalFace;
-    Triangle bestLocalTriangle;
+    int32_t bestTriangleIndex = -1;
     bool intersects = false;
 
-    // Check our local triangle set first
-    // The distance passed in here is the distance to our bounding box.  If !precision, that distance is used
-    {
-        float internalDistance = parabolicDistance;
-        BoxFace internalFace;
-        Triangle internalTriangle;
-        if (findParabolaIntersectionInternal(origin, velocity, acceleration, internalDistance, internalFace, internalTriangle, precision, trianglesTouched, allowBackface)) {
-            bestLocalDistance = internalDistance;
-            bestLocalFace = internalFace;
-            bestLocalTriangle = internalTriangle;
-            intersects = true;
-        }
-    }
+    TraversalEntry stack[MAX_TRAVERSAL_STACK];
+    int stackSize = 0;
+    stack[stackSize++] = { 0, 0.0f };
 
-    // if we're not yet at the max depth, then check our children
-    if (_depth < MAX_DEPTH) {
-        std::list<SortedTriangleCell> sortedTriangleCells;
-        auto sortingOperator = [&](std::shared_ptr<TriangleTreeCell>& child) {
-            if (child) {
-                float priority = FLT_MAX;
-                if (child->getBounds().contains(origin)) {
-                    priority = 0.0f;
-                } else {
-                    float childBoundDistance = FLT_MAX;
-                    BoxFace childBoundFace;
-                    glm::vec3 childBoundNormal;
-                    if (child->getBounds().findParabolaIntersection(origin, velocity, acceleration, childBoundDistance, childBoundFace, childBoundNormal)) {
-                        // We only need to add this cell if it's closer than the local triangle set intersection (if there was one)
-                        if (childBoundDistance < bestLocalDistance) {
-                            priority = childBoundDistance;
-                        }
-                    }
-                }
+    // the exact parabola tests don't vectorize, so the children and triangles are tested one at a time
+    while (stackSize > 0) {
+        TraversalEntry entry = stack[--stackSize];
+        if (entry.entryDistance > bestDistance) {
+            continue;
+        }
 
-                if (priority < FLT_MAX) {
-                    if (sortedTriangleCells.size() > 0 && priority < sortedTriangleCells.front().first) {
-                        sortedTriangleCells.emplace_front(priority, child);
-                    } else {
-                        sortedTriangleCells.emplace_back(priority, child);
-                    }
+        const BVHNode& node = _nodes[entry.nodeIndex];
+        float entryDistances[BVH_WIDTH];
+        uint32_t hitMask = 0;
+        for (int i = 0; i < node.numChildren; i++) {
+            glm::vec3 minimum(node.minX[i], node.minY[i], node.minZ[i]);
+            glm::vec3 maximum(node.maxX[i], node.maxY[i], node.maxZ[i]);
+            if (glm::all(glm::greaterThanEqual(origin, minimum)) && glm::all(glm::lessThanEqual(origin, maximum))) {
+                entryDistances[i] = 0.0f;
+            } else {
+                BoxFace childFace;
+                glm::vec3 childNormal;
+                if (!findParabolaAABoxIntersection(origin, velocity, acceleration, minimum, maximum - minimum,
+                                                   entryDistances[i], childFace, childNormal)) {
+                    continue;
                 }
             }
-        };
-        sortingOperator(_children.first);
-        sortingOperator(_children.second);
-
-        for (auto it = sortedTriangleCells.begin(); it != sortedTriangleCells.end(); ++it) {
-            const SortedTriangleCell& sortedTriangleCell = *it;
-            float childDistance = sortedTriangleCell.first;
-            // We can exit once childDistance > bestLocalDistance
-            if (childDistance > bestLocalDistance) {
-                break;
+            if (entryDistances[i] <= bestDistance) {
+                hitMask |= 1 << i;
             }
-            // If we're inside the child cell and !precision, we need the actual distance to the cell bounds
-            if (!precision && childDistance < EPSILON) {
-                BoxFace childBoundFace;
-                glm::vec3 childBoundNormal;
-                sortedTriangleCell.second->getBounds().findParabolaIntersection(origin, velocity, acceleration, childDistance, childBoundFace, childBoundNormal);
+        }
+
+        int childOrder[BVH_WIDTH];
+        int numHitChildren = sortChildren(hitMask, entryDistances, childOrder);
+
+        for (int i = 0; i < numHitChildren; i++) {
+            int child = childOrder[i];
+            if (!(node.leafMask & (1 << child))) {
+                continue;
             }
-            BoxFace childFace;
-            Triangle childTriangle;
-            if (sortedTriangleCell.second->findParabolaIntersection(origin, velocity, acceleration, childDistance, childFace, childTriangle, precision, trianglesTouched)) {
-                if (childDistance < bestLocalDistance) {
-                    bestLocalDistance = childDistance;
-                    bestLocalFace = childFace;
-                    bestLocalTriangle = childTriangle;
+            if (!precision) {
+                if (entryDistances[child] < bestDistance) {
+                    bestDistance = entryDistances[child];
+                    intersects = true;
+                }
+                continue;
+            }
+
+            const TrianglePacket& packet = _packets[node.children[child]];
+            for (int lane = 0; lane < BVH_WIDTH && packet.triangleIndices[lane] >= 0; lane++) {
+                float triangleDistance;
+                if (findParabolaTriangleIntersection(origin, velocity, acceleration, _triangles[packet.triangleIndices[lane]],
+                                                     triangleDistance, allowBackface) && triangleDistance < bestDistance) {
+                    bestDistance = triangleDistance;
+                    bestTriangleIndex = packet.triangleIndices[lane];
                     intersects = true;
-                    break;
                 }
             }
         }
+        for (int i = numHitChildren - 1; i >= 0; i--) {
+            int child = childOrder[i];
+            if (!(node.leafMask & (1 << child)) && entryDistances[child] <= bestDistance) {
+                assert(stackSize < MAX_TRAVERSAL_STACK);
+                stack[stackSize++] = { node.children[child], entryDistances[child] };
+            }
+        }
     }
 
     if (intersects) {
-        parabolicDistance = bestLocalDistance;
-        face = bestLocalFace;
-        triangle = bestLocalTriangle;
+        parabolicDistance = bestDistance;
+        face = UNKNOWN_FACE;
+        if (bestTriangleIndex >= 0) {
+            triangle = _triangles[bestTriangleIndex];
+        }
     }
     return intersects;
 }
@@ -12,59 +12,51 @@
 #pragma once
 
 #include <vector>
-#include <memory>
 
 #include "AABox.h"
 #include "GeometryUtil.h"
 
 class TriangleSet {
 
-    class TriangleTreeCell {
-    public:
-        TriangleTreeCell(std::vector<Triangle>& allTriangles) : _allTriangles(allTriangles) {}
-        TriangleTreeCell(std::vector<Triangle>& allTriangles, const AABox& bounds, int depth);
-
-        void insert(size_t triangleIndex);
-        void reset(const AABox& bounds, int depth = 0);
-        void clear();
-
-        bool findRayIntersection(const glm::vec3& origin, const glm::vec3& direction, const glm::vec3& invDirection,
-            float& distance, BoxFace& face, Triangle& triangle, bool precision, int& trianglesTouched,
-            bool allowBackface = false);
-        bool findParabolaIntersection(const glm::vec3& origin, const glm::vec3& velocity, const glm::vec3& acceleration,
-            float& parabolicDistance, BoxFace& face, Triangle& triangle, bool precision, int& trianglesTouched,
-            bool allowBackface = false);
-
-        const AABox& getBounds() const { return _bounds; }
-
-        void debugDump();
-
-    protected:
-        // checks our internal list of triangles
-        bool findRayIntersectionInternal(const glm::vec3& origin, const glm::vec3& direction,
-            float& distance, BoxFace& face, Triangle& triangle, bool precision, int& trianglesTouched,
-            bool allowBackface = false);
-        bool findParabolaIntersectionInternal(const glm::vec3& origin, const glm::vec3& velocity, const glm::vec3& acceleration,
-            float& parabolicDistance, BoxFace& face, Triangle& triangle, bool precision, int& trianglesTouched,
-            bool allowBackface = false);
-
-        std::pair<AABox, AABox> getTriangleTreeCellChildBounds();
-
-        std::vector<Triangle>& _allTriangles;
-        std::pair<std::shared_ptr<TriangleTreeCell>, std::shared_ptr<TriangleTreeCell>> _children;
-        int _depth { 0 };
-        int _population { 0 };
-        AABox _bounds;
-        std::vector<size_t> _triangleIndices;
-
-        friend class TriangleSet;
+    // The triangles are picked through a bounding volume hierarchy built with the surface area heuristic and kept
+    // flat in one array. Each node holds the bounds of up to 4 children side by side, and each leaf is a packet
+    // of up to 4 triangles, so that a ray is tested against 4 boxes or 4 triangles at a time.
+    static const int BVH_WIDTH = 4;
+
+    struct alignas(16) BVHNode {
+        float minX[BVH_WIDTH];
+        float minY[BVH_WIDTH];
+        float minZ[BVH_WIDTH];
+        float maxX[BVH_WIDTH];
+        float maxY[BVH_WIDTH];
+        float maxZ[BVH_WIDTH];
+        int32_t children[BVH_WIDTH]; // index of the child node, or of its triangle packet if the child is a leaf
+        int32_t numChildren { 0 };
+        uint32_t leafMask { 0 }; // bit i is set if child i is a leaf
     };
 
-    using SortedTriangleCell = std::pair<float, std::shared_ptr<TriangleTreeCell>>;
+    // v0 and the two edges from it for each triangle, as used by the ray test, with unused lanes left degenerate
+    struct alignas(16) TrianglePacket {
+        float v0X[BVH_WIDTH];
+        float v0Y[BVH_WIDTH];
+        float v0Z[BVH_WIDTH];
+        float edge1X[BVH_WIDTH];
+        float edge1Y[BVH_WIDTH];
+        float edge1Z[BVH_WIDTH];
+        float edge2X[BVH_WIDTH];
+        float edge2Y[BVH_WIDTH];
+        float edge2Z[BVH_WIDTH];
+        int32_t triangleIndices[BVH_WIDTH]; // -1 for unused lanes
+    };
 
-public:
-    TriangleSet() : _triangleTree(_triangles) {}
+    struct BuildTriangle {
+        glm::vec3 minimum;
+        glm::vec3 maximum;
+        glm::vec3 centroid;
+        int32_t index;
+    };
 
+public:
     void debugDump();
 
     void insert(const Triangle& t);
@@ -81,14 +73,26 @@ public:
     void clear();
 
     // Determine if a point is "inside" all the triangles of a convex hull. It is the responsibility of the caller to
-    // determine that the triangle set is indeed a convex hull. If the triangles added to this set are not in fact a 
+    // determine that the triangle set is indeed a convex hull. If the triangles added to this set are not in fact a
     // convex hull, the result of this method is meaningless and undetermined.
     bool convexHullContains(const glm::vec3& point) const;
     const AABox& getBounds() const { return _bounds; }
 
 protected:
+    int32_t buildNode(std::vector<BuildTriangle>& buildTriangles, size_t begin, size_t end, int depth);
+    size_t splitRange(std::vector<BuildTriangle>& buildTriangles, size_t begin, size_t end, int depth);
+    int32_t buildPacket(const std::vector<BuildTriangle>& buildTriangles, size_t begin, size_t end);
+
+    // finds the children of a node that the ray enters before maxDistance, returning them as a mask of child bits
+    // along with the distance at which the ray enters each
+    uint32_t findRayChildIntersections(const BVHNode& node, const glm::vec3& origin, const glm::vec3& invDirection,
+        float maxDistance, float entryDistances[BVH_WIDTH]) const;
+    bool findRayPacketIntersection(const TrianglePacket& packet, const glm::vec3& origin, const glm::vec3& direction,
+        float& distance, int32_t& triangleIndex, bool allowBackface) const;
+
     bool _isBalanced { false };
     std::vector<Triangle> _triangles;
-    TriangleTreeCell _triangleTree;
+    std::vector<BVHNode> _nodes;
+    std::vector<TrianglePacket> _packets;
     AABox _bounds;
 };
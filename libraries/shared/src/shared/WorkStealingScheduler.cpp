@@ -0,0 +1,266 @@
+//
+//  WorkStealingScheduler.cpp
+//  libraries/shared/src/shared
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "WorkStealingScheduler.h"
+
+#include <algorithm>
+#include <assert.h>
+
+#include <QtCore/QDebug>
+#include <QtCore/QThread>
+
+#ifdef Q_OS_LINUX
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "../SharedUtil.h"
+
+void WorkStealingScheduler::JobStats::accumulate(const JobStats& other) {
+    numJobs += other.numJobs;
+    numParticipants += other.numParticipants;
+    numChunks += other.numChunks;
+    numSteals += other.numSteals;
+    dispatchUsecs += other.dispatchUsecs;
+    barrierUsecs += other.barrierUsecs;
+    jobUsecs += other.jobUsecs;
+}
+
+int WorkStealingScheduler::defaultNumWorkers() {
+    int numCores = QThread::idealThreadCount();
+    if (numCores == -1) {
+        // idealThreadCount returns -1 if cores cannot be detected
+        static const int NUM_CORES_IF_UNKNOWN = 4;
+        numCores = NUM_CORES_IF_UNKNOWN;
+    }
+
+    // the thread calling run() is the remaining participant
+    return std::max(numCores - 1, 1);
+}
+
+WorkStealingScheduler::WorkStealingScheduler(int numWorkers) {
+    numWorkers = std::max(numWorkers, 0);
+    _workers.reserve(numWorkers);
+    for (int i = 0; i < numWorkers; ++i) {
+        _workers.emplace_back([this, i] { workerLoop(i); });
+    }
+}
+
+WorkStealingScheduler::~WorkStealingScheduler() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stop = true;
+    }
+    _workerCondition.notify_all();
+
+    for (auto& worker : _workers) {
+        worker.join();
+    }
+}
+
+WorkStealingScheduler::JobStats WorkStealingScheduler::run(const Job& job) {
+    JobStats stats;
+    if (job.numItems == 0) {
+        return stats;
+    }
+
+    ActiveJob activeJob;
+    activeJob.job = &job;
+    activeJob.startUsecs = usecTimestampNow();
+
+    // never more participants than chunks, the extra ones would only steal
+    size_t chunkSize = std::max(job.chunkSize, (size_t)1);
+    size_t numChunks = (job.numItems + chunkSize - 1) / chunkSize;
+    activeJob.numParticipants = (int)std::min<size_t>(std::max(1, std::min(job.maxParticipants, getMaxParticipants())),
+                                                      numChunks);
+
+    // split the range evenly, each participant works from the front of its slot
+    for (int i = 0; i < activeJob.numParticipants; ++i) {
+        auto slot = std::unique_ptr<Slot>(new Slot);
+        slot->begin = job.numItems * i / activeJob.numParticipants;
+        slot->end = job.numItems * (i + 1) / activeJob.numParticipants;
+        activeJob.slots.push_back(std::move(slot));
+    }
+
+    if (activeJob.numParticipants > 1) {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _openJobs.push_back(&activeJob);
+        }
+        _workerCondition.notify_all();
+    }
+
+    participate(activeJob, 0);
+
+    uint64_t barrierStart = usecTimestampNow();
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+
+        // close the job to workers that have not joined yet, and wait for those that have
+        _openJobs.remove(&activeJob);
+        --activeJob.numActive;
+        _jobCondition.wait(lock, [&] {
+            assert(activeJob.numActive >= 0);
+            return activeJob.numActive == 0;
+        });
+
+        stats.numParticipants = activeJob.nextParticipant;
+        if (activeJob.firstJoinUsecs != 0) {
+            stats.dispatchUsecs = activeJob.firstJoinUsecs - activeJob.startUsecs;
+        }
+    }
+    uint64_t end = usecTimestampNow();
+
+    stats.numJobs = 1;
+    stats.numChunks = activeJob.numChunks;
+    stats.numSteals = activeJob.numSteals;
+    stats.barrierUsecs = end - barrierStart;
+    stats.jobUsecs = end - activeJob.startUsecs;
+    return stats;
+}
+
+void WorkStealingScheduler::workerLoop(int workerIndex) {
+    bool isPinned = false;
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (true) {
+        ActiveJob* activeJob = nullptr;
+        _workerCondition.wait(lock, [&] {
+            if (_stop) {
+                return true;
+            }
+            auto it = std::find_if(_openJobs.begin(), _openJobs.end(), [](const ActiveJob* job) {
+                return job->nextParticipant < job->numParticipants;
+            });
+            activeJob = (it != _openJobs.end()) ? *it : nullptr;
+            return activeJob != nullptr;
+        });
+
+        if (_stop) {
+            return;
+        }
+
+        int participant = activeJob->nextParticipant++;
+        ++activeJob->numActive;
+        if (participant == 1) {
+            activeJob->firstJoinUsecs = usecTimestampNow();
+        }
+        lock.unlock();
+
+        bool shouldPin = _pinThreads;
+        if (shouldPin != isPinned) {
+            applyThreadPinning(workerIndex, shouldPin);
+            isPinned = shouldPin;
+        }
+
+        participate(*activeJob, participant);
+
+        lock.lock();
+        if (--activeJob->numActive == 0) {
+            _jobCondition.notify_all();
+        }
+    }
+}
+
+void WorkStealingScheduler::participate(ActiveJob& activeJob, int participant) {
+    const Job& job = *activeJob.job;
+
+    bool hasBegun = false;
+    size_t first, last;
+    while (takeChunk(activeJob, participant, first, last)) {
+        if (!hasBegun) {
+            if (job.begin) {
+                job.begin(participant);
+            }
+            hasBegun = true;
+        }
+
+        job.process(participant, first, last);
+        ++activeJob.numChunks;
+    }
+
+    if (hasBegun && job.end) {
+        job.end(participant);
+    }
+}
+
+bool WorkStealingScheduler::takeChunk(ActiveJob& activeJob, int participant, size_t& first, size_t& last) {
+    size_t chunkSize = std::max(activeJob.job->chunkSize, (size_t)1);
+    Slot& slot = *activeJob.slots[participant];
+
+    {
+        std::lock_guard<std::mutex> lock(slot.mutex);
+        if (slot.begin < slot.end) {
+            first = slot.begin;
+            last = std::min(first + chunkSize, slot.end);
+            slot.begin = last;
+            return true;
+        }
+    }
+
+    // out of work, steal the back half of the first participant that has any left
+    for (int i = 1; i < activeJob.numParticipants; ++i) {
+        Slot& victim = *activeJob.slots[(participant + i) % activeJob.numParticipants];
+
+        size_t stolenBegin, stolenEnd;
+        {
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            size_t remaining = victim.end - victim.begin;
+            if (remaining == 0) {
+                continue;
+            }
+
+            stolenEnd = victim.end;
+            stolenBegin = (remaining <= chunkSize) ? victim.begin : victim.end - remaining / 2;
+            victim.end = stolenBegin;
+        }
+        ++activeJob.numSteals;
+
+        first = stolenBegin;
+        last = std::min(stolenBegin + chunkSize, stolenEnd);
+
+        // what is left of the stolen range becomes this participant's work (and can be stolen in turn)
+        std::lock_guard<std::mutex> lock(slot.mutex);
+        slot.begin = last;
+        slot.end = stolenEnd;
+        return true;
+    }
+
+    return false;
+}
+
+void WorkStealingScheduler::applyThreadPinning(int workerIndex, bool pinned) {
+#ifdef Q_OS_LINUX
+    int numCores = std::max(QThread::idealThreadCount(), 1);
+
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    if (pinned) {
+        // core 0 is left to the threads calling run()
+        CPU_SET((workerIndex + 1) % numCores, &cpuSet);
+    } else {
+        for (int i = 0; i < numCores; ++i) {
+            CPU_SET(i, &cpuSet);
+        }
+    }
+
+    int error = pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet);
+    if (error != 0) {
+        qWarning() << "WorkStealingScheduler: could not set the affinity of worker" << workerIndex << "- error" << error;
+    }
+#else
+    Q_UNUSED(workerIndex);
+    if (pinned) {
+        static std::once_flag once;
+        std::call_once(once, [] {
+            qWarning() << "WorkStealingScheduler: thread pinning is only supported on Linux";
+        });
+    }
+#endif
+}
@@ -0,0 +1,112 @@
+//
+//  WorkStealingScheduler.h
+//  libraries/shared/src/shared
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+#ifndef hifi_WorkStealingScheduler_h
+#define hifi_WorkStealingScheduler_h
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "../DependencyManager.h"
+
+// WorkStealingScheduler runs data-parallel jobs over index ranges on one set of worker threads, so that
+// several thread pools in a process (e.g. the audio and avatar mixer slave pools) share cores instead of
+// each spinning up their own threads.
+//
+// The thread calling run() takes part in its job as participant 0, and idle workers join it as participants
+// 1..N-1.  The range is split evenly between the participants and handed out in chunks; a participant that
+// runs out of work steals half of the remaining work of another.  Participants are not tied to threads
+// across jobs, but within a job a participant runs on a single thread, so per-participant state
+// (like a mixer slave) needs no locking.
+class WorkStealingScheduler : public Dependency {
+    SINGLETON_DEPENDENCY
+
+public:
+    struct Job {
+        size_t numItems { 0 };
+        size_t chunkSize { 1 };
+        int maxParticipants { 1 }; // including the calling thread
+
+        // begin and end run on the participant's thread, begin before its first chunk and end after its last
+        std::function<void(int participant)> begin;
+        std::function<void(int participant, size_t first, size_t last)> process;
+        std::function<void(int participant)> end;
+    };
+
+    struct JobStats {
+        int numJobs { 0 };
+        int numParticipants { 0 };
+        int numChunks { 0 };
+        int numSteals { 0 };
+        uint64_t dispatchUsecs { 0 }; // from run() until the first worker joined
+        uint64_t barrierUsecs { 0 }; // the calling thread waiting for the other participants to finish
+        uint64_t jobUsecs { 0 };
+
+        void accumulate(const JobStats& other);
+    };
+
+    static int defaultNumWorkers();
+
+    WorkStealingScheduler(int numWorkers = defaultNumWorkers());
+    ~WorkStealingScheduler();
+
+    int getNumWorkers() const { return (int)_workers.size(); }
+    int getMaxParticipants() const { return getNumWorkers() + 1; }
+
+    // pin each worker to its own core (Linux only)
+    void setThreadPinning(bool enabled) { _pinThreads = enabled; }
+    bool isThreadPinningEnabled() const { return _pinThreads; }
+
+    // runs job on the calling thread and any idle workers, returns once every item has been processed
+    JobStats run(const Job& job);
+
+private:
+    struct Slot {
+        std::mutex mutex;
+        size_t begin { 0 };
+        size_t end { 0 };
+    };
+
+    struct ActiveJob {
+        const Job* job;
+        std::vector<std::unique_ptr<Slot>> slots;
+        int numParticipants; // slots.size()
+        int nextParticipant { 1 }; // guarded by _mutex
+        int numActive { 1 }; // guarded by _mutex
+        uint64_t startUsecs { 0 };
+        uint64_t firstJoinUsecs { 0 }; // guarded by _mutex
+        std::atomic<int> numChunks { 0 };
+        std::atomic<int> numSteals { 0 };
+    };
+
+    void workerLoop(int workerIndex);
+    void participate(ActiveJob& activeJob, int participant);
+    bool takeChunk(ActiveJob& activeJob, int participant, size_t& first, size_t& last);
+    void applyThreadPinning(int workerIndex, bool pinned);
+
+    std::vector<std::thread> _workers;
+
+    std::mutex _mutex;
+    std::condition_variable _workerCondition;
+    std::condition_variable _jobCondition;
+    std::list<ActiveJob*> _openJobs; // guarded by _mutex
+    bool _stop { false }; // guarded by _mutex
+
+    std::atomic<bool> _pinThreads { false };
+};
+
+#endif // hifi_WorkStealingScheduler_h
@@ -0,0 +1,80 @@
+//
+//  Space_avx2.cpp
+//  libraries/workload/src/avx2
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifdef __AVX2__
+
+#include <stdint.h>
+#include <immintrin.h>
+
+//
+// Classify 8 proxies at a time against every region sphere of every view.
+// The spheres are view-major (numRegions per view) as x, y, z, radius.
+// A proxy's region is the smallest region it touches in any view, numRegions if none.
+//
+// The arithmetic matches the scalar test: distance2(center, regionCenter) < (radius + regionRadius)^2
+//
+void categorizeProxyRegions_AVX2(const float* x, const float* y, const float* z, const float* radius, int numProxies,
+                                 const float (*regionSpheres)[4], int numRegionSpheres, int numRegions, uint8_t* regions) {
+
+    int i = 0;
+    for (; i < numProxies - 7; i += 8) {  // blocks of 8
+
+        __m256 px = _mm256_loadu_ps(&x[i]);
+        __m256 py = _mm256_loadu_ps(&y[i]);
+        __m256 pz = _mm256_loadu_ps(&z[i]);
+        __m256 pr = _mm256_loadu_ps(&radius[i]);
+
+        __m256i region = _mm256_set1_epi32(numRegions);
+
+        for (int j = 0; j < numRegionSpheres; j++) {
+            __m256 dx = _mm256_sub_ps(_mm256_set1_ps(regionSpheres[j][0]), px);
+            __m256 dy = _mm256_sub_ps(_mm256_set1_ps(regionSpheres[j][1]), py);
+            __m256 dz = _mm256_sub_ps(_mm256_set1_ps(regionSpheres[j][2]), pz);
+
+            // same order of operations as glm::dot
+            __m256 d2 = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy)), _mm256_mul_ps(dz, dz));
+
+            __m256 touch = _mm256_add_ps(pr, _mm256_set1_ps(regionSpheres[j][3]));
+            __m256 touch2 = _mm256_mul_ps(touch, touch);
+
+            // where touching, region = min(region, k)
+            __m256i inside = _mm256_castps_si256(_mm256_cmp_ps(d2, touch2, _CMP_LT_OQ));
+            __m256i k = _mm256_set1_epi32(j % numRegions);
+            region = _mm256_min_epi32(region, _mm256_blendv_epi8(region, k, inside));
+        }
+
+        // narrow to 8 bytes
+        __m128i lo = _mm256_castsi256_si128(region);
+        __m128i hi = _mm256_extracti128_si256(region, 1);
+        __m128i packed16 = _mm_packus_epi32(lo, hi);
+        __m128i packed8 = _mm_packus_epi16(packed16, packed16);
+        _mm_storel_epi64((__m128i*)&regions[i], packed8);
+    }
+
+    for (; i < numProxies; i++) {  // remainder
+        int region = numRegions;
+        for (int j = 0; j < numRegionSpheres; j++) {
+            float dx = regionSpheres[j][0] - x[i];
+            float dy = regionSpheres[j][1] - y[i];
+            float dz = regionSpheres[j][2] - z[i];
+            float d2 = (dx * dx + dy * dy) + dz * dz;
+            float touch = radius[i] + regionSpheres[j][3];
+            int k = j % numRegions;
+            if (d2 < touch * touch && k < region) {
+                region = k;
+            }
+        }
+        regions[i] = (uint8_t)region;
+    }
+
+    _mm256_zeroupper();
+}
+
+#endif
@@ -18,8 +18,35 @@
 
 #include <glm/gtx/quaternion.hpp>
 
+#include <TBBHelpers.h>
+
 using namespace workload;
 
+// spaces with fewer proxies are categorized on the calling thread
+static const uint32_t MIN_PROXIES_FOR_THREADING = 16 * 1024;
+static const uint32_t PROXIES_PER_TASK = 4 * 1024;
+
+void Space::ProxySpheres::resize(size_t size) {
+    x.resize(size);
+    y.resize(size);
+    z.resize(size);
+    radius.resize(size);
+}
+
+void Space::ProxySpheres::set(int32_t index, const Sphere& sphere) {
+    x[index] = sphere.x;
+    y[index] = sphere.y;
+    z[index] = sphere.z;
+    radius[index] = sphere.w;
+}
+
+void Space::ProxySpheres::clear() {
+    x.clear();
+    y.clear();
+    z.clear();
+    radius.clear();
+}
+
 Space::Space() : Collection() {
 }
 
@@ -31,6 +58,7 @@ void Space::processTransactionFrame(const Transaction& transaction) {
     if (maxID > (Index) _proxies.size()) {
         _proxies.resize(maxID + 100); // allocate the maxId and more
         _owners.resize(maxID + 100);
+        _proxySpheres.resize(maxID + 100);
     }
     // Now we know for sure that we have enough items in the array to
     // capture anything coming from the transaction
@@ -54,6 +82,7 @@ void Space::processResets(const Transaction::Resets& transactions) {
         // Reset the item with a new payload
         item.sphere = (std::get<1>(reset));
         item.prevRegion = item.region = Region::UNKNOWN;
+        _proxySpheres.set(proxyID, item.sphere);
 
         _owners[proxyID] = (std::get<2>(reset));
     }
@@ -87,13 +116,55 @@ void Space::processUpdates(const Transaction::Updates& transactions) {
 
         // Update the item
         item.sphere = (std::get<1>(update));
+        _proxySpheres.set(updateID, item.sphere);
     }
 }
 
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+//
+// Runtime CPU dispatch
+//
+#include <CPUDetect.h>
+
+void categorizeProxyRegions_AVX2(const float* x, const float* y, const float* z, const float* radius, int numProxies,
+                                 const float (*regionSpheres)[4], int numRegionSpheres, int numRegions, uint8_t* regions);
+
+static bool canCategorizeSIMD() {
+    static bool _cpuSupportsAVX2 = cpuSupportsAVX2();
+    return _cpuSupportsAVX2;
+}
+
+#else
+static bool canCategorizeSIMD() {
+    return false;
+}
+#endif
+
 void Space::categorizeAndGetChanges(std::vector<Space::Change>& changes) {
     std::unique_lock<std::mutex> lock(_proxiesMutex);
+    if (_isSIMDEnabled && canCategorizeSIMD()) {
+        categorizeSIMD();
+    } else {
+        categorizeScalar();
+    }
+
+    uint32_t numProxies = (uint32_t)_proxies.size();
+    for (uint32_t i = 0; i < numProxies; ++i) {
+        Proxy& proxy = _proxies[i];
+        if (proxy.region < Region::INVALID) {
+            proxy.prevRegion = proxy.region;
+            proxy.region = _newRegions[i];
+            if (proxy.region != proxy.prevRegion) {
+                changes.emplace_back(Space::Change((int32_t)i, proxy.region, proxy.prevRegion));
+            }
+        }
+    }
+}
+
+void Space::categorizeScalar() {
     uint32_t numProxies = (uint32_t)_proxies.size();
     uint32_t numViews = (uint32_t)_views.size();
+    _newRegions.resize(numProxies);
     for (uint32_t i = 0; i < numProxies; ++i) {
         Proxy& proxy = _proxies[i];
         if (proxy.region < Region::INVALID) {
@@ -111,15 +182,44 @@ void Space::categorizeAndGetChanges(std::vector<Space::Change>& changes) {
                     }
                 }
             }
-            proxy.prevRegion = proxy.region;
-            proxy.region = region;
-            if (proxy.region != proxy.prevRegion) {
-                changes.emplace_back(Space::Change((int32_t)i, proxy.region, proxy.prevRegion));
-            }
+            _newRegions[i] = region;
         }
     }
 }
 
+void Space::categorizeSIMD() {
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+    uint32_t numProxies = (uint32_t)_proxies.size();
+    _newRegions.resize(numProxies);
+
+    // every region sphere of every view, in view order
+    static_assert(sizeof(Sphere) == 4 * sizeof(float), "Sphere size doesn't match.");
+    std::vector<Sphere> regionSpheres;
+    regionSpheres.reserve(_views.size() * Region::NUM_TRACKED_REGIONS);
+    for (const auto& view : _views) {
+        regionSpheres.insert(regionSpheres.end(), view.regions, view.regions + Region::NUM_TRACKED_REGIONS);
+    }
+
+    // the regions of removed proxies are computed too, but never read
+    auto categorize = [&](uint32_t begin, uint32_t end) {
+        categorizeProxyRegions_AVX2(&_proxySpheres.x[begin], &_proxySpheres.y[begin], &_proxySpheres.z[begin],
+            &_proxySpheres.radius[begin], (int)(end - begin), (const float(*)[4])regionSpheres.data(),
+            (int)regionSpheres.size(), (int)Region::NUM_TRACKED_REGIONS, &_newRegions[begin]);
+    };
+
+    if (_isThreadingEnabled && numProxies >= MIN_PROXIES_FOR_THREADING) {
+        tbb::parallel_for(tbb::blocked_range<uint32_t>(0, numProxies, PROXIES_PER_TASK),
+            [&](const tbb::blocked_range<uint32_t>& range) {
+                categorize(range.begin(), range.end());
+            });
+    } else if (numProxies > 0) {
+        categorize(0, numProxies);
+    }
+#else
+    categorizeScalar();
+#endif
+}
+
 uint32_t Space::copyProxyValues(Proxy* proxies, uint32_t numDestProxies) const {
     std::unique_lock<std::mutex> lock(_proxiesMutex);
     auto numCopied = std::min(numDestProxies, (uint32_t)_proxies.size());
@@ -161,6 +261,8 @@ void Space::clear() {
     _IDAllocator.clear();
     _proxies.clear();
     _owners.clear();
+    _proxySpheres.clear();
+    _newRegions.clear();
     _views.clear();
 }
 
@@ -46,6 +46,10 @@ public:
     uint32_t getNumAllocatedProxies() const { return (uint32_t)(_IDAllocator.getNumAllocatedIndices()); }
 
     void categorizeAndGetChanges(std::vector<Change>& changes);
+
+    // the region tests run vectorized on CPUs that support AVX2, and split across threads in large spaces
+    void setSIMDEnabled(bool enabled) { _isSIMDEnabled = enabled; }
+    void setThreadingEnabled(bool enabled) { _isThreadingEnabled = enabled; }
     uint32_t copyProxyValues(Proxy* proxies, uint32_t numDestProxies) const;
     uint32_t copySelectedProxyValues(Proxy::Vector& proxies, const workload::indexed_container::Indices& indices) const;
 
@@ -60,12 +64,33 @@ private:
     void processRemoves(const Transaction::Removes& transactions);
     void processUpdates(const Transaction::Updates& transactions);
 
+    void categorizeScalar();
+    void categorizeSIMD();
+
+    // the proxy spheres as a structure of arrays, for the vectorized region tests
+    class ProxySpheres {
+    public:
+        void resize(size_t size);
+        void set(int32_t index, const Sphere& sphere);
+        void clear();
+
+        std::vector<float> x;
+        std::vector<float> y;
+        std::vector<float> z;
+        std::vector<float> radius;
+    };
+
     // The database of proxies is protected for editing by a mutex
     mutable std::mutex _proxiesMutex;
     Proxy::Vector _proxies;
     std::vector<Owner> _owners;
+    ProxySpheres _proxySpheres;
+    std::vector<uint8_t> _newRegions;
 
     Views _views;
+
+    bool _isSIMDEnabled { true };
+    bool _isThreadingEnabled { true };
 };
 
 using SpacePointer = std::shared_ptr<Space>;
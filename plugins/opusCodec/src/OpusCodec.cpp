@@ -0,0 +1,176 @@
+//
+//  OpusCodec.cpp
+//  plugins/opusCodec/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "OpusCodec.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include <QtCore/QDebug>
+
+#include <opus/opus.h>
+
+#include <AudioConstants.h>
+
+const char* OpusCodec::NAME { "opus" };
+
+// the largest packet an Opus frame can encode to
+static const int MAX_ENCODED_BYTES = 1275;
+
+void OpusCodec::init() {
+}
+
+void OpusCodec::deinit() {
+}
+
+bool OpusCodec::activate() {
+    CodecPlugin::activate();
+    return true;
+}
+
+void OpusCodec::deactivate() {
+    CodecPlugin::deactivate();
+}
+
+bool OpusCodec::isSupported() const {
+    return true;
+}
+
+class OpusAudioEncoder : public Encoder {
+public:
+    OpusAudioEncoder(int sampleRate, int numChannels, int bitratePerChannel, int complexity, int expectedPacketLoss) :
+        _numChannels(numChannels)
+    {
+        // microphone streams are speech, mixes may carry music and effects too
+        int application = numChannels == 1 ? OPUS_APPLICATION_VOIP : OPUS_APPLICATION_AUDIO;
+
+        int error = OPUS_OK;
+        _encoder = opus_encoder_create(sampleRate, numChannels, application, &error);
+        if (error != OPUS_OK) {
+            qWarning() << "Could not create an Opus encoder:" << opus_strerror(error);
+            _encoder = nullptr;
+            return;
+        }
+
+        opus_encoder_ctl(_encoder, OPUS_SET_BITRATE(bitratePerChannel * numChannels));
+        opus_encoder_ctl(_encoder, OPUS_SET_COMPLEXITY(complexity));
+
+        // carry a lower quality copy of each frame in the next one, for the decoder to rebuild a lost frame with;
+        // the expected loss decides how much of the bitrate that copy may take
+        opus_encoder_ctl(_encoder, OPUS_SET_INBAND_FEC(1));
+        opus_encoder_ctl(_encoder, OPUS_SET_PACKET_LOSS_PERC(expectedPacketLoss));
+    }
+
+    virtual ~OpusAudioEncoder() {
+        if (_encoder) {
+            opus_encoder_destroy(_encoder);
+        }
+    }
+
+    virtual void encode(const QByteArray& decodedBuffer, QByteArray& encodedBuffer) override {
+        if (!_encoder) {
+            // an empty frame is decoded as a lost one
+            encodedBuffer.clear();
+            return;
+        }
+
+        int frameSize = decodedBuffer.size() / (int)(sizeof(int16_t) * _numChannels);
+        encodedBuffer.resize(MAX_ENCODED_BYTES);
+        int encodedBytes = opus_encode(_encoder, (const opus_int16*)decodedBuffer.constData(), frameSize,
+                                       (unsigned char*)encodedBuffer.data(), MAX_ENCODED_BYTES);
+        encodedBuffer.resize(std::max(encodedBytes, 0));
+    }
+
+private:
+    OpusEncoder* _encoder { nullptr };
+    int _numChannels;
+};
+
+class OpusAudioDecoder : public Decoder {
+public:
+    OpusAudioDecoder(int sampleRate, int numChannels) {
+        _frameSize = AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL;
+        _decodedSize = _frameSize * sizeof(int16_t) * numChannels;
+
+        int error = OPUS_OK;
+        _decoder = opus_decoder_create(sampleRate, numChannels, &error);
+        if (error != OPUS_OK) {
+            qWarning() << "Could not create an Opus decoder:" << opus_strerror(error);
+            _decoder = nullptr;
+        }
+    }
+
+    virtual ~OpusAudioDecoder() {
+        if (_decoder) {
+            opus_decoder_destroy(_decoder);
+        }
+    }
+
+    virtual void decode(const QByteArray& encodedBuffer, QByteArray& decodedBuffer) override {
+        decode((const unsigned char*)encodedBuffer.constData(), encodedBuffer.size(), false, decodedBuffer);
+    }
+
+    virtual void lostFrame(QByteArray& decodedBuffer) override {
+        // no data has the decoder conceal the loss by extrapolating from the frames before it
+        decode(nullptr, 0, false, decodedBuffer);
+    }
+
+    virtual void recoverFrame(const QByteArray& encodedBuffer, QByteArray& decodedBuffer) override {
+        // decodes the redundant copy of the lost frame carried in the frame after it, or conceals
+        // the loss if the encoder had no room for one
+        decode((const unsigned char*)encodedBuffer.constData(), encodedBuffer.size(), true, decodedBuffer);
+    }
+
+private:
+    void decode(const unsigned char* data, int size, bool useFEC, QByteArray& decodedBuffer) {
+        decodedBuffer.resize(_decodedSize);
+
+        int decodedSamples = -1;
+        if (_decoder) {
+            decodedSamples = opus_decode(_decoder, data, size, (opus_int16*)decodedBuffer.data(), _frameSize,
+                                         useFEC ? 1 : 0);
+        }
+        if (decodedSamples != _frameSize) {
+            memset(decodedBuffer.data(), 0, _decodedSize);
+        }
+    }
+
+    OpusDecoder* _decoder { nullptr };
+    int _frameSize;
+    int _decodedSize;
+};
+
+Encoder* OpusCodec::createEncoder(int sampleRate, int numChannels) {
+    return new OpusAudioEncoder(sampleRate, numChannels, _bitratePerChannel, _complexity, _expectedPacketLoss);
+}
+
+Decoder* OpusCodec::createDecoder(int sampleRate, int numChannels) {
+    return new OpusAudioDecoder(sampleRate, numChannels);
+}
+
+void OpusCodec::releaseEncoder(Encoder* encoder) {
+    delete encoder;
+}
+
+void OpusCodec::releaseDecoder(Decoder* decoder) {
+    delete decoder;
+}
+
+void OpusCodec::setEncoderBitrate(int bitsPerSecondPerChannel) {
+    _bitratePerChannel = bitsPerSecondPerChannel;
+}
+
+void OpusCodec::setEncoderComplexity(int complexity) {
+    _complexity = complexity;
+}
+
+void OpusCodec::setEncoderExpectedPacketLoss(int percent) {
+    _expectedPacketLoss = percent;
+}
@@ -0,0 +1,58 @@
+//
+//  OpusCodec.h
+//  plugins/opusCodec/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_OpusCodec_h
+#define hifi_OpusCodec_h
+
+#include <atomic>
+
+#include <plugins/CodecPlugin.h>
+
+// Opus at a configurable bitrate, with in-band forward error correction so that a receiver can rebuild a lost
+// frame from the one after it, and packet loss concealment for frames that can't be rebuilt.
+class OpusCodec : public CodecPlugin {
+    Q_OBJECT
+
+public:
+    static const int DEFAULT_BITRATE_PER_CHANNEL = 24000; // bits per second
+    static const int DEFAULT_COMPLEXITY = 5; // 0 (fastest) to 10 (best)
+    static const int DEFAULT_EXPECTED_PACKET_LOSS = 10; // percent
+
+    // Plugin functions
+    bool isSupported() const override;
+    const QString getName() const override { return NAME; }
+
+    void init() override;
+    void deinit() override;
+
+    /// Called when a plugin is being activated for use.  May be called multiple times.
+    bool activate() override;
+    /// Called when a plugin is no longer being used.  May be called multiple times.
+    void deactivate() override;
+
+    virtual Encoder* createEncoder(int sampleRate, int numChannels) override;
+    virtual Decoder* createDecoder(int sampleRate, int numChannels) override;
+    virtual void releaseEncoder(Encoder* encoder) override;
+    virtual void releaseDecoder(Decoder* decoder) override;
+
+    virtual void setEncoderBitrate(int bitsPerSecondPerChannel) override;
+    virtual void setEncoderComplexity(int complexity) override;
+    virtual void setEncoderExpectedPacketLoss(int percent) override;
+
+private:
+    static const char* NAME;
+
+    // set from the settings thread, read as encoders are created on the mixer threads
+    std::atomic<int> _bitratePerChannel { DEFAULT_BITRATE_PER_CHANNEL };
+    std::atomic<int> _complexity { DEFAULT_COMPLEXITY };
+    std::atomic<int> _expectedPacketLoss { DEFAULT_EXPECTED_PACKET_LOSS };
+};
+
+#endif // hifi_OpusCodec_h
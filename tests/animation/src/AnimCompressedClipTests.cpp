@@ -0,0 +1,240 @@
+//
+//  AnimCompressedClipTests.cpp
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AnimCompressedClipTests.h"
+
+#include <algorithm>
+
+#include <AnimCompressedClip.h>
+#include <AnimUtil.h>
+#include <GLMHelpers.h>
+#include <NumericalConstants.h>
+
+#include <test-utils/QTestExtensions.h>
+
+QTEST_MAIN(AnimCompressedClipTests)
+
+const int NUM_FRAMES = 120;
+const int NUM_JOINTS = 55; // about a full body skeleton, not a whole number of groups
+const int BENCHMARK_NUM_CLIPS = 100;
+
+// the tolerances the clips are built with, plus room for the quantization
+const float ROTATION_ERROR = 0.003f; // radians
+const float TRANSLATION_ERROR = 0.002f;
+const float SCALE_ERROR = 0.001f;
+
+// a walk-like cycle where every joint swings, the hips move and the rest of the translations and scales hold still
+static std::vector<AnimPoseVec> makeFrames(int numFrames, int numJoints) {
+    std::vector<AnimPoseVec> frames(numFrames);
+    for (int frame = 0; frame < numFrames; frame++) {
+        float phase = TWO_PI * (float)frame / (float)numFrames;
+        frames[frame].reserve(numJoints);
+        for (int joint = 0; joint < numJoints; joint++) {
+            glm::vec3 axis = glm::normalize(glm::vec3(1.0f + joint % 3, 1.0f + joint % 5, 1.0f + joint % 7));
+            float angle = 0.5f * sinf(phase + 0.1f * joint) + 0.1f * joint;
+            glm::vec3 translation(0.0f, 0.1f * joint, 0.0f);
+            if (joint == 0) {
+                translation += glm::vec3(0.05f * sinf(phase), 0.02f * sinf(2.0f * phase), 0.5f * phase);
+            }
+            frames[frame].push_back(AnimPose(glm::vec3(1.0f), glm::angleAxis(angle, axis), translation));
+        }
+    }
+    return frames;
+}
+
+static float rotationError(const glm::quat& a, const glm::quat& b) {
+    return 2.0f * acosf(glm::min(fabsf(glm::dot(glm::normalize(a), glm::normalize(b))), 1.0f));
+}
+
+static void compareFrames(const AnimPoseVec& actual, const AnimPoseVec& expected) {
+    QCOMPARE(actual.size(), expected.size());
+    for (size_t joint = 0; joint < actual.size(); joint++) {
+        QVERIFY(rotationError(actual[joint].rot(), expected[joint].rot()) < ROTATION_ERROR);
+        QVERIFY(glm::distance(actual[joint].trans(), expected[joint].trans()) < TRANSLATION_ERROR);
+        QVERIFY(glm::distance(actual[joint].scale(), expected[joint].scale()) < SCALE_ERROR);
+    }
+}
+
+void AnimCompressedClipTests::testSampleAccuracy() {
+    std::vector<AnimPoseVec> frames = makeFrames(NUM_FRAMES, NUM_JOINTS);
+    AnimCompressedClip clip(frames);
+    QCOMPARE(clip.getNumFrames(), NUM_FRAMES);
+    QCOMPARE(clip.getNumJoints(), NUM_JOINTS);
+
+    AnimPoseVec poses;
+    for (int frame = 0; frame < NUM_FRAMES; frame++) {
+        clip.sample((float)frame, poses);
+        compareFrames(poses, frames[frame]);
+    }
+
+    // a fractional frame is the blend of the frames either side of it
+    AnimPoseVec expected(NUM_JOINTS);
+    for (int frame = 0; frame < NUM_FRAMES - 1; frame++) {
+        const float ALPHA = 0.25f;
+        clip.sample((float)frame + ALPHA, poses);
+        ::blend(NUM_JOINTS, &frames[frame][0], &frames[frame + 1][0], ALPHA, &expected[0]);
+        compareFrames(poses, expected);
+    }
+
+    // and frames outside the clip are clamped to it
+    clip.sample(-1.0f, poses);
+    compareFrames(poses, frames.front());
+    clip.sample((float)NUM_FRAMES + 10.0f, poses);
+    compareFrames(poses, frames.back());
+}
+
+void AnimCompressedClipTests::testKeyFrameReduction() {
+    std::vector<AnimPoseVec> frames = makeFrames(NUM_FRAMES, NUM_JOINTS);
+
+    AnimCompressedClip::Settings settings;
+    settings.reduceKeyFrames = false;
+    AnimCompressedClip allFrames(frames, settings);
+    QCOMPARE((int)allFrames.getKeyFrames().size(), NUM_FRAMES);
+
+    AnimCompressedClip reduced(frames);
+    const auto& keyFrames = reduced.getKeyFrames();
+    QVERIFY(keyFrames.size() < allFrames.getKeyFrames().size());
+    QCOMPARE(keyFrames.front(), 0);
+    QCOMPARE(keyFrames.back(), NUM_FRAMES - 1);
+    for (size_t key = 1; key < keyFrames.size(); key++) {
+        QVERIFY(keyFrames[key] > keyFrames[key - 1]);
+        QVERIFY(keyFrames[key] - keyFrames[key - 1] <= AnimCompressedClip::MAX_KEY_FRAME_GAP);
+    }
+
+    // quantized and without the channels that don't change, even every frame is well under the uncompressed size
+    size_t uncompressedSize = NUM_FRAMES * NUM_JOINTS * sizeof(AnimPose);
+    QVERIFY(allFrames.getByteSize() < uncompressedSize / 2);
+    QVERIFY(reduced.getByteSize() < allFrames.getByteSize());
+
+    // a clip that holds still needs only as many key frames as the longest gap between them allows
+    std::vector<AnimPoseVec> stillFrames(NUM_FRAMES, frames[0]);
+    AnimCompressedClip still(stillFrames);
+    const int MIN_KEY_FRAMES = (NUM_FRAMES - 1 + AnimCompressedClip::MAX_KEY_FRAME_GAP - 1) / AnimCompressedClip::MAX_KEY_FRAME_GAP + 1;
+    QCOMPARE((int)still.getKeyFrames().size(), MIN_KEY_FRAMES);
+    AnimPoseVec poses;
+    still.sample(NUM_FRAMES / 2.0f, poses);
+    compareFrames(poses, frames[0]);
+
+    // a sudden change keeps the frames either side of it
+    std::vector<AnimPoseVec> stepFrames = stillFrames;
+    const int STEP_FRAME = NUM_FRAMES / 2;
+    for (int frame = STEP_FRAME; frame < NUM_FRAMES; frame++) {
+        stepFrames[frame][1].rot() = glm::angleAxis(PI_OVER_TWO, Vectors::UNIT_Y) * stepFrames[frame][1].rot();
+    }
+    AnimCompressedClip step(stepFrames);
+    const auto& stepKeyFrames = step.getKeyFrames();
+    QVERIFY(std::find(stepKeyFrames.begin(), stepKeyFrames.end(), STEP_FRAME - 1) != stepKeyFrames.end());
+    QVERIFY(std::find(stepKeyFrames.begin(), stepKeyFrames.end(), STEP_FRAME) != stepKeyFrames.end());
+    for (int frame = 0; frame < NUM_FRAMES; frame++) {
+        step.sample((float)frame, poses);
+        compareFrames(poses, stepFrames[frame]);
+    }
+}
+
+void AnimCompressedClipTests::testBlendMatchesUncompressedBlend() {
+    std::vector<AnimPoseVec> frames = makeFrames(NUM_FRAMES, NUM_JOINTS);
+    AnimCompressedClip clip(frames);
+
+    AnimPoseVec poses;
+    AnimPoseVec expected(NUM_JOINTS);
+    const float ALPHAS[] = { 0.0f, 0.3f, 0.7f, 1.0f };
+    for (float alpha : ALPHAS) {
+        for (int frame = 0; frame < NUM_FRAMES; frame++) {
+            // the next frame of the last frame loops back to the first, as AnimClip does
+            int nextFrame = (frame + 1) % NUM_FRAMES;
+            clip.blend(frame, nextFrame, alpha, poses);
+            ::blend(NUM_JOINTS, &frames[frame][0], &frames[nextFrame][0], alpha, &expected[0]);
+            compareFrames(poses, expected);
+        }
+
+        // and between frames that are further apart
+        clip.blend(10, NUM_FRAMES / 2, alpha, poses);
+        ::blend(NUM_JOINTS, &frames[10][0], &frames[NUM_FRAMES / 2][0], alpha, &expected[0]);
+        compareFrames(poses, expected);
+    }
+}
+
+void AnimCompressedClipTests::testRetargetedKeyFrames() {
+    std::vector<AnimPoseVec> frames = makeFrames(NUM_FRAMES, NUM_JOINTS);
+    AnimCompressedClip clip(frames);
+    const auto& keyFrames = clip.getKeyFrames();
+
+    // a clip built from another's key frames, as AnimClip does with the poses it retargets, keeps them as they are
+    std::vector<AnimPoseVec> keyPoses(keyFrames.size());
+    for (size_t key = 0; key < keyFrames.size(); key++) {
+        keyPoses[key] = frames[keyFrames[key]];
+        for (auto& pose : keyPoses[key]) {
+            pose.trans() *= 2.0f;
+        }
+    }
+    AnimCompressedClip retargeted(NUM_FRAMES, keyFrames, keyPoses);
+    QCOMPARE(retargeted.getNumFrames(), NUM_FRAMES);
+    QVERIFY(retargeted.getKeyFrames() == keyFrames);
+
+    AnimPoseVec poses;
+    for (size_t key = 0; key < keyFrames.size(); key++) {
+        retargeted.decodeKeyFrame(key, poses);
+        compareFrames(poses, keyPoses[key]);
+    }
+}
+
+void AnimCompressedClipTests::testEmptyAndSingleFrameClips() {
+    AnimPoseVec poses;
+
+    AnimCompressedClip empty;
+    QCOMPARE(empty.getNumFrames(), 0);
+    QCOMPARE(empty.getNumJoints(), 0);
+    empty.sample(0.0f, poses);
+    QVERIFY(poses.empty());
+
+    AnimCompressedClip noFrames(std::vector<AnimPoseVec>{});
+    QCOMPARE(noFrames.getNumFrames(), 0);
+    QVERIFY(noFrames.getKeyFrames().empty());
+
+    std::vector<AnimPoseVec> frames = makeFrames(1, NUM_JOINTS);
+    AnimCompressedClip single(frames);
+    QCOMPARE(single.getNumFrames(), 1);
+    QCOMPARE((int)single.getKeyFrames().size(), 1);
+    single.sample(0.5f, poses);
+    compareFrames(poses, frames[0]);
+    single.blend(0, 0, 0.5f, poses);
+    compareFrames(poses, frames[0]);
+}
+
+// sample as many clips as there might be visible avatars, at the times they would be sampled over a few frames
+void AnimCompressedClipTests::benchmarkCompressedBlend() {
+    std::vector<AnimPoseVec> frames = makeFrames(NUM_FRAMES, NUM_JOINTS);
+    std::vector<AnimCompressedClip> clips(BENCHMARK_NUM_CLIPS, AnimCompressedClip(frames));
+    std::vector<AnimPoseVec> poses(BENCHMARK_NUM_CLIPS, AnimPoseVec(NUM_JOINTS));
+
+    int frame = 0;
+    QBENCHMARK {
+        for (int i = 0; i < BENCHMARK_NUM_CLIPS; i++) {
+            int prevFrame = (frame + i) % NUM_FRAMES;
+            clips[i].blend(prevFrame, (prevFrame + 1) % NUM_FRAMES, 0.4f, poses[i]);
+        }
+        frame++;
+    }
+}
+
+void AnimCompressedClipTests::benchmarkUncompressedBlend() {
+    std::vector<AnimPoseVec> frames = makeFrames(NUM_FRAMES, NUM_JOINTS);
+    std::vector<std::vector<AnimPoseVec>> clips(BENCHMARK_NUM_CLIPS, frames);
+    std::vector<AnimPoseVec> poses(BENCHMARK_NUM_CLIPS, AnimPoseVec(NUM_JOINTS));
+
+    int frame = 0;
+    QBENCHMARK {
+        for (int i = 0; i < BENCHMARK_NUM_CLIPS; i++) {
+            int prevFrame = (frame + i) % NUM_FRAMES;
+            int nextFrame = (prevFrame + 1) % NUM_FRAMES;
+            ::blend(NUM_JOINTS, &clips[i][prevFrame][0], &clips[i][nextFrame][0], 0.4f, &poses[i][0]);
+        }
+        frame++;
+    }
+}
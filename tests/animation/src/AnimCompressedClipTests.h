@@ -0,0 +1,28 @@
+//
+//  AnimCompressedClipTests.h
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AnimCompressedClipTests_h
+#define hifi_AnimCompressedClipTests_h
+
+#include <QtTest/QtTest>
+
+class AnimCompressedClipTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void testSampleAccuracy();
+    void testKeyFrameReduction();
+    void testBlendMatchesUncompressedBlend();
+    void testRetargetedKeyFrames();
+    void testEmptyAndSingleFrameClips();
+    void benchmarkCompressedBlend();
+    void benchmarkUncompressedBlend();
+};
+
+#endif // hifi_AnimCompressedClipTests_h
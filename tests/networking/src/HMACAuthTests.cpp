@@ -0,0 +1,96 @@
+//
+//  HMACAuthTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "HMACAuthTests.h"
+
+#include <atomic>
+#include <thread>
+
+#include <QtCore/QUuid>
+
+#include <HMACAuth.h>
+
+QTEST_MAIN(HMACAuthTests)
+
+static QByteArray toByteArray(const HMACAuth::HMACHash& hash) {
+    return QByteArray((const char*)hash.data(), (int)hash.size());
+}
+
+void HMACAuthTests::md5Test() {
+    HMACAuth hmacAuth(HMACAuth::MD5);
+    QVERIFY(hmacAuth.setKey("Jefe", 4));
+
+    const QByteArray data("what do ya want for nothing?");
+    HMACAuth::HMACHash hash;
+    QVERIFY(hmacAuth.calculateHash(hash, data.constData(), data.size()));
+    QCOMPARE(toByteArray(hash).toHex(), QByteArray("750c783e6ab0b503eaa86e310a5db738"));
+}
+
+void HMACAuthTests::sipHashTest() {
+    char key[16];
+    char data[15];
+    for (int i = 0; i < 16; ++i) {
+        key[i] = (char)i;
+    }
+    for (int i = 0; i < 15; ++i) {
+        data[i] = (char)i;
+    }
+
+    HMACAuth hmacAuth(HMACAuth::SipHash);
+    QVERIFY(!hmacAuth.setKey(key, 8));
+    QVERIFY(hmacAuth.setKey(key, 16));
+
+    HMACAuth::HMACHash hash;
+    QVERIFY(hmacAuth.calculateHash(hash, data, 0));
+    QCOMPARE(toByteArray(hash).toHex(), QByteArray("a3817f04ba25a8e66df67214c7550293"));
+    QVERIFY(hmacAuth.calculateHash(hash, data, 1));
+    QCOMPARE(toByteArray(hash).toHex(), QByteArray("da87c1d86b99af44347659119b22fc45"));
+
+    // the streaming interface gives the same result
+    QVERIFY(hmacAuth.addData(data, 7));
+    QVERIFY(hmacAuth.addData(data + 7, 8));
+    QByteArray streamed = toByteArray(hmacAuth.result());
+    QVERIFY(hmacAuth.calculateHash(hash, data, 15));
+    QCOMPARE(streamed, toByteArray(hash));
+}
+
+void HMACAuthTests::concurrentHashTest() {
+    const int NUM_THREADS = 4;
+    const int HASHES_PER_THREAD = 10000;
+    const QByteArray data(1000, 'x');
+
+    for (auto method : { HMACAuth::MD5, HMACAuth::SipHash }) {
+        HMACAuth hmacAuth(method);
+        QVERIFY(hmacAuth.setKey(QUuid::createUuid()));
+
+        hmacAuth.addData(data.constData(), data.size());
+        QByteArray expected = toByteArray(hmacAuth.result());
+
+        std::atomic<int> mismatches { 0 };
+        std::vector<std::thread> threads;
+        for (int t = 0; t < NUM_THREADS; ++t) {
+            threads.emplace_back([&] {
+                unsigned char hash[HMACAuth::MAX_HASH_LENGTH];
+                unsigned int hashLength = 0;
+                for (int i = 0; i < HASHES_PER_THREAD; ++i) {
+                    if (!hmacAuth.calculateHash(hash, hashLength, data.constData(), data.size())
+                        || QByteArray((const char*)hash, hashLength) != expected) {
+                        ++mismatches;
+                    }
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        QCOMPARE(mismatches.load(), 0);
+    }
+}
@@ -0,0 +1,30 @@
+//
+//  HMACAuthTests.h
+//  tests/networking/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_HMACAuthTests_h
+#define hifi_HMACAuthTests_h
+
+#include <QtTest/QtTest>
+
+class HMACAuthTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    // Test HMAC-MD5 against RFC 2202
+    void md5Test();
+
+    // Test SipHash-2-4-128 against the reference implementation's vectors
+    void sipHashTest();
+
+    // Test that one-shot hashes from several threads match the streamed hash
+    void concurrentHashTest();
+};
+
+#endif // hifi_HMACAuthTests_h
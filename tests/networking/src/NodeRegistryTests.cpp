@@ -0,0 +1,226 @@
+//
+//  NodeRegistryTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "NodeRegistryTests.h"
+
+#include <atomic>
+#include <thread>
+
+#include <NodeRegistry.h>
+#include <NodeType.h>
+#include <SharedUtil.h>
+
+QTEST_MAIN(NodeRegistryTests)
+
+static SharedNodePointer createNode(Node::LocalID localID) {
+    SharedNodePointer node(new Node(QUuid::createUuid(), NodeType::Agent, HifiSockAddr(), HifiSockAddr()));
+    node->setLocalID(localID);
+    return node;
+}
+
+void NodeRegistryTests::addRemoveTest() {
+    NodeRegistry registry;
+    QCOMPARE(registry.getSnapshot()->size(), (size_t)0);
+
+    auto first = createNode(1);
+    auto second = createNode(2);
+    registry.add(first);
+    registry.add(second);
+
+    auto snapshot = registry.getSnapshot();
+    QCOMPARE(snapshot->size(), (size_t)2);
+    QCOMPARE(snapshot->nodeWithUUID(first->getUUID()), first);
+    QCOMPARE(snapshot->nodeWithLocalID(2), second);
+    QVERIFY(snapshot->nodeWithLocalID(3).isNull());
+
+    // adding a node again re-indexes it rather than duplicating it
+    second->setLocalID(3);
+    registry.add(second);
+    snapshot = registry.getSnapshot();
+    QCOMPARE(snapshot->size(), (size_t)2);
+    QVERIFY(snapshot->nodeWithLocalID(2).isNull());
+    QCOMPARE(snapshot->nodeWithLocalID(3), second);
+
+    // a different node with a UUID that is already there doesn't replace the node that was added first
+    SharedNodePointer duplicate(new Node(first->getUUID(), NodeType::Agent, HifiSockAddr(), HifiSockAddr()));
+    duplicate->setLocalID(4);
+    QCOMPARE(registry.add(duplicate), first);
+    QCOMPARE(registry.add(first), first);
+    snapshot = registry.getSnapshot();
+    QCOMPARE(snapshot->size(), (size_t)2);
+    QCOMPARE(snapshot->nodeWithUUID(first->getUUID()), first);
+    QVERIFY(snapshot->nodeWithLocalID(4).isNull());
+
+    QVERIFY(registry.remove(first->getUUID()));
+    QVERIFY(!registry.remove(first->getUUID()));
+    snapshot = registry.getSnapshot();
+    QCOMPARE(snapshot->size(), (size_t)1);
+    QVERIFY(snapshot->nodeWithUUID(first->getUUID()).isNull());
+
+    auto removed = registry.removeIf([&](const SharedNodePointer& node) { return node == second; });
+    QCOMPARE(removed.size(), (size_t)1);
+    QCOMPARE(removed[0], second);
+
+    registry.add(first);
+    QCOMPARE(registry.clear().size(), (size_t)1);
+    QVERIFY(registry.getSnapshot()->empty());
+}
+
+void NodeRegistryTests::snapshotStabilityTest() {
+    NodeRegistry registry;
+    auto first = createNode(1);
+    registry.add(first);
+
+    auto snapshot = registry.getSnapshot();
+    auto generation = registry.getGeneration();
+
+    registry.add(createNode(2));
+    registry.remove(first->getUUID());
+
+    // the old snapshot still holds exactly what it held, the registry moved on
+    QCOMPARE(snapshot->size(), (size_t)1);
+    QCOMPARE(snapshot->nodeWithLocalID(1), first);
+    QVERIFY(registry.getGeneration() > generation);
+    QVERIFY(registry.getSnapshot()->nodeWithLocalID(1).isNull());
+    QVERIFY(!registry.getSnapshot()->nodeWithLocalID(2).isNull());
+}
+
+// what LimitedNodeList did before the registry, a recursive read/write lock around a hash
+class LockedNodeHash {
+public:
+    void add(const SharedNodePointer& node) {
+        QWriteLocker locker(&_lock);
+        _nodes.insert(node->getLocalID(), node);
+    }
+    void remove(Node::LocalID localID) {
+        QWriteLocker locker(&_lock);
+        _nodes.remove(localID);
+    }
+    SharedNodePointer nodeWithLocalID(Node::LocalID localID) {
+        QReadLocker locker(&_lock);
+        return _nodes.value(localID);
+    }
+    template<typename NodeLambda>
+    void eachNode(NodeLambda functor) {
+        QReadLocker locker(&_lock);
+        for (const auto& node : _nodes) {
+            functor(node);
+        }
+    }
+
+private:
+    QReadWriteLock _lock { QReadWriteLock::Recursive };
+    QHash<Node::LocalID, SharedNodePointer> _nodes;
+};
+
+const int NUM_NODES = 200;
+const int NUM_READERS = 8;
+const int READS_PER_READER = 200000;
+const int NODES_PER_ITERATION = 50; // one iteration over every node for this many lookups
+const int CHURN_NODES = 10; // the writer keeps adding and removing these
+
+// runs readers doing lookups and iterations while a writer churns nodes, returns the readers' wall time in usecs
+template<typename Add, typename Remove, typename Lookup, typename Iterate>
+static quint64 runContention(const std::vector<SharedNodePointer>& nodes, Add add, Remove remove,
+                             Lookup lookup, Iterate iterate, int& writesOut, int& foundOut) {
+    std::atomic<bool> readersDone { false };
+    std::atomic<int> found { 0 };
+    writesOut = 0;
+
+    std::thread writer([&] {
+        while (!readersDone.load()) {
+            for (int i = 0; i < CHURN_NODES; ++i) {
+                remove(nodes[i]);
+            }
+            for (int i = 0; i < CHURN_NODES; ++i) {
+                add(nodes[i]);
+            }
+            writesOut += 2 * CHURN_NODES;
+            std::this_thread::yield();
+        }
+    });
+
+    auto start = usecTimestampNow();
+    std::vector<std::thread> readers;
+    for (int r = 0; r < NUM_READERS; ++r) {
+        readers.emplace_back([&, r] {
+            int localFound = 0;
+            for (int i = 0; i < READS_PER_READER; ++i) {
+                if (i % NODES_PER_ITERATION == 0) {
+                    localFound += iterate();
+                } else if (lookup((Node::LocalID)(1 + (i * 7 + r) % NUM_NODES))) {
+                    ++localFound;
+                }
+            }
+            found += localFound;
+        });
+    }
+    for (auto& reader : readers) {
+        reader.join();
+    }
+    auto elapsed = usecTimestampNow() - start;
+
+    readersDone = true;
+    writer.join();
+
+    foundOut = found.load();
+    return elapsed;
+}
+
+void NodeRegistryTests::benchmarkContention() {
+    // the test keeps every node alive, so none is destroyed on a reader thread
+    std::vector<SharedNodePointer> nodes;
+    for (int i = 0; i < NUM_NODES; ++i) {
+        nodes.push_back(createNode((Node::LocalID)(i + 1)));
+    }
+
+    int lockedWrites = 0;
+    int lockedFound = 0;
+    LockedNodeHash locked;
+    for (const auto& node : nodes) {
+        locked.add(node);
+    }
+    quint64 lockedUsecs = runContention(nodes,
+        [&](const SharedNodePointer& node) { locked.add(node); },
+        [&](const SharedNodePointer& node) { locked.remove(node->getLocalID()); },
+        [&](Node::LocalID localID) { return !locked.nodeWithLocalID(localID).isNull(); },
+        [&] {
+            int count = 0;
+            locked.eachNode([&](const SharedNodePointer& node) { count += node->getLocalID() != 0; });
+            return count;
+        }, lockedWrites, lockedFound);
+
+    int registryWrites = 0;
+    int registryFound = 0;
+    NodeRegistry registry;
+    for (const auto& node : nodes) {
+        registry.add(node);
+    }
+    quint64 registryUsecs = runContention(nodes,
+        [&](const SharedNodePointer& node) { registry.add(node); },
+        [&](const SharedNodePointer& node) { registry.remove(node->getUUID()); },
+        [&](Node::LocalID localID) { return !registry.getSnapshot()->nodeWithLocalID(localID).isNull(); },
+        [&] {
+            int count = 0;
+            for (const auto& node : *registry.getSnapshot()) {
+                count += node->getLocalID() != 0;
+            }
+            return count;
+        }, registryWrites, registryFound);
+
+    QVERIFY(lockedFound > 0);
+    QVERIFY(registryFound > 0);
+    // the registry keeps its nodes across the churn
+    QCOMPARE(registry.getSnapshot()->size(), (size_t)NUM_NODES);
+
+    qDebug() << NUM_READERS << "readers," << READS_PER_READER << "reads each," << NUM_NODES << "nodes";
+    qDebug() << "QReadWriteLock hash:" << lockedUsecs << "usecs," << lockedWrites << "writes";
+    qDebug() << "NodeRegistry:" << registryUsecs << "usecs," << registryWrites << "writes";
+}
@@ -0,0 +1,30 @@
+//
+//  NodeRegistryTests.h
+//  tests/networking/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_NodeRegistryTests_h
+#define hifi_NodeRegistryTests_h
+
+#include <QtTest/QtTest>
+
+class NodeRegistryTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    // Test lookups and iteration across adds, re-indexing and removes
+    void addRemoveTest();
+
+    // Test that a snapshot does not change while the registry does
+    void snapshotStabilityTest();
+
+    // Compare reader throughput against a read/write locked hash, with a writer adding and removing nodes
+    void benchmarkContention();
+};
+
+#endif // hifi_NodeRegistryTests_h
@@ -0,0 +1,102 @@
+//
+//  EntityEncodeCacheTests.cpp
+//  tests/octree/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "EntityEncodeCacheTests.h"
+
+#include <EntityItem.h>
+#include <EntityItemProperties.h>
+#include <GLMHelpers.h>
+#include <Octree.h>
+#include <OctreePacketData.h>
+#include <ShapeEntityItem.h>
+
+QTEST_MAIN(EntityEncodeCacheTests)
+
+static EntityItemPointer makeEntity() {
+    EntityItemProperties properties;
+    properties.setType(EntityTypes::Box);
+    properties.setPosition(glm::vec3(1.0f, 2.0f, 3.0f));
+    EntityItemPointer entity = ShapeEntityItem::factory(EntityItemID(QUuid::createUuid()), properties);
+    entity->setSimulationOwner(QUuid::createUuid(), SCRIPT_GRAB_SIMULATION_PRIORITY);
+    entity->setVelocity(glm::vec3(0.0f, 1.0f, 0.0f));
+    return entity;
+}
+
+// encodes the entity on its own into a new packet, as it would be sent to one more node
+static QByteArray encode(const EntityItemPointer& entity, bool& cacheHit) {
+    OctreePacketData packetData;
+    EncodeBitstreamParams params;
+    auto appendState = entity->appendCachedEntityData(&packetData, params, nullptr, false, cacheHit);
+    if (appendState != OctreeElement::COMPLETED) {
+        return QByteArray();
+    }
+    return QByteArray((const char*)packetData.getUncompressedData(), packetData.getUncompressedSize());
+}
+
+// the encode that a node would get without the cache
+static QByteArray encodeUncached(const EntityItemPointer& entity) {
+    OctreePacketData packetData;
+    EncodeBitstreamParams params;
+    entity->appendEntityData(&packetData, params, nullptr, false);
+    return QByteArray((const char*)packetData.getUncompressedData(), packetData.getUncompressedSize());
+}
+
+void EntityEncodeCacheTests::reusesUnchangedEncode() {
+    EntityItemPointer entity = makeEntity();
+
+    bool cacheHit = true;
+    QByteArray first = encode(entity, cacheHit);
+    QVERIFY(!first.isEmpty());
+    QVERIFY(!cacheHit);
+
+    QByteArray second = encode(entity, cacheHit);
+    QVERIFY(cacheHit);
+    QCOMPARE(second, first);
+}
+
+void EntityEncodeCacheTests::reencodesAfterOwnershipChangedOnServer() {
+    EntityItemPointer entity = makeEntity();
+
+    bool cacheHit = false;
+    QByteArray owned = encode(entity, cacheHit);
+    encode(entity, cacheHit);
+    QVERIFY(cacheHit);
+
+    // as SimpleEntitySimulation does when an owner goes away, with no edit to bump the entity's timestamps
+    quint64 lastEdited = entity->getLastEdited();
+    entity->clearSimulationOwnership();
+    entity->markAsChangedOnServer();
+    QCOMPARE(entity->getLastEdited(), lastEdited);
+
+    QByteArray unowned = encode(entity, cacheHit);
+    QVERIFY(!cacheHit);
+    QVERIFY(unowned != owned);
+    QCOMPARE(unowned, encodeUncached(entity));
+}
+
+void EntityEncodeCacheTests::reencodesAfterVelocityChangedOnServer() {
+    EntityItemPointer entity = makeEntity();
+
+    bool cacheHit = false;
+    QByteArray moving = encode(entity, cacheHit);
+    encode(entity, cacheHit);
+    QVERIFY(cacheHit);
+
+    // as SimpleEntitySimulation does when it stops an entity that has no owner
+    entity->setVelocity(Vectors::ZERO);
+    entity->setAngularVelocity(Vectors::ZERO);
+    entity->setAcceleration(Vectors::ZERO);
+    entity->markAsChangedOnServer();
+
+    QByteArray stopped = encode(entity, cacheHit);
+    QVERIFY(!cacheHit);
+    QVERIFY(stopped != moving);
+    QCOMPARE(stopped, encodeUncached(entity));
+}
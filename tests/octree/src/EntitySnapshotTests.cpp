@@ -0,0 +1,174 @@
+//
+//  EntitySnapshotTests.cpp
+//  tests/octree/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "EntitySnapshotTests.h"
+
+#include <QtCore/QTemporaryDir>
+
+#include <AccountManager.h>
+#include <AddressManager.h>
+#include <EntityItemProperties.h>
+#include <EntitySnapshot.h>
+#include <EntityTree.h>
+#include <EntityTreeElement.h>
+#include <NodeList.h>
+#include <NumericalConstants.h>
+#include <ShapeEntityItem.h>
+#include <StatTracker.h>
+
+QTEST_MAIN(EntitySnapshotTests)
+
+void EntitySnapshotTests::initTestCase() {
+    // adding entities to a tree needs a node list
+    DependencyManager::registerInheritance<LimitedNodeList, NodeList>();
+    DependencyManager::set<StatTracker>();
+    DependencyManager::set<AccountManager>();
+    DependencyManager::set<AddressManager>();
+    DependencyManager::set<NodeList>(NodeType::EntityServer, INVALID_PORT);
+}
+
+static EntitySnapshot::Header testHeader() {
+    EntitySnapshot::Header header;
+    header.persistID = QUuid::createUuid();
+    header.dataVersion = 42;
+    header.sourceHash = QByteArray(EntitySnapshot::SOURCE_HASH_SIZE, 'h');
+    return header;
+}
+
+void EntitySnapshotTests::writeAndReadHeader() {
+    QTemporaryDir dir;
+    QString filename = dir.filePath("models.snapshot");
+
+    auto header = testHeader();
+    QVERIFY(EntitySnapshot::write(filename, header, {}));
+
+    EntitySnapshot::Header readHeader;
+    QVERIFY(EntitySnapshot::readHeader(filename, readHeader));
+    QCOMPARE(readHeader.persistID, header.persistID);
+    QCOMPARE(readHeader.dataVersion, header.dataVersion);
+    QCOMPARE(readHeader.numEntities, (quint64)0);
+    QCOMPARE(readHeader.sourceHash, header.sourceHash);
+}
+
+void EntitySnapshotTests::readEmpty() {
+    QTemporaryDir dir;
+    QString filename = dir.filePath("models.snapshot");
+
+    auto header = testHeader();
+    QVERIFY(EntitySnapshot::write(filename, header, {}));
+
+    EntitySnapshot::Header readHeader;
+    std::vector<EntityItemPointer> entities;
+    QVERIFY(EntitySnapshot::read(filename, readHeader, entities));
+    QCOMPARE(readHeader.persistID, header.persistID);
+    QVERIFY(entities.empty());
+}
+
+void EntitySnapshotTests::readKeepsPersistedMotion() {
+    QTemporaryDir dir;
+    QString filename = dir.filePath("models.snapshot");
+
+    // a moving entity that was last simulated well before the snapshot is read
+    EntityItemProperties properties;
+    properties.setType(EntityTypes::Box);
+    properties.setPosition(glm::vec3(1.0f, 2.0f, 3.0f));
+    EntityItemPointer entity = ShapeEntityItem::factory(EntityItemID(QUuid::createUuid()), properties);
+    entity->setVelocity(glm::vec3(0.0f, 1.0f, 0.0f));
+    entity->setLastSimulated(usecTimestampNow() - 10 * USECS_PER_SECOND);
+
+    QVERIFY(EntitySnapshot::write(filename, testHeader(), { entity }));
+
+    // the snapshot is read as the server's own data: no node list is needed and nothing is extrapolated
+    EntitySnapshot::Header readHeader;
+    std::vector<EntityItemPointer> entities;
+    QVERIFY(EntitySnapshot::read(filename, readHeader, entities));
+    QCOMPARE((int)entities.size(), 1);
+    QCOMPARE(entities[0]->getEntityItemID(), entity->getEntityItemID());
+    QCOMPARE(entities[0]->getWorldPosition(), entity->getWorldPosition());
+    QCOMPARE(entities[0]->getWorldVelocity(), entity->getWorldVelocity());
+}
+
+static EntityTreePointer createTree() {
+    EntityTreePointer tree = std::make_shared<EntityTree>(true);
+    tree->createRootElement();
+    tree->setIsServer(true);
+    return tree;
+}
+
+static QSet<QUuid> entityIDs(const EntityTreePointer& tree) {
+    QSet<QUuid> ids;
+    tree->withReadLock([&] {
+        tree->recurseTreeWithOperation([&](const OctreeElementPointer& element, void*) {
+            std::static_pointer_cast<EntityTreeElement>(element)->forEachEntity([&](const EntityItemPointer& entity) {
+                ids.insert(entity->getEntityItemID());
+            });
+            return true;
+        });
+    });
+    return ids;
+}
+
+void EntitySnapshotTests::skipsEntitiesWithBadParents() {
+    QTemporaryDir dir;
+    QString jsonFilename = dir.filePath("models.json.gz");
+    QString snapshotFilename = dir.filePath("models.snapshot");
+
+    // one entity without a parent and one whose parent can't be resolved
+    EntityTreePointer tree = createTree();
+    EntityItemProperties properties;
+    properties.setType(EntityTypes::Box);
+    properties.setPosition(glm::vec3(1.0f, 2.0f, 3.0f));
+    EntityItemID validID(QUuid::createUuid());
+    EntityItemID orphanID(QUuid::createUuid());
+    tree->withWriteLock([&] {
+        tree->addEntity(validID, properties);
+        properties.setParentID(QUuid::createUuid());
+        tree->addEntity(orphanID, properties);
+    });
+    QCOMPARE(entityIDs(tree).size(), 2);
+
+    QVERIFY(tree->writeToFile(jsonFilename.toLocal8Bit().constData()));
+    QVERIFY(tree->writeToSnapshotFile(snapshotFilename, QByteArray(EntitySnapshot::SOURCE_HASH_SIZE, 'h')));
+
+    // both formats load the same entities, without the orphan
+    EntityTreePointer fromJSON = createTree();
+    bool jsonRead = false;
+    fromJSON->withWriteLock([&] {
+        jsonRead = fromJSON->readFromFile(jsonFilename.toLocal8Bit().constData());
+    });
+    QVERIFY(jsonRead);
+
+    EntityTreePointer fromSnapshot = createTree();
+    bool snapshotRead = false;
+    fromSnapshot->withWriteLock([&] {
+        snapshotRead = fromSnapshot->readFromSnapshotFile(snapshotFilename);
+    });
+    QVERIFY(snapshotRead);
+
+    QSet<QUuid> expectedIDs { validID };
+    QCOMPARE(entityIDs(fromJSON), expectedIDs);
+    QCOMPARE(entityIDs(fromSnapshot), expectedIDs);
+}
+
+void EntitySnapshotTests::rejectsInvalidFile() {
+    QTemporaryDir dir;
+    QString filename = dir.filePath("models.snapshot");
+
+    QFile file(filename);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write(QByteArray(256, 'x'));
+    file.close();
+
+    EntitySnapshot::Header readHeader;
+    std::vector<EntityItemPointer> entities;
+    QVERIFY(!EntitySnapshot::readHeader(filename, readHeader));
+    QVERIFY(!EntitySnapshot::read(filename, readHeader, entities));
+    QVERIFY(!EntitySnapshot::readHeader(dir.filePath("missing.snapshot"), readHeader));
+}
@@ -0,0 +1,96 @@
+//
+//  OctreeJournalTests.cpp
+//  tests/octree/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "OctreeJournalTests.h"
+
+#include <QtCore/QTemporaryDir>
+
+#include <OctreeJournal.h>
+
+QTEST_MAIN(OctreeJournalTests)
+
+static OctreeJournal::Header testHeader() {
+    OctreeJournal::Header header;
+    header.persistID = QUuid::createUuid();
+    header.dataVersion = 42;
+    header.contentVersion = 7;
+    return header;
+}
+
+void OctreeJournalTests::appendAndRead() {
+    QTemporaryDir dir;
+    QString filename = dir.filePath("models.json.gz.journal");
+
+    auto header = testHeader();
+    OctreeJournal journal(filename);
+    QVERIFY(journal.reset(header));
+
+    QUuid updatedID = QUuid::createUuid();
+    QUuid deletedID = QUuid::createUuid();
+    QVERIFY(journal.append({ { OctreeJournal::RecordType::Update, updatedID, QByteArray("first") } }));
+    QVERIFY(journal.append({ { OctreeJournal::RecordType::Update, updatedID, QByteArray("second") },
+                             { OctreeJournal::RecordType::Delete, deletedID, QByteArray() } }));
+    QCOMPARE(journal.getNumRecords(), 3);
+    journal.close();
+
+    OctreeJournal::Header readHeader;
+    std::vector<OctreeJournal::Record> records;
+    QVERIFY(OctreeJournal::read(filename, readHeader, records));
+    QCOMPARE(readHeader.persistID, header.persistID);
+    QCOMPARE(readHeader.dataVersion, header.dataVersion);
+    QCOMPARE(readHeader.contentVersion, header.contentVersion);
+
+    QCOMPARE((int)records.size(), 3);
+    QCOMPARE(records[0].id, updatedID);
+    QCOMPARE(records[0].data, QByteArray("first"));
+    QCOMPARE(records[1].data, QByteArray("second"));
+    QCOMPARE(records[2].type, OctreeJournal::RecordType::Delete);
+    QCOMPARE(records[2].id, deletedID);
+}
+
+void OctreeJournalTests::resetTruncates() {
+    QTemporaryDir dir;
+    QString filename = dir.filePath("models.json.gz.journal");
+
+    OctreeJournal journal(filename);
+    QVERIFY(journal.reset(testHeader()));
+    QVERIFY(journal.append({ { OctreeJournal::RecordType::Delete, QUuid::createUuid(), QByteArray() } }));
+
+    auto header = testHeader();
+    QVERIFY(journal.reset(header));
+    journal.close();
+
+    OctreeJournal::Header readHeader;
+    std::vector<OctreeJournal::Record> records;
+    QVERIFY(OctreeJournal::read(filename, readHeader, records));
+    QCOMPARE(readHeader.persistID, header.persistID);
+    QVERIFY(records.empty());
+}
+
+void OctreeJournalTests::ignoresTornRecord() {
+    QTemporaryDir dir;
+    QString filename = dir.filePath("models.json.gz.journal");
+
+    OctreeJournal journal(filename);
+    QVERIFY(journal.reset(testHeader()));
+    QVERIFY(journal.append({ { OctreeJournal::RecordType::Update, QUuid::createUuid(), QByteArray("intact") } }));
+    QVERIFY(journal.append({ { OctreeJournal::RecordType::Update, QUuid::createUuid(), QByteArray("torn away") } }));
+    journal.close();
+
+    // lose the tail of the last record, as a crash mid-write would
+    QFile file(filename);
+    QVERIFY(file.resize(file.size() - 4));
+
+    OctreeJournal::Header readHeader;
+    std::vector<OctreeJournal::Record> records;
+    QVERIFY(OctreeJournal::read(filename, readHeader, records));
+    QCOMPARE((int)records.size(), 1);
+    QCOMPARE(records[0].data, QByteArray("intact"));
+}
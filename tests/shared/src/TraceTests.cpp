@@ -9,11 +9,17 @@
 #include "TraceTests.h"
 
 #include <QtTest/QtTest>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
 #include <QtGui/QDesktopServices>
 
 #include <Profile.h>
 
+#include <thread>
+
 #include <NumericalConstants.h>
+#include <shared/FileUtils.h>
 #include <test-utils/QTestExtensions.h>
 
 QTEST_MAIN(TraceTests)
@@ -45,3 +51,65 @@ void TraceTests::testTraceSerialization() {
     qDebug() << "Done";
 }
 
+void TraceTests::testThreadBuffers() {
+    const QString THREADS_OUTPUT_FILE = "traces/testThreadBuffers.json";
+    const int NUM_THREADS = 4;
+    const int RANGES_PER_THREAD = 1000;
+
+    auto tracer = DependencyManager::set<tracing::Tracer>();
+    tracer->startTracing();
+    std::vector<std::thread> threads;
+    for (int i = 0; i < NUM_THREADS; ++i) {
+        threads.emplace_back([&] {
+            for (int j = 0; j < RANGES_PER_THREAD; ++j) {
+                PROFILE_RANGE(test, "ThreadEvent");
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    tracer->stopTracing();
+    QCOMPARE(tracer->getDroppedEventCount(), (uint64_t)0);
+    tracer->serialize(THREADS_OUTPUT_FILE);
+
+    QFile file(FileUtils::computeDocumentPath(THREADS_OUTPUT_FILE));
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    auto events = QJsonDocument::fromJson(file.readAll()).array();
+
+    int numBegins = 0;
+    int numEnds = 0;
+    for (const auto& event : events) {
+        auto object = event.toObject();
+        if (object["name"].toString() == "ThreadEvent") {
+            if (object["ph"].toString() == "B") {
+                ++numBegins;
+            } else if (object["ph"].toString() == "E") {
+                ++numEnds;
+            }
+        }
+    }
+    QCOMPARE(numBegins, NUM_THREADS * RANGES_PER_THREAD);
+    QCOMPARE(numEnds, NUM_THREADS * RANGES_PER_THREAD);
+}
+
+// the path every range took before the per-thread buffers
+void TraceTests::benchmarkLockedEvents() {
+    auto tracer = DependencyManager::set<tracing::Tracer>();
+    tracer->startTracing();
+    QBENCHMARK {
+        QString name("BenchmarkEvent");
+        tracing::traceEvent(trace_test(), name, tracing::DurationBegin, "", { { "nv_payload", 0 } });
+        tracing::traceEvent(trace_test(), name, tracing::DurationEnd);
+    }
+    tracer->stopTracing();
+}
+
+void TraceTests::benchmarkProfileRange() {
+    auto tracer = DependencyManager::set<tracing::Tracer>();
+    tracer->startTracing();
+    QBENCHMARK {
+        PROFILE_RANGE(test, "BenchmarkEvent");
+    }
+    tracer->stopTracing();
+}
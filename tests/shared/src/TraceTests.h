@@ -15,6 +15,9 @@ class TraceTests : public QObject {
     Q_OBJECT
 private slots:
     void testTraceSerialization();
+    void testThreadBuffers();
+    void benchmarkLockedEvents();
+    void benchmarkProfileRange();
 };
 
 #endif // hifi_TraceTests_h
@@ -0,0 +1,241 @@
+//
+//  TriangleSetTests.cpp
+//  tests/shared/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "TriangleSetTests.h"
+
+#include <random>
+
+#include <GLMHelpers.h>
+#include <NumericalConstants.h>
+#include <TriangleSet.h>
+
+#include <test-utils/QTestExtensions.h>
+
+QTEST_MAIN(TriangleSetTests)
+
+static const int NUM_RINGS = 48;
+static const int NUM_SEGMENTS = 48;
+static const glm::vec3 AVATAR_CENTER { 0.0f, 0.9f, 0.0f };
+static const float PICK_DISTANCE = 3.0f; // meters from the avatar that picks start
+static const float MAX_DISTANCE_ERROR = 1.0e-4f;
+
+// an ellipsoid tessellated the way an exported mesh would be, facing out
+static void addEllipsoid(std::vector<Triangle>& triangles, const glm::vec3& center, const glm::vec3& radii) {
+    auto pointAt = [&](int ring, int segment) {
+        float latitude = PI * ring / NUM_RINGS;
+        float longitude = TWO_PI * segment / NUM_SEGMENTS;
+        return center + radii * glm::vec3(sinf(latitude) * cosf(longitude), cosf(latitude), sinf(latitude) * sinf(longitude));
+    };
+    auto addTriangle = [&](const glm::vec3& v0, const glm::vec3& v1, const glm::vec3& v2) {
+        Triangle triangle { v0, v1, v2 };
+        if (glm::dot(glm::cross(v1 - v0, v2 - v0), (v0 + v1 + v2) / 3.0f - center) < 0.0f) {
+            std::swap(triangle.v1, triangle.v2);
+        }
+        triangles.push_back(triangle);
+    };
+
+    for (int ring = 0; ring < NUM_RINGS; ring++) {
+        for (int segment = 0; segment < NUM_SEGMENTS; segment++) {
+            glm::vec3 corners[] = { pointAt(ring, segment), pointAt(ring + 1, segment),
+                                    pointAt(ring + 1, segment + 1), pointAt(ring, segment + 1) };
+            if (ring > 0) {
+                addTriangle(corners[0], corners[2], corners[3]);
+            }
+            if (ring < NUM_RINGS - 1) {
+                addTriangle(corners[0], corners[1], corners[2]);
+            }
+        }
+    }
+}
+
+// The shared library can't read model files, so this stands in for an avatar mesh: a body made of overlapping
+// parts with about as many triangles as a typical avatar, most of them small and tightly clustered.
+static std::vector<Triangle> createAvatarMesh() {
+    std::vector<Triangle> triangles;
+    addEllipsoid(triangles, { 0.0f, 1.65f, 0.0f }, { 0.1f, 0.12f, 0.11f }); // head
+    addEllipsoid(triangles, { 0.0f, 1.5f, 0.0f }, { 0.05f, 0.06f, 0.05f }); // neck
+    addEllipsoid(triangles, { 0.0f, 1.2f, 0.0f }, { 0.2f, 0.3f, 0.12f }); // torso
+    addEllipsoid(triangles, { 0.0f, 0.9f, 0.0f }, { 0.18f, 0.12f, 0.11f }); // hips
+    for (float side : { -1.0f, 1.0f }) {
+        addEllipsoid(triangles, { side * 0.35f, 1.3f, 0.0f }, { 0.15f, 0.05f, 0.05f }); // upper arm
+        addEllipsoid(triangles, { side * 0.62f, 1.3f, 0.0f }, { 0.14f, 0.04f, 0.04f }); // forearm
+        addEllipsoid(triangles, { side * 0.8f, 1.3f, 0.0f }, { 0.06f, 0.02f, 0.04f }); // hand
+        addEllipsoid(triangles, { side * 0.1f, 0.6f, 0.0f }, { 0.07f, 0.22f, 0.07f }); // thigh
+        addEllipsoid(triangles, { side * 0.1f, 0.22f, 0.0f }, { 0.05f, 0.2f, 0.05f }); // shin
+        addEllipsoid(triangles, { side * 0.1f, 0.03f, 0.06f }, { 0.05f, 0.03f, 0.12f }); // foot
+    }
+    return triangles;
+}
+
+struct Pick {
+    glm::vec3 origin;
+    glm::vec3 direction;
+    bool allowBackface;
+};
+
+// picks from all around the avatar, toward random points in its bounds
+static std::vector<Pick> createPicks(const AABox& bounds, int numPicks) {
+    std::mt19937 random(numPicks);
+    std::uniform_real_distribution<float> unitDistribution(0.0f, 1.0f);
+    std::normal_distribution<float> normalDistribution;
+
+    std::vector<Pick> picks;
+    for (int i = 0; i < numPicks; i++) {
+        glm::vec3 offset(normalDistribution(random), normalDistribution(random), normalDistribution(random));
+        glm::vec3 origin = AVATAR_CENTER + glm::normalize(offset) * PICK_DISTANCE;
+        glm::vec3 target = bounds.getCorner() + bounds.getDimensions() *
+            glm::vec3(unitDistribution(random), unitDistribution(random), unitDistribution(random));
+        picks.push_back({ origin, glm::normalize(target - origin), i % 2 == 1 });
+    }
+    return picks;
+}
+
+static bool findRayIntersectionLinearly(const std::vector<Triangle>& triangles, const Pick& pick, float& distance) {
+    distance = FLT_MAX;
+    for (const auto& triangle : triangles) {
+        float triangleDistance;
+        if (findRayTriangleIntersection(pick.origin, pick.direction, triangle, triangleDistance, pick.allowBackface)) {
+            distance = std::min(distance, triangleDistance);
+        }
+    }
+    return distance < FLT_MAX;
+}
+
+static bool findParabolaIntersectionLinearly(const std::vector<Triangle>& triangles, const Pick& pick,
+                                             const glm::vec3& acceleration, float& parabolicDistance) {
+    parabolicDistance = FLT_MAX;
+    for (const auto& triangle : triangles) {
+        float triangleDistance;
+        if (findParabolaTriangleIntersection(pick.origin, pick.direction, acceleration, triangle, triangleDistance,
+                                             pick.allowBackface)) {
+            parabolicDistance = std::min(parabolicDistance, triangleDistance);
+        }
+    }
+    return parabolicDistance < FLT_MAX;
+}
+
+static TriangleSet createTriangleSet(const std::vector<Triangle>& triangles) {
+    TriangleSet triangleSet;
+    triangleSet.reserve(triangles.size());
+    for (const auto& triangle : triangles) {
+        triangleSet.insert(triangle);
+    }
+    triangleSet.balanceTree();
+    return triangleSet;
+}
+
+void TriangleSetTests::testRayMatchesLinearSearch() {
+    auto triangles = createAvatarMesh();
+    auto triangleSet = createTriangleSet(triangles);
+
+    int numHits = 0;
+    for (const auto& pick : createPicks(triangleSet.getBounds(), 1000)) {
+        float expectedDistance;
+        bool expectedHit = findRayIntersectionLinearly(triangles, pick, expectedDistance);
+
+        float distance = FLT_MAX;
+        BoxFace face;
+        Triangle triangle;
+        bool hit = triangleSet.findRayIntersection(pick.origin, pick.direction, 1.0f / pick.direction, distance, face,
+                                                   triangle, true, pick.allowBackface);
+        QCOMPARE(hit, expectedHit);
+        if (hit) {
+            QCOMPARE_WITH_ABS_ERROR(distance, expectedDistance, MAX_DISTANCE_ERROR);
+
+            float triangleDistance;
+            QVERIFY(findRayTriangleIntersection(pick.origin, pick.direction, triangle, triangleDistance, pick.allowBackface));
+            QCOMPARE_WITH_ABS_ERROR(triangleDistance, distance, MAX_DISTANCE_ERROR);
+            numHits++;
+        }
+    }
+    QVERIFY(numHits > 0);
+}
+
+void TriangleSetTests::testParabolaMatchesLinearSearch() {
+    auto triangles = createAvatarMesh();
+    auto triangleSet = createTriangleSet(triangles);
+    const glm::vec3 acceleration { 0.0f, -0.5f, 0.0f };
+
+    int numHits = 0;
+    for (const auto& pick : createPicks(triangleSet.getBounds(), 100)) {
+        float expectedDistance;
+        bool expectedHit = findParabolaIntersectionLinearly(triangles, pick, acceleration, expectedDistance);
+
+        float parabolicDistance = FLT_MAX;
+        BoxFace face;
+        Triangle triangle;
+        bool hit = triangleSet.findParabolaIntersection(pick.origin, pick.direction, acceleration, parabolicDistance, face,
+                                                        triangle, true, pick.allowBackface);
+        QCOMPARE(hit, expectedHit);
+        if (hit) {
+            QCOMPARE_WITH_ABS_ERROR(parabolicDistance, expectedDistance, MAX_DISTANCE_ERROR);
+            numHits++;
+        }
+    }
+    QVERIFY(numHits > 0);
+}
+
+void TriangleSetTests::testEmptyAndSmallSets() {
+    const glm::vec3 origin { 0.0f, 0.0f, 1.0f };
+    const glm::vec3 direction { 0.0f, 0.0f, -1.0f };
+    float distance = FLT_MAX;
+    BoxFace face;
+    Triangle triangle;
+
+    TriangleSet triangleSet;
+    QCOMPARE(triangleSet.findRayIntersection(origin, direction, 1.0f / direction, distance, face, triangle, true), false);
+
+    // a single triangle facing the ray, and one behind it facing away
+    triangleSet.insert({ { -1.0f, -1.0f, 0.0f }, { 1.0f, -1.0f, 0.0f }, { 0.0f, 1.0f, 0.0f } });
+    triangleSet.insert({ { -1.0f, -1.0f, -1.0f }, { 0.0f, 1.0f, -1.0f }, { 1.0f, -1.0f, -1.0f } });
+    QCOMPARE(triangleSet.findRayIntersection(origin, direction, 1.0f / direction, distance, face, triangle, true), true);
+    QCOMPARE_WITH_ABS_ERROR(distance, 1.0f, EPSILON);
+
+    // from between the two, only the back face is ahead
+    const glm::vec3 between { 0.0f, 0.0f, -0.5f };
+    distance = FLT_MAX;
+    QCOMPARE(triangleSet.findRayIntersection(between, direction, 1.0f / direction, distance, face, triangle, true), false);
+    QCOMPARE(triangleSet.findRayIntersection(between, direction, 1.0f / direction, distance, face, triangle, true, true), true);
+    QCOMPARE_WITH_ABS_ERROR(distance, 0.5f, EPSILON);
+
+    triangleSet.clear();
+    QCOMPARE(triangleSet.findRayIntersection(origin, direction, 1.0f / direction, distance, face, triangle, true), false);
+}
+
+void TriangleSetTests::benchmarkRayIntersection() {
+    auto triangleSet = createTriangleSet(createAvatarMesh());
+    auto picks = createPicks(triangleSet.getBounds(), 1000);
+
+    QBENCHMARK {
+        for (const auto& pick : picks) {
+            float distance = FLT_MAX;
+            BoxFace face;
+            Triangle triangle;
+            triangleSet.findRayIntersection(pick.origin, pick.direction, 1.0f / pick.direction, distance, face, triangle,
+                                            true, pick.allowBackface);
+        }
+    }
+}
+
+void TriangleSetTests::benchmarkParabolaIntersection() {
+    auto triangleSet = createTriangleSet(createAvatarMesh());
+    auto picks = createPicks(triangleSet.getBounds(), 1000);
+    const glm::vec3 acceleration { 0.0f, -0.5f, 0.0f };
+
+    QBENCHMARK {
+        for (const auto& pick : picks) {
+            float parabolicDistance = FLT_MAX;
+            BoxFace face;
+            Triangle triangle;
+            triangleSet.findParabolaIntersection(pick.origin, pick.direction, acceleration, parabolicDistance, face,
+                                                 triangle, true, pick.allowBackface);
+        }
+    }
+}
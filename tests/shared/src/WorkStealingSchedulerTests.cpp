@@ -0,0 +1,179 @@
+//
+//  WorkStealingSchedulerTests.cpp
+//  tests/shared/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "WorkStealingSchedulerTests.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <shared/WorkStealingScheduler.h>
+
+QTEST_MAIN(WorkStealingSchedulerTests)
+
+static const int NUM_WORKERS = 3;
+
+static WorkStealingScheduler::Job countingJob(std::vector<std::atomic<int>>& counts, size_t chunkSize) {
+    WorkStealingScheduler::Job job;
+    job.numItems = counts.size();
+    job.chunkSize = chunkSize;
+    job.maxParticipants = NUM_WORKERS + 1;
+    job.process = [&counts](int participant, size_t first, size_t last) {
+        for (size_t i = first; i < last; ++i) {
+            ++counts[i];
+        }
+    };
+    return job;
+}
+
+void WorkStealingSchedulerTests::testEveryItemOnce() {
+    WorkStealingScheduler scheduler(NUM_WORKERS);
+    QCOMPARE(scheduler.getMaxParticipants(), NUM_WORKERS + 1);
+
+    for (size_t numItems : { 1, 2, 7, 100, 1001 }) {
+        for (size_t chunkSize : { 1, 3, 64 }) {
+            std::vector<std::atomic<int>> counts(numItems);
+            for (auto& count : counts) {
+                count = 0;
+            }
+
+            auto stats = scheduler.run(countingJob(counts, chunkSize));
+
+            for (auto& count : counts) {
+                QCOMPARE(count.load(), 1);
+            }
+            QCOMPARE(stats.numJobs, 1);
+            QVERIFY(stats.numParticipants >= 1);
+            QVERIFY(stats.numParticipants <= NUM_WORKERS + 1);
+            QVERIFY((size_t)stats.numChunks >= (numItems + chunkSize - 1) / chunkSize);
+        }
+    }
+}
+
+void WorkStealingSchedulerTests::testParticipantHooks() {
+    WorkStealingScheduler scheduler(NUM_WORKERS);
+
+    const size_t NUM_ITEMS = 1000;
+    std::vector<std::atomic<int>> counts(NUM_ITEMS);
+    for (auto& count : counts) {
+        count = 0;
+    }
+
+    // a participant runs on one thread for the whole job, between its begin and end
+    std::vector<std::thread::id> threads(NUM_WORKERS + 1);
+    std::vector<int> begins(NUM_WORKERS + 1, 0);
+    std::vector<int> ends(NUM_WORKERS + 1, 0);
+    std::atomic<bool> sameThread { true };
+
+    auto job = countingJob(counts, 4);
+    auto process = job.process;
+    job.begin = [&](int participant) {
+        threads[participant] = std::this_thread::get_id();
+        ++begins[participant];
+    };
+    job.process = [&](int participant, size_t first, size_t last) {
+        if (threads[participant] != std::this_thread::get_id() || begins[participant] != 1 || ends[participant] != 0) {
+            sameThread = false;
+        }
+        process(participant, first, last);
+    };
+    job.end = [&](int participant) {
+        ++ends[participant];
+    };
+
+    scheduler.run(job);
+
+    QVERIFY(sameThread);
+    QCOMPARE(begins[0], 1); // the calling thread always has work first
+    QCOMPARE(threads[0], std::this_thread::get_id());
+    for (int i = 0; i <= NUM_WORKERS; ++i) {
+        QCOMPARE(begins[i], ends[i]);
+    }
+    for (auto& count : counts) {
+        QCOMPARE(count.load(), 1);
+    }
+}
+
+void WorkStealingSchedulerTests::testUnevenWork() {
+    WorkStealingScheduler scheduler(NUM_WORKERS);
+
+    // all of the cost is in the first participant's slot, the others have to steal it
+    const size_t NUM_ITEMS = 64;
+    std::vector<std::atomic<int>> counts(NUM_ITEMS);
+    for (auto& count : counts) {
+        count = 0;
+    }
+
+    auto job = countingJob(counts, 1);
+    auto process = job.process;
+    job.process = [&](int participant, size_t first, size_t last) {
+        if (first < NUM_ITEMS / (NUM_WORKERS + 1)) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        }
+        process(participant, first, last);
+    };
+
+    auto stats = scheduler.run(job);
+
+    for (auto& count : counts) {
+        QCOMPARE(count.load(), 1);
+    }
+    if (stats.numParticipants > 1) {
+        QVERIFY(stats.numSteals > 0);
+    }
+}
+
+void WorkStealingSchedulerTests::testConcurrentJobs() {
+    WorkStealingScheduler scheduler(NUM_WORKERS);
+
+    const size_t NUM_ITEMS = 5000;
+    const int NUM_ROUNDS = 50;
+    std::vector<std::atomic<int>> firstCounts(NUM_ITEMS);
+    std::vector<std::atomic<int>> secondCounts(NUM_ITEMS);
+    for (size_t i = 0; i < NUM_ITEMS; ++i) {
+        firstCounts[i] = 0;
+        secondCounts[i] = 0;
+    }
+
+    // two pools submitting from their own threads share the workers
+    std::thread other([&] {
+        for (int round = 0; round < NUM_ROUNDS; ++round) {
+            scheduler.run(countingJob(secondCounts, 8));
+        }
+    });
+    for (int round = 0; round < NUM_ROUNDS; ++round) {
+        scheduler.run(countingJob(firstCounts, 8));
+    }
+    other.join();
+
+    for (size_t i = 0; i < NUM_ITEMS; ++i) {
+        QCOMPARE(firstCounts[i].load(), NUM_ROUNDS);
+        QCOMPARE(secondCounts[i].load(), NUM_ROUNDS);
+    }
+}
+
+void WorkStealingSchedulerTests::testNoWorkers() {
+    WorkStealingScheduler scheduler(0);
+    QCOMPARE(scheduler.getMaxParticipants(), 1);
+
+    std::vector<std::atomic<int>> counts(100);
+    for (auto& count : counts) {
+        count = 0;
+    }
+
+    auto stats = scheduler.run(countingJob(counts, 7));
+
+    for (auto& count : counts) {
+        QCOMPARE(count.load(), 1);
+    }
+    QCOMPARE(stats.numParticipants, 1);
+    QCOMPARE(stats.numSteals, 0);
+    QCOMPARE(stats.dispatchUsecs, (uint64_t)0);
+}
@@ -0,0 +1,27 @@
+//
+//  WorkStealingSchedulerTests.h
+//  tests/shared/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_WorkStealingSchedulerTests_h
+#define hifi_WorkStealingSchedulerTests_h
+
+#include <QtTest/QtTest>
+
+class WorkStealingSchedulerTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void testEveryItemOnce();
+    void testParticipantHooks();
+    void testUnevenWork();
+    void testConcurrentJobs();
+    void testNoWorkers();
+};
+
+#endif // hifi_WorkStealingSchedulerTests_h
@@ -0,0 +1,173 @@
+//
+//  SpaceRegionTests.cpp
+//  tests/workload/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "SpaceRegionTests.h"
+
+#include <workload/Space.h>
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
+
+QTEST_MAIN(SpaceRegionTests)
+
+const float WORLD_WIDTH = 1000.0f;
+const float MIN_RADIUS = 0.1f;
+const float MAX_RADIUS = 20.0f;
+
+static float randomFloat() {
+    return 2.0f * ((float)rand() / (float)RAND_MAX) - 1.0f;
+}
+
+static workload::Sphere randomSphere() {
+    float radius = MIN_RADIUS + (MAX_RADIUS - MIN_RADIUS) * 0.5f * (randomFloat() + 1.0f);
+    return workload::Sphere(WORLD_WIDTH * randomFloat(), WORLD_WIDTH * randomFloat(), WORLD_WIDTH * randomFloat(), radius);
+}
+
+// views scattered over the world, with regions big enough that proxies land in all of them
+static workload::Views randomViews(uint32_t numViews) {
+    workload::Views views;
+    for (uint32_t i = 0; i < numViews; ++i) {
+        workload::View view;
+        view.origin = 0.5f * WORLD_WIDTH * glm::vec3(randomFloat(), randomFloat(), randomFloat());
+        view.direction = glm::normalize(glm::vec3(randomFloat(), 0.0f, randomFloat()) + glm::vec3(0.0f, 0.0f, -0.01f));
+        float distances[] = { 1.0f, 50.0f, 1.0f, 150.0f, 1.0f, 400.0f };
+        workload::View::updateRegionsFromBackFrontDistances(view, distances);
+        views.push_back(view);
+    }
+    return views;
+}
+
+static void resetProxies(workload::Space& space, const std::vector<workload::Sphere>& spheres) {
+    workload::Transaction transaction;
+    for (const auto& sphere : spheres) {
+        transaction.reset(space.allocateID(), sphere, workload::Owner());
+    }
+    space.enqueueTransaction(transaction);
+    space.enqueueFrame();
+    space.processTransactionQueue();
+}
+
+static void updateProxies(workload::Space& space, const workload::Transaction::Updates& updates) {
+    workload::Transaction transaction;
+    transaction.update(updates);
+    space.enqueueTransaction(transaction);
+    space.enqueueFrame();
+    space.processTransactionQueue();
+}
+
+static bool changesMatch(const workload::Changes& a, const workload::Changes& b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (a[i].proxyId != b[i].proxyId || a[i].region != b[i].region || a[i].prevRegion != b[i].prevRegion) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void SpaceRegionTests::testSIMDMatchesScalar() {
+    srand(1);
+    const uint32_t NUM_PROXIES = 10007; // not a multiple of the vector width
+    std::vector<workload::Sphere> spheres;
+    for (uint32_t i = 0; i < NUM_PROXIES; ++i) {
+        spheres.push_back(randomSphere());
+    }
+
+    workload::Space scalarSpace;
+    scalarSpace.setSIMDEnabled(false);
+    workload::Space simdSpace;
+
+    resetProxies(scalarSpace, spheres);
+    resetProxies(simdSpace, spheres);
+
+    for (uint32_t numViews = 1; numViews <= 3; ++numViews) {
+        auto views = randomViews(numViews);
+        scalarSpace.setViews(views);
+        simdSpace.setViews(views);
+
+        workload::Changes scalarChanges;
+        workload::Changes simdChanges;
+        scalarSpace.categorizeAndGetChanges(scalarChanges);
+        simdSpace.categorizeAndGetChanges(simdChanges);
+        QVERIFY(!scalarChanges.empty());
+        QVERIFY(changesMatch(scalarChanges, simdChanges));
+
+        // move a tenth of the proxies
+        workload::Transaction::Updates updates;
+        for (uint32_t i = 0; i < NUM_PROXIES; i += 10) {
+            updates.emplace_back(i, randomSphere());
+        }
+        updateProxies(scalarSpace, updates);
+        updateProxies(simdSpace, updates);
+
+        scalarChanges.clear();
+        simdChanges.clear();
+        scalarSpace.categorizeAndGetChanges(scalarChanges);
+        simdSpace.categorizeAndGetChanges(simdChanges);
+        QVERIFY(changesMatch(scalarChanges, simdChanges));
+    }
+
+    for (uint32_t i = 0; i < NUM_PROXIES; ++i) {
+        QCOMPARE(scalarSpace.getRegion(i), simdSpace.getRegion(i));
+    }
+}
+
+void SpaceRegionTests::benchmarkCategorize() {
+    srand(2);
+    const uint32_t NUM_PROXIES = 100000;
+    const uint32_t NUM_VIEWS = 3;
+    const int NUM_FRAMES = 20;
+
+    std::vector<workload::Sphere> spheres;
+    for (uint32_t i = 0; i < NUM_PROXIES; ++i) {
+        spheres.push_back(randomSphere());
+    }
+    std::vector<workload::Views> frameViews;
+    for (int i = 0; i < NUM_FRAMES; ++i) {
+        frameViews.push_back(randomViews(NUM_VIEWS));
+    }
+
+    struct Mode {
+        const char* name;
+        bool isSIMDEnabled;
+        bool isThreadingEnabled;
+    };
+    const Mode MODES[] = { { "scalar", false, false }, { "simd", true, false }, { "simd + threads", true, true } };
+
+    workload::Changes referenceChanges;
+    for (const auto& mode : MODES) {
+        workload::Space space;
+        space.setSIMDEnabled(mode.isSIMDEnabled);
+        space.setThreadingEnabled(mode.isThreadingEnabled);
+        resetProxies(space, spheres);
+
+        // every frame the views move, so every proxy is retested
+        workload::Changes allChanges;
+        workload::Changes changes;
+        auto start = usecTimestampNow();
+        for (const auto& views : frameViews) {
+            space.setViews(views);
+            changes.clear();
+            space.categorizeAndGetChanges(changes);
+            allChanges.insert(allChanges.end(), changes.begin(), changes.end());
+        }
+        auto duration = usecTimestampNow() - start;
+
+        qDebug() << mode.name << ":" << NUM_PROXIES << "proxies," << NUM_VIEWS << "views,"
+            << (float)duration / NUM_FRAMES << "usecs per frame," << allChanges.size() << "changes";
+
+        if (referenceChanges.empty()) {
+            referenceChanges = std::move(allChanges);
+        } else {
+            QVERIFY(changesMatch(referenceChanges, allChanges));
+        }
+    }
+}
@@ -0,0 +1,24 @@
+//
+//  SpaceRegionTests.h
+//  tests/workload/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_workload_SpaceRegionTests_h
+#define hifi_workload_SpaceRegionTests_h
+
+#include <QtTest/QtTest>
+
+class SpaceRegionTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void testSIMDMatchesScalar();
+    void benchmarkCategorize();
+};
+
+#endif // hifi_workload_SpaceRegionTests_h
@@ -0,0 +1,271 @@
+//
+//  AvatarLoadApp.cpp
+//  tools/avatar-load-client/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AvatarLoadApp.h"
+
+#include <algorithm>
+
+#include <QCommandLineParser>
+#include <QLoggingCategory>
+
+#include <DomainHandler.h>
+#include <NetworkLogging.h>
+#include <NumericalConstants.h>
+#include <SharedLogging.h>
+
+static const int UPDATE_INTERVAL_MSECS = 5;
+static const int DEFAULT_NUM_AVATARS = 100;
+static const float DEFAULT_AVATARS_PER_SECOND = 50.0f;
+static const int DEFAULT_REPORT_SECONDS = 5;
+
+// p50/p95/p99 and max of the samples, which are consumed
+static QString percentiles(std::vector<float>& samples) {
+    if (samples.empty()) {
+        return "no samples";
+    }
+
+    auto valueAt = [&](float fraction) {
+        auto nth = samples.begin() + std::min(samples.size() - 1, (size_t)(fraction * samples.size()));
+        std::nth_element(samples.begin(), nth, samples.end());
+        return *nth;
+    };
+
+    QString result = QString("p50 %1 p95 %2 p99 %3 max %4 ms (%5 samples)")
+        .arg(valueAt(0.5f), 0, 'f', 2)
+        .arg(valueAt(0.95f), 0, 'f', 2)
+        .arg(valueAt(0.99f), 0, 'f', 2)
+        .arg(*std::max_element(samples.begin(), samples.end()), 0, 'f', 2)
+        .arg(samples.size());
+    samples.clear();
+    return result;
+}
+
+AvatarLoadApp::AvatarLoadApp(int argc, char* argv[]) :
+    QCoreApplication(argc, argv)
+{
+    QCommandLineParser parser;
+    parser.setApplicationDescription("High Fidelity avatar load client - connects many simulated avatars to a domain. "
+        "Each avatar has its own UDP socket, so raise the open file limit to match the number of avatars.");
+
+    const QCommandLineOption helpOption = parser.addHelpOption();
+
+    const QCommandLineOption verboseOutput("v", "verbose output");
+    parser.addOption(verboseOutput);
+
+    const QCommandLineOption domainAddressOption("d", "domain-server address", "host:port",
+                                                 QString("127.0.0.1:%1").arg(DEFAULT_DOMAIN_SERVER_PORT));
+    parser.addOption(domainAddressOption);
+
+    const QCommandLineOption numAvatarsOption("n", "number of avatars", "count", QString::number(DEFAULT_NUM_AVATARS));
+    parser.addOption(numAvatarsOption);
+
+    const QCommandLineOption rampOption("ramp", "avatars added per second", "rate",
+                                        QString::number(DEFAULT_AVATARS_PER_SECOND));
+    parser.addOption(rampOption);
+
+    const QCommandLineOption durationOption("duration", "seconds to run for, 0 to run until stopped", "seconds", "0");
+    parser.addOption(durationOption);
+
+    const QCommandLineOption reportOption("report", "seconds between reports", "seconds",
+                                          QString::number(DEFAULT_REPORT_SECONDS));
+    parser.addOption(reportOption);
+
+    const QCommandLineOption originOption("origin", "center of the spawn area", "x,y,z", "0,0,0");
+    parser.addOption(originOption);
+
+    const QCommandLineOption spreadOption("spread", "side of the square spawn area, meters", "meters",
+                                          QString::number(_settings.spread));
+    parser.addOption(spreadOption);
+
+    const QCommandLineOption pathOption("path", "how avatars move: stationary, circle or wander", "path", "circle");
+    parser.addOption(pathOption);
+
+    const QCommandLineOption radiusOption("radius", "radius of the circle path, meters", "meters",
+                                          QString::number(_settings.pathRadius));
+    parser.addOption(radiusOption);
+
+    const QCommandLineOption speedOption("speed", "walking speed, meters per second", "speed",
+                                         QString::number(_settings.walkSpeed));
+    parser.addOption(speedOption);
+
+    const QCommandLineOption viewRadiusOption("view-radius", "how far avatars ask to see others, meters", "meters",
+                                              QString::number(_settings.viewRadius));
+    parser.addOption(viewRadiusOption);
+
+    const QCommandLineOption audioOption("audio", "microphone audio: none, tone or recording", "audio", "tone");
+    parser.addOption(audioOption);
+
+    const QCommandLineOption talkOption("talk", "fraction of the time tone avatars talk", "ratio",
+                                        QString::number(_settings.talkRatio));
+    parser.addOption(talkOption);
+
+    const QCommandLineOption recordingOption("recording", "recording (.hfr) whose joints, and audio, avatars replay",
+                                             "file");
+    parser.addOption(recordingOption);
+
+    if (!parser.parse(QCoreApplication::arguments())) {
+        qCritical() << parser.errorText() << endl;
+        parser.showHelp();
+        Q_UNREACHABLE();
+    }
+
+    if (parser.isSet(helpOption)) {
+        parser.showHelp();
+        Q_UNREACHABLE();
+    }
+
+    if (!parser.isSet(verboseOutput)) {
+        const_cast<QLoggingCategory*>(&networking())->setEnabled(QtDebugMsg, false);
+        const_cast<QLoggingCategory*>(&networking())->setEnabled(QtInfoMsg, false);
+
+        const_cast<QLoggingCategory*>(&shared())->setEnabled(QtDebugMsg, false);
+        const_cast<QLoggingCategory*>(&shared())->setEnabled(QtInfoMsg, false);
+
+        QLoggingCategory::setFilterRules("hifi.avatars.debug=false");
+    }
+
+    QStringList domainAddress = parser.value(domainAddressOption).split(":");
+    quint16 domainPort = domainAddress.size() > 1 ? domainAddress[1].toUShort() : DEFAULT_DOMAIN_SERVER_PORT;
+    _domainSockAddr = HifiSockAddr(domainAddress[0], domainPort, true);
+    if (_domainSockAddr.getAddress().isNull()) {
+        qCritical() << "Could not resolve domain-server address" << parser.value(domainAddressOption);
+        parser.showHelp(1);
+    }
+
+    _numAvatars = std::max(parser.value(numAvatarsOption).toInt(), 0);
+    _avatarsPerSecond = std::max(parser.value(rampOption).toFloat(), 1.0f);
+    _durationUsecs = parser.value(durationOption).toULongLong() * USECS_PER_SECOND;
+
+    QStringList origin = parser.value(originOption).split(",");
+    if (origin.size() == 3) {
+        _settings.origin = glm::vec3(origin[0].toFloat(), origin[1].toFloat(), origin[2].toFloat());
+    }
+    _settings.spread = parser.value(spreadOption).toFloat();
+    _settings.pathRadius = parser.value(radiusOption).toFloat();
+    _settings.walkSpeed = parser.value(speedOption).toFloat();
+    _settings.viewRadius = parser.value(viewRadiusOption).toFloat();
+    _settings.talkRatio = glm::clamp(parser.value(talkOption).toFloat(), 0.0f, 1.0f);
+
+    QString path = parser.value(pathOption);
+    if (path == "stationary") {
+        _settings.path = AvatarPath::Stationary;
+    } else if (path == "wander") {
+        _settings.path = AvatarPath::Wander;
+    } else {
+        _settings.path = AvatarPath::Circle;
+    }
+
+    if (parser.isSet(recordingOption)) {
+        _settings.track = AvatarLoadTrack::fromFile(parser.value(recordingOption));
+        if (!_settings.track) {
+            parser.showHelp(1);
+        }
+    }
+
+    QString audio = parser.value(audioOption);
+    if (audio == "none") {
+        _settings.audio = AvatarAudio::None;
+    } else if (audio == "recording") {
+        if (!_settings.track || _settings.track->getAudio().empty()) {
+            qCritical() << "--audio recording needs a --recording with audio in it";
+            parser.showHelp(1);
+        }
+        _settings.audio = AvatarAudio::Recording;
+    } else {
+        _settings.audio = AvatarAudio::Tone;
+    }
+
+    qDebug() << "Connecting" << _numAvatars << "avatars to" << _domainSockAddr << "at" << _avatarsPerSecond
+        << "per second";
+
+    _sessions.reserve(_numAvatars);
+
+    connect(&_updateTimer, &QTimer::timeout, this, &AvatarLoadApp::update);
+    _updateTimer.setTimerType(Qt::PreciseTimer);
+    _updateTimer.start(UPDATE_INTERVAL_MSECS);
+
+    connect(&_reportTimer, &QTimer::timeout, this, &AvatarLoadApp::report);
+    _reportTimer.start(std::max(parser.value(reportOption).toInt(), 1) * (int)MSECS_PER_SECOND);
+
+    connect(this, &QCoreApplication::aboutToQuit, this, &AvatarLoadApp::finish);
+
+    _elapsedTimer.start();
+}
+
+void AvatarLoadApp::update() {
+    quint64 elapsedUsecs = _elapsedTimer.nsecsElapsed() / NSECS_PER_USEC;
+
+    if (_durationUsecs > 0 && elapsedUsecs >= _durationUsecs) {
+        report();
+        quit();
+        return;
+    }
+
+    // ramp up rather than have every avatar ask the domain-server to connect at once
+    size_t numDueAvatars = std::min((size_t)_numAvatars,
+                                    (size_t)(_avatarsPerSecond * elapsedUsecs / USECS_PER_SECOND) + 1);
+    while (_sessions.size() < numDueAvatars) {
+        _sessions.emplace_back(new AvatarLoadSession((int)_sessions.size(), _domainSockAddr, _settings, _stats));
+    }
+
+    for (auto& session : _sessions) {
+        session->update(elapsedUsecs);
+    }
+}
+
+void AvatarLoadApp::report() {
+    quint64 elapsedUsecs = _elapsedTimer.nsecsElapsed() / NSECS_PER_USEC;
+    float seconds = std::max((float)(elapsedUsecs - _lastReportUsecs) / USECS_PER_SECOND, EPSILON);
+    _lastReportUsecs = elapsedUsecs;
+
+    int numConnected = 0;
+    int numWithAudioMixer = 0;
+    int numWithAvatarMixer = 0;
+    for (auto& session : _sessions) {
+        numConnected += session->isConnected() ? 1 : 0;
+        numWithAudioMixer += session->hasActiveAudioMixer() ? 1 : 0;
+        numWithAvatarMixer += session->hasActiveAvatarMixer() ? 1 : 0;
+    }
+
+    qDebug() << "Avatars:" << _sessions.size() << "of" << _numAvatars << "started," << numConnected << "connected,"
+        << numWithAudioMixer << "with the audio-mixer," << numWithAvatarMixer << "with the avatar-mixer,"
+        << _stats.connectionsDenied << "connections denied";
+
+    qDebug().noquote() << QString("Sent: %1 packets/s %2 kbps, %3 datagrams per syscall")
+        .arg(_stats.packetsSent / seconds, 0, 'f', 0)
+        .arg(_stats.bytesSent * BITS_IN_BYTE / seconds / BYTES_PER_KILOBIT, 0, 'f', 0)
+        .arg(_stats.sendSyscalls > 0 ? (float)_stats.packetsSent / _stats.sendSyscalls : 0.0f, 0, 'f', 2);
+    qDebug().noquote() << QString("Received: %1 packets/s %2 kbps")
+        .arg(_stats.packetsReceived / seconds, 0, 'f', 0)
+        .arg(_stats.bytesReceived * BITS_IN_BYTE / seconds / BYTES_PER_KILOBIT, 0, 'f', 0);
+
+    qDebug().noquote() << "Audio-mixer round trip:" << percentiles(_stats.audioMixerRoundTrips);
+    qDebug().noquote() << "Avatar-mixer round trip:" << percentiles(_stats.avatarMixerRoundTrips);
+
+    // how regularly each mixer gets a mix out to every listener, which slips as the mixer falls behind
+    qDebug().noquote() << "Audio mix interval:" << percentiles(_stats.audioMixIntervals);
+    qDebug().noquote() << "Avatar mix interval:" << percentiles(_stats.avatarMixIntervals);
+
+    _stats.packetsSent = 0;
+    _stats.bytesSent = 0;
+    _stats.packetsReceived = 0;
+    _stats.bytesReceived = 0;
+    _stats.sendSyscalls = 0;
+}
+
+void AvatarLoadApp::finish() {
+    _updateTimer.stop();
+    _reportTimer.stop();
+
+    for (auto& session : _sessions) {
+        session->disconnect();
+    }
+    _sessions.clear();
+}
@@ -0,0 +1,52 @@
+//
+//  AvatarLoadApp.h
+//  tools/avatar-load-client/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AvatarLoadApp_h
+#define hifi_AvatarLoadApp_h
+
+#include <memory>
+#include <vector>
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QTimer>
+
+#include "AvatarLoadSession.h"
+
+// Simulates many headless avatars from one process, to load a domain's audio and avatar mixers the way that
+// many real clients would. Every avatar is updated from a single timer on the main thread, and the sends due
+// for an avatar on each update go out as one batch.
+class AvatarLoadApp : public QCoreApplication {
+    Q_OBJECT
+public:
+    AvatarLoadApp(int argc, char* argv[]);
+
+private slots:
+    void update();
+    void report();
+    void finish();
+
+private:
+    SimulatedAvatarSettings _settings;
+    HifiSockAddr _domainSockAddr;
+    int _numAvatars { 0 };
+    float _avatarsPerSecond { 0.0f };
+    quint64 _durationUsecs { 0 };
+
+    std::vector<std::unique_ptr<AvatarLoadSession>> _sessions;
+    AvatarLoadStats _stats;
+
+    QTimer _updateTimer;
+    QTimer _reportTimer;
+    QElapsedTimer _elapsedTimer;
+    quint64 _lastReportUsecs { 0 };
+};
+
+#endif // hifi_AvatarLoadApp_h
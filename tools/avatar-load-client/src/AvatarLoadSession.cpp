@@ -0,0 +1,534 @@
+//
+//  AvatarLoadSession.cpp
+//  tools/avatar-load-client/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AvatarLoadSession.h"
+
+#include <algorithm>
+#include <chrono>
+
+#include <QtCore/QDataStream>
+
+#include <AudioConstants.h>
+#include <AvatarHashMap.h>
+#include <LimitedNodeList.h>
+#include <NodeList.h>
+#include <NodePermissions.h>
+#include <ReceivedMessage.h>
+#include <SharedUtil.h>
+#include <UUID.h>
+#include <shared/ConicalViewFrustum.h>
+#include <shared/NetworkUtils.h>
+#include <udt/PacketHeaders.h>
+
+// must match how Node signs packets with its connection secret
+static const HMACAuth::AuthMethod NODE_AUTH_METHOD = HMACAuth::SipHash;
+
+static const quint64 CHECK_IN_INTERVAL_USECS = DOMAIN_SERVER_CHECK_IN_MSECS * USECS_PER_MSEC;
+static const quint64 PING_INTERVAL_USECS = USECS_PER_SECOND;
+static const quint64 AVATAR_QUERY_INTERVAL_USECS = USECS_PER_SECOND;
+static const quint64 AUDIO_FRAME_USECS = AudioConstants::NETWORK_FRAME_USECS;
+
+// after a stall, a session sends at most this many frames late before skipping ahead
+static const quint64 MAX_AUDIO_CATCH_UP_USECS = 4 * AUDIO_FRAME_USECS;
+
+// spreads the sessions' sends over each interval so they don't all go out on the same tick
+static const quint64 SESSION_PHASE_STRIDE_USECS = 997;
+
+AvatarLoadSession::AvatarLoadSession(int index, const HifiSockAddr& domainSockAddr,
+                                     const SimulatedAvatarSettings& settings, AvatarLoadStats& stats) :
+    _domainSockAddr(domainSockAddr),
+    _settings(settings),
+    _stats(stats),
+    _avatar(index, settings),
+    // thousands of these share the machine, so leave the system socket buffers at their defaults
+    _socket(nullptr, false),
+    _machineFingerprint(QUuid::createUuid())
+{
+    _socket.bind(QHostAddress::AnyIPv4);
+    _localSockAddr = HifiSockAddr(getGuessedLocalAddress(), _socket.localPort());
+
+    _socket.setPacketHandler([this](std::unique_ptr<udt::Packet> packet) {
+        processPacket(std::move(packet));
+    });
+    _socket.setMessageHandler([this](std::unique_ptr<udt::Packet> packet) {
+        // the reliable lists the avatar-mixer sends (identities and traits of the others) are only counted
+        ++_stats.packetsReceived;
+        _stats.bytesReceived += packet->getWireSize();
+    });
+
+    quint64 phase = (quint64)index * SESSION_PHASE_STRIDE_USECS;
+    _nextCheckInUsecs = phase % CHECK_IN_INTERVAL_USECS;
+    _nextAudioUsecs = phase % AUDIO_FRAME_USECS;
+    _nextAvatarDataUsecs = phase % MIN_TIME_BETWEEN_MY_AVATAR_DATA_SENDS;
+}
+
+void AvatarLoadSession::update(quint64 elapsedUsecs) {
+    if (elapsedUsecs >= _nextCheckInUsecs) {
+        sendDomainServerCheckIn();
+        _nextCheckInUsecs = elapsedUsecs + CHECK_IN_INTERVAL_USECS;
+    }
+
+    if (!isConnected()) {
+        return;
+    }
+
+    bool isBatching = _socket.beginSendBatch();
+    quint64 packetsSentBefore = _stats.packetsSent;
+
+    for (auto& mixer : _mixers) {
+        if (elapsedUsecs >= mixer.nextPingUsecs) {
+            pingMixer(mixer);
+            mixer.nextPingUsecs = elapsedUsecs + PING_INTERVAL_USECS;
+        }
+    }
+
+    auto avatarMixer = findActiveMixer(NodeType::AvatarMixer);
+    if (avatarMixer && elapsedUsecs >= _nextAvatarDataUsecs) {
+        if (!avatarMixer->hasSentIdentity) {
+            sendIdentity(*avatarMixer);
+        }
+
+        _avatar.simulate(elapsedUsecs);
+        sendAvatarData(*avatarMixer);
+        _nextAvatarDataUsecs = std::max(_nextAvatarDataUsecs + MIN_TIME_BETWEEN_MY_AVATAR_DATA_SENDS, elapsedUsecs);
+
+        if (elapsedUsecs >= _nextAvatarQueryUsecs) {
+            sendAvatarQuery(*avatarMixer);
+            _nextAvatarQueryUsecs = elapsedUsecs + AVATAR_QUERY_INTERVAL_USECS;
+        }
+    }
+
+    auto audioMixer = findActiveMixer(NodeType::AudioMixer);
+    if (audioMixer) {
+        if (elapsedUsecs > _nextAudioUsecs + MAX_AUDIO_CATCH_UP_USECS) {
+            _nextAudioUsecs = elapsedUsecs;
+        }
+
+        // audio goes out at the network frame rate regardless of how often we are updated
+        while (elapsedUsecs >= _nextAudioUsecs) {
+            sendAudio(*audioMixer);
+            _nextAudioUsecs += AUDIO_FRAME_USECS;
+        }
+    }
+
+    if (isBatching) {
+        auto batchStats = _socket.endSendBatch();
+        _stats.sendSyscalls += batchStats.numSyscalls;
+    } else {
+        _stats.sendSyscalls += _stats.packetsSent - packetsSentBefore;
+    }
+}
+
+void AvatarLoadSession::disconnect() {
+    if (isConnected()) {
+        sendPacket(NLPacket::create(PacketType::DomainDisconnectRequest, 0), _domainSockAddr, nullptr);
+    }
+}
+
+void AvatarLoadSession::processPacket(std::unique_ptr<udt::Packet> packet) {
+    auto nlPacket = NLPacket::fromBase(std::move(packet));
+
+    ++_stats.packetsReceived;
+    _stats.bytesReceived += nlPacket->getWireSize();
+
+    switch (nlPacket->getType()) {
+        case PacketType::DomainList: {
+            ReceivedMessage message(*nlPacket);
+            processDomainList(message);
+            break;
+        }
+        case PacketType::DomainServerAddedNode: {
+            ReceivedMessage message(*nlPacket);
+            QDataStream packetStream(message.getMessage());
+            processAddedNode(packetStream);
+            break;
+        }
+        case PacketType::DomainServerRemovedNode: {
+            removeMixer(QUuid::fromRfc4122(nlPacket->read(NUM_BYTES_RFC4122_UUID)));
+            break;
+        }
+        case PacketType::DomainConnectionDenied: {
+            ++_stats.connectionsDenied;
+            break;
+        }
+        default: {
+            // everything else we care about comes from one of the mixers
+            auto mixer = findMixer(nlPacket->getSourceID());
+            if (!mixer) {
+                break;
+            }
+
+            auto receiveUsecs = (quint64)std::chrono::duration_cast<std::chrono::microseconds>(
+                nlPacket->getReceiveTime().time_since_epoch()).count();
+
+            switch (nlPacket->getType()) {
+                case PacketType::Ping:
+                    processPing(*nlPacket, *mixer);
+                    break;
+                case PacketType::PingReply:
+                    processPingReply(*nlPacket, *mixer);
+                    break;
+                case PacketType::MixedAudio:
+                case PacketType::SilentAudioFrame:
+                case PacketType::BulkAvatarData:
+                    processMix(*mixer, receiveUsecs);
+                    break;
+                default:
+                    break;
+            }
+            break;
+        }
+    }
+}
+
+void AvatarLoadSession::processDomainList(ReceivedMessage& message) {
+    QDataStream packetStream(message.getMessage());
+
+    QUuid domainUUID;
+    NLPacket::LocalID domainLocalID;
+    QUuid newUUID;
+    NLPacket::LocalID newLocalID;
+    NodePermissions newPermissions;
+    bool isAuthenticated;
+    quint64 connectRequestTimestamp;
+    quint64 domainServerPingSendTime;
+    quint64 domainServerCheckinProcessingTime;
+    bool newConnection;
+    quint64 domainListVersion;
+    bool isDelta;
+    quint64 domainListBaseVersion;
+
+    packetStream >> domainUUID >> domainLocalID >> newUUID >> newLocalID >> newPermissions >> isAuthenticated
+        >> connectRequestTimestamp >> domainServerPingSendTime >> domainServerCheckinProcessingTime
+        >> newConnection >> domainListVersion >> isDelta >> domainListBaseVersion;
+
+    if (isConnected() && (domainUUID != _domainUUID || newUUID != _sessionUUID || newLocalID != _sessionLocalID)) {
+        // the domain-server restarted or forgot about us, start over with the mixers it gives us now
+        resetSession();
+    }
+
+    _domainUUID = domainUUID;
+    _sessionUUID = newUUID;
+    _sessionLocalID = newLocalID;
+    _authenticatePackets = isAuthenticated;
+    _avatar.setSessionUUID(newUUID);
+
+    if (isDelta) {
+        quint32 numRemovedNodes;
+        packetStream >> numRemovedNodes;
+
+        for (quint32 i = 0; i < numRemovedNodes; ++i) {
+            QUuid removedNodeUUID;
+            packetStream >> removedNodeUUID;
+            removeMixer(removedNodeUUID);
+        }
+    }
+
+    while (packetStream.device()->pos() < message.getSize()) {
+        processAddedNode(packetStream);
+    }
+
+    // as in NodeList, a delta only brings us up to date if we have the list it is a delta from
+    if (!isDelta || (_domainListVersion != 0 && domainListBaseVersion <= _domainListVersion)) {
+        _domainListVersion = domainListVersion;
+    }
+}
+
+void AvatarLoadSession::processAddedNode(QDataStream& packetStream) {
+    NodeType_t type;
+    QUuid uuid;
+    HifiSockAddr publicSocket;
+    HifiSockAddr localSocket;
+    NodePermissions permissions;
+    bool isReplicated;
+    NLPacket::LocalID localID;
+    QUuid connectionSecret;
+
+    packetStream >> type >> uuid >> publicSocket >> localSocket >> permissions >> isReplicated >> localID
+        >> connectionSecret;
+
+    if (type != NodeType::AudioMixer && type != NodeType::AvatarMixer) {
+        return;
+    }
+
+    // if the public socket address is 0 then it's reachable at the same IP as the domain server
+    if (publicSocket.getAddress().isNull()) {
+        publicSocket.setAddress(_domainSockAddr.getAddress());
+    }
+
+    auto mixer = findMixer(uuid);
+    if (!mixer) {
+        _mixers.emplace_back();
+        mixer = &_mixers.back();
+        mixer->type = type;
+        mixer->uuid = uuid;
+        mixer->authenticateHash.reset(new HMACAuth(NODE_AUTH_METHOD));
+    }
+
+    if (publicSocket != mixer->publicSocket || localSocket != mixer->localSocket) {
+        mixer->publicSocket = publicSocket;
+        mixer->localSocket = localSocket;
+        mixer->activeSocket.clear();
+    }
+
+    if (connectionSecret != mixer->connectionSecret) {
+        mixer->connectionSecret = connectionSecret;
+        mixer->authenticateHash->setKey(connectionSecret);
+    }
+
+    mixer->localID = localID;
+}
+
+void AvatarLoadSession::processPing(NLPacket& packet, Mixer& mixer) {
+    PingType_t pingType;
+    quint64 timeFromOriginalPing;
+    packet.readPrimitive(&pingType);
+    packet.readPrimitive(&timeFromOriginalPing);
+
+    auto replyPacket = NLPacket::create(PacketType::PingReply, sizeof(PingType_t) + sizeof(quint64) + sizeof(quint64));
+    replyPacket->writePrimitive(pingType);
+    replyPacket->writePrimitive(timeFromOriginalPing);
+    replyPacket->writePrimitive(usecTimestampNow());
+
+    // the mixer activates the socket we reply from, which is how it starts sending us mixes
+    sendPacket(std::move(replyPacket), packet.getSenderSockAddr(), mixer.authenticateHash.get());
+}
+
+void AvatarLoadSession::processPingReply(NLPacket& packet, Mixer& mixer) {
+    PingType_t pingType;
+    quint64 ourOriginalTime;
+    packet.readPrimitive(&pingType);
+    packet.readPrimitive(&ourOriginalTime);
+
+    // the first socket the mixer answers on is the one we use from now on
+    if (mixer.activeSocket.isNull()) {
+        mixer.activeSocket = packet.getSenderSockAddr();
+    }
+
+    float roundTripMsecs = (float)(usecTimestampNow() - ourOriginalTime) / USECS_PER_MSEC;
+    if (mixer.type == NodeType::AudioMixer) {
+        _stats.audioMixerRoundTrips.push_back(roundTripMsecs);
+    } else {
+        _stats.avatarMixerRoundTrips.push_back(roundTripMsecs);
+    }
+}
+
+void AvatarLoadSession::processMix(Mixer& mixer, quint64 receiveUsecs) {
+    if (mixer.lastMixUsecs != 0 && receiveUsecs > mixer.lastMixUsecs) {
+        float intervalMsecs = (float)(receiveUsecs - mixer.lastMixUsecs) / USECS_PER_MSEC;
+        if (mixer.type == NodeType::AudioMixer) {
+            _stats.audioMixIntervals.push_back(intervalMsecs);
+        } else {
+            _stats.avatarMixIntervals.push_back(intervalMsecs);
+        }
+    }
+    mixer.lastMixUsecs = receiveUsecs;
+}
+
+void AvatarLoadSession::sendDomainServerCheckIn() {
+    bool isConnectRequest = !isConnected();
+    auto domainPacket = NLPacket::create(isConnectRequest ? PacketType::DomainConnectRequest
+                                                          : PacketType::DomainListRequest);
+    QDataStream packetStream(domainPacket.get());
+
+    if (isConnectRequest) {
+        // no assignment or ICE client ID to connect with
+        packetStream << QUuid();
+
+        QByteArray protocolVersionSig = protocolVersionsSignature();
+        packetStream.writeBytes(protocolVersionSig.constData(), protocolVersionSig.size());
+
+        // no hardware address, and a fingerprint of our own so the domain-server sees a machine per avatar
+        packetStream << QString();
+        packetStream << _machineFingerprint;
+
+        // no system info
+        packetStream << QByteArray();
+
+        packetStream << (quint32)LimitedNodeList::ConnectReason::Connect;
+
+        // no previous connection uptime
+        packetStream << quint64(0);
+    }
+
+    packetStream << quint64(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+
+    // leave the public address for the domain-server to fill in from what it sees us send from
+    HifiSockAddr publicSockAddr(QHostAddress(), _localSockAddr.getPort());
+    packetStream << NodeType::Agent << publicSockAddr << _localSockAddr
+        << (QList<NodeType_t>() << NodeType::AudioMixer << NodeType::AvatarMixer);
+
+    // no place name
+    packetStream << QString();
+
+    if (isConnectRequest) {
+        // anonymous
+        packetStream << QString();
+    } else {
+        packetStream << _domainListVersion;
+    }
+
+    sendPacket(std::move(domainPacket), _domainSockAddr, nullptr);
+}
+
+void AvatarLoadSession::pingMixer(Mixer& mixer) {
+    auto sendPing = [&](PingType_t pingType, const HifiSockAddr& sockAddr) {
+        auto pingPacket = NLPacket::create(PacketType::Ping, sizeof(PingType_t) + sizeof(quint64) + sizeof(int64_t));
+        pingPacket->writePrimitive(pingType);
+        pingPacket->writePrimitive(usecTimestampNow());
+        pingPacket->writePrimitive(INITIAL_CONNECTION_ID);
+        sendPacket(std::move(pingPacket), sockAddr, mixer.authenticateHash.get());
+    };
+
+    if (!mixer.activeSocket.isNull()) {
+        sendPing(PingType::Agnostic, mixer.activeSocket);
+    } else {
+        // punch to both sockets until the mixer answers on one
+        sendPing(PingType::Local, mixer.localSocket);
+        sendPing(PingType::Public, mixer.publicSocket);
+    }
+}
+
+void AvatarLoadSession::sendAvatarData(Mixer& avatarMixer) {
+    // as in AvatarData::sendAvatarDataPacket, now and again send all the joints in case a change was lost
+    bool sendAllData = randFloat() < AVATAR_SEND_FULL_UPDATE_RATIO;
+
+    QByteArray avatarByteArray = _avatar.toByteArrayStateful(sendAllData ? AvatarData::SendAllData
+                                                                         : AvatarData::CullSmallData);
+
+    int maximumByteArraySize = NLPacket::maxPayloadSize(PacketType::AvatarData) - sizeof(AvatarDataSequenceNumber);
+    if (avatarByteArray.size() > maximumByteArraySize) {
+        avatarByteArray = _avatar.toByteArrayStateful(AvatarData::MinimumData, true);
+    }
+
+    _avatar.doneEncoding(!sendAllData);
+
+    auto avatarPacket = NLPacket::create(PacketType::AvatarData,
+                                         avatarByteArray.size() + sizeof(AvatarDataSequenceNumber));
+    avatarPacket->writePrimitive(_avatarSequenceNumber++);
+    avatarPacket->write(avatarByteArray);
+
+    sendPacket(std::move(avatarPacket), avatarMixer.activeSocket, avatarMixer.authenticateHash.get());
+}
+
+void AvatarLoadSession::sendAvatarQuery(Mixer& avatarMixer) {
+    ConicalViewFrustum view;
+    view.setPositionAndSimpleRadius(_avatar.getWorldPosition(), _settings.viewRadius);
+
+    auto queryPacket = NLPacket::create(PacketType::AvatarQuery);
+    auto destinationBuffer = reinterpret_cast<unsigned char*>(queryPacket->getPayload());
+    unsigned char* bufferStart = destinationBuffer;
+
+    uint8_t numFrustums = 1;
+    memcpy(destinationBuffer, &numFrustums, sizeof(numFrustums));
+    destinationBuffer += sizeof(numFrustums);
+    destinationBuffer += view.serialize(destinationBuffer);
+
+    queryPacket->setPayloadSize(destinationBuffer - bufferStart);
+
+    sendPacket(std::move(queryPacket), avatarMixer.activeSocket, avatarMixer.authenticateHash.get());
+}
+
+void AvatarLoadSession::sendIdentity(Mixer& avatarMixer) {
+    // our identity always fits in one packet, so it goes as a single reliable one rather than a list
+    auto identityPacket = NLPacket::create(PacketType::AvatarIdentity, -1, true);
+    identityPacket->write(_avatar.identityByteArray());
+
+    sendPacket(std::move(identityPacket), avatarMixer.activeSocket, avatarMixer.authenticateHash.get());
+    avatarMixer.hasSentIdentity = true;
+}
+
+void AvatarLoadSession::sendAudio(Mixer& audioMixer) {
+    int16_t samples[AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL];
+    bool hasAudio = _avatar.nextAudioFrame(samples);
+
+    auto audioPacket = NLPacket::create(hasAudio ? PacketType::MicrophoneAudioNoEcho : PacketType::SilentAudioFrame);
+    audioPacket->writePrimitive(audioMixer.audioSequenceNumber++);
+
+    // no codec, the audio-mixer takes PCM until one is negotiated
+    audioPacket->writeString(QString());
+
+    if (hasAudio) {
+        // mono
+        audioPacket->writePrimitive((quint8)0);
+    } else {
+        // the number of silent samples, so the audio-mixer can uphold timing
+        audioPacket->writePrimitive((int16_t)AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+    }
+
+    // the same source position and orientation as Agent sends for a scripted avatar
+    audioPacket->writePrimitive(_avatar.getWorldPosition());
+    audioPacket->writePrimitive(_avatar.getHeadOrientation());
+    audioPacket->writePrimitive(_avatar.getWorldPosition());
+    audioPacket->writePrimitive(glm::vec3(0));
+
+    if (hasAudio) {
+        audioPacket->write(reinterpret_cast<const char*>(samples), sizeof(samples));
+    }
+
+    sendPacket(std::move(audioPacket), audioMixer.activeSocket, audioMixer.authenticateHash.get());
+}
+
+void AvatarLoadSession::sendPacket(std::unique_ptr<NLPacket> packet, const HifiSockAddr& sockAddr,
+                                   HMACAuth* authenticateHash) {
+    // the same header LimitedNodeList::fillPacketHeader writes
+    bool isSourced = !PacketTypeEnum::getNonSourcedPackets().contains(packet->getType());
+    if (isSourced) {
+        packet->writeSourceID(_sessionLocalID);
+    }
+
+    if (_authenticatePackets && authenticateHash && isSourced
+        && !PacketTypeEnum::getNonVerifiedPackets().contains(packet->getType())) {
+        packet->writeVerificationHash(*authenticateHash);
+    }
+
+    ++_stats.packetsSent;
+    _stats.bytesSent += packet->getWireSize();
+
+    _socket.writePacket(std::move(packet), sockAddr);
+}
+
+void AvatarLoadSession::resetSession() {
+    _sessionUUID = QUuid();
+    _sessionLocalID = NLPacket::NULL_LOCAL_ID;
+    _domainListVersion = 0;
+    _mixers.clear();
+    _socket.clearConnections();
+}
+
+AvatarLoadSession::Mixer* AvatarLoadSession::findMixer(const QUuid& uuid) {
+    auto it = std::find_if(_mixers.begin(), _mixers.end(), [&](const Mixer& mixer) { return mixer.uuid == uuid; });
+    return it != _mixers.end() ? &(*it) : nullptr;
+}
+
+AvatarLoadSession::Mixer* AvatarLoadSession::findMixer(NLPacket::LocalID localID) {
+    auto it = std::find_if(_mixers.begin(), _mixers.end(), [&](const Mixer& mixer) {
+        return mixer.localID == localID;
+    });
+    return it != _mixers.end() ? &(*it) : nullptr;
+}
+
+void AvatarLoadSession::removeMixer(const QUuid& uuid) {
+    _mixers.erase(std::remove_if(_mixers.begin(), _mixers.end(), [&](const Mixer& mixer) {
+        return mixer.uuid == uuid;
+    }), _mixers.end());
+}
+
+AvatarLoadSession::Mixer* AvatarLoadSession::findActiveMixer(NodeType_t type) {
+    return const_cast<Mixer*>(static_cast<const AvatarLoadSession*>(this)->findActiveMixer(type));
+}
+
+const AvatarLoadSession::Mixer* AvatarLoadSession::findActiveMixer(NodeType_t type) const {
+    auto it = std::find_if(_mixers.begin(), _mixers.end(), [&](const Mixer& mixer) {
+        return mixer.type == type && !mixer.activeSocket.isNull();
+    });
+    return it != _mixers.end() ? &(*it) : nullptr;
+}
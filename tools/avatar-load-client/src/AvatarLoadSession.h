@@ -0,0 +1,128 @@
+//
+//  AvatarLoadSession.h
+//  tools/avatar-load-client/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AvatarLoadSession_h
+#define hifi_AvatarLoadSession_h
+
+#include <memory>
+#include <vector>
+
+#include <QtCore/QUuid>
+
+#include <HifiSockAddr.h>
+#include <HMACAuth.h>
+#include <NLPacket.h>
+#include <NodeType.h>
+#include <udt/Socket.h>
+
+#include "SimulatedAvatar.h"
+
+class ReceivedMessage;
+
+// Counters and latency samples shared by every session, collected on the single load thread and
+// drained by AvatarLoadApp at each report.
+struct AvatarLoadStats {
+    quint64 packetsSent { 0 };
+    quint64 bytesSent { 0 };
+    quint64 packetsReceived { 0 };
+    quint64 bytesReceived { 0 };
+    quint64 sendSyscalls { 0 };
+    quint64 connectionsDenied { 0 };
+
+    // ping round trips to each mixer, msecs
+    std::vector<float> audioMixerRoundTrips;
+    std::vector<float> avatarMixerRoundTrips;
+
+    // time between consecutive mixes received from each mixer, msecs
+    std::vector<float> audioMixIntervals;
+    std::vector<float> avatarMixIntervals;
+};
+
+// The client side of one simulated avatar's connection to a domain: a minimal domain-server session that
+// only asks for the audio and avatar mixers, the pings that activate a socket with each of them, and the
+// avatar data and microphone audio streams. Each session has its own socket, since the domain-server and
+// mixers tell nodes apart by their address.
+class AvatarLoadSession {
+public:
+    AvatarLoadSession(int index, const HifiSockAddr& domainSockAddr, const SimulatedAvatarSettings& settings,
+                      AvatarLoadStats& stats);
+
+    // sends whatever is due at this time, in usecs since the load test started
+    void update(quint64 elapsedUsecs);
+
+    // tells the domain-server we are leaving so it doesn't wait for us to time out
+    void disconnect();
+
+    bool isConnected() const { return !_sessionUUID.isNull(); }
+    bool hasActiveAudioMixer() const { return findActiveMixer(NodeType::AudioMixer) != nullptr; }
+    bool hasActiveAvatarMixer() const { return findActiveMixer(NodeType::AvatarMixer) != nullptr; }
+
+private:
+    struct Mixer {
+        NodeType_t type;
+        QUuid uuid;
+        NLPacket::LocalID localID;
+        HifiSockAddr publicSocket;
+        HifiSockAddr localSocket;
+        HifiSockAddr activeSocket;
+        QUuid connectionSecret;
+        std::unique_ptr<HMACAuth> authenticateHash;
+        quint64 nextPingUsecs { 0 };
+        quint64 lastMixUsecs { 0 };
+        quint16 audioSequenceNumber { 0 };
+        bool hasSentIdentity { false };
+    };
+
+    void processPacket(std::unique_ptr<udt::Packet> packet);
+    void processDomainList(ReceivedMessage& message);
+    void processAddedNode(QDataStream& packetStream);
+    void processPing(NLPacket& packet, Mixer& mixer);
+    void processPingReply(NLPacket& packet, Mixer& mixer);
+    void processMix(Mixer& mixer, quint64 receiveUsecs);
+
+    void sendDomainServerCheckIn();
+    void pingMixer(Mixer& mixer);
+    void sendAvatarData(Mixer& avatarMixer);
+    void sendAvatarQuery(Mixer& avatarMixer);
+    void sendIdentity(Mixer& avatarMixer);
+    void sendAudio(Mixer& audioMixer);
+
+    void sendPacket(std::unique_ptr<NLPacket> packet, const HifiSockAddr& sockAddr, HMACAuth* authenticateHash);
+    void resetSession();
+
+    Mixer* findMixer(const QUuid& uuid);
+    Mixer* findMixer(NLPacket::LocalID localID);
+    void removeMixer(const QUuid& uuid);
+    Mixer* findActiveMixer(NodeType_t type);
+    const Mixer* findActiveMixer(NodeType_t type) const;
+
+    HifiSockAddr _domainSockAddr;
+    const SimulatedAvatarSettings& _settings;
+    AvatarLoadStats& _stats;
+    SimulatedAvatar _avatar;
+    udt::Socket _socket;
+    HifiSockAddr _localSockAddr;
+    QUuid _machineFingerprint;
+
+    QUuid _domainUUID;
+    QUuid _sessionUUID;
+    NLPacket::LocalID _sessionLocalID { NLPacket::NULL_LOCAL_ID };
+    bool _authenticatePackets { true };
+    quint64 _domainListVersion { 0 };
+    std::vector<Mixer> _mixers;
+
+    quint64 _nextCheckInUsecs { 0 };
+    quint64 _nextAvatarDataUsecs { 0 };
+    quint64 _nextAvatarQueryUsecs { 0 };
+    quint64 _nextAudioUsecs { 0 };
+    quint16 _avatarSequenceNumber { 0 };
+};
+
+#endif // hifi_AvatarLoadSession_h
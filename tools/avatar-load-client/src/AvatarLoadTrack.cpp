@@ -0,0 +1,81 @@
+//
+//  AvatarLoadTrack.cpp
+//  tools/avatar-load-client/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AvatarLoadTrack.h"
+
+#include <algorithm>
+
+#include <QtCore/QDebug>
+
+#include <AudioConstants.h>
+#include <AvatarData.h>
+#include <Transform.h>
+#include <recording/Clip.h>
+
+AvatarLoadTrack::Pointer AvatarLoadTrack::fromFile(const QString& filePath) {
+    auto clip = recording::Clip::fromFile(filePath);
+    if (!clip) {
+        qWarning() << "Could not read recording" << filePath;
+        return Pointer();
+    }
+
+    static const recording::FrameType AVATAR_FRAME_TYPE = recording::Frame::registerFrameType(AvatarData::FRAME_NAME);
+    static const recording::FrameType AUDIO_FRAME_TYPE =
+        recording::Frame::registerFrameType(AudioConstants::getAudioFrameName());
+
+    auto track = std::make_shared<AvatarLoadTrack>();
+
+    // decode every frame through a scratch avatar with an identity basis, so the poses come out relative to
+    // where the recording started and each simulated avatar can replay them from its own position
+    AvatarData scratchAvatar;
+    scratchAvatar.setRecordingBasis(std::make_shared<Transform>());
+
+    clip->seekFrameTime(0);
+    for (auto frame = clip->nextFrame(); frame; frame = clip->nextFrame()) {
+        if (frame->type == AVATAR_FRAME_TYPE) {
+            AvatarData::fromFrame(frame->data, scratchAvatar);
+
+            Pose pose;
+            pose.time = frame->timeOffset;
+            pose.translation = scratchAvatar.getWorldPosition();
+            pose.rotation = scratchAvatar.getWorldOrientation();
+            pose.joints = scratchAvatar.getRawJointData();
+            track->_poses.push_back(pose);
+        } else if (frame->type == AUDIO_FRAME_TYPE) {
+            auto samples = reinterpret_cast<const int16_t*>(frame->data.constData());
+            track->_audio.insert(track->_audio.end(), samples, samples + frame->data.size() / sizeof(int16_t));
+        }
+    }
+
+    if (track->_poses.empty()) {
+        qWarning() << "Recording" << filePath << "has no avatar frames";
+        return Pointer();
+    }
+
+    // frames are written in time order, but don't rely on it for the binary search in poseAt
+    std::stable_sort(track->_poses.begin(), track->_poses.end(), [](const Pose& a, const Pose& b) {
+        return a.time < b.time;
+    });
+
+    track->_duration = std::max(track->_poses.back().time, (Time)1);
+
+    qDebug() << "Loaded recording" << filePath << "-" << track->_poses.size() << "poses,"
+        << track->_audio.size() / AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL << "audio frames,"
+        << recording::Frame::frameTimeToSeconds(track->_duration) << "seconds";
+
+    return track;
+}
+
+const AvatarLoadTrack::Pose& AvatarLoadTrack::poseAt(Time time) const {
+    auto next = std::upper_bound(_poses.begin(), _poses.end(), time, [](Time time, const Pose& pose) {
+        return time < pose.time;
+    });
+    return next == _poses.begin() ? *next : *(next - 1);
+}
@@ -0,0 +1,57 @@
+//
+//  AvatarLoadTrack.h
+//  tools/avatar-load-client/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AvatarLoadTrack_h
+#define hifi_AvatarLoadTrack_h
+
+#include <memory>
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <QtCore/QVector>
+
+#include <JointData.h>
+#include <recording/Frame.h>
+
+// A recording decoded once up front and shared by every simulated avatar that replays it.
+// Avatar frames are stored relative to the start of the recording, and the joint arrays are implicitly
+// shared, so applying a pose to thousands of avatars does not copy or re-parse any frame data.
+class AvatarLoadTrack {
+public:
+    using Pointer = std::shared_ptr<const AvatarLoadTrack>;
+    using Time = recording::Frame::Time;
+
+    struct Pose {
+        Time time { 0 };
+        glm::vec3 translation;
+        glm::quat rotation;
+        QVector<JointData> joints;
+    };
+
+    // returns nullptr when the file can't be read or has no avatar frames
+    static Pointer fromFile(const QString& filePath);
+
+    Time getDuration() const { return _duration; }
+
+    // the last pose at or before the given offset into the recording
+    const Pose& poseAt(Time time) const;
+
+    // the recorded microphone input, as mono network-rate samples
+    const std::vector<int16_t>& getAudio() const { return _audio; }
+
+private:
+    std::vector<Pose> _poses;
+    std::vector<int16_t> _audio;
+    Time _duration { 0 };
+};
+
+#endif // hifi_AvatarLoadTrack_h
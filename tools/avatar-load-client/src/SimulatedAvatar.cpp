@@ -0,0 +1,167 @@
+//
+//  SimulatedAvatar.cpp
+//  tools/avatar-load-client/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "SimulatedAvatar.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <AudioConstants.h>
+#include <GLMHelpers.h>
+#include <NumericalConstants.h>
+
+static const float TONE_AMPLITUDE = 6000.0f;
+static const float MIN_TONE_FREQUENCY = 150.0f; // Hz
+static const float TONE_FREQUENCY_STEP = 10.0f; // Hz
+static const int NUM_TONE_FREQUENCIES = 30;
+static const float MIN_BURST_SECONDS = 1.0f;
+static const float MAX_BURST_SECONDS = 4.0f;
+static const float WANDER_ARRIVAL_DISTANCE = 0.1f; // meters
+
+SimulatedAvatar::SimulatedAvatar(int index, const SimulatedAvatarSettings& settings) :
+    _settings(settings),
+    _random(index)
+{
+    std::uniform_real_distribution<float> spawnDistribution(-0.5f, 0.5f);
+    _spawnPosition = _settings.origin +
+        glm::vec3(spawnDistribution(_random), 0.0f, spawnDistribution(_random)) * _settings.spread;
+    _pathPosition = _spawnPosition;
+    _wanderTarget = _spawnPosition;
+
+    std::uniform_real_distribution<float> angleDistribution(0.0f, TWO_PI);
+    _pathAngle = angleDistribution(_random);
+
+    float toneFrequency = MIN_TONE_FREQUENCY + TONE_FREQUENCY_STEP * (index % NUM_TONE_FREQUENCIES);
+    _tonePhaseStep = TWO_PI * toneFrequency / AudioConstants::SAMPLE_RATE;
+
+    if (_settings.track) {
+        std::uniform_int_distribution<AvatarLoadTrack::Time> offsetDistribution(0, _settings.track->getDuration());
+        _trackOffset = offsetDistribution(_random);
+
+        auto& audio = _settings.track->getAudio();
+        if (!audio.empty()) {
+            _recordedAudioOffset = ((size_t)_trackOffset * AudioConstants::SAMPLE_RATE / MSECS_PER_SECOND) % audio.size();
+        }
+    }
+
+    setDisplayName(QString("Load Avatar %1").arg(index));
+    setWorldPosition(_spawnPosition);
+}
+
+void SimulatedAvatar::simulate(quint64 elapsedUsecs) {
+    float deltaTime = (float)(elapsedUsecs - _lastSimulateUsecs) / USECS_PER_SECOND;
+    _lastSimulateUsecs = elapsedUsecs;
+
+    walk(deltaTime);
+
+    if (!_settings.track) {
+        setWorldPosition(_pathPosition);
+        setWorldOrientation(_pathOrientation);
+        return;
+    }
+
+    auto trackTime = (AvatarLoadTrack::Time)((elapsedUsecs / USECS_PER_MSEC + _trackOffset) %
+        _settings.track->getDuration());
+    const auto& pose = _settings.track->poseAt(trackTime);
+
+    setWorldPosition(_pathPosition + _pathOrientation * pose.translation);
+    setWorldOrientation(_pathOrientation * pose.rotation);
+    setRawJointData(pose.joints);
+}
+
+void SimulatedAvatar::walk(float deltaTime) {
+    switch (_settings.path) {
+        case AvatarPath::Stationary:
+            break;
+
+        case AvatarPath::Circle: {
+            float radius = std::max(_settings.pathRadius, EPSILON);
+            _pathAngle = fmodf(_pathAngle + deltaTime * _settings.walkSpeed / radius, TWO_PI);
+
+            glm::vec3 offset(cosf(_pathAngle), 0.0f, sinf(_pathAngle));
+            _pathPosition = _spawnPosition + offset * radius;
+
+            // face along the circle, our forward is -z
+            glm::vec3 heading(-offset.z, 0.0f, offset.x);
+            _pathOrientation = glm::angleAxis(atan2f(-heading.x, -heading.z), Vectors::UNIT_Y);
+            break;
+        }
+
+        case AvatarPath::Wander: {
+            glm::vec3 toTarget = _wanderTarget - _pathPosition;
+            float distance = glm::length(toTarget);
+            if (distance < WANDER_ARRIVAL_DISTANCE) {
+                std::uniform_real_distribution<float> targetDistribution(-0.5f, 0.5f);
+                _wanderTarget = _settings.origin +
+                    glm::vec3(targetDistribution(_random), 0.0f, targetDistribution(_random)) * _settings.spread;
+                break;
+            }
+
+            glm::vec3 heading = toTarget / distance;
+            _pathPosition += heading * std::min(distance, deltaTime * _settings.walkSpeed);
+            _pathOrientation = glm::angleAxis(atan2f(-heading.x, -heading.z), Vectors::UNIT_Y);
+            break;
+        }
+    }
+}
+
+bool SimulatedAvatar::nextAudioFrame(int16_t* samples) {
+    const int NUM_SAMPLES = AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL;
+
+    switch (_settings.audio) {
+        case AvatarAudio::None:
+            return false;
+
+        case AvatarAudio::Tone: {
+            if (_burstFramesLeft <= 0) {
+                // alternate between talking and listening, spending talkRatio of the time talking on average
+                std::uniform_real_distribution<float> unitDistribution(0.0f, 1.0f);
+                std::uniform_real_distribution<float> burstDistribution(MIN_BURST_SECONDS, MAX_BURST_SECONDS);
+                _isTalking = unitDistribution(_random) < _settings.talkRatio;
+                _burstFramesLeft = (int)(burstDistribution(_random) * AudioConstants::SAMPLE_RATE / NUM_SAMPLES);
+            }
+            --_burstFramesLeft;
+
+            if (!_isTalking) {
+                return false;
+            }
+
+            for (int i = 0; i < NUM_SAMPLES; ++i) {
+                samples[i] = (int16_t)(TONE_AMPLITUDE * sinf(_tonePhase));
+                _tonePhase += _tonePhaseStep;
+            }
+            _tonePhase = fmodf(_tonePhase, TWO_PI);
+            return true;
+        }
+
+        case AvatarAudio::Recording: {
+            if (!_settings.track || _settings.track->getAudio().empty()) {
+                return false;
+            }
+
+            auto& audio = _settings.track->getAudio();
+            bool isSilent = true;
+            for (int i = 0; i < NUM_SAMPLES; ++i) {
+                samples[i] = audio[_recordedAudioOffset];
+                isSilent = isSilent && samples[i] == 0;
+                _recordedAudioOffset = (_recordedAudioOffset + 1) % audio.size();
+            }
+            return !isSilent;
+        }
+    }
+
+    return false;
+}
+
+QByteArray SimulatedAvatar::toByteArrayStateful(AvatarDataDetail dataDetail, bool dropFaceTracking) {
+    // as for ScriptableAvatar, nothing else keeps the global position used by the encoder up to date
+    _globalPosition = getWorldPosition();
+    return AvatarData::toByteArrayStateful(dataDetail, dropFaceTracking);
+}
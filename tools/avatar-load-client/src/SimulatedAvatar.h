@@ -0,0 +1,81 @@
+//
+//  SimulatedAvatar.h
+//  tools/avatar-load-client/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_SimulatedAvatar_h
+#define hifi_SimulatedAvatar_h
+
+#include <random>
+
+#include <AvatarData.h>
+
+#include "AvatarLoadTrack.h"
+
+enum class AvatarPath {
+    Stationary, // stays where it spawned
+    Circle, // walks a circle around where it spawned
+    Wander // walks between random points in the spawn area
+};
+
+enum class AvatarAudio {
+    None, // never talks, only sends the silent frames that keep its mix coming
+    Tone, // talks in bursts of a tone, sending silent frames in between
+    Recording // replays the microphone input of the recording
+};
+
+struct SimulatedAvatarSettings {
+    glm::vec3 origin;
+    float spread { 20.0f }; // meters, side of the square avatars spawn in
+    AvatarPath path { AvatarPath::Circle };
+    float pathRadius { 2.0f }; // meters
+    float walkSpeed { 1.0f }; // meters per second
+    AvatarAudio audio { AvatarAudio::Tone };
+    float talkRatio { 0.3f }; // fraction of the time a Tone avatar is talking
+    float viewRadius { 100.0f }; // meters, how far around it the avatar asks the avatar-mixer for others
+    AvatarLoadTrack::Pointer track;
+};
+
+// A headless avatar that walks a scripted path, optionally replaying the joints of a recording on top of it,
+// and produces one network frame of microphone audio at a time.
+class SimulatedAvatar : public AvatarData {
+public:
+    SimulatedAvatar(int index, const SimulatedAvatarSettings& settings);
+
+    // moves the avatar along its path to the given time, in usecs since the load test started
+    void simulate(quint64 elapsedUsecs);
+
+    // fills one network frame of mono samples, returns false (and leaves samples untouched) for a silent frame
+    bool nextAudioFrame(int16_t* samples);
+
+    QByteArray toByteArrayStateful(AvatarDataDetail dataDetail, bool dropFaceTracking = false) override;
+
+private:
+    void walk(float deltaTime);
+
+    const SimulatedAvatarSettings& _settings;
+
+    std::mt19937 _random;
+    glm::vec3 _spawnPosition;
+    glm::vec3 _pathPosition;
+    glm::quat _pathOrientation;
+    glm::vec3 _wanderTarget;
+    float _pathAngle { 0.0f };
+    quint64 _lastSimulateUsecs { 0 };
+
+    // each avatar starts somewhere else in the recording so they don't all move in lockstep
+    AvatarLoadTrack::Time _trackOffset { 0 };
+
+    float _tonePhase { 0.0f };
+    float _tonePhaseStep { 0.0f };
+    int _burstFramesLeft { 0 };
+    bool _isTalking { false };
+    size_t _recordedAudioOffset { 0 };
+};
+
+#endif // hifi_SimulatedAvatar_h
@@ -16,6 +16,7 @@
 #include <udt/Constants.h>
 #include <udt/Packet.h>
 #include <udt/PacketList.h>
+#include <udt/SendScheduler.h>
 
 #include <LogHandler.h>
 
@@ -55,10 +56,17 @@ const QCommandLineOption MESSAGE_SEED {
 const QCommandLineOption STATS_INTERVAL {
     "stats-interval", "stats output interval (default is 100ms)", "milliseconds"
 };
+const QCommandLineOption CONNECTIONS {
+    "connections", "number of connections to open to the target, each from its own socket (default is 1)", "integer"
+};
+const QCommandLineOption SEND_THREADS {
+    "send-threads", "number of threads pacing the send queues of every connection (default is 2)", "integer"
+};
 
 const QStringList CLIENT_STATS_TABLE_HEADERS {
     "Send (Mb/s)", "Est. Max (Mb/s)", "RTT (ms)", "CW (P)", "Period (us)",
-    "Recv ACK", "Procd ACK", "Sent Packets", "Re-sent Packets"
+    "Recv ACK", "Procd ACK", "Sent Packets", "Re-sent Packets",
+    "Steps", "Late (us)", "Max Late (us)"
 };
 
 const QStringList SERVER_STATS_TABLE_HEADERS {
@@ -74,8 +82,14 @@ UDTTest::UDTTest(int& argc, char** argv) :
     // randomize the seed for packet size randomization
     srand(time(NULL));
 
+    // the scheduler is created with the first send queue, set its number of threads before anything is sent
+    if (_argumentParser.isSet(SEND_THREADS)) {
+        udt::SendScheduler::setNumThreads(_argumentParser.value(SEND_THREADS).toInt());
+    }
+
     _socket.bind(QHostAddress::AnyIPv4, _argumentParser.value(PORT_OPTION).toUInt());
     qDebug() << "Test socket is listening on" << _socket.localPort();
+    _sendSockets.push_back(&_socket);
     
     if (_argumentParser.isSet(TARGET_OPTION)) {
         // parse the IP and port combination for this target
@@ -94,6 +108,30 @@ UDTTest::UDTTest(int& argc, char** argv) :
             qDebug() << "Packets will be sent to" << _target;
         }
     }
+
+    if (_argumentParser.isSet(CONNECTIONS)) {
+        int numConnections = _argumentParser.value(CONNECTIONS).toInt();
+
+        if (numConnections < 1) {
+            qCritical() << "Cannot open fewer than one connection to the target.";
+            QMetaObject::invokeMethod(this, "quit", Qt::QueuedConnection);
+        } else if (numConnections > 1 && _argumentParser.isSet(ORDERED_PACKETS)) {
+            qCritical() << "Cannot send ordered packets on more than one connection.";
+            QMetaObject::invokeMethod(this, "quit", Qt::QueuedConnection);
+        } else {
+            // the target tells connections apart by their address, so every extra connection needs its own port
+            for (int i = 1; i < numConnections; ++i) {
+                auto socket = std::unique_ptr<udt::Socket>(new udt::Socket(this));
+                socket->bind(QHostAddress::AnyIPv4);
+                _sendSockets.push_back(socket.get());
+                _extraSockets.push_back(std::move(socket));
+            }
+
+            if (numConnections > 1) {
+                qDebug() << "Packets will be sent on" << numConnections << "connections";
+            }
+        }
+    }
     
     if (_argumentParser.isSet(PACKET_SIZE)) {
         // parse the desired packet size
@@ -224,7 +262,7 @@ void UDTTest::parseArguments() {
     _argumentParser.addOptions({
         PORT_OPTION, TARGET_OPTION, PACKET_SIZE, MIN_PACKET_SIZE, MAX_PACKET_SIZE,
         MAX_SEND_BYTES, MAX_SEND_PACKETS, UNRELIABLE_PACKETS, ORDERED_PACKETS,
-        MESSAGE_SIZE, MESSAGE_SEED, STATS_INTERVAL
+        MESSAGE_SIZE, MESSAGE_SEED, STATS_INTERVAL, CONNECTIONS, SEND_THREADS
     });
     
     if (!_argumentParser.parse(arguments())) {
@@ -241,20 +279,37 @@ void UDTTest::parseArguments() {
 
 void UDTTest::sendInitialPackets() {
     static const int NUM_INITIAL_PACKETS = 500;
+    static const int MIN_INITIAL_PACKETS_PER_CONNECTION = 16;
     
     int numPackets = std::max(NUM_INITIAL_PACKETS, _maxSendPackets);
+
+    // split the initial packets between the connections, so that 1000 connections don't queue up gigabytes
+    int numConnections = (int)_sendSockets.size();
+    int numPacketsPerConnection = std::max(numPackets / numConnections, MIN_INITIAL_PACKETS_PER_CONNECTION);
     
-    for (int i = 0; i < numPackets; ++i) {
-        sendPacket();
+    for (auto socket : _sendSockets) {
+        for (int i = 0; i < numPacketsPerConnection; ++i) {
+            sendPacket(*socket);
+        }
     }
     
     if (numPackets == NUM_INITIAL_PACKETS) {
-        // we've put 500 initial packets in the queue, everytime we hear one has gone out we should add a new one
-        _socket.connectToSendSignal(_target, this, SLOT(refillPacket()));
+        // we've put the initial packets in the queues, everytime we hear one has gone out we should add a new one
+        for (auto socket : _sendSockets) {
+            socket->connectToSendSignal(_target, this, SLOT(refillPacket()));
+        }
     }
 }
 
 void UDTTest::sendPacket() {
+    // refill the connections in turn
+    udt::Socket& socket = *_sendSockets[_nextSendSocket];
+    _nextSendSocket = (_nextSendSocket + 1) % _sendSockets.size();
+
+    sendPacket(socket);
+}
+
+void UDTTest::sendPacket(udt::Socket& socket) {
     
     if (_maxSendPackets != -1 && _totalQueuedPackets > _maxSendPackets) {
         // don't send more packets, we've hit max
@@ -310,7 +365,7 @@ void UDTTest::sendPacket() {
             _totalQueuedBytes += (int)packetList->getDataSize();
             _totalQueuedPackets += (int)packetList->getNumPackets();
             
-            _socket.writePacketList(std::move(packetList), _target);
+            socket.writePacketList(std::move(packetList), _target);
         }
         
     } else {
@@ -321,9 +376,9 @@ void UDTTest::sendPacket() {
         
         // queue or send this packet by calling write packet on the socket for our target
         if (_sendReliable) {
-            _socket.writePacket(std::move(newPacket), _target);
+            socket.writePacket(std::move(newPacket), _target);
         } else {
-            _socket.writePacket(*newPacket, _target);
+            socket.writePacket(*newPacket, _target);
         }
         
         ++_totalQueuedPackets;
@@ -372,7 +427,38 @@ void UDTTest::sampleStats() {
             first = false;
         }
         
+        // with more than one connection, rates and counts are summed and the rest is averaged over the connections
         udt::ConnectionStats::Stats stats = _socket.sampleStatsForConnection(_target);
+        if (_sendSockets.size() > 1) {
+            int64_t totalRTT = stats.rtt;
+            int64_t totalCongestionWindowSize = stats.congestionWindowSize;
+            int64_t totalPacketSendPeriod = stats.packetSendPeriod;
+
+            for (auto& socket : _extraSockets) {
+                udt::ConnectionStats::Stats connectionStats = socket->sampleStatsForConnection(_target);
+
+                stats.sendRate += connectionStats.sendRate;
+                stats.estimatedBandwith += connectionStats.estimatedBandwith;
+                stats.events[udt::ConnectionStats::Stats::ReceivedACK] +=
+                    connectionStats.events[udt::ConnectionStats::Stats::ReceivedACK];
+                stats.events[udt::ConnectionStats::Stats::ProcessedACK] +=
+                    connectionStats.events[udt::ConnectionStats::Stats::ProcessedACK];
+                stats.sentPackets += connectionStats.sentPackets;
+                stats.retransmittedPackets += connectionStats.retransmittedPackets;
+
+                totalRTT += connectionStats.rtt;
+                totalCongestionWindowSize += connectionStats.congestionWindowSize;
+                totalPacketSendPeriod += connectionStats.packetSendPeriod;
+            }
+
+            int64_t numConnections = (int64_t)_sendSockets.size();
+            stats.rtt = (int)(totalRTT / numConnections);
+            stats.congestionWindowSize = (int)(totalCongestionWindowSize / numConnections);
+            stats.packetSendPeriod = (int)(totalPacketSendPeriod / numConnections);
+        }
+
+        // how late the shared scheduler ran the send queues past the time they were due to send
+        udt::SendScheduler::Stats schedulerStats = udt::SendScheduler::getInstance().sampleStats();
         
         int headerIndex = -1;
         
@@ -386,7 +472,10 @@ void UDTTest::sampleStats() {
             QString::number(stats.events[udt::ConnectionStats::Stats::ReceivedACK]).rightJustified(CLIENT_STATS_TABLE_HEADERS[++headerIndex].size()),
             QString::number(stats.events[udt::ConnectionStats::Stats::ProcessedACK]).rightJustified(CLIENT_STATS_TABLE_HEADERS[++headerIndex].size()),
             QString::number(stats.sentPackets).rightJustified(CLIENT_STATS_TABLE_HEADERS[++headerIndex].size()),
-            QString::number(stats.retransmittedPackets).rightJustified(CLIENT_STATS_TABLE_HEADERS[++headerIndex].size())
+            QString::number(stats.retransmittedPackets).rightJustified(CLIENT_STATS_TABLE_HEADERS[++headerIndex].size()),
+            QString::number(schedulerStats.numSteps).rightJustified(CLIENT_STATS_TABLE_HEADERS[++headerIndex].size()),
+            QString::number(schedulerStats.averageLatenessUsecs).rightJustified(CLIENT_STATS_TABLE_HEADERS[++headerIndex].size()),
+            QString::number(schedulerStats.maxLatenessUsecs).rightJustified(CLIENT_STATS_TABLE_HEADERS[++headerIndex].size())
         };
         
         // output this line of values
@@ -401,6 +490,13 @@ void UDTTest::sampleStats() {
         auto sockets = _socket.getConnectionSockAddrs();
         if (sockets.size() > 0) {
             udt::ConnectionStats::Stats stats = _socket.sampleStatsForConnection(sockets.front());
+
+            // the receive rates are summed over every connection from senders
+            for (size_t i = 1; i < sockets.size(); ++i) {
+                udt::ConnectionStats::Stats connectionStats = _socket.sampleStatsForConnection(sockets[i]);
+                stats.receivedBytes += connectionStats.receivedBytes;
+                stats.receiveRate += connectionStats.receiveRate;
+            }
             
             int headerIndex = -1;
             
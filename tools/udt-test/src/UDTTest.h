@@ -15,7 +15,9 @@
 #define hifi_UDTTest_h
 
 
+#include <memory>
 #include <random>
+#include <vector>
 
 #include <QtCore/QCoreApplication>
 #include <QtCore/QCommandLineParser>
@@ -43,11 +45,17 @@ private:
     void parseArguments();
     void handleMessage(std::unique_ptr<Message> message);
     
-    void sendInitialPackets(); // fills the queue with packets to start
-    void sendPacket(); // constructs and sends a packet according to the test parameters
+    void sendInitialPackets(); // fills the queues with packets to start
+    void sendPacket(); // constructs and sends a packet on the next connection according to the test parameters
+    void sendPacket(udt::Socket& socket); // constructs and sends a packet according to the test parameters
     
     QCommandLineParser _argumentParser;
     udt::Socket _socket;
+
+    // when sending on more than one connection, every connection beyond the first gets its own socket
+    std::vector<std::unique_ptr<udt::Socket>> _extraSockets;
+    std::vector<udt::Socket*> _sendSockets;
+    size_t _nextSendSocket { 0 }; // the connection refilled next
     
     HifiSockAddr _target; // the target for sent packets
     